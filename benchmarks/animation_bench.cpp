@@ -0,0 +1,148 @@
+/***************************************************************************************************
+ * @file  animation_bench.cpp
+ * @brief Headless benchmark of the compression and the sampling of animation tracks
+ **************************************************************************************************/
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "animation/AnimationSampler.hpp"
+#include "maths/quaternion.hpp"
+
+static constexpr unsigned int CHARACTERS_COUNT = 200; ///< The amount of animated characters.
+static constexpr unsigned int JOINTS_COUNT = 60;      ///< The amount of joints per character.
+static constexpr float CLIP_DURATION = 4.0f;          ///< The duration of each clip in seconds.
+static constexpr float KEYFRAME_RATE = 30.0f;         ///< The keyframes per second of each channel.
+static constexpr unsigned int FRAMES_COUNT = 2000;    ///< The amount of sampled frames.
+static constexpr float FRAME_DELTA = 1.0f / 60.0f;    ///< The fixed timestep between frames.
+
+/**
+ * @brief Creates a clip like the ones exported by DCC tools: every joint has a keyframe for each
+ * property at a fixed rate, translations and scales barely move and rotations are smooth curves.
+ */
+static std::vector<AnimationChannel> create_channels(unsigned int first_node, std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    const size_t keyframes_count = static_cast<size_t>(CLIP_DURATION * KEYFRAME_RATE) + 1;
+
+    std::vector<AnimationChannel> channels;
+    for(unsigned int joint = 0 ; joint < JOINTS_COUNT ; ++joint) {
+        vec3 axis(distribution(generator) - 0.5f, distribution(generator) - 0.5f, distribution(generator) - 0.5f);
+        axis /= std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+        float amplitude = distribution(generator);
+        float frequency = 0.25f + distribution(generator);
+        float bone_length = distribution(generator);
+
+        for(AnimationPath path : { AnimationPath::TRANSLATION, AnimationPath::ROTATION, AnimationPath::SCALE }) {
+            AnimationChannel& channel = channels.emplace_back();
+            channel.node = first_node + joint;
+            channel.path = path;
+            channel.interpolation = AnimationInterpolation::LINEAR;
+
+            for(size_t i = 0 ; i < keyframes_count ; ++i) {
+                float time = static_cast<float>(i) / KEYFRAME_RATE;
+                channel.times.push_back(time);
+
+                switch(path) {
+                    case AnimationPath::TRANSLATION:
+                        channel.values.insert(channel.values.end(), { 0.0f, bone_length, 0.0f });
+                        break;
+                    case AnimationPath::ROTATION: {
+                        float half_angle = 0.5f * amplitude * std::sin(6.2831853f * frequency * time);
+                        float sin = std::sin(half_angle);
+                        channel.values.insert(channel.values.end(),
+                                              { axis.x * sin, axis.y * sin, axis.z * sin, std::cos(half_angle) });
+                        break;
+                    }
+                    case AnimationPath::SCALE:
+                        channel.values.insert(channel.values.end(), { 1.0f, 1.0f, 1.0f });
+                        break;
+                    case AnimationPath::WEIGHTS: break;
+                }
+            }
+        }
+    }
+
+    return channels;
+}
+
+int main() {
+    std::mt19937 generator(42);
+
+    std::vector<std::vector<AnimationChannel>> clips;
+    std::vector<Animation> animations(CHARACTERS_COUNT);
+    size_t raw_size = 0;
+    size_t raw_keys_count = 0;
+    size_t compressed_size = 0;
+    size_t compressed_keys_count = 0;
+
+    /* ---- Compression ---- */
+    auto compression_start = std::chrono::steady_clock::now();
+
+    for(unsigned int i = 0 ; i < CHARACTERS_COUNT ; ++i) {
+        clips.push_back(create_channels(i * JOINTS_COUNT, generator));
+
+        animations[i].name = "Character " + std::to_string(i);
+        animations[i].duration = CLIP_DURATION;
+        animations[i].time = CLIP_DURATION * static_cast<float>(i) / CHARACTERS_COUNT;
+
+        for(const AnimationChannel& channel : clips.back()) {
+            raw_size += (channel.times.size() + channel.values.size()) * sizeof(float);
+            raw_keys_count += channel.times.size();
+
+            AnimationTrack& track = animations[i].tracks.emplace_back(AnimationTrack::compress(channel));
+            compressed_size += track.get_size();
+            compressed_keys_count += track.times.size();
+        }
+    }
+
+    std::chrono::duration<double, std::milli> compression_duration = std::chrono::steady_clock::now() - compression_start;
+
+    /* ---- Sampling ---- */
+    std::vector<Transform> transforms(CHARACTERS_COUNT * JOINTS_COUNT);
+    AnimationSampler sampler;
+    vec4 checksum(0.0f);
+
+    auto run = [&](auto&& sample_frame) {
+        size_t tracks_count = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for(unsigned int frame = 0 ; frame < FRAMES_COUNT ; ++frame) {
+            for(Animation& animation : animations) { animation.advance(FRAME_DELTA); }
+            tracks_count += sample_frame();
+        }
+
+        std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(tracks_count) / duration.count();
+    };
+
+    double raw_rate = run([&] {
+        size_t tracks_count = 0;
+        for(unsigned int i = 0 ; i < CHARACTERS_COUNT ; ++i) {
+            for(const AnimationChannel& channel : clips[i]) { checksum += channel.sample(animations[i].time); }
+            tracks_count += clips[i].size();
+        }
+        return tracks_count;
+    });
+
+    double sampling_rate = run([&] { return sampler.sample(animations); });
+    double applying_rate = run([&] { return sampler.sample(animations, transforms, {}); });
+
+    for(const Transform& transform : transforms) { checksum += vec4(vec3(transform.get_local_position()), 0.0f); }
+
+    /* ---- Report ---- */
+    std::cout << "Characters: " << CHARACTERS_COUNT << ", joints: " << JOINTS_COUNT
+              << ", tracks: " << CHARACTERS_COUNT * JOINTS_COUNT * 3 << '\n'
+              << "Keys: " << raw_keys_count << " -> " << compressed_keys_count << '\n'
+              << "Size: " << raw_size / 1024 << " KiB -> " << compressed_size / 1024 << " KiB ("
+              << 100.0 * static_cast<double>(compressed_size) / static_cast<double>(raw_size) << "%)\n"
+              << "Compression: " << compression_duration.count() << " ms\n"
+              << "Raw channels sampled per ms: " << raw_rate << '\n'
+              << "Tracks sampled per ms: " << sampling_rate << '\n'
+              << "Tracks sampled and applied per ms: " << applying_rate << '\n'
+              << "Checksum: " << checksum.x + checksum.y + checksum.z + checksum.w << '\n';
+
+    return 0;
+}
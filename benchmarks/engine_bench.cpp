@@ -0,0 +1,428 @@
+/***************************************************************************************************
+ * @file  engine_bench.cpp
+ * @brief Headless micro-benchmarks of the maths, culling and mesh modules
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "animation/Skin.hpp"
+#include "culling/AABB.hpp"
+#include "culling/Ray.hpp"
+#include "maths/affine3x4.hpp"
+#include "maths/mat3.hpp"
+#include "maths/quaternion.hpp"
+#include "maths/Transform.hpp"
+#include "maths/transforms.hpp"
+#include "mesh/Mesh.hpp"
+
+#include "matrix.hpp"
+
+static constexpr unsigned int SEED = 42;                ///< The seed of the generated data.
+static constexpr unsigned int REPETITIONS_COUNT = 9;    ///< The amount of runs of each benchmark.
+static constexpr size_t MATRICES_COUNT = 4096;          ///< The amount of matrices and quaternions.
+static constexpr size_t AABBS_COUNT = 4096;             ///< The amount of boxes, more than Sponza's nodes.
+static constexpr double WORLD_OFFSET = 30000.0;         ///< How far the transforms are from the origin.
+static constexpr unsigned int GRID_WIDTH = 512;         ///< The amount of quads along x in the mesh.
+static constexpr unsigned int GRID_DEPTH = 256;         ///< The amount of quads along z in the mesh.
+static constexpr unsigned int RAYS_COUNT = 16;          ///< The amount of rays cast at the mesh.
+static constexpr size_t TRIANGLES_COUNT = 2 * GRID_WIDTH * GRID_DEPTH; ///< About Sponza's triangles.
+
+static float checksum = 0.0f; ///< Accumulates every result so that none of the work is optimized out.
+
+/**
+ * @brief Runs a benchmark several times and prints the median time per operation, which is stable
+ * from one run to the next unlike the mean.
+ * @param name The name of the benchmark.
+ * @param operations_count The amount of operations done by each run.
+ * @param function The benchmark, called once per run.
+ */
+template <typename Function>
+static void run(const char* name, size_t operations_count, Function&& function) {
+    std::vector<double> durations;
+
+    for(unsigned int i = 0 ; i < REPETITIONS_COUNT ; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+        durations.push_back(duration.count() / static_cast<double>(operations_count));
+    }
+
+    std::ranges::sort(durations);
+
+    std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << durations[REPETITIONS_COUNT / 2] << " ns/op"
+              << std::setw(12) << durations.front() << " min"
+              << std::setw(12) << durations.back() << " max\n";
+}
+
+/**
+ * @brief Creates a random TRS matrix, like the global model matrices of a scene's nodes.
+ */
+static mat4 create_matrix(std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    vec3 translation(10.0f * distribution(generator), 10.0f * distribution(generator), 10.0f * distribution(generator));
+    vec3 rotation(180.0f * distribution(generator), 180.0f * distribution(generator), 180.0f * distribution(generator));
+    vec3 scale(1.5f + distribution(generator), 1.5f + distribution(generator), 1.5f + distribution(generator));
+    return TRS_matrix(translation, rotation, scale);
+}
+
+/**
+ * @brief Creates a random unit quaternion.
+ */
+static quaternion create_quaternion(std::mt19937& generator) {
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    quaternion q(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+    q.normalize();
+    return q;
+}
+
+/**
+ * @brief Creates a wavy grid with as many triangles as Sponza, spanning [-GRID_WIDTH/2, GRID_WIDTH/2]
+ * along x and [-GRID_DEPTH/2, GRID_DEPTH/2] along z.
+ * @param is_skinned Whether every vertex is also influenced by the joints 0 to 3, with weights that
+ * sum to 1.
+ */
+static Mesh create_grid(bool is_skinned = false) {
+    Mesh mesh(MeshPrimitive::TRIANGLES);
+    mesh.enable_attribute(ATTRIBUTE_POSITION);
+    if(is_skinned) {
+        mesh.enable_attribute(ATTRIBUTE_JOINTS);
+        mesh.enable_attribute(ATTRIBUTE_WEIGHTS);
+    }
+
+    for(unsigned int z = 0 ; z <= GRID_DEPTH ; ++z) {
+        for(unsigned int x = 0 ; x <= GRID_WIDTH ; ++x) {
+            float height = 0.5f * std::sin(0.1f * static_cast<float>(x)) * std::cos(0.1f * static_cast<float>(z));
+            vec3 position(static_cast<float>(x) - 0.5f * GRID_WIDTH, height, static_cast<float>(z) - 0.5f * GRID_DEPTH);
+            if(is_skinned) {
+                mesh.add_vertex(position, vec4(0.0f, 1.0f, 2.0f, 3.0f), vec4(0.4f, 0.3f, 0.2f, 0.1f));
+            } else {
+                mesh.add_vertex(position);
+            }
+        }
+    }
+
+    for(unsigned int z = 0 ; z < GRID_DEPTH ; ++z) {
+        for(unsigned int x = 0 ; x < GRID_WIDTH ; ++x) {
+            unsigned int top_left = z * (GRID_WIDTH + 1) + x;
+            unsigned int bottom_left = top_left + GRID_WIDTH + 1;
+            mesh.add_face(top_left, bottom_left, bottom_left + 1, top_left + 1);
+        }
+    }
+
+    return mesh;
+}
+
+int main() {
+    std::mt19937 generator(SEED);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    /* ---- Data ---- */
+    std::vector<mat4> matrices(MATRICES_COUNT);
+    std::vector<mat4> results(MATRICES_COUNT);
+    std::vector<mat3> normal_matrices(MATRICES_COUNT);
+    std::vector<matrix<float, 4>> templated_matrices(MATRICES_COUNT);
+    std::vector<matrix<float, 4>> templated_results(MATRICES_COUNT);
+    std::vector<affine3x4> affine_matrices(MATRICES_COUNT);
+    std::vector<affine3x4> affine_results(MATRICES_COUNT);
+    std::vector<quaternion> quaternions(MATRICES_COUNT);
+    std::vector<quaternion> quaternion_results(MATRICES_COUNT);
+    std::vector<quaternion> next_quaternions(MATRICES_COUNT);
+    std::vector<float> factors(MATRICES_COUNT);
+    std::vector<vec3> translations(MATRICES_COUNT);
+    std::vector<vec3> scales(MATRICES_COUNT);
+    for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+        matrices[i] = create_matrix(generator);
+        templated_matrices[i] = matrix<float, 4>(matrices[i]);
+        affine_matrices[i] = affine3x4(matrices[i]);
+        quaternions[i] = create_quaternion(generator);
+    }
+    for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+        next_quaternions[i] = quaternions[(i + 1) % MATRICES_COUNT];
+        factors[i] = 0.5f + 0.5f * distribution(generator);
+        translations[i] = vec3(matrices[i](0, 3), matrices[i](1, 3), matrices[i](2, 3));
+        scales[i] = vec3(1.5f + distribution(generator), 1.5f + distribution(generator), 1.5f + distribution(generator));
+    }
+
+    std::vector<AABB> aabbs(AABBS_COUNT);
+    std::vector<AABB> transformed_aabbs(AABBS_COUNT);
+    for(AABB& aabb : aabbs) {
+        vec3 center(100.0f * distribution(generator), 20.0f * distribution(generator), 50.0f * distribution(generator));
+        vec3 extent(1.0f + std::abs(distribution(generator)), 1.0f + std::abs(distribution(generator)), 1.0f + std::abs(distribution(generator)));
+        aabb.set(center - extent, center + extent);
+    }
+
+    /* AABB::is_in_frustum only uses the view projection matrix. */
+    Frustum frustum;
+    frustum.view_projection = perspective(1.0471976f, 16.0f / 9.0f, 0.1f, 100.0f)
+                              * look_at(vec3(0.0f, 5.0f, 0.0f), vec3(1.0f, 4.0f, 0.5f), vec3(0.0f, 1.0f, 0.0f));
+
+    /* A binary tree of transforms, tens of kilometers away from the origin like georeferenced scenes. */
+    std::vector<Transform> transforms(MATRICES_COUNT);
+    transforms[0].set_local_position(dvec3(WORLD_OFFSET, 120.0, -WORLD_OFFSET));
+    for(size_t i = 1 ; i < MATRICES_COUNT ; ++i) {
+        transforms[i].set_local_position(translations[i]);
+        transforms[i].set_local_orientation(quaternions[i]);
+    }
+    dvec3 camera_position = dvec3(WORLD_OFFSET, 125.0, -WORLD_OFFSET);
+    mat4 relative_view_projection = perspective(1.0471976f, 16.0f / 9.0f, 0.1f, 100.0f)
+                                    * look_at(vec3(0.0f), vec3(1.0f, -1.0f, 0.5f), vec3(0.0f, 1.0f, 0.0f));
+
+    Mesh grid = create_grid();
+    grid.update_AABB();
+
+    std::vector<Ray> rays;
+    for(unsigned int i = 0 ; i < RAYS_COUNT ; ++i) {
+        vec3 origin(0.4f * GRID_WIDTH * distribution(generator), 10.0f, 0.4f * GRID_DEPTH * distribution(generator));
+        rays.emplace_back(origin, vec3(0.2f * distribution(generator), -1.0f, 0.2f * distribution(generator)));
+    }
+
+    std::vector<vec4> triangles;
+    triangles.reserve(3 * TRIANGLES_COUNT);
+    grid.for_each_triangle([&](unsigned int index0, unsigned int index1, unsigned int index2) {
+        for(unsigned int index : { index0, index1, index2 }) {
+            triangles.emplace_back(vec3(grid.get_attribute_value(ATTRIBUTE_POSITION, index)), 1.0f);
+        }
+    });
+
+    /* ---- Checks ---- */
+    affine_TRS_matrices(translations, quaternions, scales, affine_results);
+    for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+        // The TRS matrices must scale before rotating, like the product of their factors, in the
+        // scalar and the batch versions.
+        mat4 expected = translate(translations[i]) * quaternions[i].get_matrix() * scale(scales[i]);
+        affine3x4 affine = affine_TRS_matrix(translations[i], quaternions[i], scales[i]);
+        for(uint8_t row = 0 ; row < 3 ; ++row) {
+            for(uint8_t column = 0 ; column < 4 ; ++column) {
+                if(std::abs(affine(row, column) - expected(row, column)) > 1e-4f * std::max(1.0f, std::abs(expected(row, column)))) {
+                    throw std::runtime_error("affine_TRS_matrix differs from T * R * S at (" + std::to_string(row) + ", "
+                                             + std::to_string(column) + ").");
+                }
+                if(std::abs(affine_results[i](row, column) - affine(row, column)) > 1e-5f * std::max(1.0f, std::abs(affine(row, column)))) {
+                    throw std::runtime_error("affine_TRS_matrices differs from affine_TRS_matrix at (" + std::to_string(row)
+                                             + ", " + std::to_string(column) + ").");
+                }
+            }
+        }
+    }
+
+    {
+        // Picking a skinned mesh whose joints don't move must hit the same triangles as picking it
+        // statically, translation of the model matrix included.
+        Mesh skinned_grid = create_grid(true);
+        std::vector<affine3x4> identity_matrices(4, affine3x4(1.0f));
+        JointPalette palette;
+        palette.set(identity_matrices);
+
+        std::vector<vec4> positions(skinned_grid.get_vertices_amount());
+        for(size_t i = 0 ; i < positions.size() ; ++i) {
+            positions[i] = vec4(vec3(skinned_grid.get_attribute_value(ATTRIBUTE_POSITION, i)), 1.0f);
+        }
+        palette.skin_positions(skinned_grid, positions);
+
+        affine3x4 model(translate(1.5f, -2.0f, 0.5f));
+        for(const Ray& ray : rays) {
+            float static_distance = grid.intersect(ray, model);
+            float skinned_distance = skinned_grid.intersect(ray, model, positions);
+            if(std::abs(static_distance - skinned_distance) > 1e-3f * std::max(1.0f, std::abs(static_distance))) {
+                throw std::runtime_error("Skinned picking with an identity palette found a distance of "
+                                         + std::to_string(skinned_distance) + " instead of "
+                                         + std::to_string(static_distance) + ".");
+            }
+        }
+    }
+
+    std::cout << "Matrices: " << MATRICES_COUNT << ", AABBs: " << AABBS_COUNT
+              << ", triangles: " << TRIANGLES_COUNT << ", rays: " << RAYS_COUNT << ", seed: " << SEED << '\n';
+
+    /* ---- Maths ---- */
+    run("mat4 * mat4", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { results[i] = matrices[i] * matrices[(i + 1) % MATRICES_COUNT]; }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("mat4 * vec4", MATRICES_COUNT, [&] {
+        vec4 sum(0.0f);
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { sum += matrices[i] * vec4(1.0f, 2.0f, 3.0f, 1.0f); }
+        checksum += sum.x;
+    });
+
+    run("P * V * M * vec4", MATRICES_COUNT, [&] {
+        vec4 sum(0.0f);
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            sum += frustum.view_projection * matrices[i] * matrices[(i + 1) % MATRICES_COUNT] * vec4(1.0f, 2.0f, 3.0f, 1.0f);
+        }
+        checksum += sum.x;
+    });
+
+    run("matrix<float, 4> * matrix", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            templated_results[i] = templated_matrices[i] * templated_matrices[(i + 1) % MATRICES_COUNT];
+        }
+        checksum += templated_results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("lazy P * V * M * vec4", MATRICES_COUNT, [&] {
+        matrix<float, 4> view_projection(frustum.view_projection);
+        vec4 sum(0.0f);
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            sum += lazy(view_projection) * templated_matrices[i] * templated_matrices[(i + 1) % MATRICES_COUNT]
+                   * vec4(1.0f, 2.0f, 3.0f, 1.0f);
+        }
+        checksum += sum.x;
+    });
+
+    run("affine_inverse", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { results[i] = affine_inverse(matrices[i]); }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("inverse", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { results[i] = inverse(matrices[i]); }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("affine3x4 * affine3x4", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            affine_results[i] = affine_matrices[i] * affine_matrices[(i + 1) % MATRICES_COUNT];
+        }
+        checksum += affine_results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("mat4 * affine3x4", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { results[i] = frustum.view_projection * affine_matrices[i]; }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("affine_inverse (affine3x4)", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { affine_results[i] = affine_inverse(affine_matrices[i]); }
+        checksum += affine_results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("transpose_inverse", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { normal_matrices[i] = transpose_inverse(matrices[i]); }
+        checksum += normal_matrices[MATRICES_COUNT / 2](0, 0);
+    });
+
+    run("quaternion * quaternion", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            quaternion_results[i] = quaternions[i] * quaternions[(i + 1) % MATRICES_COUNT];
+        }
+        checksum += quaternion_results[MATRICES_COUNT / 2].w;
+    });
+
+    run("quaternion::normalize", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            quaternion_results[i] = 1.5f * quaternions[i];
+            quaternion_results[i].normalize();
+        }
+        checksum += quaternion_results[MATRICES_COUNT / 2].w;
+    });
+
+    run("quaternion::get_matrix", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { results[i] = quaternions[i].get_matrix(); }
+        checksum += results[MATRICES_COUNT / 2](0, 1);
+    });
+
+    run("slerp", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            quaternion_results[i] = slerp(quaternions[i], quaternions[(i + 1) % MATRICES_COUNT], 0.3f);
+        }
+        checksum += quaternion_results[MATRICES_COUNT / 2].w;
+    });
+
+    run("slerp (batch)", MATRICES_COUNT, [&] {
+        slerp(quaternions, next_quaternions, factors, quaternion_results);
+        checksum += quaternion_results[MATRICES_COUNT / 2].w;
+    });
+
+    run("nlerp (batch)", MATRICES_COUNT, [&] {
+        nlerp(quaternions, next_quaternions, factors, quaternion_results);
+        checksum += quaternion_results[MATRICES_COUNT / 2].w;
+    });
+
+    run("rotate", MATRICES_COUNT, [&] {
+        vec3 sum(0.0f);
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) { sum += rotate(quaternions[i], vec3(1.0f, 2.0f, 3.0f)); }
+        checksum += sum.x;
+    });
+
+    run("affine_TRS_matrix", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            affine_results[i] = affine_TRS_matrix(translations[i], quaternions[i], scales[i]);
+        }
+        checksum += affine_results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("affine_TRS_matrices (batch)", MATRICES_COUNT, [&] {
+        affine_TRS_matrices(translations, quaternions, scales, affine_results);
+        checksum += affine_results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    /* ---- Transforms ---- */
+    run("Transform::update_global_model", MATRICES_COUNT, [&] {
+        transforms[0].update_global_model();
+        for(size_t i = 1 ; i < MATRICES_COUNT ; ++i) { transforms[i].update_global_model(transforms[(i - 1) / 2]); }
+        checksum += transforms[MATRICES_COUNT / 2].get_global_position().x;
+    });
+
+    run("view projection * model", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            results[i] = frustum.view_projection * transforms[i].get_global_model_const_reference();
+        }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    run("camera relative mvp", MATRICES_COUNT, [&] {
+        for(size_t i = 0 ; i < MATRICES_COUNT ; ++i) {
+            results[i] = relative_view_projection * transforms[i].compute_relative_global_model(camera_position);
+        }
+        checksum += results[MATRICES_COUNT / 2](0, 3);
+    });
+
+    /* ---- Culling ---- */
+    run("AABB::set (mat4)", AABBS_COUNT, [&] {
+        for(size_t i = 0 ; i < AABBS_COUNT ; ++i) { transformed_aabbs[i].set(aabbs[i], matrices[i % MATRICES_COUNT]); }
+        checksum += transformed_aabbs[AABBS_COUNT / 2].max_point.x;
+    });
+
+    run("AABB::set (affine3x4)", AABBS_COUNT, [&] {
+        for(size_t i = 0 ; i < AABBS_COUNT ; ++i) { transformed_aabbs[i].set(aabbs[i], affine_matrices[i % MATRICES_COUNT]); }
+        checksum += transformed_aabbs[AABBS_COUNT / 2].max_point.x;
+    });
+
+    run("AABB::transform", AABBS_COUNT, [&] {
+        AABB::transform(aabbs, affine_matrices, transformed_aabbs);
+        checksum += transformed_aabbs[AABBS_COUNT / 2].max_point.x;
+    });
+
+    run("AABB::is_in_frustum", AABBS_COUNT, [&] {
+        unsigned int visible_count = 0;
+        for(const AABB& aabb : aabbs) { visible_count += aabb.is_in_frustum(frustum); }
+        checksum += static_cast<float>(visible_count);
+    });
+
+    run("Ray::intersect_triangle", TRIANGLES_COUNT, [&] {
+        float closest = 0.0f;
+        for(size_t i = 0 ; i < triangles.size() ; i += 3) {
+            closest = std::max(closest, rays[0].intersect_triangle(triangles[i], triangles[i + 1], triangles[i + 2]));
+        }
+        checksum += closest;
+    });
+
+    run("Mesh::intersect", RAYS_COUNT * TRIANGLES_COUNT, [&] {
+        for(const Ray& ray : rays) { checksum += grid.intersect(ray, affine3x4(1.0f)); }
+    });
+
+    std::cout << "Checksum: " << checksum << '\n';
+
+    return 0;
+}
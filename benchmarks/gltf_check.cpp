@@ -0,0 +1,55 @@
+/***************************************************************************************************
+ * @file  gltf_check.cpp
+ * @brief Headless check of the glTF decoding stage, which only needs engine_core
+ **************************************************************************************************/
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+#include "assets/GLTFModel.hpp"
+
+static const std::filesystem::path DEFAULT_SCENE = "data/models/duck.glb"; ///< The scene decoded if none is passed.
+
+/**
+ * @brief Decodes glTF scenes like the engine does before creating their GL resources, and prints
+ * what they contain. Needs to be run from the repository's root if no scene is passed.
+ * @return 0 if every scene was decoded, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    std::vector<std::filesystem::path> paths(argv + 1, argv + argc);
+    if(paths.empty()) { paths.push_back(DEFAULT_SCENE); }
+
+    bool is_passing = true;
+    for(const std::filesystem::path& path : paths) {
+        try {
+            GLTF::Model model;
+            model.load(path, true);
+            model.create_meshes();
+            model.create_skins_and_animations();
+
+            size_t primitives_count = 0, vertices_count = 0, indices_count = 0, targets_count = 0;
+            for(unsigned int i = 0 ; i < model.meshes.get_size() ; ++i) {
+                for(unsigned int j = 0 ; j < model.meshes[i].primitives.get_size() ; ++j) {
+                    const GLTF::Primitive& primitive = model.meshes[i].primitives[j];
+                    ++primitives_count;
+                    vertices_count += primitive.primitive.get_vertices_amount();
+                    indices_count += primitive.primitive.get_indices_amount();
+                    targets_count += primitive.morph_targets.get_targets_count();
+                }
+            }
+
+            std::cout << path.string() << ": passed, " << model.meshes.get_size() << " meshes, "
+                      << primitives_count << " primitives, " << vertices_count << " vertices, "
+                      << indices_count << " indices, " << targets_count << " morph targets, "
+                      << model.materials.size() << " materials, " << model.inverse_bind_matrices.size()
+                      << " skins, " << model.animations.size() << " animations\n";
+        } catch(const std::exception& exception) {
+            std::cout << path.string() << ": FAILED, " << exception.what() << '\n';
+            is_passing = false;
+        }
+    }
+
+    return is_passing ? 0 : 1;
+}
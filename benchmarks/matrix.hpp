@@ -0,0 +1,270 @@
+/***************************************************************************************************
+ * @file  matrix.hpp
+ * @brief Declaration and implementation of the matrix struct and of its lazy products, for engine_bench
+ **************************************************************************************************/
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+#include "maths/mat4.hpp"
+#include "maths/simd.hpp"
+#include "maths/vector4.hpp"
+
+/**
+ * @struct matrix
+ * @brief Represents a square matrix whose type and size are known at compile time. Everything is
+ * defined in this header and is constexpr, so that chains of operations can be evaluated at compile
+ * time or fully inlined in the hot loops. Like mat4, its columns are stored one after the other.
+ * Only what engine_bench measures against mat4 is implemented: the engine itself uses mat4 and
+ * affine3x4, as its matrices are sent to the GPU rather than applied to vertices on the CPU.
+ * @tparam Type The type of the matrix's components.
+ * @tparam N The number of rows and columns.
+ */
+template <typename Type, uint8_t N>
+struct matrix {
+    static_assert(N >= 2, "A matrix needs at least 2 rows and columns.");
+
+    /**
+     * @brief Constructs a matrix with all components equal to 0.
+     */
+    [[gnu::always_inline]] constexpr matrix() : columns() { }
+
+    /**
+     * @brief Constructs a 4 by 4 matrix from a mat4.
+     * @param mat The mat4 to convert.
+     */
+    [[gnu::always_inline]] explicit matrix(const mat4& mat) requires (N == 4) : columns() {
+        for(uint8_t column = 0 ; column < 4 ; ++column) {
+            for(uint8_t row = 0 ; row < 4 ; ++row) {
+                columns[column][row] = static_cast<Type>(mat(row, column));
+            }
+        }
+    }
+
+    /**
+     * @brief Accesses an element of the matrix.
+     * @param row The row's index.
+     * @param column The column's index.
+     * @return A reference to the element.
+     */
+    [[gnu::always_inline]] constexpr Type& operator()(uint8_t row, uint8_t column) {
+        return columns[column][row];
+    }
+
+    /**
+     * @brief Accesses an element of the matrix.
+     * @param row The row's index.
+     * @param column The column's index.
+     * @return A const reference to the element.
+     */
+    [[gnu::always_inline]] constexpr const Type& operator()(uint8_t row, uint8_t column) const {
+        return columns[column][row];
+    }
+
+private:
+    Type columns[N][N]; ///< The columns of the matrix.
+};
+
+/* ---- Operators ---- */
+
+/** @brief Multiplies a matrix by another.
+ *  @param left The left operand.
+ *  @param right The right operand.
+ *  @return The product of the two matrices.
+ */
+template <typename Type, uint8_t N>
+[[gnu::always_inline]] constexpr matrix<Type, N> operator *(const matrix<Type, N>& left, const matrix<Type, N>& right) {
+    matrix<Type, N> result;
+
+#ifdef __SSE__
+    if constexpr(std::is_same_v<Type, float> && N == 4) {
+        if !consteval {
+            __m128 left_column0 = _mm_loadu_ps(&left(0, 0));
+            __m128 left_column1 = _mm_loadu_ps(&left(0, 1));
+            __m128 left_column2 = _mm_loadu_ps(&left(0, 2));
+            __m128 left_column3 = _mm_loadu_ps(&left(0, 3));
+
+            for(uint8_t column = 0 ; column < 4 ; ++column) {
+                __m128 right_column = _mm_loadu_ps(&right(0, column));
+                __m128 result_column = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(left_column0, broadcast<0>(right_column)), _mm_mul_ps(left_column1, broadcast<1>(right_column))),
+                    _mm_add_ps(_mm_mul_ps(left_column2, broadcast<2>(right_column)), _mm_mul_ps(left_column3, broadcast<3>(right_column)))
+                );
+                _mm_storeu_ps(&result(0, column), result_column);
+            }
+
+            return result;
+        }
+    }
+#endif
+
+    /* Each column of the result is a combination of the columns of left. It's accumulated in a local
+     * array because result may be the caller's storage and alias one of the operands. */
+    for(uint8_t column = 0 ; column < N ; ++column) {
+        Type result_column[N] {};
+
+        for(uint8_t k = 0 ; k < N ; ++k) {
+            for(uint8_t row = 0 ; row < N ; ++row) {
+                result_column[row] += left(row, k) * right(k, column);
+            }
+        }
+
+        for(uint8_t row = 0 ; row < N ; ++row) { result(row, column) = result_column[row]; }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Multiplies a 4 by 4 matrix by a 4-component vector interpreted as a 4x1 column matrix.
+ * @param mat The matrix.
+ * @param vec The vector.
+ * @return The vector formed with the values in the 4 rows of mat * vec.
+ */
+template <typename Type>
+[[gnu::always_inline]] constexpr vector4<Type> operator *(const matrix<Type, 4>& mat, const vector4<Type>& vec) {
+#ifdef __SSE__
+    if constexpr(std::is_same_v<Type, float>) {
+        if !consteval {
+            __m128 result = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mat(0, 0)), _mm_set1_ps(vec.x)), _mm_mul_ps(_mm_loadu_ps(&mat(0, 1)), _mm_set1_ps(vec.y))),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mat(0, 2)), _mm_set1_ps(vec.z)), _mm_mul_ps(_mm_loadu_ps(&mat(0, 3)), _mm_set1_ps(vec.w)))
+            );
+
+            vector4<Type> vector;
+            _mm_storeu_ps(&vector.x, result);
+            return vector;
+        }
+    }
+#endif
+
+    return vector4<Type>(
+        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z + mat(0, 3) * vec.w,
+        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z + mat(1, 3) * vec.w,
+        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z + mat(2, 3) * vec.w,
+        mat(3, 0) * vec.x + mat(3, 1) * vec.y + mat(3, 2) * vec.z + mat(3, 3) * vec.w
+    );
+}
+
+/* ---- Lazy Products ---- */
+
+/**
+ * @brief A chain of matrix products that is only evaluated when it's multiplied by a vector or
+ * converted to a matrix.
+ */
+template <typename Expression>
+concept matrix_expression = requires(const Expression& expression) {
+    typename Expression::value_type;
+    expression.evaluate();
+};
+
+/**
+ * @struct matrix_reference
+ * @brief The leaves of a lazy product. They refer to their matrix, which must therefore outlive the
+ * expression: lazy products are meant to be evaluated in the expression that builds them.
+ */
+template <typename Type, uint8_t N>
+struct matrix_reference {
+    using value_type = Type;
+    static constexpr uint8_t size = N;
+
+    /**
+     * @return The referred matrix.
+     */
+    [[gnu::always_inline]] constexpr const matrix<Type, N>& evaluate() const { return mat; }
+
+    /**
+     * @brief Multiplies the referred matrix by a vector.
+     * @param vec The vector.
+     * @return mat * vec.
+     */
+    template <typename Vector>
+    [[gnu::always_inline]] constexpr Vector apply(const Vector& vec) const { return mat * vec; }
+
+    const matrix<Type, N>& mat; ///< The referred matrix.
+};
+
+/**
+ * @struct matrix_product
+ * @brief The product of two lazy expressions. Multiplying it by a vector multiplies the vector by
+ * each matrix of the chain from right to left, so P * V * M * v costs 3 matrix-vector products
+ * instead of 2 matrix-matrix products and a matrix-vector one.
+ * @tparam Left The left expression.
+ * @tparam Right The right expression.
+ */
+template <matrix_expression Left, matrix_expression Right>
+struct matrix_product {
+    static_assert(Left::size == Right::size, "Only matrices of the same size can be multiplied.");
+
+    using value_type = typename Left::value_type;
+    static constexpr uint8_t size = Left::size;
+
+    /**
+     * @return The matrix resulting from the product.
+     */
+    [[gnu::always_inline]] constexpr matrix<value_type, size> evaluate() const {
+        return left.evaluate() * right.evaluate();
+    }
+
+    /**
+     * @brief Multiplies the product by a vector, from right to left.
+     * @param vec The vector.
+     * @return left * (right * vec).
+     */
+    template <typename Vector>
+    [[gnu::always_inline]] constexpr Vector apply(const Vector& vec) const {
+        return left.apply(right.apply(vec));
+    }
+
+    /**
+     * @brief Evaluates the product.
+     */
+    [[gnu::always_inline]] constexpr operator matrix<value_type, size>() const { return evaluate(); }
+
+    Left left;   ///< The left expression.
+    Right right; ///< The right expression.
+};
+
+/**
+ * @brief Starts a lazy product, for example: lazy(projection) * view * model * vec.
+ * @param mat The first matrix of the product.
+ * @return A lazy expression referring to the matrix.
+ */
+template <typename Type, uint8_t N>
+[[gnu::always_inline]] constexpr matrix_reference<Type, N> lazy(const matrix<Type, N>& mat) {
+    return { mat };
+}
+
+/** @brief Appends a matrix to a lazy product without evaluating it.
+ *  @param left The lazy product.
+ *  @param right The matrix.
+ *  @return The lazy product of the two operands.
+ */
+template <matrix_expression Left, typename Type, uint8_t N>
+[[gnu::always_inline]] constexpr matrix_product<Left, matrix_reference<Type, N>> operator *(const Left& left, const matrix<Type, N>& right) {
+    return { left, { right } };
+}
+
+/** @brief Multiplies two lazy products without evaluating them.
+ *  @param left The left lazy product.
+ *  @param right The right lazy product.
+ *  @return The lazy product of the two operands.
+ */
+template <matrix_expression Left, matrix_expression Right>
+[[gnu::always_inline]] constexpr matrix_product<Left, Right> operator *(const Left& left, const Right& right) {
+    return { left, right };
+}
+
+/**
+ * @brief Multiplies a lazy product of 4 by 4 matrices by a vector, one matrix at a time.
+ * @param expression The lazy product.
+ * @param vec The vector.
+ * @return The vector resulting from expression * vec.
+ */
+template <matrix_expression Expression>
+[[gnu::always_inline]] constexpr vector4<typename Expression::value_type> operator *(
+    const Expression& expression, const vector4<typename Expression::value_type>& vec) requires (Expression::size == 4) {
+    return expression.apply(vec);
+}
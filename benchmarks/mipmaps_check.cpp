@@ -0,0 +1,178 @@
+/***************************************************************************************************
+ * @file  mipmaps_check.cpp
+ * @brief Headless check of the CPU mip generator against reference images
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "assets/Image.hpp"
+#include "assets/Mipmaps.hpp"
+
+static const std::filesystem::path SOURCE_PATH = "data/textures/dirt.png"; ///< The image the mips are generated from.
+static const std::filesystem::path REFERENCES_DIRECTORY = "data/mipmaps";  ///< Where the reference images are.
+static constexpr unsigned int TOLERANCE = 1;      ///< The maximum difference of a channel with its reference.
+static constexpr unsigned int THREADS_COUNT = 4;  ///< The threads used to check that they don't change the result.
+
+/**
+ * @struct Case
+ * @brief A filter and a color space whose mip chain is compared with a reference image.
+ */
+struct Case {
+    const char* name;    ///< The name of the case, which is also the name of its reference image.
+    MipmapFilter filter; ///< The downsampling filter.
+    bool srgb;           ///< Whether the RGB channels are filtered in linear space.
+};
+
+static constexpr Case CASES[] {
+    { "box_srgb", MipmapFilter::BOX, true },
+    { "kaiser_srgb", MipmapFilter::KAISER, true },
+    { "lanczos_srgb", MipmapFilter::LANCZOS, true },
+    { "kaiser_linear", MipmapFilter::KAISER, false },
+};
+
+/**
+ * @brief Places every level of a mip chain but the first one side by side, top aligned, in a RGBA
+ * image. The first level is a copy of the source image so it isn't compared.
+ * @param levels The mip chain.
+ * @param width Where the width of the atlas is written.
+ * @param height Where the height of the atlas is written.
+ * @return The atlas' pixels, 4 unsigned bytes per pixel.
+ */
+static std::vector<unsigned char> create_atlas(const std::vector<MipLevel>& levels,
+                                               unsigned int& width,
+                                               unsigned int& height) {
+    width = 0;
+    height = levels.size() > 1 ? levels[1].height : 0;
+    for(size_t i = 1 ; i < levels.size() ; ++i) { width += levels[i].width; }
+
+    std::vector<unsigned char> atlas(4 * static_cast<size_t>(width) * height, 0);
+    unsigned int x = 0;
+    for(size_t i = 1 ; i < levels.size() ; ++i) {
+        for(unsigned int y = 0 ; y < levels[i].height ; ++y) {
+            std::memcpy(atlas.data() + 4 * (static_cast<size_t>(y) * width + x),
+                        levels[i].pixels.data() + 4 * static_cast<size_t>(y) * levels[i].width,
+                        4 * static_cast<size_t>(levels[i].width));
+        }
+        x += levels[i].width;
+    }
+
+    return atlas;
+}
+
+/**
+ * @brief Writes a RGBA image to an uncompressed TGA file with its origin at the top left, which
+ * stb_image can read back.
+ */
+static void write_tga(const std::filesystem::path& path,
+                      const std::vector<unsigned char>& pixels,
+                      unsigned int width,
+                      unsigned int height) {
+    unsigned char header[18] {};
+    header[2] = 2; // Uncompressed true color.
+    header[12] = static_cast<unsigned char>(width & 0xFF);
+    header[13] = static_cast<unsigned char>(width >> 8);
+    header[14] = static_cast<unsigned char>(height & 0xFF);
+    header[15] = static_cast<unsigned char>(height >> 8);
+    header[16] = 32;   // Bits per pixel.
+    header[17] = 0x28; // 8 alpha bits, top left origin.
+
+    std::vector<unsigned char> bgra(pixels.size());
+    for(size_t i = 0 ; i < pixels.size() ; i += 4) {
+        bgra[i] = pixels[i + 2];
+        bgra[i + 1] = pixels[i + 1];
+        bgra[i + 2] = pixels[i];
+        bgra[i + 3] = pixels[i + 3];
+    }
+
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path, std::ios::binary);
+    if(!file.is_open()) { throw std::runtime_error("Couldn't write reference image '" + path.string() + "'."); }
+
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(bgra.data()), static_cast<std::streamsize>(bgra.size()));
+}
+
+/**
+ * @brief Generates the mip chain of the source image with every filter and compares them with the
+ * reference images, or replaces the reference images if --update is passed. Needs to be run from the
+ * repository's root.
+ * @return 0 if every mip chain matches its reference, 1 otherwise.
+ */
+int main(int argc, char* argv[]) {
+    const bool is_updating = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+
+    /* Every channel amount is expanded to RGBA, like in CompressedImage. */
+    Image image(SOURCE_PATH, false);
+    const unsigned int channels_amount = image.get_channels_amount();
+    std::vector<unsigned char> pixels(4 * static_cast<size_t>(image.get_width()) * image.get_height());
+    for(size_t i = 0 ; i < static_cast<size_t>(image.get_width()) * image.get_height() ; ++i) {
+        const unsigned char* pixel = image.get_data() + i * channels_amount;
+        pixels[4 * i] = pixel[0];
+        pixels[4 * i + 1] = channels_amount >= 2 ? pixel[1] : 0;
+        pixels[4 * i + 2] = channels_amount >= 3 ? pixel[2] : 0;
+        pixels[4 * i + 3] = channels_amount == 4 ? pixel[3] : 255;
+    }
+
+    bool is_passing = true;
+    for(const Case& check : CASES) {
+        std::vector<MipLevel> levels = generate_mipmaps(pixels.data(),
+                                                        image.get_width(),
+                                                        image.get_height(),
+                                                        check.filter,
+                                                        check.srgb,
+                                                        1);
+        std::vector<MipLevel> threaded_levels = generate_mipmaps(pixels.data(),
+                                                                 image.get_width(),
+                                                                 image.get_height(),
+                                                                 check.filter,
+                                                                 check.srgb,
+                                                                 THREADS_COUNT);
+
+        unsigned int width, height;
+        std::vector<unsigned char> atlas = create_atlas(levels, width, height);
+        std::filesystem::path reference_path = REFERENCES_DIRECTORY / (std::string(check.name) + ".tga");
+
+        if(is_updating) {
+            write_tga(reference_path, atlas, width, height);
+            std::cout << check.name << ": written to '" << reference_path.string() << "'\n";
+            continue;
+        }
+
+        unsigned int threaded_width, threaded_height;
+        if(create_atlas(threaded_levels, threaded_width, threaded_height) != atlas) {
+            std::cout << check.name << ": FAILED, the result depends on the amount of threads\n";
+            is_passing = false;
+            continue;
+        }
+
+        Image reference(reference_path, false);
+        if(reference.get_width() != width
+           || reference.get_height() != height
+           || reference.get_channels_amount() != 4) {
+            std::cout << check.name << ": FAILED, the reference is " << reference.get_width() << 'x'
+                      << reference.get_height() << " with " << reference.get_channels_amount()
+                      << " channels instead of " << width << 'x' << height << " RGBA\n";
+            is_passing = false;
+            continue;
+        }
+
+        unsigned int max_difference = 0;
+        for(size_t i = 0 ; i < atlas.size() ; ++i) {
+            unsigned int difference = std::abs(static_cast<int>(atlas[i]) - static_cast<int>(reference.get_data()[i]));
+            max_difference = std::max(max_difference, difference);
+        }
+
+        const bool is_matching = max_difference <= TOLERANCE;
+        std::cout << check.name << ": " << (is_matching ? "passed" : "FAILED") << ", max difference " << max_difference << '\n';
+        is_passing = is_passing && is_matching;
+    }
+
+    return is_passing ? 0 : 1;
+}
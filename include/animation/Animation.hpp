@@ -0,0 +1,31 @@
+/***************************************************************************************************
+ * @file  Animation.hpp
+ * @brief Declaration of the Animation struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "animation/AnimationTrack.hpp"
+
+/**
+ * @struct Animation
+ * @brief A clip animating the local transforms of nodes of the scene graph, and its playback state.
+ * Its tracks are sampled by an AnimationSampler.
+ */
+struct Animation {
+    /**
+     * @brief Advances the playback and loops back to the start once the end is reached.
+     * @param delta The time since the last update in seconds.
+     */
+    void advance(float delta);
+
+    std::string name;                   ///< The name of the clip.
+    std::vector<AnimationTrack> tracks; ///< The compressed channels of the clip.
+    float duration = 0.0f;              ///< The time of the last keyframe in seconds.
+    float time = 0.0f;                  ///< The current playback time in seconds.
+    float speed = 1.0f;                 ///< How fast the clip is played.
+    bool is_playing = true;             ///< Whether the clip is advanced and sampled every frame.
+};
@@ -0,0 +1,65 @@
+/***************************************************************************************************
+ * @file  AnimationChannel.hpp
+ * @brief Declaration of the AnimationChannel struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "maths/vec4.hpp"
+
+/**
+ * @enum AnimationPath
+ * @brief The property an animation channel drives.
+ */
+enum class AnimationPath : unsigned char {
+    TRANSLATION,
+    ROTATION,
+    SCALE,
+    WEIGHTS, ///< The weights of the morph targets of the node's meshes.
+};
+
+/**
+ * @enum AnimationInterpolation
+ * @brief How the values of a channel are interpolated between its keyframes.
+ */
+enum class AnimationInterpolation : unsigned char {
+    STEP,
+    LINEAR,
+    CUBIC_SPLINE, ///< Each keyframe has an in-tangent, a value and an out-tangent.
+};
+
+/**
+ * @struct AnimationChannel
+ * @brief The keyframes of a single property of a single node, as they are imported. Channels are
+ * compressed into AnimationTracks to be played.
+ */
+struct AnimationChannel {
+    /**
+     * @brief Samples the channel.
+     * @param time The time in seconds, clamped to the keyframes' range.
+     * @param value Where the get_components_count components of the value at this time are written.
+     */
+    void sample(float time, float* value) const;
+
+    /**
+     * @brief Samples a channel whose values have at most 4 components.
+     * @param time The time in seconds, clamped to the keyframes' range.
+     * @return The value at this time: xyz for translations and scales, xyzw for rotations.
+     */
+    vec4 sample(float time) const;
+
+    /**
+     * @return The amount of components of a value: 4 for rotations, 3 for translations and scales and
+     * the amount of morph targets for weights.
+     */
+    unsigned int get_components_count() const;
+
+    unsigned int node;                    ///< The index of the driven node in the scene graph.
+    AnimationPath path;                   ///< The driven property.
+    AnimationInterpolation interpolation; ///< The interpolation between keyframes.
+    unsigned int weights_count = 0;       ///< The amount of morph targets driven by a weights channel.
+    std::vector<float> times;             ///< The time of each keyframe in seconds, increasing.
+    std::vector<float> values;            ///< The values of the keyframes, tightly packed.
+};
@@ -0,0 +1,59 @@
+/***************************************************************************************************
+ * @file  AnimationSampler.hpp
+ * @brief Declaration of the AnimationSampler class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "animation/Animation.hpp"
+#include "maths/Transform.hpp"
+
+/**
+ * @class AnimationSampler
+ * @brief Samples the tracks of all the playing animations of a frame in one batch. The tracks are
+ * first sampled into a contiguous buffer, only reading the keys, then the samples are written to the
+ * local transforms of their nodes in a second pass, so the two kinds of memory accesses don't evict
+ * each other from the cache. The rotations are interpolated together, 4 at a time.
+ */
+class AnimationSampler {
+public:
+    /**
+     * @brief Samples the playing animations at their current time and writes the values to the local
+     * transforms of their nodes, which become dirty, and to the morph weights.
+     * @param animations The animations.
+     * @param transforms The scene graph's transforms.
+     * @param morph_weights The scene graph's morph weights.
+     * @return The amount of tracks sampled.
+     */
+    size_t sample(std::span<Animation> animations, std::vector<Transform>& transforms, std::span<float> morph_weights);
+
+    /**
+     * @brief Samples the playing animations at their current time without writing the values.
+     * @param animations The animations.
+     * @return The amount of tracks sampled.
+     */
+    size_t sample(std::span<Animation> animations);
+
+private:
+    /**
+     * @struct Sample
+     * @brief The value of a track and the property it drives.
+     */
+    struct Sample {
+        vec4 value;         ///< The sampled value, or the amount of weights in x for weights.
+        unsigned int node;  ///< The track's node.
+        AnimationPath path; ///< The driven property.
+    };
+
+    std::vector<Sample> samples; ///< The samples of the current frame.
+    std::vector<float> weights;  ///< The sampled weights of the current frame, in the samples' order.
+
+    /// The key before the time of each rotation track, replaced by the interpolated rotation.
+    std::vector<quaternion> rotation_starts;
+    std::vector<quaternion> rotation_ends; ///< The key after the time of each rotation track.
+    std::vector<float> rotation_factors;   ///< The interpolation factor of each rotation track.
+    std::vector<size_t> rotation_samples;  ///< The index of each rotation track's sample.
+};
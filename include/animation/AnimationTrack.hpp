@@ -0,0 +1,114 @@
+/***************************************************************************************************
+ * @file  AnimationTrack.hpp
+ * @brief Declaration of the QuantizedQuaternion and AnimationTrack structs
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "animation/AnimationChannel.hpp"
+#include "maths/quaternion.hpp"
+#include "maths/vec4.hpp"
+
+/**
+ * @struct QuantizedQuaternion
+ * @brief A unit quaternion stored in 48 bits with the "smallest three" method: the largest component
+ * is dropped and recomputed from the others, which are in [-1/sqrt(2), 1/sqrt(2)] and are stored on
+ * 15 bits each. The index of the dropped component is stored in the top bits of the first two words.
+ */
+struct QuantizedQuaternion {
+    /**
+     * @brief Quantizes a unit quaternion.
+     * @param q The quaternion as xyzw.
+     * @return The quantized quaternion.
+     */
+    static QuantizedQuaternion quantize(const vec4& q);
+
+    /**
+     * @return The quaternion as xyzw. It represents the same rotation as the quantized one, but its
+     * largest component is always positive.
+     */
+    vec4 dequantize() const;
+
+    uint16_t data[3]; ///< The three smallest components and the index of the largest one.
+};
+
+/**
+ * @struct AnimationTrack
+ * @brief A compressed AnimationChannel. Rotations are quantized, cubic splines are resampled into
+ * linear keys, and the keys that can be interpolated from their neighbours within a tolerance are
+ * removed. The track remembers the last key it was sampled at, so playing it forward doesn't need a
+ * search.
+ */
+struct AnimationTrack {
+    /**
+     * @brief Compresses a channel.
+     * @param channel The channel.
+     * @param tolerance The maximum difference allowed between a component of the channel and the
+     * same component of the track, at the channel's keyframes.
+     * @return The track.
+     */
+    static AnimationTrack compress(const AnimationChannel& channel, float tolerance = DEFAULT_TOLERANCE);
+
+    /**
+     * @brief Samples the track.
+     * @param time The time in seconds, clamped to the keys' range.
+     * @param value Where the components_count components of the value at this time are written.
+     */
+    void sample(float time, float* value);
+
+    /**
+     * @brief Samples a track whose values have at most 4 components.
+     * @param time The time in seconds, clamped to the keys' range.
+     * @return The value at this time: xyz for translations and scales, xyzw for rotations.
+     */
+    vec4 sample(float time);
+
+    /**
+     * @brief Finds the keys a rotation track interpolates between at a time, so that the rotations of
+     * several tracks can be interpolated at once. The track needs at least one key.
+     * @param time The time in seconds, clamped to the keys' range.
+     * @param start The key before the time.
+     * @param end The key after the time, equal to start if the key's value is held.
+     * @return The interpolation factor between start and end.
+     */
+    float get_rotation_keys(float time, quaternion& start, quaternion& end);
+
+    /**
+     * @brief Moves the cursor to the key before a time. The track needs at least one key.
+     * @param time The time in seconds.
+     * @param key The index of the key before the time, clamped to the keys' range.
+     * @return The interpolation factor between the key and the next one, or -1 if the key's value is
+     * held: before the first key, after the last one or in a step track.
+     */
+    float seek(float time, size_t& key);
+
+    /**
+     * @param key The index of the key.
+     * @param value Where the components_count components of the key are written.
+     */
+    void get_key(size_t key, float* value) const;
+
+    /**
+     * @return The amount of bytes used by the keys.
+     */
+    size_t get_size() const;
+
+    static constexpr float DEFAULT_TOLERANCE = 1e-4f; ///< The default compression tolerance.
+    static constexpr float RESAMPLING_RATE = 30.0f;   ///< The keys per second of resampled splines.
+
+    /**
+     * The index of the driven node in the scene graph. For weights tracks, the index of the first
+     * driven weight in the scene graph's morph weights.
+     */
+    unsigned int node;
+    AnimationPath path;                         ///< The driven property.
+    bool is_step;                               ///< Whether the keys are held instead of interpolated.
+    unsigned int components_count;              ///< The amount of components of a key.
+    unsigned int cursor = 0;                    ///< The key the track was last sampled after.
+    std::vector<float> times;                   ///< The time of each key in seconds, increasing.
+    std::vector<float> values;                  ///< The keys of the other tracks, tightly packed.
+    std::vector<QuantizedQuaternion> rotations; ///< The keys of rotation tracks.
+};
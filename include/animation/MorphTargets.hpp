@@ -0,0 +1,125 @@
+/***************************************************************************************************
+ * @file  MorphTargets.hpp
+ * @brief Declaration of the MorphTarget, Morph and MorphDelta structs and the MorphTargets class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "culling/AABB.hpp"
+#include "maths/vec2.hpp"
+#include "maths/vec3.hpp"
+#include "maths/vec4.hpp"
+
+/**
+ * @struct MorphTarget
+ * @brief The sparse deltas of a morph target: only the vertices it moves are stored. The deltas are
+ * padded to 4 components so that they can be loaded in SIMD registers.
+ */
+struct MorphTarget {
+    std::vector<unsigned int> vertices; ///< The indices of the vertices the target moves, increasing.
+    std::vector<vec4> position_deltas;  ///< The position delta of each vertex.
+    std::vector<vec4> normal_deltas;    ///< The normal delta of each vertex, empty if it has none.
+    std::vector<vec4> tangent_deltas;   ///< The tangent delta of each vertex, empty if it has none.
+    vec3 min_position_delta;            ///< The component-wise minimum of the position deltas.
+    vec3 max_position_delta;            ///< The component-wise maximum of the position deltas.
+};
+
+/**
+ * @struct MorphDelta
+ * @brief The deltas of a vertex for a single target, laid out like the std430 struct the deformed
+ * vertex shaders read.
+ */
+struct MorphDelta {
+    vec4 position; ///< The position delta, with the index of the target in w.
+    vec4 normal;   ///< The normal delta.
+    vec4 tangent;  ///< The tangent delta.
+};
+
+/**
+ * @class MorphTargets
+ * @brief The morph targets of a mesh. Each target is stored sparsely, since morph targets usually
+ * only move a few vertices of the mesh, like the ones of the mouth for a face. The targets can be
+ * applied on the CPU, which only goes through the active ones, or be converted to a per vertex layout
+ * for the vertex shaders.
+ */
+class MorphTargets {
+public:
+    /**
+     * @brief Adds a target from the dense deltas of every vertex. The vertices whose deltas are all
+     * zero are dropped.
+     * @param vertices_count The amount of vertices of the mesh.
+     * @param positions The position deltas, 3 floats per vertex, or empty.
+     * @param normals The normal deltas, 3 floats per vertex, or empty.
+     * @param tangents The tangent deltas, 3 floats per vertex, or empty.
+     */
+    void add_target(size_t vertices_count,
+                    std::span<const float> positions,
+                    std::span<const float> normals,
+                    std::span<const float> tangents);
+
+    /**
+     * @return The amount of targets.
+     */
+    size_t get_targets_count() const;
+
+    /**
+     * @return The total amount of vertex deltas of all the targets.
+     */
+    size_t get_deltas_count() const;
+
+    /**
+     * @brief Adds the weighted position deltas of the targets whose weight isn't zero.
+     * @param weights The weight of each target.
+     * @param positions The positions of the mesh's vertices, which are morphed. Their w component is
+     * left unchanged.
+     */
+    void morph_positions(std::span<const float> weights, std::vector<vec4>& positions) const;
+
+    /**
+     * @brief Blends the deltas of the targets whose weight isn't zero into a single delta per vertex,
+     * which the deformed vertex shaders read instead of going through every target of the vertex.
+     * The deltas of the vertices moved by any target are cleared first, the others aren't written.
+     * @param weights The weight of each target.
+     * @param deltas One delta per vertex of the mesh, zero for the vertices no target moves.
+     * @return The first vertex whose delta was written and one past the last one.
+     */
+    uvec2 blend_deltas(std::span<const float> weights, std::span<MorphDelta> deltas) const;
+
+    /**
+     * @brief Computes a bounding box of the morphed mesh from the bounds of each target's deltas.
+     * @param aabb The AABB of the mesh.
+     * @param weights The weight of each target.
+     * @return An AABB that contains the morphed mesh.
+     */
+    AABB get_AABB(const AABB& aabb, std::span<const float> weights) const;
+
+    /**
+     * @brief Appends the deltas grouped by vertex, the layout read by the deformed vertex shaders.
+     * @param vertices_count The amount of vertices of the mesh.
+     * @param ranges The first delta and the amount of deltas of each vertex. The offsets start at the
+     * current size of deltas.
+     * @param deltas The deltas.
+     */
+    void append_deltas_by_vertex(size_t vertices_count, std::vector<uvec2>& ranges, std::vector<MorphDelta>& deltas) const;
+
+    std::vector<float> default_weights; ///< The weights of the targets when they aren't animated.
+
+private:
+    std::vector<MorphTarget> targets; ///< The targets.
+};
+
+/**
+ * @struct Morph
+ * @brief The morph targets of a mesh node and where its data is in the scene graph's buffers.
+ */
+struct Morph {
+    const MorphTargets* targets;        ///< The mesh's targets.
+    unsigned int weights_offset;        ///< The index of the node's first weight in the scene graph's morph weights.
+    unsigned int ranges_offset;         ///< The index of the mesh's first vertex in the scene graph's morph ranges and blended deltas.
+    unsigned int vertices_count;        ///< The amount of vertices of the mesh.
+    bool is_blended;                    ///< Whether the deltas are blended on the CPU this frame.
+    std::vector<float> blended_weights; ///< The weights the blended deltas were computed with.
+};
@@ -0,0 +1,61 @@
+/***************************************************************************************************
+ * @file  Skin.hpp
+ * @brief Declaration of the Skin struct and the JointPalette class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "maths/affine3x4.hpp"
+#include "maths/vec3.hpp"
+#include "maths/vec4.hpp"
+
+class Mesh;
+
+/**
+ * @struct Skin
+ * @brief The joints that deform the skinned meshes of a node. The joint matrix of a joint is
+ * inverse(mesh node's global model) * joint's global model * inverse bind matrix, so that the node's
+ * model matrix can still be applied after skinning.
+ */
+struct Skin {
+    unsigned int mesh_node;                       ///< The node the skinned meshes are under.
+    std::vector<unsigned int> joints;             ///< The index of each joint's node in the scene graph.
+    std::vector<affine3x4> inverse_bind_matrices; ///< The inverse bind matrix of each joint.
+    unsigned int palette_offset;                  ///< The index of the skin's first joint matrix in the scene graph's palette.
+};
+
+/**
+ * @class JointPalette
+ * @brief The joint matrices of a skin for CPU skinning, stored as structure of arrays: one array per
+ * column, so that the 4 columns of a joint are loaded straight into SIMD registers and blended with
+ * the vertex's weights.
+ */
+class JointPalette {
+public:
+    /**
+     * @brief Copies joint matrices into the palette.
+     * @param matrices The joint matrices.
+     */
+    void set(std::span<const affine3x4> matrices);
+
+    /**
+     * @return The amount of joints in the palette.
+     */
+    size_t get_size() const;
+
+    /**
+     * @brief Skins the position of every vertex of a mesh: the positions are transformed by the sum
+     * of the joint matrices weighted by the vertex's weights.
+     * @param mesh The mesh, which needs joints and weights.
+     * @param positions The position of every vertex, with a w of 1, which are skinned and keep a w
+     * of 1 as long as the vertex's weights sum to 1. They can be the mesh's positions or its morphed
+     * positions.
+     */
+    void skin_positions(const Mesh& mesh, std::vector<vec4>& positions) const;
+
+private:
+    std::vector<vec4> columns[4]; ///< The columns of every joint matrix, by column then by joint.
+};
@@ -5,11 +5,41 @@
 
 #pragma once
 
+#include <filesystem>
+#include <memory>
 #include "assets/Camera.hpp"
+#include "assets/CameraPath.hpp"
 #include "culling/Frustum.hpp"
 #include "engine/Framebuffer.hpp"
 #include "engine/SceneGraph.hpp"
 
+/**
+ * @struct OffscreenSettings
+ * @brief What is rendered in headless mode.
+ */
+struct OffscreenSettings {
+    std::filesystem::path scene_path;    ///< The path of the glTF scene to render.
+    vec3 camera_position;                ///< The position of the camera.
+    vec3 camera_target;                  ///< The point the camera looks at.
+    unsigned int frames_count;           ///< The amount of frames to render.
+    float frame_delta;                   ///< The fixed timestep between two frames in seconds.
+    std::filesystem::path output_prefix; ///< The frames are written to "<prefix>_<frame>.png".
+};
+
+/**
+ * @struct BenchmarkSettings
+ * @brief How a scene is benchmarked.
+ */
+struct BenchmarkSettings {
+    std::filesystem::path scene_path;    ///< The path of the glTF scene to benchmark.
+    std::filesystem::path camera_path;   ///< The path of the camera path to replay.
+    float frame_delta;                   ///< The fixed timestep between two frames in seconds.
+    unsigned int warmup_frames_count;    ///< The amount of frames rendered before recording.
+    std::filesystem::path report_prefix; ///< The reports are written to "<prefix>.csv" and "<prefix>.json".
+    std::filesystem::path baseline_path; ///< The JSON report to compare against, or empty.
+    float threshold;                     ///< How much slower than the baseline a timing can be.
+};
+
 /**
  * @class Application
  * @brief Core of the project. Assembles everything together and handles the main loop.
@@ -31,7 +61,39 @@ public:
      */
     void run();
 
+    /**
+     * @brief Renders a scene offscreen at a fixed timestep and writes every frame to a PNG file. The
+     * window needs to be headless.
+     * @param settings What to render.
+     */
+    void render_offscreen(const OffscreenSettings& settings);
+
+    /**
+     * @brief Loads a scene, replays a camera path at a fixed timestep while recording the timings of
+     * every frame, then writes the reports and compares them against the baseline.
+     * @param settings How to benchmark the scene.
+     * @return Whether no timing regressed compared to the baseline.
+     */
+    bool run_benchmark(const BenchmarkSettings& settings);
+
 private:
+    /**
+     * @brief Polls and handles the window's events.
+     */
+    void poll_events();
+
+    /**
+     * @brief Updates the scene, draws it and the ImGui windows, then swaps the buffers.
+     * @param delta The time since the last frame in seconds.
+     */
+    void update_and_draw_frame(float delta);
+
+    /**
+     * @brief Updates the loading scenes until all of them and their textures are loaded.
+     * @throw std::runtime_error If a scene failed to load.
+     */
+    void wait_for_loading();
+
     /**
      * @brief Draws the background, the scene and handles post processing.
      */
@@ -47,13 +109,20 @@ private:
      */
     void draw_imgui_object_editor_window();
 
-    SceneGraph scene_graph;  ///< Scene graph.
-    Camera camera;           ///< The camera.
-    Framebuffer framebuffer; ///< The framebuffer used to render.
+    SceneGraph scene_graph;   ///< Scene graph.
+    Camera camera;            ///< The camera.
+    Framebuffer framebuffer;  ///< The framebuffer used to render.
+    Handle<Mesh> screen_mesh; ///< The mesh covering the whole screen.
+
+    std::unique_ptr<Framebuffer> output_framebuffer; ///< The post processed frame in headless mode.
 
     Frustum frustum; ///< The frustum used for culling.
 
-    bool are_axes_drawn; ///< Whether the axes are drawn.
+    CameraPath recorded_path;    ///< The camera path being recorded.
+    double recording_start_time; ///< When the first key of the recorded path was added.
+
+    bool are_axes_drawn;          ///< Whether the axes are drawn.
+    bool is_profiler_window_open; ///< Whether the profiler's window is drawn.
 
     vec3 sky_color_low;
     vec3 sky_color_high;
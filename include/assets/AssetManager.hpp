@@ -6,28 +6,13 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include "materials/Material.hpp"
 #include "mesh/Mesh.hpp"
 #include "Shader.hpp"
+#include "ShaderName.hpp"
 #include "Texture.hpp"
-
-enum ShaderName {
-    SHADER_NONE = -1,
-
-    SHADER_POINT_MESH,
-    SHADER_LINE_MESH,
-    SHADER_BACKGROUND,
-    SHADER_FLAT,
-    SHADER_LAMBERT,
-    SHADER_BLINN_PHONG,
-    SHADER_METALLIC_ROUGHNESS,
-    SHADER_METALLIC_ROUGHNESS_NO_TANGENT,
-    SHADER_TERRAIN,
-    SHADER_POST_PROCESSING,
-    SHADER_NORMALS,
-    SHADER_WIREFRAME,
-
-    SHADER_COUNT
-};
+#include "utility/SlotMap.hpp"
 
 /**
  * @class AssetManager
@@ -48,9 +33,48 @@ public:
     static Texture& add_texture(const std::string& name, const vec3& color);
     static Mesh& add_mesh(const std::string& name);
 
+    /**
+     * @brief Adds a texture created from a glTF image, or finds the texture that was already created
+     * from the same uri or the same pixels with the same color space.
+     * @param image The image.
+     * @param sampler The sampler that describes how the texture should be sampled.
+     * @param srgb Whether the texture should use the SRGB color space.
+     * @return The texture's handle.
+     */
+    static Handle<Texture> add_texture(const tinygltf::Image& image, const tinygltf::Sampler& sampler, bool srgb);
+
+    /**
+     * @brief Finds or creates a 1x1 texture of a color, like the textures of the materials that
+     * don't have a map.
+     * @param color The texture's color.
+     * @return The texture's handle.
+     */
+    static Handle<Texture> get_color_texture(const vec3& color);
+
+    /**
+     * @brief Adds a mesh without a name, like the meshes of a glTF scene.
+     * @param mesh The mesh, which is moved into the asset manager.
+     * @return The mesh's handle. The mesh has no references yet.
+     */
+    static Handle<Mesh> add_mesh(Mesh&& mesh);
+
+    /**
+     * @brief Adds a material, like the materials of a glTF scene.
+     * @param material The material.
+     * @return The material's handle. The material has no references yet.
+     */
+    static Handle<Material> add_material(std::unique_ptr<Material> material);
+
+    /**
+     * @brief Makes another name refer to a texture that is already in the asset manager.
+     * @param alias The new name.
+     * @param texture_name_or_path The texture's name or path.
+     */
+    static void add_texture_alias(const std::string& alias, const std::string& texture_name_or_path);
+
     template <typename MeshFunc, typename... Args>
     static Mesh& add_mesh(const std::string& name, MeshFunc&& create_mesh, Args&&... args) {
-        Mesh& mesh = get().meshes.emplace(name, Mesh()).first->second;
+        Mesh& mesh = add_mesh(name);
         std::invoke(std::forward<MeshFunc>(create_mesh), mesh, std::forward<Args>(args)...);
         return mesh;
     }
@@ -60,20 +84,103 @@ public:
                                const std::string& second,
                                MeshFunc&& create_mesh,
                                Args&&... args) {
-        AssetManager& asset_manager = get();
-        std::invoke(std::forward<MeshFunc>(create_mesh),
-                    asset_manager.meshes.emplace(first, Mesh()).first->second,
-                    asset_manager.meshes.emplace(second, Mesh()).first->second,
-                    std::forward<Args>(args)...);
+        Mesh& first_mesh = add_mesh(first);
+        Mesh& second_mesh = add_mesh(second);
+        std::invoke(std::forward<MeshFunc>(create_mesh), first_mesh, second_mesh, std::forward<Args>(args)...);
     }
 
     static Shader& get_shader(ShaderName shader_name);
     static Texture& get_texture(const std::string& texture_name_or_path);
     static Mesh& get_mesh(const std::string& mesh_name);
 
+    /**
+     * @brief Finds the handle of a texture, which can then be used to access it without a lookup.
+     * @param texture_name_or_path The texture's name or path.
+     * @return The texture's handle.
+     */
+    static Handle<Texture> get_texture_handle(const std::string& texture_name_or_path);
+
+    /**
+     * @brief Finds the handle of a mesh, which can then be used to access it without a lookup.
+     * @param mesh_name The mesh's name.
+     * @return The mesh's handle.
+     */
+    static Handle<Mesh> get_mesh_handle(const std::string& mesh_name);
+
+    /**
+     * @brief Accesses a texture through its handle.
+     * @throw std::runtime_error If the texture was unloaded.
+     */
+    static Texture& get_texture(Handle<Texture> handle);
+
+    /**
+     * @brief Accesses a mesh through its handle.
+     * @throw std::runtime_error If the mesh was unloaded.
+     */
+    static Mesh& get_mesh(Handle<Mesh> handle);
+
+    /**
+     * @brief Accesses a material through its handle.
+     * @throw std::runtime_error If the material was removed.
+     */
+    static Material& get_material(Handle<Material> handle);
+
+    /**
+     * @brief Adds a reference to a texture, which prevents it from being unloaded.
+     * @param handle The texture's handle.
+     */
+    static void acquire(Handle<Texture> handle);
+
+    /**
+     * @brief Adds a reference to a mesh, which prevents it from being unloaded.
+     * @param handle The mesh's handle.
+     */
+    static void acquire(Handle<Mesh> handle);
+
+    /**
+     * @brief Adds a reference to a material, which prevents it from being removed.
+     * @param handle The material's handle.
+     */
+    static void acquire(Handle<Material> handle);
+
+    /**
+     * @brief Removes a reference to a texture. The texture is freed and removed once it has no
+     * references left, after which all of its handles are stale.
+     * @param handle The texture's handle.
+     * @throw std::runtime_error If the texture has no references, it was never acquired.
+     */
+    static void release(Handle<Texture> handle);
+
+    /**
+     * @brief Removes a reference to a mesh. The mesh is removed once it has no references left,
+     * after which all of its handles are stale.
+     * @param handle The mesh's handle.
+     * @throw std::runtime_error If the mesh has no references, it was never acquired.
+     */
+    static void release(Handle<Mesh> handle);
+
+    /**
+     * @brief Removes a reference to a material. The material is removed once it has no references
+     * left, after which all of its handles are stale.
+     * @param handle The material's handle.
+     * @throw std::runtime_error If the material has no references, it was never acquired.
+     */
+    static void release(Handle<Material> handle);
+
     static Texture* get_texture_ptr(const std::string& texture_name_or_path);
+
+    /**
+     * @return A pointer to the texture, or nullptr if it was unloaded.
+     */
+    static Texture* get_texture_ptr(Handle<Texture> handle);
+
     static Mesh* get_mesh_ptr(const std::string& mesh_name);
 
+    /**
+     * @return A pointer to the mesh, or nullptr if it was unloaded.
+     */
+    static Mesh* get_mesh_ptr(Handle<Mesh> handle);
+
     static bool has_texture(const std::string& texture_name_or_path);
     static bool has_mesh(const std::string& mesh_name);
 
@@ -85,6 +192,10 @@ private:
     ~AssetManager();
 
     Shader shaders[SHADER_COUNT];
-    std::unordered_map<std::string, Texture> textures;
-    std::unordered_map<std::string, Mesh> meshes;
+
+    SlotMap<Texture> textures;                                      ///< The textures.
+    SlotMap<Mesh> meshes;                                           ///< The meshes.
+    SlotMap<std::unique_ptr<Material>, Material> materials;         ///< The materials.
+    std::unordered_map<std::string, Handle<Texture>> texture_names; ///< The handle of each texture name or path.
+    std::unordered_map<std::string, Handle<Mesh>> mesh_names;       ///< The handle of each mesh name.
 };
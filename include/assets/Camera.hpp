@@ -49,6 +49,11 @@ public:
      */
     vec3 get_position() const;
 
+    /**
+     * @return The camera's position in double precision.
+     */
+    dvec3 get_precise_position() const;
+
     /**
      * @return The direction is looking towards.
      */
@@ -95,6 +100,13 @@ public:
      */
     mat4 get_view_projection_matrix() const;
 
+    /**
+     * @brief Calculates the view-projection matrix of the camera placed at the origin, for models
+     * whose translation is relative to the camera's position.
+     * @return The projection matrix multiplied by the view matrix without its translation.
+     */
+    mat4 get_relative_view_projection_matrix() const;
+
     /**
      * @brief Calculates the camera's rotation matrix.
      * @return A rotation matrix that rotates towards where the camera is looking.
@@ -116,11 +128,11 @@ public:
     mat4 get_inverse_projection_matrix() const;
 
     /**
-     * @brief Calculates the inverse of the view-projectino matrix.
-     * @return The inverse of the view matrix multiplied with the inverse of the projection matrix:\n
+     * @return The inverse of the view-projection matrix, updated whenever the view or the projection
+     * changes: the inverse of the view matrix multiplied with the inverse of the projection matrix:\n
      * (PV)^(-1) = V^(-1) * P^(-1).
      */
-    mat4 get_inverse_view_projection_matrix() const;
+    const mat4& get_inverse_view_projection_matrix() const;
 
     /**
      * @brief Sets the camera's position to a certain point.
@@ -128,6 +140,12 @@ public:
      */
     void set_position(const vec3& position);
 
+    /**
+     * @brief Sets the camera's position to a certain point.
+     * @param position The camera's new position.
+     */
+    void set_position(const dvec3& position);
+
     /**
      * @brief Updates the camera's direction depending on how the mouse moved since the last frame.
      * @param pitch_offset The offset to the camera's tilt angle (in degrees).
@@ -162,9 +180,20 @@ private:
      */
     void update_vectors_and_view_matrix();
 
-    vec3 position; ///< The camera's position.
-    float pitch;   ///< The camera's pitch angle (in radians), the camera's tilt, the "up/down" angle.
-    float yaw;     ///< The camera's yaw angle (in radians), the angle around the y axis, the "left/right angle."
+    /**
+     * @brief Recalculates the translation of the view matrix from the camera's position, in double
+     * precision.
+     */
+    void update_view_matrix_translation();
+
+    /**
+     * @brief Recalculates the inverse of the view-projection matrix.
+     */
+    void update_inverse_view_projection_matrix();
+
+    dvec3 position; ///< The camera's position, in double precision for large worlds.
+    float pitch;    ///< The camera's pitch angle (in radians), the camera's tilt, the "up/down" angle.
+    float yaw;      ///< The camera's yaw angle (in radians), the angle around the y axis, the "left/right angle."
 
     vec3 direction; ///< The direction is looking towards.
     vec3 right;     ///< The direction pointing right of where the camera is looking.
@@ -175,8 +204,9 @@ private:
     const float near_distance; ///< Distance of the near plane.
     const float far_distance;  ///< Distance of the far plane.
 
-    mat4 view_matrix;       ///< The camera's view matrix. Used every frame in the mvp matrix calculation.
-    mat4 projection_matrix; ///< The projection matrix. Used every frame in the mvp matrix calculation.
+    mat4 view_matrix;                    ///< The camera's view matrix. Used every frame in the mvp matrix calculation.
+    mat4 projection_matrix;              ///< The projection matrix. Used every frame in the mvp matrix calculation.
+    mat4 inverse_view_projection_matrix; ///< The inverse of the view-projection matrix, used for picking.
 
     const vec3 WORLD_UP { 0.0f, 1.0f, 0.0f }; ///< Where "up" is.
 };
@@ -0,0 +1,80 @@
+/***************************************************************************************************
+ * @file  CameraPath.hpp
+ * @brief Declaration of the CameraPath class and the CameraKey struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include "maths/vec3.hpp"
+
+/**
+ * @struct CameraKey
+ * @brief A keyframe of a camera path.
+ */
+struct CameraKey {
+    float time;    ///< The time of the key in seconds.
+    vec3 position; ///< The position of the camera.
+    vec3 target;   ///< The point the camera looks at.
+};
+
+/**
+ * @class CameraPath
+ * @brief A camera path that goes through keyframes along Catmull-Rom splines. Paths are recorded
+ * from the interactive camera and replayed by the benchmark mode. They are stored as text files with
+ * one key per line: "time px py pz tx ty tz". Empty lines and lines starting with '#' are ignored.
+ */
+class CameraPath {
+public:
+    /**
+     * @brief Creates an empty path.
+     */
+    CameraPath() = default;
+
+    /**
+     * @brief Loads a path from a file.
+     * @param path The path of the file.
+     */
+    explicit CameraPath(const std::filesystem::path& path);
+
+    /**
+     * @brief Writes the path to a file.
+     * @param path The path of the file.
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Adds a key at the end of the path.
+     * @param time The time of the key, which needs to be greater than the last key's.
+     * @param position The position of the camera.
+     * @param target The point the camera looks at.
+     */
+    void add_key(float time, const vec3& position, const vec3& target);
+
+    /**
+     * @brief Removes all the keys.
+     */
+    void clear();
+
+    /**
+     * @return The amount of keys.
+     */
+    size_t get_keys_count() const;
+
+    /**
+     * @return The time of the last key.
+     */
+    float get_duration() const;
+
+    /**
+     * @brief Samples the path. Before the first key and after the last one, the path stays on them.
+     * @param time The time in seconds.
+     * @param position The position of the camera.
+     * @param target The point the camera looks at.
+     */
+    void sample(float time, vec3& position, vec3& target) const;
+
+private:
+    std::vector<CameraKey> keys; ///< The keys, sorted by time.
+};
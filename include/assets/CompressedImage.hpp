@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * @file  CompressedImage.hpp
+ * @brief Declaration of the CompressedImage class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "Image.hpp"
+#include "Mipmaps.hpp"
+
+/**
+ * @brief The block compression formats an image can be compressed to.
+ */
+enum class CompressionFormat : unsigned int {
+    BC1, ///< RGB, 4 bits per pixel.
+    BC3, ///< RGBA, 8 bits per pixel.
+    BC4, ///< R, 4 bits per pixel.
+    BC5  ///< RG, 8 bits per pixel. Used for normal maps, the z component is reconstructed in shaders.
+};
+
+/**
+ * @class CompressedImage
+ * @brief Holds an image compressed with a block compression format along with its whole mip chain.
+ * Compressed images can be saved to and loaded from the texture cache.
+ */
+class CompressedImage {
+public:
+    /**
+     * @struct Level
+     * @brief Describes a mip level of the image.
+     */
+    struct Level {
+        unsigned int width;  ///< The level's width in pixels.
+        unsigned int height; ///< The level's height in pixels.
+        size_t offset;       ///< The offset of the level's blocks in the data.
+        size_t size;         ///< The size of the level's blocks in bytes.
+    };
+
+    /**
+     * @brief Creates an empty compressed image.
+     */
+    CompressedImage();
+
+    /**
+     * @brief Generates the mip chain of an image and compresses every level. Can be called from any
+     * thread.
+     * @param image The image to compress.
+     * @param format The compression format.
+     * @param srgb Whether the image uses the SRGB color space, so that its mip levels are filtered in
+     * linear space.
+     * @param filter The filter used to generate the mip levels.
+     * @param threads_count The amount of threads used to generate the mip levels, see
+     * generate_mipmaps. Threads that already run in parallel with others should pass 1.
+     */
+    CompressedImage(const Image& image,
+                    CompressionFormat format,
+                    bool srgb,
+                    MipmapFilter filter,
+                    unsigned int threads_count = 0);
+
+    /**
+     * @brief Chooses the most fitting compression format for an image.
+     * @param image The image.
+     * @param is_normal_map Whether the image is a tangent space normal map.
+     * @return BC4 for 1 channel, BC5 for 2 channels and normal maps, BC3 if some pixels aren't opaque
+     * and BC1 otherwise.
+     */
+    static CompressionFormat choose_format(const Image& image, bool is_normal_map);
+
+    /**
+     * @brief Returns the path of an image in the texture cache.
+     * @param hash The hash of the image's encoded data and of how it is compressed.
+     * @return The path of the cached image, which might not exist.
+     */
+    static std::filesystem::path get_cache_path(uint64_t hash);
+
+    /**
+     * @brief Loads a compressed image that was saved with the save method. Files whose header is
+     * invalid or doesn't match their size are rejected, and the image is left unchanged.
+     * @param path The path to the file.
+     * @return Whether the file exists and could be loaded.
+     */
+    bool load(const std::filesystem::path& path);
+
+    /**
+     * @brief Saves the compressed image to a file, creating the directories if needed.
+     * @param path The path to the file.
+     */
+    void save(const std::filesystem::path& path) const;
+
+    /**
+     * @return The compression format.
+     */
+    CompressionFormat get_format() const;
+
+    /**
+     * @return The mip levels, starting from the largest one.
+     */
+    const std::vector<Level>& get_levels() const;
+
+    /**
+     * @return The blocks of all the levels.
+     */
+    const unsigned char* get_data() const;
+
+    /**
+     * @return The size in bytes of the blocks of all the levels.
+     */
+    size_t get_size() const;
+
+    /**
+     * @return Whether the format stores transparency.
+     */
+    bool has_transparency() const;
+
+private:
+    CompressionFormat format;        ///< The compression format.
+    std::vector<Level> levels;       ///< The mip levels.
+    std::vector<unsigned char> data; ///< The blocks of all the levels.
+};
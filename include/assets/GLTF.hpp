@@ -6,52 +6,173 @@
 #pragma once
 
 #include <filesystem>
+#include <future>
+#include <vector>
 
-#include "Shader.hpp"
 #include "tiny_gltf.h"
+#include "assets/GLTFModel.hpp"
 #include "materials/MRMaterial.hpp"
 #include "mesh/Mesh.hpp"
-#include "utility/HeapArray.hpp"
+#include "utility/SlotMap.hpp"
 
 class SceneGraph;
 
 namespace GLTF {
-    struct Primitive {
-        ::Mesh primitive;
-        MRMaterial* material;
-        const Shader* shader;
-    };
-
-    struct Mesh {
-        std::string name;
-        HeapArray<Primitive> primitives;
+    /**
+     * @struct PrimitiveAssets
+     * @brief The assets a primitive of the model was turned into, which the scene holds a reference to.
+     */
+    struct PrimitiveAssets {
+        Handle<::Mesh> mesh;       ///< The mesh that is drawn, another scene's if the content is the same.
+        Handle<Material> material; ///< The primitive's material, invalid if it has none.
     };
 
-    struct AttributeInfo {
-        Attribute attribute;
-
-        const float* data;
-        size_t stride_in_floats;
-        unsigned char elements_count;
+    /**
+     * @struct TextureUpload
+     * @brief A material texture that still needs to be created on the GPU.
+     */
+    struct TextureUpload {
+        Handle<Material> material;          ///< The material whose map is created.
+        Handle<Texture> MRMaterial::* map;  ///< The map to create.
+        int texture_index;                  ///< The index of the tinygltf texture. -1 if the material has no texture.
+        bool srgb;                          ///< Whether the texture should use the SRGB color space.
+        bool is_normal_map;                 ///< Whether the texture is a tangent space normal map.
+        vec3 default_color;                 ///< The color used if there is no texture or while it is being loaded.
     };
 
     /**
     * @class Scene
-    * @brief
+    * @brief The GL side of a glTF import: creates the meshes' buffers, the materials and their
+    * textures, and the scene graph nodes from a GLTF::Model.
     */
     class Scene {
     public:
+        /**
+         * @brief Creates an empty scene. Use load or load_async to fill it.
+         */
+        Scene();
+
+        /**
+         * @brief Synchronously loads a scene and adds its nodes to the scene graph.
+         * @param path The path to the .gltf or .glb file.
+         * @param scene_graph The scene graph to add the nodes to.
+         * @param scene_node_index The index of the node the scene's nodes are added under.
+         */
         Scene(const std::filesystem::path& path, SceneGraph* scene_graph, unsigned int scene_node_index);
+
         ~Scene();
 
+        Scene(const Scene&) = delete;
+        Scene& operator=(const Scene&) = delete;
+
         void load(const std::filesystem::path& path, SceneGraph* scene_graph, unsigned int scene_node_index);
 
+        /**
+         * @brief Starts loading a scene on a background thread and returns immediately. The file is
+         * parsed and the vertex data is decoded on the background thread, then update_loading needs
+         * to be called every frame in order to add the nodes to the scene graph and to progressively
+         * upload the meshes to the GPU. The textures are handed to the TextureStreamer.
+         * @param path The path to the .gltf or .glb file.
+         * @param scene_node_index The index of the node the scene's nodes will be added under.
+         */
+        void load_async(const std::filesystem::path& path, unsigned int scene_node_index);
+
+        /**
+         * @brief Advances an asynchronous load. Once the background thread is done, the nodes are
+         * added to the scene graph with placeholder textures that get streamed, then meshes are
+         * uploaded until the upload budget runs out. If the scene couldn't be decoded or its nodes
+         * couldn't be created, the error is reported and the load fails, see has_failed.
+         * @param scene_graph The scene graph to add the nodes to.
+         * @param upload_budget How many bytes can still be uploaded to the GPU this frame. The
+         * uploaded amount is subtracted from it. The last upload of a frame can overshoot it.
+         * @return Whether the scene is completely loaded.
+         */
+        bool update_loading(SceneGraph* scene_graph, size_t& upload_budget);
+
+        /**
+         * @return Whether the scene is still being loaded asynchronously. A failed load isn't.
+         */
+        bool is_loading() const;
+
+        /**
+         * @return Whether the asynchronous load failed, in which case it stopped.
+         */
+        bool has_failed() const;
+
+        /**
+         * @return The fraction of the scene that was loaded, between 0 and 1.
+         */
+        float get_loading_progress() const;
+
         void add_node(const std::vector<tinygltf::Node>& t_nodes,
                       const tinygltf::Node& t_node,
                       SceneGraph* scene_graph,
                       int sg_parent_index);
 
     private:
-        HeapArray<Mesh> meshes;
+        enum class LoadingState : unsigned char {
+            LOADED,
+            DECODING,
+            UPLOADING,
+            FAILED
+        };
+
+        /**
+         * @brief Decodes the model. Does not use OpenGL so it can run on a background thread.
+         * @param images_as_is Whether to keep the encoded images instead of decoding them.
+         */
+        void decode(const std::filesystem::path& path, bool images_as_is);
+
+        /**
+         * @brief Creates the materials of the primitives and adds them to the asset manager, where the
+         * scene acquires them. Their textures are not created, they are added to pending_textures.
+         */
+        void create_materials();
+
+        /**
+         * @brief Moves the meshes to the asset manager, where the scene acquires them, replacing the
+         * meshes whose content was already loaded by the scene graph with the existing ones. Then
+         * adds the nodes of the model's scenes to the scene graph. The new meshes are added to
+         * pending_meshes.
+         */
+        void create_nodes(SceneGraph* scene_graph);
+
+        /**
+         * @brief Adds the skins of the skinned nodes and the animations to the scene graph, once the
+         * nodes were added. Skinned primitives are given the skinned shaders.
+         */
+        void add_skins_and_animations(SceneGraph* scene_graph);
+
+        /**
+         * @brief Creates a material texture on the GPU, or finds the one that was already created
+         * from the same image, and gives it to the material.
+         * @return The amount of bytes of the texture's image data.
+         */
+        size_t upload_texture(const TextureUpload& upload) const;
+
+        /**
+         * @brief Hands a texture's encoded image to the texture streamer and gives the material the
+         * texture, which is a placeholder until the image is uploaded.
+         * @param upload The texture.
+         * @param is_last_use Whether no other texture uses the image, in which case its data is moved
+         * instead of copied.
+         */
+        void stream_texture(const TextureUpload& upload, bool is_last_use);
+
+        /**
+         * @return The sampler of a tinygltf texture, or the default sampler if it doesn't have one.
+         */
+        const tinygltf::Sampler& get_sampler(const tinygltf::Texture& t_texture) const;
+
+        Model model;                                          ///< The decoded glTF model.
+        std::vector<std::vector<PrimitiveAssets>> assets;     ///< The assets of each primitive of each mesh.
+        unsigned int scene_node_index;                        ///< The index of the node the scene is under.
+        LoadingState state;                                   ///< The state of the loading.
+        std::future<void> decoding;                           ///< The background thread's result.
+        std::vector<Handle<::Mesh>> pending_meshes;           ///< Meshes whose buffers still need to be created.
+        std::vector<TextureUpload> pending_textures;          ///< Textures that still need to be created.
+        size_t uploads_count;                                 ///< The total amount of meshes to upload.
+        std::vector<unsigned int> node_indices;               ///< The scene graph index of each glTF node.
+        std::vector<unsigned int> morph_weights_offsets;      ///< The first morph weight of each glTF node.
     };
 }
@@ -0,0 +1,166 @@
+/***************************************************************************************************
+ * @file  GLTFModel.hpp
+ * @brief Declaration of the GLTF::Model class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "tiny_gltf.h"
+#include "animation/Animation.hpp"
+#include "animation/MorphTargets.hpp"
+#include "maths/affine3x4.hpp"
+#include "maths/vec4.hpp"
+#include "mesh/Mesh.hpp"
+#include "utility/HeapArray.hpp"
+#include "utility/MappedFile.hpp"
+
+namespace GLTF {
+    /**
+     * @struct MaterialData
+     * @brief The parameters of a metallic roughness material, from which the GL layer creates it.
+     */
+    struct MaterialData {
+        std::string name;                ///< The name of the material.
+        vec4 base_color;                 ///< The base color factor.
+        float metallic;                  ///< The metallic factor.
+        float roughness;                 ///< The roughness factor.
+        int base_color_texture;          ///< The index of the base color texture, -1 if there is none.
+        int metallic_roughness_texture;  ///< The index of the metallic roughness texture, -1 if there is none.
+        int normal_texture;              ///< The index of the normal texture, -1 if there is none.
+    };
+
+    struct Primitive {
+        ::Mesh primitive;           ///< The decoded mesh, until it is moved to the asset manager.
+        int material;               ///< The index of the primitive's material, -1 if it has none.
+        uint64_t content_hash;      ///< The hash of the primitive's mesh, computed while decoding.
+        MorphTargets morph_targets; ///< The primitive's morph targets, empty if it has none.
+    };
+
+    struct Mesh {
+        std::string name;
+        HeapArray<Primitive> primitives;
+    };
+
+    struct AttributeInfo {
+        Attribute attribute;
+
+        const unsigned char* data;
+        size_t stride;            ///< The distance between two elements in bytes.
+        unsigned int size;        ///< The size of an element in bytes.
+        unsigned int padded_size; ///< The size of an element in the mesh's vertices.
+        bool is_mapped;           ///< Whether the data is in a mapped file.
+    };
+
+    /**
+     * @struct BufferData
+     * @brief The content of a glTF buffer.
+     */
+    struct BufferData {
+        std::span<const unsigned char> data; ///< The buffer's bytes.
+        bool is_mapped;                      ///< Whether they are in a mapped file, which lives as long as the model.
+    };
+
+    /**
+     * @class Model
+     * @brief The CPU side of a glTF import: parses a file and decodes its meshes, materials, skins
+     * and animations without OpenGL, so that it can run on a background thread or on a machine
+     * without a GPU. GLTF::Scene creates the GL resources and the scene graph nodes from it.
+     */
+    class Model {
+    public:
+        /**
+         * @brief Maps the glTF file and its external buffers into memory and parses the file with
+         * tinygltf. The mapped buffers are hidden from tinygltf so that it doesn't copy them, they
+         * are read from the mappings through the buffers array instead.
+         * @param path The path to the .gltf or .glb file.
+         * @param images_as_is Whether to keep the encoded images instead of decoding them.
+         */
+        void load(const std::filesystem::path& path, bool images_as_is);
+
+        /**
+         * @brief Decodes the meshes, their vertex data and morph targets, and the materials' parameters.
+         */
+        void create_meshes();
+
+        /**
+         * @brief Decodes the keyframes of the animations and the inverse bind matrices of the skins.
+         * The animation channels target glTF nodes.
+         */
+        void create_skins_and_animations();
+
+        /**
+         * @brief Frees the tinygltf model and the buffers once the scene doesn't need them anymore.
+         * The decoded meshes are kept, and so are the mappings they can point to.
+         */
+        void release_source();
+
+        /**
+         * @brief Reads all the components of an accessor as floats, normalized integers included.
+         * Accessors without a buffer view are zeros, and the values of sparse accessors are applied.
+         * @param t_accessor The accessor.
+         * @return The components, tightly packed.
+         */
+        std::vector<float> read_accessor(const tinygltf::Accessor& t_accessor) const;
+
+        /**
+         * @brief Enables or disables converting the indexed triangle lists of the models that are
+         * decoded from now on to triangle strips, when that reduces the amount of indices.
+         * @param is_enabled Whether stripifying is enabled.
+         */
+        static void set_stripifying_enabled(bool is_enabled);
+
+        /**
+         * @return Whether stripifying is enabled.
+         */
+        static bool is_stripifying_enabled();
+
+        tinygltf::Model t_model;                                   ///< The tinygltf model, until release_source.
+        HeapArray<Mesh> meshes;                                    ///< The decoded meshes.
+        std::vector<MaterialData> materials;                       ///< The decoded materials.
+        std::vector<std::vector<affine3x4>> inverse_bind_matrices; ///< The inverse bind matrices of each skin.
+        std::vector<Animation> animations;                         ///< The decoded animations.
+
+    private:
+        /**
+         * @brief Finds the data of an accessor and checks that all its elements are in its buffer.
+         * @param t_accessor The accessor.
+         * @param element_size The size of an element of the accessor in bytes.
+         * @return The first element of the accessor.
+         */
+        const unsigned char* get_accessor_data(const tinygltf::Accessor& t_accessor, size_t element_size) const;
+
+        /**
+         * @brief Reads the indices of an accessor, for the index accessors that can't be used in
+         * place. Accessors without a buffer view are zeros, and the values of sparse accessors are
+         * applied.
+         * @param t_accessor The accessor, of unsigned bytes, shorts or ints.
+         * @return The indices.
+         * @throw std::runtime_error If the accessor isn't an index accessor or is out of bounds.
+         */
+        std::vector<unsigned int> read_index_accessor(const tinygltf::Accessor& t_accessor) const;
+
+        /**
+         * @brief Finds data in a buffer view and checks that all its elements are in the view.
+         * @param buffer_view_index The index of the buffer view.
+         * @param byte_offset The offset of the data in the buffer view.
+         * @param count The amount of elements.
+         * @param element_size The size of an element in bytes.
+         * @return The first element.
+         */
+        const unsigned char* get_buffer_view_data(int buffer_view_index,
+                                                  size_t byte_offset,
+                                                  size_t count,
+                                                  size_t element_size) const;
+
+        std::vector<MappedFile> mapped_files; ///< The glTF file and its external buffers.
+        std::vector<BufferData> buffers;      ///< The content of the model's buffers.
+
+        static inline std::atomic<bool> b_is_stripifying_enabled = false; ///< Whether triangle lists are stripified.
+    };
+}
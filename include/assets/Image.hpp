@@ -20,6 +20,30 @@ public:
      */
     explicit Image(const std::filesystem::path& path, bool flip_vertically = true);
 
+    /**
+     * @brief Decodes an image that is stored in memory, in any format supported by stb_image (PNG,
+     * JPEG, etc...). Can be called from any thread.
+     * @param encoded_data The encoded image data.
+     * @param size The size in bytes of the encoded image data.
+     * @param flip_vertically Whether to flip the image on vertically.
+     */
+    Image(const unsigned char* encoded_data, size_t size, bool flip_vertically);
+
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    /**
+     * @brief Move constructor. The other image no longer owns any data.
+     * @param image The image to move.
+     */
+    Image(Image&& image) noexcept;
+
+    /**
+     * @brief Move operator. The other image no longer owns any data.
+     * @param image The image to move.
+     */
+    Image& operator=(Image&& image) noexcept;
+
     /**
      * @brief Frees all the allocated memory.
      */
@@ -45,6 +69,11 @@ public:
      */
     unsigned int get_channels_amount() const;
 
+    /**
+     * @return The size in bytes of the image's data.
+     */
+    size_t get_size() const;
+
 private:
     unsigned char* data;          ///< The data of the image.
     unsigned int width;           ///< The width of the image.
@@ -0,0 +1,48 @@
+/***************************************************************************************************
+ * @file  Mipmaps.hpp
+ * @brief Declaration of functions to generate mip chains on the CPU
+ **************************************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+/**
+ * @brief The filters that can be used to downsample the mip levels.
+ */
+enum class MipmapFilter : unsigned char {
+    BOX,    ///< Averages 2x2 pixels, the same as most drivers' glGenerateMipmap.
+    KAISER, ///< Sinc windowed by a Kaiser window. Sharp with little ringing.
+    LANCZOS ///< Lanczos 3. Sharpest, with some ringing on hard edges.
+};
+
+/**
+ * @struct MipLevel
+ * @brief The RGBA pixels of a mip level.
+ */
+struct MipLevel {
+    unsigned int width;                ///< The level's width in pixels.
+    unsigned int height;               ///< The level's height in pixels.
+    std::vector<unsigned char> pixels; ///< The level's pixels, 4 unsigned bytes per pixel.
+};
+
+/**
+ * @brief Generates the whole mip chain of a RGBA image, down to 1x1. Each level is filtered from the
+ * previous one in linear floating point, without rounding in between. Does not use OpenGL so it can
+ * be called from any thread.
+ * @param pixels The image's pixels, 4 unsigned bytes per pixel.
+ * @param width The image's width.
+ * @param height The image's height.
+ * @param filter The downsampling filter.
+ * @param srgb Whether the RGB channels use the SRGB color space, in which case they are filtered in
+ * linear space. The alpha channel is always linear.
+ * @param threads_count The amount of threads used to filter each level. 0 uses as many threads as
+ * the hardware supports.
+ * @return All the levels, starting with a copy of the image.
+ */
+std::vector<MipLevel> generate_mipmaps(const unsigned char* pixels,
+                                       unsigned int width,
+                                       unsigned int height,
+                                       MipmapFilter filter,
+                                       bool srgb,
+                                       unsigned int threads_count = 0);
@@ -0,0 +1,28 @@
+/***************************************************************************************************
+ * @file  ShaderName.hpp
+ * @brief Declaration of the ShaderName enum
+ **************************************************************************************************/
+
+#pragma once
+
+enum ShaderName {
+    SHADER_NONE = -1,
+
+    SHADER_POINT_MESH,
+    SHADER_LINE_MESH,
+    SHADER_BACKGROUND,
+    SHADER_FLAT,
+    SHADER_LAMBERT,
+    SHADER_BLINN_PHONG,
+    SHADER_METALLIC_ROUGHNESS,
+    SHADER_METALLIC_ROUGHNESS_NO_TANGENT,
+    SHADER_METALLIC_ROUGHNESS_DEFORMED,
+    SHADER_METALLIC_ROUGHNESS_NO_TANGENT_DEFORMED,
+    SHADER_VIRTUAL_TEXTURE_FEEDBACK,
+    SHADER_TERRAIN,
+    SHADER_POST_PROCESSING,
+    SHADER_NORMALS,
+    SHADER_WIREFRAME,
+
+    SHADER_COUNT
+};
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <filesystem>
+#include "CompressedImage.hpp"
 #include "Image.hpp"
 #include "tiny_gltf.h"
 #include "maths/vec3.hpp"
@@ -68,6 +69,19 @@ public:
                 unsigned int height,
                 const void* data);
 
+    /**
+     * @brief Creates a texture from pixel data that uses an unsigned byte per channel.
+     * @warning The responsibility of freeing the texture goes to the user, so if this instance of
+     * the Texture class already had an active texture (id != 0) and you no longer wish to use that
+     * texture, be sure to call the free method beforehand.
+     * @param width The image's width.
+     * @param height The image's height.
+     * @param channels_amount The amount of channels of the image.
+     * @param srgb Whether to set the internal format to SRGB.
+     * @param data The texture's image data, or an offset in the bound pixel unpack buffer.
+     */
+    void create(unsigned int width, unsigned int height, unsigned int channels_amount, bool srgb, const void* data);
+
     /**
      * @brief Creates a texture by assigning an image's data to a new texture.
      * @warning The responsibility of freeing the texture goes to the user, so if this instance of
@@ -78,6 +92,27 @@ public:
      */
     void create(const Image& image, bool srgb);
 
+    /**
+     * @brief Creates a texture from a block compressed image, uploading all of its mip levels.
+     * @warning The responsibility of freeing the texture goes to the user, so if this instance of
+     * the Texture class already had an active texture (id != 0) and you no longer wish to use that
+     * texture, be sure to call the free method beforehand.
+     * @param image The compressed image.
+     * @param srgb Whether to set the internal format to SRGB. Only used by BC1 and BC3.
+     * @param data The blocks of all the levels, or an offset in the bound pixel unpack buffer.
+     */
+    void create(const CompressedImage& image, bool srgb, const unsigned char* data);
+
+    /**
+     * @brief Replaces all the levels of a compressed texture, keeping its id so that all of its
+     * copies use the new levels. Used to lower or restore a texture's resolution.
+     * @param id The texture's id.
+     * @param image The compressed image the texture was created from.
+     * @param srgb Whether to set the internal format to SRGB. Only used by BC1 and BC3.
+     * @param first_level The level of the image that becomes the texture's first level.
+     */
+    static void replace_levels(unsigned int id, const CompressedImage& image, bool srgb, unsigned int first_level);
+
     /**
      * @brief Creates a texture by loading an image and assigning its data to a new texture.
      * @warning The responsibility of freeing the texture goes to the user, so if this instance of
@@ -118,7 +153,22 @@ public:
     void create(const tinygltf::Image& image, const tinygltf::Sampler& sampler, bool srgb);
 
     /**
-     * @brief Binds the texture to a specifc texture unit.
+     * @brief Sets the texture's wrapping and filtering parameters using a sampler from the tinygltf
+     * library. Parameters that the sampler leaves undefined are not changed.
+     * @param sampler The sampler that describes how the texture should be sampled.
+     */
+    void set_sampler(const tinygltf::Sampler& sampler) const;
+
+    /**
+     * @brief Makes the texture a virtual texture, whose pages are streamed by the
+     * VirtualTextureSystem. A virtual texture has no texture id and can't be bound with bind.
+     * @param image The texture's image, compressed with BC1 or BC3 in the SRGB color space.
+     */
+    void create_virtual(CompressedImage&& image);
+
+    /**
+     * @brief Binds the texture to a specifc texture unit and marks it as used this frame for the
+     * TextureResidencyManager.
      * @param texture_unit The opengl texture unit ID.
      */
     void bind(unsigned int texture_unit = 0) const;
@@ -138,7 +188,18 @@ public:
      */
     bool has_transparency() const;
 
+    /**
+     * @return Whether the texture is a virtual texture.
+     */
+    bool is_virtual() const;
+
+    /**
+     * @return The index of the texture in the VirtualTextureSystem. Only valid for virtual textures.
+     */
+    unsigned int get_virtual_texture_index() const;
+
 private:
-    unsigned int id;         ///< Texture id.
-    bool b_has_transparency; ///< Whether the texture has transparency.
+    unsigned int id;                    ///< Texture id.
+    bool b_has_transparency;            ///< Whether the texture has transparency.
+    unsigned int virtual_texture_index; ///< The index of the virtual texture, ~0u if not virtual.
 };
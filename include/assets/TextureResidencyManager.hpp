@@ -0,0 +1,158 @@
+/***************************************************************************************************
+ * @file  TextureResidencyManager.hpp
+ * @brief Declaration of the TextureResidencyManager class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "CompressedImage.hpp"
+
+/**
+ * @class TextureResidencyManager
+ * @brief Tracks the GPU memory used by every texture and the last frame it was bound. When the
+ * memory used goes over the budget, the least recently used textures are downgraded to their lower
+ * mip levels, and they are restored to their full resolution once they are bound again and there is
+ * enough room. Textures are tracked by id, so all the copies of a Texture stay valid. Only textures
+ * that can be reloaded from the texture cache can be downgraded, the others are only counted. The
+ * compressed images are read from the cache by the TextureStreamer's worker threads, the main thread
+ * only uploads them.
+ */
+class TextureResidencyManager {
+public:
+    TextureResidencyManager(const TextureResidencyManager&) = delete;
+    TextureResidencyManager& operator=(const TextureResidencyManager&) = delete;
+
+    static inline TextureResidencyManager& get() {
+        static TextureResidencyManager texture_residency_manager;
+        return texture_residency_manager;
+    }
+
+    /**
+     * @brief Starts tracking a texture.
+     * @param id The texture's id.
+     * @param size The GPU memory used by the texture in bytes.
+     */
+    static void add(unsigned int id, size_t size);
+
+    /**
+     * @brief Allows a tracked texture to be downgraded by giving it a compressed image in the texture
+     * cache to reload its levels from. The texture needs to be at full resolution.
+     * @param id The texture's id.
+     * @param cache_path The path of the compressed image the texture was created from.
+     * @param srgb Whether the texture uses the SRGB color space.
+     */
+    static void set_source(unsigned int id, const std::filesystem::path& cache_path, bool srgb);
+
+    /**
+     * @brief Stops tracking a texture.
+     * @param id The texture's id.
+     */
+    static void remove(unsigned int id);
+
+    /**
+     * @brief Marks a texture as used this frame. Called every time a texture is bound.
+     * @param id The texture's id.
+     */
+    static void touch(unsigned int id);
+
+    /**
+     * @param id The texture's id.
+     * @return The GPU memory used by the texture in bytes, 0 if it isn't tracked.
+     */
+    static size_t get_size(unsigned int id);
+
+    /**
+     * @brief Uploads the images reloaded by the worker threads, then starts reloading the downgraded
+     * textures that were used this frame if they fit in the budget, and the lower levels of the least
+     * recently used textures until the budget is respected. Needs to be called once per frame.
+     * @param upload_budget How many bytes can still be uploaded to the GPU this frame. The uploaded
+     * amount is subtracted from it.
+     */
+    static void update(size_t& upload_budget);
+
+    /**
+     * @brief Sets how much GPU memory the textures can use before they start being downgraded.
+     * @param budget The budget in bytes.
+     */
+    static void set_budget(size_t budget);
+
+    /**
+     * @return The budget in bytes.
+     */
+    static size_t get_budget();
+
+    /**
+     * @return The GPU memory used by all the tracked textures in bytes.
+     */
+    static size_t get_usage();
+
+    /**
+     * @return The amount of times a texture was downgraded.
+     */
+    static size_t get_evictions_count();
+
+    static constexpr unsigned int DOWNGRADED_SIZE = 64; ///< The maximum width of a downgraded texture.
+
+private:
+    TextureResidencyManager();
+
+    /**
+     * @struct Entry
+     * @brief A tracked texture.
+     */
+    struct Entry {
+        size_t size;                      ///< The GPU memory currently used by the texture.
+        size_t full_size;                 ///< The GPU memory used by the texture at full resolution.
+        uint64_t last_used_frame;         ///< The last frame the texture was bound.
+        std::filesystem::path cache_path; ///< The compressed image to reload from, empty if none.
+        bool srgb;                        ///< Whether the texture uses the SRGB color space.
+        bool is_downgraded;               ///< Whether only the lower mip levels are on the GPU.
+        uint64_t reload_id;               ///< The id of the reload in flight, 0 if there is none.
+        bool is_reload_downgrading;       ///< Whether the reload in flight downgrades the texture.
+    };
+
+    /**
+     * @struct LoadedImage
+     * @brief A compressed image reloaded from the cache by a worker thread.
+     */
+    struct LoadedImage {
+        unsigned int id;                      ///< The texture's id.
+        uint64_t reload_id;                   ///< The id of the reload, to ignore textures that were removed since.
+        bool is_downgraded;                   ///< Whether to only upload the lower levels.
+        std::optional<CompressedImage> image; ///< The image, empty if it couldn't be loaded.
+    };
+
+    /**
+     * @brief Starts loading the compressed image of a texture on a worker thread.
+     * @param id The texture's id.
+     * @param entry The texture's entry.
+     * @param is_downgraded Whether only the levels that are at most DOWNGRADED_SIZE wide will be
+     * uploaded.
+     */
+    void queue_reload(unsigned int id, Entry& entry, bool is_downgraded);
+
+    /**
+     * @brief Replaces the levels of a texture with the ones of its reloaded compressed image.
+     * @param loaded_image The reloaded image.
+     * @return The amount of bytes uploaded, 0 if the texture was removed or if the compressed image
+     * couldn't be loaded, in which case the texture can no longer be downgraded.
+     */
+    size_t upload(LoadedImage& loaded_image);
+
+    std::unordered_map<unsigned int, Entry> entries; ///< The tracked textures, by id.
+    size_t budget;                                   ///< The GPU memory budget in bytes.
+    size_t usage;                                    ///< The GPU memory used in bytes.
+    size_t evictions_count;                          ///< The amount of times a texture was downgraded.
+    uint64_t frame;                                  ///< The current frame.
+    uint64_t next_reload_id;                         ///< The id of the next reload.
+
+    std::mutex mutex;                      ///< Protects loaded_images.
+    std::deque<LoadedImage> loaded_images; ///< The images reloaded by the worker threads.
+};
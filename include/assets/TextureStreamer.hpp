@@ -0,0 +1,205 @@
+/***************************************************************************************************
+ * @file  TextureStreamer.hpp
+ * @brief Declaration of the TextureStreamer class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CompressedImage.hpp"
+#include "Texture.hpp"
+#include "maths/vec3.hpp"
+#include "tiny_gltf.h"
+#include "utility/SlotMap.hpp"
+
+/**
+ * @class TextureStreamer
+ * @brief Decodes encoded images (PNG, JPEG, etc...) and block compresses them on a pool of worker
+ * threads, then uploads them to the GPU through a ring of pixel buffer objects, without uploading
+ * more than a certain amount of bytes per frame. The compressed images are saved in the texture
+ * cache so that the next loads skip decoding and compressing. The textures are 1x1 placeholders
+ * in the asset manager until their image is uploaded.
+ */
+class TextureStreamer {
+public:
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    static inline TextureStreamer& get() {
+        static TextureStreamer texture_streamer;
+        return texture_streamer;
+    }
+
+    /**
+     * @brief Requests a texture to be decoded and uploaded. If a texture with the same key or the same
+     * content is already in the asset manager or already being streamed, it is used right away. The
+     * content is identified by the XXH64 hash of the encoded data and of the settings, and keys are
+     * only shared between requests with the same settings.
+     * @param key The key used to find the texture in the asset manager, usually the image's uri. If
+     * empty, the texture is only shared with textures that have the same content.
+     * @param encoded_data The encoded image data. Can be empty if a request with the same key and
+     * settings was already made.
+     * @param sampler The sampler that describes how the texture should be sampled.
+     * @param srgb Whether the texture should use the SRGB color space.
+     * @param is_normal_map Whether the texture is a tangent space normal map, which is compressed
+     * to BC5.
+     * @param placeholder_color The color of the 1x1 texture used until the image is uploaded.
+     * @param is_virtual Whether the texture should be a virtual texture, whose pages are streamed by
+     * the VirtualTextureSystem. Only used if the image is compressed to BC1 or BC3 and if the
+     * VirtualTextureSystem can take another texture.
+     * @return The handle of the texture in the asset manager, whose content is replaced once the
+     * image is uploaded. The texture has no references yet, its users acquire it.
+     * @throw std::runtime_error If the texture isn't shared and there is no image data.
+     */
+    static Handle<Texture> request(const std::string& key,
+                                   std::vector<unsigned char>&& encoded_data,
+                                   const tinygltf::Sampler& sampler,
+                                   bool srgb,
+                                   bool is_normal_map,
+                                   const vec3& placeholder_color,
+                                   bool is_virtual = false);
+
+    /**
+     * @brief Uploads the decoded images until the upload budget runs out or until all the pixel
+     * buffers are still in use by the GPU. Needs to be called every frame.
+     * @param upload_budget How many bytes can still be uploaded to the GPU this frame. The uploaded
+     * amount is subtracted from it. The last upload of a frame can overshoot it.
+     */
+    static void update(size_t& upload_budget);
+
+    /**
+     * @brief Runs a task on one of the worker threads, before the images waiting to be decoded. Used
+     * for short file reads that shouldn't stall the main thread, like reloading an image from the
+     * texture cache.
+     * @param task The task. It must not use OpenGL.
+     */
+    static void run_on_worker(std::function<void()>&& task);
+
+    /**
+     * @return The amount of images that are waiting to be decoded or uploaded.
+     */
+    static size_t get_pending_count();
+
+    /**
+     * @return The amount of requests that reused a texture with the same uri or content.
+     */
+    static size_t get_deduplicated_count();
+
+    /**
+     * @return The GPU memory saved by reusing textures, in bytes.
+     */
+    static size_t get_deduplicated_size();
+
+private:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    /**
+     * @struct Request
+     * @brief The textures waiting for an image and how to create them.
+     */
+    struct Request {
+        std::vector<std::string> keys; ///< The content key of the texture, then the uri keys of the same content.
+        Handle<Texture> texture;       ///< The texture whose placeholder is replaced once the image is uploaded.
+        tinygltf::Sampler sampler;     ///< How the texture should be sampled.
+        bool srgb;                     ///< Whether the texture should use the SRGB color space.
+        bool is_virtual;               ///< Whether the texture should be a virtual texture.
+        size_t duplicates_count;       ///< The amount of requests that were merged into this one.
+    };
+
+    /**
+     * @struct Job
+     * @brief An image to decode on a worker thread.
+     */
+    struct Job {
+        unsigned int request_id;                 ///< The id of the request waiting for the image.
+        std::vector<unsigned char> encoded_data; ///< The encoded image data.
+        uint64_t hash;                           ///< The hash of the image data and its settings.
+        bool srgb;                               ///< Whether the image uses the SRGB color space.
+        bool is_normal_map;                      ///< Whether the image is a normal map.
+    };
+
+    /**
+     * @struct DecodedImage
+     * @brief An image decoded and compressed by a worker thread.
+     */
+    struct DecodedImage {
+        unsigned int request_id;              ///< The id of the request waiting for the image.
+        std::optional<CompressedImage> image; ///< The compressed image. Empty if it couldn't be decoded.
+        std::filesystem::path cache_path;     ///< Where the image is in the cache, empty if it isn't.
+    };
+
+    /**
+     * @struct PixelBuffer
+     * @brief A pixel unpack buffer and the fence signaled when the GPU no longer reads from it.
+     */
+    struct PixelBuffer {
+        unsigned int id;  ///< The buffer's id.
+        size_t capacity;  ///< The size of the buffer's storage in bytes.
+        void* fence;      ///< The fence inserted after the last upload, nullptr if there is none.
+    };
+
+    /**
+     * @brief The loop run by the worker threads.
+     * @param stop_token Used to stop the thread.
+     */
+    void work(const std::stop_token& stop_token);
+
+    /**
+     * @brief Finds the texture with a specific key if it is already requested or in the asset manager.
+     * @param key The key, a uri key or a content key.
+     * @return The texture's handle, or an invalid handle if it isn't found.
+     */
+    Handle<Texture> share(const std::string& key);
+
+    /**
+     * @brief Starts the worker threads and creates the pixel buffers if it wasn't done already.
+     */
+    void start();
+
+    /**
+     * @brief Uploads an image using the next pixel buffer of the ring, or gives it to the
+     * VirtualTextureSystem for virtual textures.
+     * @param image The image to upload. Moved from for virtual textures.
+     * @param cache_path Where the image is in the texture cache, empty if it isn't.
+     * @param request The request waiting for the image.
+     * @return Whether the image was uploaded, false if the pixel buffer is still in use by the GPU.
+     */
+    bool upload(CompressedImage& image, const std::filesystem::path& cache_path, const Request& request);
+
+    /**
+     * @brief Replaces the placeholder of a request in the asset manager with the uploaded texture.
+     * @param texture The uploaded texture.
+     * @param request The request waiting for the texture.
+     */
+    static void assign_texture(const Texture& texture, const Request& request);
+
+    static constexpr unsigned int PIXEL_BUFFERS_COUNT = 3;
+    static constexpr MipmapFilter MIPMAP_FILTER = MipmapFilter::KAISER;
+
+    std::vector<std::jthread> workers;       ///< The threads decoding the images.
+    std::mutex mutex;                        ///< Protects jobs, tasks and decoded_images.
+    std::condition_variable_any jobs_cv;     ///< Notified when a job or a task is added.
+    std::deque<Job> jobs;                    ///< The images waiting to be decoded.
+    std::deque<std::function<void()>> tasks; ///< The tasks waiting to be run, see run_on_worker.
+    std::deque<DecodedImage> decoded_images; ///< The images waiting to be uploaded.
+
+    std::unordered_map<unsigned int, Request> requests; ///< The pending requests by id. Main thread only.
+    std::unordered_map<std::string, unsigned int> keys; ///< The id of the pending request of each key.
+    unsigned int next_request_id;                       ///< The id of the next request.
+
+    PixelBuffer pixel_buffers[PIXEL_BUFFERS_COUNT]; ///< The ring of pixel unpack buffers.
+    unsigned int next_pixel_buffer;                 ///< The index of the next pixel buffer to use.
+
+    size_t deduplicated_count; ///< The amount of requests that reused a texture.
+    size_t deduplicated_size;  ///< The GPU memory saved by reusing textures, in bytes.
+};
@@ -0,0 +1,185 @@
+/***************************************************************************************************
+ * @file  VirtualTextureSystem.hpp
+ * @brief Declaration of the VirtualTextureSystem class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "CompressedImage.hpp"
+#include "Shader.hpp"
+
+/**
+ * @class VirtualTextureSystem
+ * @brief Virtual texturing for block compressed textures. Each texture is split into pages of
+ * PAGE_SIZE x PAGE_SIZE texels on each of its mip levels. A low resolution feedback pass writes the
+ * pages that are needed on screen, which are then copied from the CPU side images into the slots
+ * of a fixed size physical atlas, evicting the least recently used pages. Every texture has a page
+ * table whose entries give the slot of a page, or the slot of its closest resident ancestor. The
+ * coarsest page of every texture always stays resident so that there is always something to sample.
+ */
+class VirtualTextureSystem {
+public:
+    VirtualTextureSystem(const VirtualTextureSystem&) = delete;
+    VirtualTextureSystem& operator=(const VirtualTextureSystem&) = delete;
+
+    static inline VirtualTextureSystem& get() {
+        static VirtualTextureSystem virtual_texture_system;
+        return virtual_texture_system;
+    }
+
+    /**
+     * @brief Enables or disables virtual texturing for the textures that are streamed from now on.
+     * @param is_enabled Whether virtual texturing is enabled.
+     */
+    static void set_enabled(bool is_enabled);
+
+    /**
+     * @return Whether virtual texturing is enabled.
+     */
+    static bool is_enabled();
+
+    /**
+     * @brief Adds a virtual texture and makes its coarsest page resident.
+     * @param image The texture's image, compressed with BC1 or BC3 in the SRGB color space.
+     * @return The index of the virtual texture.
+     * @throw std::runtime_error If the image isn't BC1 or BC3 or is too large, or if can_add_texture
+     * is false.
+     */
+    static unsigned int add_texture(CompressedImage&& image);
+
+    /**
+     * @return Whether another virtual texture can be added. The textures past MAX_TEXTURES_COUNT, or
+     * once the coarsest pages fill the atlas, need to be regular textures.
+     */
+    static bool can_add_texture();
+
+    /**
+     * @brief Binds a virtual texture's page table to unit 3 and the physical atlas to unit 4 and sets
+     * the uniforms used by the sample_virtual_texture function of the shaders.
+     * @param texture_index The index of the virtual texture.
+     * @param shader The shader whose uniforms need to be updated.
+     */
+    static void bind(unsigned int texture_index, const Shader* shader);
+
+    /**
+     * @brief Binds the feedback framebuffer if there are virtual textures and the last feedback was
+     * read back.
+     * @return Whether the feedback pass needs to be drawn, in which case end_feedback_pass needs to
+     * be called afterward.
+     */
+    static bool begin_feedback_pass();
+
+    /**
+     * @brief Starts reading the feedback back asynchronously and restores the viewport.
+     */
+    static void end_feedback_pass();
+
+    /**
+     * @brief Processes the feedback once it is read back, streams the missing pages into the atlas
+     * and updates the page tables. Needs to be called every frame.
+     * @param upload_budget How many bytes can still be uploaded to the GPU this frame. The uploaded
+     * amount is subtracted from it.
+     */
+    static void update(size_t& upload_budget);
+
+    /**
+     * @return The amount of pages that are resident in the physical atlas.
+     */
+    static size_t get_resident_pages_count();
+
+    /**
+     * @return The amount of slots in the physical atlas.
+     */
+    static unsigned int get_slots_count();
+
+    static constexpr unsigned int PAGE_SIZE = 128;            ///< The width of a page in texels.
+    static constexpr unsigned int PAGE_BORDER = 4;            ///< The border around pages, for filtering.
+    static constexpr unsigned int SLOTS_PER_SIDE = 32;        ///< The amount of slots per side of the atlas.
+    static constexpr unsigned int FEEDBACK_DOWNSCALE = 8;     ///< How much smaller the feedback pass is.
+    static constexpr unsigned int MAX_TEXTURES_COUNT = 65535; ///< The feedback stores the texture index + 1 on 16 bits.
+
+private:
+    VirtualTextureSystem();
+    ~VirtualTextureSystem();
+
+    /**
+     * @struct VirtualTexture
+     * @brief A texture and its page table.
+     */
+    struct VirtualTexture {
+        CompressedImage image;                    ///< The texture's image, with all its mip levels.
+        unsigned int page_table;                  ///< The page table's texture id.
+        unsigned int page_table_size;             ///< The width of the page table's first level.
+        unsigned int max_level;                   ///< The level that fits in a single page.
+        std::vector<std::vector<uint32_t>> pages; ///< The slot + 1 of each page of each level, 0 if not resident.
+        bool is_page_table_dirty;                 ///< Whether the page table needs to be uploaded.
+    };
+
+    /**
+     * @struct Slot
+     * @brief A slot of the physical atlas.
+     */
+    struct Slot {
+        uint64_t page_key;        ///< The key of the page in the slot.
+        uint64_t last_used_frame; ///< The last frame the page was needed.
+        bool is_used;             ///< Whether a page is in the slot.
+        bool is_pinned;           ///< Whether the page can never be evicted.
+    };
+
+    /**
+     * @brief Creates the physical atlas and the feedback resources if it wasn't done already.
+     */
+    void init();
+
+    /**
+     * @brief Marks a page and its ancestors as needed this frame.
+     * @param page_key The key of the page.
+     * @param missing_pages Where the pages that aren't resident are added.
+     */
+    void touch_page(uint64_t page_key, std::vector<uint64_t>& missing_pages);
+
+    /**
+     * @brief Copies a page's blocks into a slot of the physical atlas.
+     * @param page_key The key of the page.
+     * @param slot_index The index of the slot.
+     */
+    void load_page(uint64_t page_key, unsigned int slot_index);
+
+    /**
+     * @brief Finds a free slot or evicts the least recently used page that wasn't needed this frame.
+     * @return The slot's index, or INVALID_SLOT if all slots are in use.
+     */
+    unsigned int acquire_slot();
+
+    /**
+     * @brief Resolves the page table entries of a texture and uploads its page table.
+     * @param texture The virtual texture.
+     */
+    static void upload_page_table(VirtualTexture& texture);
+
+    /**
+     * @brief Creates the feedback framebuffer at a specific resolution.
+     */
+    void create_feedback_framebuffer(unsigned int width, unsigned int height);
+
+    static constexpr unsigned int INVALID_SLOT = ~0u;
+
+    bool b_is_enabled;                                         ///< Whether virtual texturing is enabled.
+    std::vector<VirtualTexture> textures;                      ///< The virtual textures.
+    std::vector<Slot> slots;                                   ///< The slots of the physical atlas.
+    std::unordered_map<uint64_t, unsigned int> resident_pages; ///< The slot of each resident page.
+    uint64_t frame;                                            ///< The current frame, used for the LRU.
+    unsigned int atlas;                                        ///< The physical atlas' texture id.
+
+    unsigned int feedback_FBO;     ///< The feedback pass' framebuffer.
+    unsigned int feedback_texture; ///< The feedback pass' color attachment.
+    unsigned int feedback_RBO;     ///< The feedback pass' depth attachment.
+    unsigned int feedback_PBO;     ///< The buffer the feedback is read back to.
+    unsigned int feedback_width;   ///< The width of the feedback framebuffer.
+    unsigned int feedback_height;  ///< The height of the feedback framebuffer.
+    void* feedback_fence;          ///< Signaled when the feedback is read back, nullptr if none is pending.
+};
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "Frustum.hpp"
 #include "maths/Transform.hpp"
 
@@ -33,6 +35,10 @@ struct AABB {
 
     void set(const vec3& min, const vec3& max);
     void set(const AABB& aabb, const Transform& transform);
+    void set(const AABB& aabb, const mat4& model);
+    void set(const AABB& aabb, const affine3x4& model);
+
+    static void transform(std::span<const AABB> aabbs, std::span<const affine3x4> models, std::span<AABB> results);
 
     vec4 min_point;
     vec4 max_point;
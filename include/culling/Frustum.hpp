@@ -13,7 +13,20 @@
  * @brief
  */
 struct Frustum {
-    void update(const Camera& camera);
+    /**
+     * @brief Updates the frustum from a camera.
+     * @param camera The camera.
+     */
+    void update(const Camera& camera) {
+        update(camera.get_view_projection_matrix(), camera.get_inverse_projection_matrix());
+    }
+
+    /**
+     * @brief Updates the frustum from matrices, which doesn't need a camera and so a window.
+     * @param view_projection The view projection matrix.
+     * @param inverse_projection The matrix transforming projection space points to view space.
+     */
+    void update(const mat4& view_projection, const mat4& inverse_projection);
 
     mat4 view_projection;
     vec4 points[8];
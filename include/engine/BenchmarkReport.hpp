@@ -0,0 +1,73 @@
+/***************************************************************************************************
+ * @file  BenchmarkReport.hpp
+ * @brief Declaration of the BenchmarkReport class and the TimingStatistics struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "engine/FrameTimer.hpp"
+
+/**
+ * @struct TimingStatistics
+ * @brief The distribution of a timing over the frames of a benchmark, in milliseconds.
+ */
+struct TimingStatistics {
+    std::string name; ///< What is timed: a stage, "cpu_total" or "gpu_total".
+    float mean;       ///< The average.
+    float p50;        ///< The median.
+    float p95;        ///< The 95th percentile.
+    float p99;        ///< The 99th percentile.
+    float max;        ///< The maximum.
+};
+
+/**
+ * @class BenchmarkReport
+ * @brief Computes the statistics of the frames recorded by a benchmark, writes them to CSV and JSON
+ * files and compares them against the JSON report of a baseline.
+ */
+class BenchmarkReport {
+public:
+    /**
+     * @brief Computes the statistics of the frames.
+     * @param scene_name The name of the benchmarked scene.
+     * @param records The records of the frames.
+     */
+    BenchmarkReport(const std::string& scene_name, const std::vector<FrameRecord>& records);
+
+    /**
+     * @brief Writes the timings of every frame to a CSV file, one row per frame.
+     * @param path The path of the CSV file.
+     */
+    void write_csv(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Writes the statistics to a JSON file, which can be used as a baseline.
+     * @param path The path of the JSON file.
+     */
+    void write_json(const std::filesystem::path& path) const;
+
+    /**
+     * @brief Prints the statistics as a table.
+     * @param stream Where to print them.
+     */
+    void print(std::ostream& stream) const;
+
+    /**
+     * @brief Compares the median and 95th percentile of every timing against a baseline and prints
+     * the differences. Timings below 0.05ms are too noisy to be compared.
+     * @param baseline_path The path of the baseline's JSON report.
+     * @param threshold How much slower than the baseline a timing can be, 0.1 being 10%.
+     * @param stream Where to print the comparison.
+     * @return Whether no timing regressed.
+     */
+    bool compare(const std::filesystem::path& baseline_path, float threshold, std::ostream& stream) const;
+
+private:
+    std::string scene_name;                   ///< The name of the benchmarked scene.
+    std::vector<FrameRecord> records;         ///< The records of the frames.
+    std::vector<TimingStatistics> statistics; ///< The statistics of each stage, the CPU and the GPU.
+};
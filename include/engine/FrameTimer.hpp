@@ -0,0 +1,145 @@
+/***************************************************************************************************
+ * @file  FrameTimer.hpp
+ * @brief Declaration of the FrameTimer class and the FrameStage enum
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+/**
+ * @enum FrameStage
+ * @brief The stages of a frame whose CPU time is measured.
+ */
+enum FrameStage : unsigned char {
+    FRAME_STAGE_EVENTS,
+    FRAME_STAGE_LOADING,
+    FRAME_STAGE_ANIMATIONS,
+    FRAME_STAGE_TRANSFORMS,
+    FRAME_STAGE_AABBS,
+    FRAME_STAGE_CULLING,
+    FRAME_STAGE_SUBMISSION,
+    FRAME_STAGE_IMGUI,
+    FRAME_STAGE_SWAP,
+
+    FRAME_STAGE_COUNT
+};
+
+/**
+ * @brief Returns the name of a frame stage, used as a column in the benchmark reports.
+ * @param stage The stage.
+ * @return The stage's name.
+ */
+const char* get_frame_stage_name(FrameStage stage);
+
+/**
+ * @struct FrameRecord
+ * @brief The timings of a frame, in milliseconds.
+ */
+struct FrameRecord {
+    std::array<float, FRAME_STAGE_COUNT> stages; ///< The CPU time of each stage.
+    float cpu_total;                             ///< The CPU time of the whole frame.
+    float gpu_total;                             ///< The GPU time of the frame, or -1 if unknown.
+};
+
+/**
+ * @class FrameTimer
+ * @brief Records the CPU time of each stage of the frames and their GPU time while it's enabled.
+ * The GPU time is measured with GL_TIME_ELAPSED queries that are read a few frames later so that
+ * the CPU never waits for the GPU.
+ */
+class FrameTimer {
+public:
+    FrameTimer(const FrameTimer&) = delete;            ///< Delete copy constructor.
+    FrameTimer& operator=(const FrameTimer&) = delete; ///< Deleted copy operator.
+
+    /**
+     * @brief Access the FrameTimer singleton.
+     * @return A reference to the FrameTimer singleton.
+     */
+    static inline FrameTimer& get() {
+        static FrameTimer frame_timer;
+        return frame_timer;
+    }
+
+    /**
+     * @struct Scope
+     * @brief Measures the time of a stage until it falls out of scope. A stage can be measured in
+     * several scopes in the same frame, their times are summed.
+     */
+    struct Scope {
+        /**
+         * @brief Starts measuring a stage.
+         * @param stage The stage.
+         */
+        explicit Scope(FrameStage stage);
+
+        /**
+         * @brief Adds the time since the construction to the stage.
+         */
+        ~Scope();
+
+        const FrameStage stage;                                 ///< The measured stage.
+        const std::chrono::steady_clock::time_point start_time; ///< When the scope started.
+    };
+
+    /**
+     * @brief Starts or stops recording. Starting clears the previous records.
+     * @param is_enabled Whether the frames are recorded.
+     */
+    static void set_enabled(bool is_enabled);
+
+    /**
+     * @return Whether the frames are recorded.
+     */
+    static bool is_enabled();
+
+    /**
+     * @brief Starts a new frame. Needs to be called before any OpenGL command of the frame.
+     */
+    static void begin_frame();
+
+    /**
+     * @brief Ends the current frame and reads the GPU times of the previous frames that are ready.
+     */
+    static void end_frame();
+
+    /**
+     * @brief Waits for the GPU times of all the recorded frames.
+     */
+    static void resolve();
+
+    /**
+     * @return The records of the frames since recording was enabled.
+     */
+    static const std::vector<FrameRecord>& get_records();
+
+private:
+    /**
+     * @brief Creates the timer queries.
+     */
+    FrameTimer();
+
+    /**
+     * @brief Deletes the timer queries.
+     */
+    ~FrameTimer();
+
+    /**
+     * @brief Reads the GPU time of a recorded frame.
+     * @param frame The frame's index in the records.
+     * @param wait Whether to wait for the result if it isn't available.
+     * @return Whether the time was read.
+     */
+    bool read_query(size_t frame, bool wait);
+
+    static constexpr unsigned int QUERIES_COUNT = 4; ///< The amount of frames the GPU can be behind.
+
+    bool b_is_enabled;                                 ///< Whether the frames are recorded.
+    std::vector<FrameRecord> records;                  ///< The records of the frames.
+    std::chrono::steady_clock::time_point frame_start; ///< When the current frame started.
+    std::array<unsigned int, QUERIES_COUNT> queries;   ///< The timer queries, used in turn.
+    size_t first_pending_frame;                        ///< The first frame whose GPU time wasn't read.
+};
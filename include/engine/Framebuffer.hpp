@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <filesystem>
 #include "assets/Texture.hpp"
 #include "maths/vec2.hpp"
 
@@ -26,6 +27,13 @@ public:
 
     vec2 get_resolution() const;
 
+    /**
+     * @brief Reads the framebuffer's pixels back and writes them to a PNG file. The colors are
+     * clamped to [0, 1] and the alpha is dropped.
+     * @param path The path of the PNG file.
+     */
+    void save_png(const std::filesystem::path& path) const;
+
 private:
     unsigned int FBO; ///< Frame Buffer Object.
     unsigned int RBO; ///< Rendering Buffer Object.
@@ -8,7 +8,7 @@
 #include <string>
 #include <vector>
 
-#include "assets/AssetManager.hpp"
+#include "assets/ShaderName.hpp"
 
 constexpr unsigned int INVALID_INDEX = ~0u;
 
@@ -32,6 +32,8 @@ struct Node {
     unsigned int color_index;    ///< The index of the node's color. INVALID_INDEX if no color.
     unsigned int scene_index;    ///< The index of the node's scene. INVALID_INDEX if not a scene.
     unsigned int material_index; ///< The index of the node's material. INVALID_INDEX if no material.
+    unsigned int skin_index;     ///< The index of the node's skin. INVALID_INDEX if not skinned.
+    unsigned int morph_index;    ///< The index of the node's morph. INVALID_INDEX if it has no morph targets.
 
     bool is_visible;  ///< Whether the node is visible.
     bool is_selected; ///< Whether the node is selected.
@@ -0,0 +1,218 @@
+/***************************************************************************************************
+ * @file  Profiler.hpp
+ * @brief Declaration of the Profiler class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Profiler
+ * @brief A hierarchical profiler of scoped zones. CPU zones can be opened on any thread, each thread
+ * writes its zones to its own lock-free ring buffer which the main thread drains once per frame. GPU
+ * zones are measured with GL_TIMESTAMP queries that are read a few frames later, so the CPU never
+ * waits for the GPU. The last frames are kept to be shown in a flame graph and exported as a Chrome
+ * trace that can be opened in chrome://tracing or Perfetto.
+ */
+class Profiler {
+public:
+    Profiler(const Profiler&) = delete;            ///< Delete copy constructor.
+    Profiler& operator=(const Profiler&) = delete; ///< Deleted copy operator.
+
+    /**
+     * @brief Access the Profiler singleton.
+     * @return A reference to the Profiler singleton.
+     */
+    static inline Profiler& get() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    /**
+     * @struct Zone
+     * @brief Measures the CPU time of a scope on the current thread.
+     */
+    struct Zone {
+        /**
+         * @brief Opens the zone.
+         * @param name The name of the zone, which needs to outlive the profiler, like a literal.
+         */
+        explicit Zone(const char* name);
+
+        /**
+         * @brief Closes the zone and writes it to the thread's ring buffer.
+         */
+        ~Zone();
+
+        const char* const name; ///< The name of the zone.
+        int64_t start;          ///< When the zone was opened in nanoseconds, or -1 if it isn't recorded.
+    };
+
+    /**
+     * @struct GPUZone
+     * @brief Measures the GPU time of the OpenGL commands issued in a scope. Can only be used on the
+     * thread owning the OpenGL context.
+     */
+    struct GPUZone {
+        /**
+         * @brief Opens the zone.
+         * @param name The name of the zone, which needs to outlive the profiler, like a literal.
+         */
+        explicit GPUZone(const char* name);
+
+        /**
+         * @brief Closes the zone.
+         */
+        ~GPUZone();
+
+        /// The index of the zone in the pending GPU zones, which don't move until the end of the
+        /// frame, or -1 if it isn't recorded.
+        size_t zone_index;
+    };
+
+    /**
+     * @brief Starts or stops recording zones. The profiler is disabled until then, so that it
+     * doesn't weigh on the frames when it isn't looked at.
+     * @param is_enabled Whether zones are recorded.
+     */
+    static void set_enabled(bool is_enabled);
+
+    /**
+     * @return Whether zones are recorded.
+     */
+    static bool is_enabled();
+
+    /**
+     * @brief Names the current thread in the flame graph and the traces.
+     * @param name The thread's name.
+     */
+    static void set_thread_name(const std::string& name);
+
+    /**
+     * @brief Ends the current frame: drains the threads' ring buffers, reads the GPU zones whose
+     * queries are ready and starts a new frame. Needs to be called once per frame on the main thread.
+     */
+    static void end_frame();
+
+    /**
+     * @brief Draws the profiler's window with the flame graph of a frame.
+     * @param is_open Whether the window is open, set to false when it's closed.
+     */
+    static void add_imgui_window(bool* is_open);
+
+    /**
+     * @brief Writes the recorded frames to a file in the Chrome trace event format.
+     * @param path The path of the JSON file.
+     */
+    static void export_chrome_trace(const std::filesystem::path& path);
+
+private:
+    /**
+     * @brief Initializes the first frame.
+     */
+    Profiler();
+
+    /**
+     * @brief Deletes the GPU queries.
+     */
+    ~Profiler();
+
+    /**
+     * @struct Event
+     * @brief A closed zone.
+     */
+    struct Event {
+        const char* name;   ///< The name of the zone.
+        int64_t start;      ///< When the zone was opened in nanoseconds.
+        int64_t end;        ///< When the zone was closed in nanoseconds.
+        unsigned int depth; ///< The amount of zones the zone is nested in.
+        unsigned int track; ///< The index of the thread in threads, or GPU_TRACK.
+    };
+
+    /**
+     * @struct ThreadBuffer
+     * @brief The ring buffer of a thread. The thread is the only writer of head and the main thread
+     * the only writer of tail, so no lock is needed. Zones are dropped when the buffer is full.
+     */
+    struct ThreadBuffer {
+        static constexpr size_t CAPACITY = 4096; ///< The amount of events, a power of 2.
+
+        std::array<Event, CAPACITY> events; ///< The events.
+        std::atomic<size_t> head = 0;       ///< The amount of events written.
+        std::atomic<size_t> tail = 0;       ///< The amount of events read.
+        unsigned int depth = 0;             ///< The amount of currently open zones.
+        std::string name;                   ///< The thread's name.
+    };
+
+    /**
+     * @struct PendingGPUZone
+     * @brief A GPU zone whose queries aren't read yet.
+     */
+    struct PendingGPUZone {
+        const char* name;                    ///< The name of the zone.
+        std::array<unsigned int, 2> queries; ///< The timestamp queries at the start and end of the zone.
+        unsigned int depth;                  ///< The amount of GPU zones the zone is nested in.
+        uint64_t frame;                      ///< The frame the zone was recorded in.
+        bool is_closed;                      ///< Whether the end query was issued.
+    };
+
+    /**
+     * @struct Frame
+     * @brief The zones of a frame.
+     */
+    struct Frame {
+        uint64_t index;            ///< The index of the frame since the start.
+        int64_t start;             ///< When the frame started in nanoseconds.
+        int64_t end;               ///< When the frame ended in nanoseconds.
+        std::vector<Event> events; ///< The zones closed during the frame.
+    };
+
+    /**
+     * @return The current time in nanoseconds.
+     */
+    static int64_t get_time();
+
+    /**
+     * @return The current thread's ring buffer, which is registered the first time.
+     */
+    ThreadBuffer& get_thread_buffer();
+
+    /**
+     * @brief Reads the GPU zones whose queries are ready and adds them to their frame.
+     */
+    void read_gpu_zones();
+
+    /**
+     * @brief Draws the zones of a frame as a flame graph, one band per track.
+     * @param frame The frame.
+     */
+    void draw_flame_graph(const Frame& frame) const;
+
+    static constexpr unsigned int GPU_TRACK = 0xFFFFFFFFu; ///< The track of the GPU zones.
+    static constexpr size_t FRAMES_COUNT = 240;            ///< The amount of frames kept.
+
+    std::atomic<bool> b_is_enabled; ///< Whether zones are recorded.
+
+    mutable std::mutex threads_mutex;                   ///< Guards threads and the threads' names.
+    std::vector<std::unique_ptr<ThreadBuffer>> threads; ///< The ring buffer of every thread.
+
+    std::deque<Frame> frames; ///< The last frames, the back one being the current frame.
+    uint64_t frames_count;    ///< The amount of frames since the start.
+
+    std::vector<PendingGPUZone> gpu_zones;  ///< The GPU zones whose queries aren't read yet.
+    std::vector<unsigned int> free_queries; ///< The timestamp queries that can be reused.
+    unsigned int gpu_depth;                 ///< The amount of currently open GPU zones.
+    int64_t gpu_time_offset;                ///< Converts GPU timestamps to CPU times.
+
+    bool is_paused;          ///< Whether the flame graph stays on the selected frame.
+    uint64_t selected_frame; ///< The index of the frame shown in the flame graph.
+};
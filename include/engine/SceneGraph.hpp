@@ -5,8 +5,15 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include "Node.hpp"
+#include "animation/Animation.hpp"
+#include "animation/AnimationSampler.hpp"
+#include "animation/MorphTargets.hpp"
+#include "animation/Skin.hpp"
 #include "assets/AssetManager.hpp"
 #include "assets/GLTF.hpp"
 #include "assets/Shader.hpp"
@@ -20,19 +27,131 @@ bool is_mouse_hovering_imgui();
 class SceneGraph {
 public:
     SceneGraph();
+    ~SceneGraph();
+
+    SceneGraph(const SceneGraph&) = delete;
+    SceneGraph& operator=(const SceneGraph&) = delete;
 
     Node& operator[](unsigned int node_index);
 
     void draw(const Frustum& frustum);
 
+    /**
+     * @brief Draws the visible meshes with the virtual texture feedback shader, writing the pages of
+     * the virtual textures they need. Needs to be called between VirtualTextureSystem's
+     * begin_feedback_pass and end_feedback_pass, after draw updated the transforms.
+     * @param frustum The camera's frustum.
+     */
+    void draw_virtual_texture_feedback(const Frustum& frustum);
+
     unsigned int add_simple_node(ADD_NODE_PARAMETERS);
     unsigned int add_mesh_node(ADD_NODE_PARAMETERS, unsigned int mesh_index, ShaderName shader_name);
-    unsigned int add_mesh_node(ADD_NODE_PARAMETERS, const Mesh* mesh, ShaderName shader_name);
+
+    /**
+     * @brief Adds a mesh node, which acquires the mesh until the scene graph is destroyed.
+     * @param mesh The handle of a mesh in the asset manager.
+     * @param shader_name The shader the mesh is drawn with.
+     * @return The index of the node.
+     */
+    unsigned int add_mesh_node(ADD_NODE_PARAMETERS, Handle<Mesh> mesh, ShaderName shader_name);
     unsigned int add_gltf_scene_node(ADD_NODE_PARAMETERS, const std::filesystem::path& scene_path);
 
-    unsigned int add_mesh(const Mesh* mesh);
+    /**
+     * @brief Adds a scene node and starts loading a glTF scene on a background thread. Returns
+     * immediately, the scene's nodes, meshes and textures are added progressively by
+     * update_loading_scenes.
+     * @return The index of the scene node.
+     */
+    unsigned int add_gltf_scene_node_async(ADD_NODE_PARAMETERS, const std::filesystem::path& scene_path);
+
+    /**
+     * @brief Advances the scenes that are being loaded asynchronously, the texture streamer, the
+     * virtual texture system and the texture residency manager, uploading at most
+     * upload_budget_per_frame bytes to the GPU. Needs to be called once per frame.
+     */
+    void update_loading_scenes();
+
+    /**
+     * @brief Adds a mesh that nodes can refer to by index, which acquires it until the scene graph
+     * is destroyed.
+     * @param mesh The handle of a mesh in the asset manager.
+     * @return The index of the mesh in meshes.
+     */
+    unsigned int add_mesh(Handle<Mesh> mesh);
+
+    /**
+     * @brief Finds a mesh with the same content that was already registered by a glTF scene. The
+     * registered meshes are acquired by the scenes in gltf_scenes, which live as long as the scene
+     * graph, and so do their mapped files. The registered mesh with the same hash is compared with
+     * the mesh byte for byte before being reused.
+     * @param mesh The mesh, whose buffers must not be bound yet.
+     * @param content_hash The mesh's content hash, see Mesh::get_content_hash.
+     * @return The handle of the existing mesh, or an invalid handle if there is none.
+     */
+    Handle<Mesh> find_duplicate_mesh(const Mesh& mesh, uint64_t content_hash);
+
+    /**
+     * @brief Registers a mesh so that later glTF meshes with the same content reuse it.
+     * @param mesh The handle of the mesh in the asset manager.
+     * @param content_hash The mesh's content hash, see Mesh::get_content_hash.
+     */
+    void register_mesh_content(Handle<Mesh> mesh, uint64_t content_hash);
+
+    /**
+     * @brief Adds a skin, whose joint matrices are computed every frame and uploaded for the
+     * skinned vertex shaders.
+     * @param skin The skin. Its palette offset is set by the scene graph.
+     * @return The index of the skin.
+     */
+    unsigned int add_skin(Skin&& skin);
+
+    /**
+     * @brief Adds an animation, which is played every frame by update_animations.
+     * @return The index of the animation.
+     */
+    unsigned int add_animation(Animation&& animation);
+
+    /**
+     * @brief Advances the animations that are playing and samples all their tracks in one batch into
+     * the local transforms of the nodes they drive. Needs to be called once per frame before draw.
+     * @param delta The time since the last frame in seconds.
+     */
+    void update_animations(float delta);
+
+    /**
+     * @brief Adds the morph target weights of a node. They can be shared by several morphs, like the
+     * primitives of a glTF mesh, and be animated by weights tracks.
+     * @param weights The initial weights.
+     * @return The index of the first weight in morph_weights.
+     */
+    unsigned int add_morph_weights(std::span<const float> weights);
+
+    /**
+     * @brief Gives morph targets to a mesh node. Its mesh is then deformed by the deformed shaders.
+     * @param node_index The index of the mesh node.
+     * @param targets The targets of the node's mesh. They need to outlive the scene graph.
+     * @param weights_offset The index of the first weight of the targets in morph_weights.
+     * @return The index of the morph.
+     */
+    unsigned int add_morph(unsigned int node_index, const MorphTargets* targets, unsigned int weights_offset);
+
+    /**
+     * @brief Computes the positions of a morphed or skinned mesh node on the CPU, with the weights and
+     * the joint matrices of the last drawn frame. Only the active morph targets are applied.
+     * @param node_index The index of the mesh node.
+     * @param positions Where the positions are written, one per vertex with a w of 1.
+     */
+    void get_deformed_positions(unsigned int node_index, std::vector<vec4>& positions) const;
+
     unsigned int add_color_to_node(unsigned int node_index, const vec4& color);
-    unsigned int add_material_to_node(unsigned int node_index, Material* material);
+
+    /**
+     * @brief Gives a material to a node, which acquires it until the scene graph is destroyed.
+     * @param node_index The index of the node.
+     * @param material The handle of a material in the asset manager.
+     * @return The index of the material in materials.
+     */
+    unsigned int add_material_to_node(unsigned int node_index, Handle<Material> material);
 
     void add_imgui_node_tree();
     void add_object_editor_to_imgui_window();
@@ -45,31 +164,108 @@ public:
     std::vector<AABB> AABBs;
     std::vector<int> is_in_frustum;
 
-    std::vector<const Mesh*> meshes;
-    std::vector<Material*> materials;
+    std::vector<Handle<Mesh>> meshes;        ///< The meshes of the mesh nodes, acquired by the scene graph.
+    std::vector<Handle<Material>> materials; ///< The materials of the nodes, acquired by the scene graph.
     std::vector<vec4> colors;
-    std::vector<GLTF::Scene> gltf_scenes;
+    std::vector<std::unique_ptr<GLTF::Scene>> gltf_scenes;
+    std::vector<Skin> skins;
+    std::vector<Animation> animations;
+    std::vector<affine3x4> joint_matrices; ///< The joint matrices of every skin, updated each frame.
+    std::vector<Morph> morphs;
+    std::vector<float> morph_weights; ///< The morph target weights of every node, updated by the animations.
 
     bool are_AABBs_drawn;
     bool are_normals_drawn;
     bool is_wireframe_drawn;
+    bool is_camera_relative; ///< Whether nodes are drawn relative to the camera, for scenes far from the origin.
     unsigned int total_drawn_objects;
+    size_t upload_budget_per_frame; ///< How many bytes loading scenes can upload to the GPU each frame.
+    size_t deduplicated_meshes_count; ///< The amount of glTF meshes that reused an existing mesh.
+    size_t deduplicated_meshes_size;  ///< The amount of bytes that weren't uploaded thanks to it.
 
 private:
     unsigned int light_node_index;
     vec3 light_position;
     vec3 light_color;
 
-    void draw(const Frustum& frustum, unsigned int node_index);
-    void draw(const mat4& view_projection, const Shader& shader, unsigned int node_index) const;
+    dvec3 rendering_origin;        ///< The camera's position when the nodes are drawn relative to it.
+    mat4 relative_view_projection; ///< The camera's view projection matrix without its translation.
+
+    /**
+     * @brief Updates the rendering origin and the relative view projection matrix from the active
+     * camera, for the camera relative mode.
+     */
+    void update_rendering_origin();
+
+    /**
+     * @brief Appends the visible nodes of a subtree whose AABB is in the frustum to visible_nodes,
+     * parents first.
+     * @param frustum The frustum.
+     * @param node_index The root of the subtree.
+     */
+    void cull(const Frustum& frustum, unsigned int node_index);
+
+    /**
+     * @brief Draws a node that passed culling and its AABB if it's drawn.
+     * @param frustum The frustum.
+     * @param node_index The node.
+     */
+    void submit(const Frustum& frustum, unsigned int node_index);
+
+    void draw_virtual_texture_feedback(const Frustum& frustum, const Shader& shader, unsigned int node_index) const;
+    /**
+     * @brief Draws a node with a shader.
+     * @param view_projection The view projection matrix.
+     * @param shader The shader.
+     * @param node_index The node.
+     * @param is_material_bound Whether the node's material sets its uniforms and binds its textures.
+     */
+    void draw(const mat4& view_projection, const Shader& shader, unsigned int node_index, bool is_material_bound = true) const;
 
     void update_transform_and_children(unsigned int node_index = 0);
     void force_update_transform_and_children(unsigned int node_index = 0);
     void update_AABBs(unsigned int node_index = 0);
 
+    /**
+     * @brief Computes the joint matrices of every skin from the global models of their joints and
+     * uploads them to the shader storage buffer bound to JOINT_MATRICES_BINDING.
+     */
+    void update_skins();
+
+    /**
+     * @brief Uploads the morph deltas if morphs were added and the morph weights to the shader
+     * storage buffers bound to the MORPH_*_BINDING bindings. The morphs with at most
+     * CPU_MORPH_MAX_ACTIVE_TARGETS active targets are blended on the CPU, and their blended deltas
+     * are uploaded when their weights changed.
+     */
+    void update_morphs();
+
     unsigned int add_node(ADD_NODE_PARAMETERS, Node::Type type);
 
     void add_node_to_imgui_node_tree(unsigned int node_index);
 
     unsigned int selected_node;
+    Handle<Mesh> wireframe_cube_mesh; ///< The mesh used to draw the AABBs.
+    std::vector<unsigned int> visible_nodes; ///< The nodes that passed culling this frame.
+
+    std::unordered_map<uint64_t, Handle<Mesh>> meshes_by_content; ///< The glTF meshes, by content hash.
+
+    static constexpr unsigned int JOINT_MATRICES_BINDING = 2; ///< The binding of the joint matrices' buffer.
+    unsigned int joint_matrices_SSBO; ///< The shader storage buffer the joint matrices are uploaded to.
+    mutable JointPalette picking_palette; ///< The palette get_deformed_positions skins with, reused to keep its memory.
+    AnimationSampler animation_sampler; ///< Samples the playing animations in one batch each frame.
+
+    static constexpr unsigned int MORPH_RANGES_BINDING = 3;  ///< The binding of the morph ranges' buffer.
+    static constexpr unsigned int MORPH_DELTAS_BINDING = 4;  ///< The binding of the morph deltas' buffer.
+    static constexpr unsigned int MORPH_WEIGHTS_BINDING = 5; ///< The binding of the morph weights' buffer.
+    static constexpr unsigned int MORPH_BLENDED_BINDING = 6; ///< The binding of the blended morph deltas' buffer.
+    static constexpr size_t CPU_MORPH_MAX_ACTIVE_TARGETS = 4; ///< The most active targets a morph blended on the CPU has.
+    std::vector<uvec2> morph_ranges;      ///< The first delta and the amount of deltas of every morphed vertex.
+    std::vector<MorphDelta> morph_deltas; ///< The deltas of every morphed vertex, grouped by vertex.
+    std::vector<MorphDelta> morph_blended_deltas; ///< The single delta of every vertex of the morphs blended on the CPU.
+    unsigned int morph_ranges_SSBO;       ///< The shader storage buffer of morph_ranges.
+    unsigned int morph_deltas_SSBO;       ///< The shader storage buffer of morph_deltas.
+    unsigned int morph_weights_SSBO;      ///< The shader storage buffer of morph_weights.
+    unsigned int morph_blended_SSBO;      ///< The shader storage buffer of morph_blended_deltas.
+    bool are_morph_deltas_uploaded;       ///< Whether the buffers of the ranges and deltas are up to date.
 };
@@ -12,7 +12,9 @@
 
 /**
  * @class Window
- * @brief Acts as a layer above the GLFW window.
+ * @brief Acts as a layer above the GLFW window. In headless mode, the window is created on GLFW's
+ * null platform with a surfaceless EGL context, or an OSMesa one if EGL isn't available, so the
+ * engine can render offscreen on machines without a display or a GPU.
  */
 class Window {
 public:
@@ -28,6 +30,19 @@ public:
         return window;
     }
 
+    /**
+     * @brief Makes the window headless. Needs to be called before the window is created.
+     * @param width The width of the offscreen render.
+     * @param height The height of the offscreen render.
+     */
+    static void set_headless(int width, int height);
+
+    /**
+     * @return Whether the window is headless. Headless windows have no default framebuffer, so
+     * everything needs to be rendered into a Framebuffer.
+     */
+    static bool is_headless();
+
     /**
      * @return The GLFW window pointer.
      */
@@ -85,4 +100,8 @@ private:
     GLFWwindow* window; ///< The GLFW window pointer.
     int width;          ///< The width of the window.
     int height;         ///< The height of the window.
+
+    static inline bool b_is_headless = false; ///< Whether the window is headless.
+    static inline int headless_width = 0;     ///< The width of the window in headless mode.
+    static inline int headless_height = 0;    ///< The height of the window in headless mode.
 };
@@ -8,6 +8,7 @@
 #include "assets/Texture.hpp"
 #include "Material.hpp"
 #include "maths/vec4.hpp"
+#include "utility/SlotMap.hpp"
 
 /**
  * @struct MRMaterial
@@ -16,6 +17,22 @@
 struct MRMaterial : Material {
     explicit MRMaterial(const std::string& name);
 
+    /**
+     * @brief Releases the material's maps.
+     */
+    ~MRMaterial() override;
+
+    MRMaterial(const MRMaterial&) = delete;
+    MRMaterial& operator=(const MRMaterial&) = delete;
+
+    /**
+     * @brief Replaces one of the material's maps. The new texture is acquired and the previous one
+     * is released.
+     * @param map The map, like &MRMaterial::base_color_map.
+     * @param texture The new texture's handle.
+     */
+    void set_map(Handle<Texture> MRMaterial::* map, Handle<Texture> texture);
+
     /**
      * @brief Updates a shader's uniforms' values with the material's data.
      * @param shader The shader whose uniforms need to be updated.
@@ -27,16 +44,21 @@ struct MRMaterial : Material {
      */
     bool has_transparency() const override;
 
+    /**
+     * @return Whether the material's base color map is a virtual texture.
+     */
+    bool has_virtual_textures() const override;
+
     /**
      * @brief Add this material to the object editor.
      */
     void add_to_object_editor() override;
 
     vec4 base_color; ///< Diffuse albedo for dielectrics / Specular color for metals.
-    Texture base_color_map; ///< Diffuse albedo for dielectrics / Specular color for metals.
+    Handle<Texture> base_color_map; ///< Diffuse albedo for dielectrics / Specular color for metals.
     float metallic; ///< Whether a surface appears to be dielectric (0.0) or metallic (1.0). Usually a binary value.
     float roughness; ///< Perceived smoothness (1.0) or roughness (0.0).
-    Texture metallic_roughness_map; ///< The green channel is a roughness map / The blue channel is a metallic map.
+    Handle<Texture> metallic_roughness_map; ///< The green channel is a roughness map / The blue channel is a metallic map.
     float reflectance; ///< Fresnel reflectance at normal incidence angle (When view direction == normal).
-    Texture normal_map;
+    Handle<Texture> normal_map; ///< Tangent space normal map. Set the maps with set_map, they must be set before drawing.
 };
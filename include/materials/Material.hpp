@@ -32,6 +32,11 @@ struct Material {
      */
     virtual bool has_transparency() const = 0;
 
+    /**
+     * @return Whether any of the material's textures is a virtual texture.
+     */
+    virtual bool has_virtual_textures() const { return false; }
+
     /**
      * @brief Add this material to the object editor.
      */
@@ -5,7 +5,8 @@
 
 #pragma once
 
-#include "maths/mat4.hpp"
+#include "maths/affine3x4.hpp"
+#include "maths/mat3.hpp"
 #include "maths/transforms.hpp"
 
 /**
@@ -28,13 +29,19 @@ public:
      */
     void set_local_position(const vec3& position);
 
+    /**
+     * @brief Changes the local position of the transform.
+     * @param position The transform's new position.
+     */
+    void set_local_position(const dvec3& position);
+
     /**
      * @brief Changes the local position of the transform.
      * @param x The transform's new position on the x axis.
      * @param y The transform's new position on the y axis.
      * @param z The transform's new position on the z axis.
      */
-    void set_local_position(float x, float y, float z);
+    void set_local_position(double x, double y, double z);
 
     /**
      * @brief Changes the local orientation of the transform.
@@ -92,13 +99,13 @@ public:
     /**
      * @return The transform's local position.
      */
-    vec3 get_local_position() const;
+    dvec3 get_local_position() const;
 
     /**
      * @return A reference to the transform's local position. If the value is modified,
      * set_local_model_to_dirty need to be called.
      */
-    vec3& get_local_position_reference();
+    dvec3& get_local_position_reference();
 
     /**
      * @return The transform's local orientation.
@@ -126,19 +133,46 @@ public:
      * @return The transform's global model, the product of the local model matrices of all its
      * parents and itself.
      */
-    mat4 get_global_model() const;
+    affine3x4 get_global_model() const;
 
     /**
      * @return A const reference to the transform's global model, the product of the local model
      * matrices of all its parents and itself.
      */
-    const mat4& get_global_model_const_reference() const;
+    const affine3x4& get_global_model_const_reference() const;
+
+    /**
+     * @return A const reference to the inverse of the transform's global model, which is updated
+     * with it.
+     */
+    const affine3x4& get_inverse_global_model_const_reference() const;
+
+    /**
+     * @return A const reference to the matrix transforming the normals, the transpose of the inverse
+     * of the upper left 3x3 matrix of the global model, which is updated with it.
+     */
+    const mat3& get_normals_model_const_reference() const;
 
     /**
      * @return The transform's global position.
      */
     vec3 get_global_position() const;
 
+    /**
+     * @return A const reference to the transform's global position in double precision, which stays
+     * precise far from the origin unlike the global model's translation.
+     */
+    const dvec3& get_precise_global_position_const_reference() const;
+
+    /**
+     * @brief Computes the global model relative to an origin, usually the camera's position. Its
+     * translation is the difference between the double precision positions, so it stays precise as
+     * long as the transform is close to the origin, however far both are from the world's origin.
+     * @param origin The origin.
+     * @return The global model translated by -origin.
+     */
+    affine3x4 compute_relative_global_model(const dvec3& origin) const;
+
     /**
      * @return The transform's global scale.
      */
@@ -169,7 +203,7 @@ public:
      * @brief Computes and returns the local model matrix.
      * @return The transform's local model matrix.
      */
-    mat4 compute_local_model() const;
+    affine3x4 compute_local_model() const;
 
     /**
      * @brief Sets the value of the global model matrix to the local model matrix. Used if the entity
@@ -180,17 +214,25 @@ public:
     /**
      * @brief Sets the value of the global model matrix to the product of the global model of the
      * parent of the entity related to the transform and the transform's local model matrix.
-     * @param parent_global_model The entity related to the transform's parent's global model matrix.
+     * @param parent The transform of the entity related to the transform's parent.
      */
-    void update_global_model(const mat4& parent_global_model);
+    void update_global_model(const Transform& parent);
 
 private:
-    vec3 local_position;          ///< The transform's local position.
+    /**
+     * @brief Updates the inverse of the global model and the normals model from the global model.
+     */
+    void update_inverse_global_model();
+
+    dvec3 local_position;         ///< The transform's local position.
     quaternion local_orientation; ///< The transform's local orientation.
     vec3 local_scale;             ///< The transform's local scale.
 
     bool is_dirty; ///< Whether the local model was modified.
 
     /// The transform's global model, the product of the local model matrices of all its parents and itself.
-    mat4 global_model;
+    affine3x4 global_model;
+    affine3x4 inverse_global_model; ///< The inverse of the global model.
+    mat3 normals_model;             ///< The transpose of the inverse of the global model's upper left 3x3 matrix.
+    dvec3 global_position;          ///< The global model's translation in double precision.
 };
@@ -0,0 +1,134 @@
+/***************************************************************************************************
+ * @file  affine3x4.hpp
+ * @brief Declaration of the affine3x4 struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include "vec3.hpp"
+#include "vec4.hpp"
+#include "mat4.hpp"
+
+/**
+ * @struct affine3x4
+ * @brief Represents an affine transformation matrix: a 4 by 4 matrix whose last row is always
+ * (0, 0, 0, 1) and therefore isn't stored. Its 3 rows are stored one after the other, which takes 48
+ * bytes instead of 64 and is read by GLSL as a std430 mat3x4 whose columns are the rows.
+ */
+struct affine3x4 {
+    /**
+     * @brief Constructs an affine3x4 with all components equal to 0.
+     */
+    affine3x4() = default;
+
+    /**
+     * @brief Constructs an affine3x4 with a specific value for each component of its 3 rows.
+     * @param v00, v01, v02, v03 The values of the components of the first row.
+     * @param v10, v11, v12, v13 The values of the components of the second row.
+     * @param v20, v21, v22, v23 The values of the components of the third row.
+     */
+    affine3x4(float v00, float v01, float v02, float v03,
+              float v10, float v11, float v12, float v13,
+              float v20, float v21, float v22, float v23);
+
+    /**
+     * @brief Constructs an affine3x4 which is the identity matrix multiplied by a scalar, without
+     * translation.
+     * @param scalar The value for the components on the diagonal.
+     */
+    explicit affine3x4(float scalar);
+
+    /**
+     * @brief Constructs an affine3x4 from the first 3 rows of a mat4, whose last row is assumed to
+     * be (0, 0, 0, 1).
+     * @param mat The affine mat4.
+     */
+    explicit affine3x4(const mat4& mat);
+
+    /**
+     * @brief Accesses an element of the affine3x4.
+     * @param row The row's index, between 0 and 2.
+     * @param column The column's index.
+     * @return A reference to the element.
+     */
+    float& operator()(uint8_t row, uint8_t column) { return (&rows[row].x)[column]; }
+
+    /**
+     * @brief Accesses an element of the affine3x4.
+     * @param row The row's index, between 0 and 2.
+     * @param column The column's index.
+     * @return A const reference to the element.
+     */
+    const float& operator()(uint8_t row, uint8_t column) const { return (&rows[row].x)[column]; }
+
+    /**
+     * @brief Access a row of the affine3x4.
+     * @param row The row's index, between 0 and 2.
+     * @return A const reference to the row.
+     */
+    const vec4& get_row(uint8_t row) const { return rows[row]; }
+
+    /**
+     * @return The mat4 with the same first 3 rows and a last row of (0, 0, 0, 1).
+     */
+    mat4 to_mat4() const;
+
+private:
+    vec4 rows[3]; ///< The first 3 rows of the matrix.
+};
+
+/**
+ * @brief Writes the components of the given affine3x4 to the output stream in the format:\n
+ * ( v00 ; v01 ; v02 ; v03 )\n
+ * ( v10 ; v11 ; v12 ; v13 )\n
+ * ( v20 ; v21 ; v22 ; v23 )\n
+ * @param stream The output stream to write to.
+ * @param mat The affine3x4 to write to the stream.
+ * @return A reference to the output stream after writing the affine3x4.
+ */
+std::ostream& operator <<(std::ostream& stream, const affine3x4& mat);
+
+/** @brief Composes two affine transformations.
+ *  @param left The left operand, applied last.
+ *  @param right The right operand, applied first.
+ *  @return The product of the two affine3x4.
+ */
+affine3x4 operator *(const affine3x4& left, const affine3x4& right);
+
+/** @brief Multiplies a mat4, like a view projection matrix, by an affine transformation.
+ *  @param left The mat4.
+ *  @param right The affine3x4.
+ *  @return The product of the mat4 and the affine3x4.
+ */
+mat4 operator *(const mat4& left, const affine3x4& right);
+
+/**
+ * @brief Multiplies an affine3x4 by a 4-component vector interpreted as a 4x1 column matrix.
+ * @param mat The affine3x4.
+ * @param vec The vector.
+ * @return The vector formed with the values in the 4 rows of mat * vec, whose w is vec's.
+ */
+vec4 operator *(const affine3x4& mat, const vec4& vec);
+
+/**
+ * @brief Transforms a point: its translation is applied.
+ * @param mat The affine3x4.
+ * @param point The point.
+ * @return The result of mat * (point.x, point.y, point.z, 1.0).
+ */
+vec3 transform_point(const affine3x4& mat, const vec3& point);
+
+/**
+ * @brief Transforms a vector, like a direction: its translation isn't applied.
+ * @param mat The affine3x4.
+ * @param vector The vector.
+ * @return The result of mat * (vector.x, vector.y, vector.z, 0.0).
+ */
+vec3 transform_vector(const affine3x4& mat, const vec3& vector);
+
+/**
+ * @brief Calculates the inverse of an affine transformation.
+ * @param mat The affine3x4.
+ * @return The inverse of the affine3x4. If no inverse exists, simply returns the input affine3x4.
+ */
+affine3x4 affine_inverse(const affine3x4& mat);
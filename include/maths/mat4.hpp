@@ -7,6 +7,7 @@
 
 #include "vec3.hpp"
 #include "vec4.hpp"
+#include "simd.hpp"
 
 /**
  * @struct mat4
@@ -150,12 +151,39 @@ mat4 operator +(const mat4& left, const mat4& right);
  */
 mat4 operator -(const mat4& left, const mat4& right);
 
-/** @brief Multiplies a mat4 by another.
+/** @brief Multiplies a mat4 by another. Defined in the header, like the products by vectors, so that
+ *  it can be inlined in the hot loops of other translation units.
  *  @param left The left operand.
  *  @param right The right operand.
  *  @return The product of the two mat4.
  */
-mat4 operator *(const mat4& left, const mat4& right);
+inline mat4 operator *(const mat4& left, const mat4& right) {
+    mat4 result;
+
+#ifdef __SSE__
+    /* Each column of the result is a combination of the columns of left. */
+    __m128 left_column0 = _mm_loadu_ps(&left[0].x);
+    __m128 left_column1 = _mm_loadu_ps(&left[1].x);
+    __m128 left_column2 = _mm_loadu_ps(&left[2].x);
+    __m128 left_column3 = _mm_loadu_ps(&left[3].x);
+
+    for(uint8_t column = 0 ; column < 4 ; ++column) {
+        __m128 right_column = _mm_loadu_ps(&right[column].x);
+        __m128 result_column = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(left_column0, broadcast<0>(right_column)), _mm_mul_ps(left_column1, broadcast<1>(right_column))),
+            _mm_add_ps(_mm_mul_ps(left_column2, broadcast<2>(right_column)), _mm_mul_ps(left_column3, broadcast<3>(right_column)))
+        );
+        _mm_storeu_ps(&result[column].x, result_column);
+    }
+#else
+    for(uint8_t column = 0 ; column < 4 ; ++column) {
+        result[column] = left[0] * right(0, column) + left[1] * right(1, column)
+                         + left[2] * right(2, column) + left[3] * right(3, column);
+    }
+#endif
+
+    return result;
+}
 
 /** @brief Adds a scalar to each of a mat4's components.
  *  @param mat The mat4.
@@ -198,7 +226,13 @@ mat4 operator /(const mat4& mat, float scalar);
  * @param vec The vector.
  * @return The vector formed with the values in the first 3 rows of the result of mat * (vec.x, vec.y, vec.z, 0.0).
  */
-vec3 operator*(const mat4& mat, const vec3& vec);
+inline vec3 operator*(const mat4& mat, const vec3& vec) {
+    return vec3(
+        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z,
+        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z,
+        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z
+    );
+}
 
 /**
  * @brief Multiplies a mat4 by a 4-component vector interpreted as a 4x1 column mat4.
@@ -206,4 +240,32 @@ vec3 operator*(const mat4& mat, const vec3& vec);
  * @param vec The vector.
  * @return The vector formed with the values in the 4 rows of mat * vec.
  */
-vec4 operator*(const mat4& mat, const vec4& vec);
+inline vec4 operator*(const mat4& mat, const vec4& vec) {
+#ifdef __SSE__
+    __m128 result = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mat[0].x), _mm_set1_ps(vec.x)), _mm_mul_ps(_mm_loadu_ps(&mat[1].x), _mm_set1_ps(vec.y))),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mat[2].x), _mm_set1_ps(vec.z)), _mm_mul_ps(_mm_loadu_ps(&mat[3].x), _mm_set1_ps(vec.w)))
+    );
+
+    vec4 vector;
+    _mm_storeu_ps(&vector.x, result);
+    return vector;
+#else
+    return mat[0] * vec.x + mat[1] * vec.y + mat[2] * vec.z + mat[3] * vec.w;
+#endif
+}
+
+/**
+ * @brief Calculates the inverse of an affine transformation matrix, whose last row is (0, 0, 0, 1).
+ * @param mat The affine mat4.
+ * @return The inverse of the mat4. If no inverse exists, simply returns the input mat4.
+ */
+mat4 affine_inverse(const mat4& mat);
+
+/**
+ * @brief Calculates the inverse of any invertible mat4, for example a projection matrix. Prefer
+ * affine_inverse for transformation matrices, which is cheaper.
+ * @param mat The mat4.
+ * @return The inverse of the mat4. If no inverse exists, simply returns the input mat4.
+ */
+mat4 inverse(const mat4& mat);
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "mat4.hpp"
 
 /**
@@ -196,3 +198,56 @@ quaternion operator /(const quaternion& q, float scalar);
  * @return The division of the scalar by the quaternion.
  */
 quaternion operator /(float scalar, const quaternion& q);
+
+/**
+ * @brief Spherically interpolates between two unit quaternions along the shortest path.
+ * @param q The quaternion at t = 0.
+ * @param r The quaternion at t = 1.
+ * @param t The interpolation factor, between 0 and 1.
+ * @return The interpolated unit quaternion.
+ */
+quaternion slerp(const quaternion& q, quaternion r, float t);
+
+/**
+ * @brief Linearly interpolates between two unit quaternions along the shortest path and normalizes
+ * the result. Cheaper than slerp and close to it when the quaternions are close, like consecutive
+ * animation keys.
+ * @param q The quaternion at t = 0.
+ * @param r The quaternion at t = 1.
+ * @param t The interpolation factor, between 0 and 1.
+ * @return The interpolated unit quaternion.
+ */
+quaternion nlerp(const quaternion& q, quaternion r, float t);
+
+/**
+ * @brief Spherically interpolates between arrays of unit quaternions, 4 at a time with SSE.
+ * @param starts The quaternions at t = 0.
+ * @param ends The quaternions at t = 1.
+ * @param factors The interpolation factor of each pair of quaternions.
+ * @param results The interpolated unit quaternions. Can be the same array as starts or ends.
+ */
+void slerp(std::span<const quaternion> starts,
+           std::span<const quaternion> ends,
+           std::span<const float> factors,
+           std::span<quaternion> results);
+
+/**
+ * @brief Linearly interpolates between arrays of unit quaternions and normalizes the results, 4 at
+ * a time with SSE.
+ * @param starts The quaternions at t = 0.
+ * @param ends The quaternions at t = 1.
+ * @param factors The interpolation factor of each pair of quaternions.
+ * @param results The interpolated unit quaternions. Can be the same array as starts or ends.
+ */
+void nlerp(std::span<const quaternion> starts,
+           std::span<const quaternion> ends,
+           std::span<const float> factors,
+           std::span<quaternion> results);
+
+/**
+ * @brief Rotates a vector by a unit quaternion without converting it to a matrix.
+ * @param q The unit quaternion.
+ * @param vector The vector.
+ * @return The rotated vector, q * vector * conjugate(q).
+ */
+vec3 rotate(const quaternion& q, const vec3& vector);
@@ -0,0 +1,28 @@
+/***************************************************************************************************
+ * @file  simd.hpp
+ * @brief Helpers shared by the SSE paths of the maths module
+ **************************************************************************************************/
+
+#pragma once
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+
+/**
+ * @brief Broadcasts a component of a vector to its 4 components.
+ */
+template <int index>
+inline __m128 broadcast(__m128 vector) {
+    return _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(index, index, index, index));
+}
+
+/**
+ * @brief Computes the cross product of the xyz components of two vectors. The w component is 0.
+ */
+inline __m128 cross_product(__m128 left, __m128 right) {
+    __m128 left_yzx = _mm_shuffle_ps(left, left, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 right_yzx = _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 result = _mm_sub_ps(_mm_mul_ps(left, right_yzx), _mm_mul_ps(left_yzx, right));
+    return _mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1));
+}
+#endif
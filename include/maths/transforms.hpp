@@ -5,6 +5,9 @@
 
 #pragma once
 
+#include <span>
+
+#include "affine3x4.hpp"
 #include "mat4.hpp"
 #include "quaternion.hpp"
 #include "vec3.hpp"
@@ -132,7 +135,7 @@ mat4 TRS_matrix(const vec3& translation, const vec3& rotation, const vec3& scale
 
 /**
  * @brief Calculates the TRS matrix such that TRS=T*Rq*S, with T being a translation matrix, Rq
- * being the rotation matrix derived from a quaternion S being a scale matrix.
+ * being the rotation matrix derived from a quaternion and S being a scale matrix.
  * @param translation The value of the translation vector.
  * @param rotation The rotation quaternion. Assumed to be a unit quaternion.
  * @param scale The values of the scaling factors.
@@ -141,6 +144,29 @@ mat4 TRS_matrix(const vec3& translation, const vec3& rotation, const vec3& scale
  */
 mat4 TRS_matrix(const vec3& translation, const quaternion& rotation, const vec3& scale);
 
+/**
+ * @brief Calculates the same TRS matrix as TRS_matrix without its constant last row.
+ * @param translation The value of the translation vector.
+ * @param rotation The rotation quaternion. Assumed to be a unit quaternion.
+ * @param scale The values of the scaling factors.
+ * @return The affine transformation that scales then rotates then translates a point according to
+ * the given parameters.
+ */
+affine3x4 affine_TRS_matrix(const vec3& translation, const quaternion& rotation, const vec3& scale);
+
+/**
+ * @brief Calculates the affine TRS matrices of arrays of translations, rotations and scales, 4 at a
+ * time with SSE.
+ * @param translations The values of the translation vectors.
+ * @param rotations The rotation quaternions. Assumed to be unit quaternions.
+ * @param scales The values of the scaling factors.
+ * @param results The affine TRS matrix of each translation, rotation and scale.
+ */
+void affine_TRS_matrices(std::span<const vec3> translations,
+                         std::span<const quaternion> rotations,
+                         std::span<const vec3> scales,
+                         std::span<affine3x4> results);
+
 /**
  * @brief Calculates the 'look at' matrix. That allows to simulate a camera.
  * @param eye The position of the camera.
@@ -8,5 +8,6 @@
 #include "vector3.hpp"
 
 using vec3 = vector3<float>;
+using dvec3 = vector3<double>;
 using ivec3 = vector3<int>;
 using uvec3 = vector3<unsigned int>;
@@ -22,53 +22,53 @@ struct vector2 {
     /**
      * @brief Constructs a vector2 with all components set to 0 (or default initialized in the case of a class).
      */
-    vector2() : x(), y() { }
+    constexpr vector2() : x(), y() { }
 
     /**
      * @brief Constructs a vector2 with a specific value for each component.
      * @param x The value of the x component.
      * @param y The value of the y component.
      */
-    vector2(Type x, Type y) : x(x), y(y) { }
+    constexpr vector2(Type x, Type y) : x(x), y(y) { }
 
     /**
      * @brief Constructs a vector2 with its components specified by a vector3's first 2 components.
      * @param xyz The value of the xy (and the ignored z) components.
      */
-    vector2(const vector3<Type>& xyz) : x(xyz.x), y(xyz.y) { }
+    constexpr vector2(const vector3<Type>& xyz) : x(xyz.x), y(xyz.y) { }
 
     /**
      * @brief Constructs a vector2 with its components specified by a vector4's first 2 components.
      * @param xyzw The value of the xy (and the ignored z and w) components.
      */
-    vector2(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y) { }
+    constexpr vector2(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y) { }
 
     /**
      * @brief Constructs a vector2 with the same value for each component.
      * @param value The value of each component.
      */
-    explicit vector2(Type value) : x(value), y(value) { }
+    explicit constexpr vector2(Type value) : x(value), y(value) { }
 
     /**
      * @brief Access an element of the vector2 by its index.
      * @param index The index of the element. 0 <= index < 2.
      * @return A reference to the element.
      */
-    float& operator[](uint8_t index) { return (&x)[index]; }
+    Type& operator[](uint8_t index) { return (&x)[index]; }
 
     /**
      * @brief Access an element of the vector2 by its index.
      * @param index The index of the element. 0 <= index < 2.
      * @return A const reference to the element.
      */
-    const float& operator[](uint8_t index) const { return (&x)[index]; }
+    const Type& operator[](uint8_t index) const { return (&x)[index]; }
 
     /**
      * @brief Adds another vector2's components to the current instance's components.
      * @param vec The vector2 to add.
      * @return A reference to this instance.
      */
-    vector2& operator +=(const vector2& vec) {
+    constexpr vector2& operator +=(const vector2& vec) {
         x += vec.x;
         y += vec.y;
 
@@ -80,7 +80,7 @@ struct vector2 {
      * @param vec The vector2 to subtract by.
      * @return A reference to this instance.
      */
-    vector2& operator -=(const vector2& vec) {
+    constexpr vector2& operator -=(const vector2& vec) {
         x -= vec.x;
         y -= vec.y;
 
@@ -92,7 +92,7 @@ struct vector2 {
      * @param vec The vector2 to multiply by.
      * @return A reference to this instance.
      */
-    vector2& operator *=(const vector2& vec) {
+    constexpr vector2& operator *=(const vector2& vec) {
         x *= vec.x;
         y *= vec.y;
 
@@ -104,7 +104,7 @@ struct vector2 {
      * @param vec The vector2 to divide by.
      * @return A reference to this instance.
      */
-    vector2& operator /=(const vector2& vec) {
+    constexpr vector2& operator /=(const vector2& vec) {
         x /= vec.x;
         y /= vec.y;
 
@@ -116,7 +116,7 @@ struct vector2 {
      * @param value The value to add.
      * @return A reference to this instance.
      */
-    vector2& operator +=(Type value) {
+    constexpr vector2& operator +=(Type value) {
         x += value;
         y += value;
 
@@ -128,7 +128,7 @@ struct vector2 {
      * @param value The value to subtract by.
      * @return A reference to this instance.
      */
-    vector2& operator -=(Type value) {
+    constexpr vector2& operator -=(Type value) {
         x -= value;
         y -= value;
 
@@ -140,7 +140,7 @@ struct vector2 {
      * @param value The value to multiply by.
      * @return A reference to this instance.
      */
-    vector2& operator *=(Type value) {
+    constexpr vector2& operator *=(Type value) {
         x *= value;
         y *= value;
 
@@ -152,7 +152,7 @@ struct vector2 {
      * @param value The value to divide by.
      * @return A reference to this instance.
      */
-    vector2& operator /=(Type value) {
+    constexpr vector2& operator /=(Type value) {
         x /= value;
         y /= value;
 
@@ -164,7 +164,7 @@ struct vector2 {
      * @param other The vector2 to compare with.
      * @return Whether the two vector2 are equal.
      */
-    bool operator ==(const vector2& other) const {
+    constexpr bool operator ==(const vector2& other) const {
         return x == other.x && y == other.y;
     }
 
@@ -173,7 +173,7 @@ struct vector2 {
      * @param other The vector2 to compare with.
      * @return Whether the two vector2 are different.
      */
-    bool operator !=(const vector2& other) const {
+    constexpr bool operator !=(const vector2& other) const {
         return x != other.x || y != other.y;
     }
 
@@ -212,7 +212,7 @@ std::istream& operator >>(std::istream& stream, vector2<Type>& vec) {
  *  @return The component-wise sum of the two vector2.
  */
 template <typename Type>
-vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x + right.x,
         left.y + right.y
@@ -225,7 +225,7 @@ vector2<Type> operator +(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise subtraction of the first vector2 by the second.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x - right.x,
         left.y - right.y
@@ -238,7 +238,7 @@ vector2<Type> operator -(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise product of the two vector2.
  */
 template <typename Type>
-vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x * right.x,
         left.y * right.y
@@ -251,7 +251,7 @@ vector2<Type> operator *(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise division of the first vector2 by the second.
  */
 template <typename Type>
-vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right) {
+constexpr vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right) {
     return vector2<Type>(
         left.x / right.x,
         left.y / right.y
@@ -264,7 +264,7 @@ vector2<Type> operator /(const vector2<Type>& left, const vector2<Type>& right)
  *  @return The component-wise sum of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator +(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator +(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x + value,
         vec.y + value
@@ -277,7 +277,7 @@ vector2<Type> operator +(const vector2<Type>& vec, Type value) {
  *  @return The component-wise subtraction of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator -(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x - value,
         vec.y - value
@@ -290,7 +290,7 @@ vector2<Type> operator -(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator *(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator *(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x * value,
         vec.y * value
@@ -303,7 +303,7 @@ vector2<Type> operator *(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator *(Type value, const vector2<Type>& vec) {
+constexpr vector2<Type> operator *(Type value, const vector2<Type>& vec) {
     return vector2<Type>(
         value * vec.x,
         value * vec.y
@@ -316,7 +316,7 @@ vector2<Type> operator *(Type value, const vector2<Type>& vec) {
  *  @return The component-wise division of a vector2 by a value.
  */
 template <typename Type>
-vector2<Type> operator /(const vector2<Type>& vec, Type value) {
+constexpr vector2<Type> operator /(const vector2<Type>& vec, Type value) {
     return vector2<Type>(
         vec.x / value,
         vec.y / value
@@ -329,6 +329,6 @@ vector2<Type> operator /(const vector2<Type>& vec, Type value) {
  *  @return The component-wise product of a vector2 by -1.
  */
 template <typename Type>
-vector2<Type> operator -(const vector2<Type>& vec) {
+constexpr vector2<Type> operator -(const vector2<Type>& vec) {
     return vector2(-vec.x, -vec.y);
 }
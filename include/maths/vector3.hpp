@@ -19,7 +19,7 @@ struct vector3 {
      * @brief Constructs a vector3 with all components set to 0 (or default initialized in the case
      * of a class).
      */
-    vector3() : x(), y(), z() { }
+    constexpr vector3() : x(), y(), z() { }
 
     /**
      * @brief Constructs a vector3 with a specific value for each component.
@@ -27,7 +27,7 @@ struct vector3 {
      * @param y The value of the y component.
      * @param z The value of the z component.
      */
-    vector3(Type x, Type y, Type z) : x(x), y(y), z(z) { }
+    constexpr vector3(Type x, Type y, Type z) : x(x), y(y), z(z) { }
 
     /**
      * @brief Constructs a vector3 with its first 2 components specified by a vector2 and its last
@@ -35,40 +35,49 @@ struct vector3 {
      * @param xy The value of the x and y components
      * @param z The value of the z component.
      */
-    vector3(const vector2<Type>& xy, float z) : x(xy.x), y(xy.y), z(z) { }
+    constexpr vector3(const vector2<Type>& xy, Type z) : x(xy.x), y(xy.y), z(z) { }
 
     /**
      * @brief Constructs a vector3 with its components specified by a vector4's first 3 components.
      * @param xyzw The value of the xyz (and the ignored w) components.
      */
-    explicit vector3(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y), z(xyzw.z) { }
+    explicit constexpr vector3(const vector4<Type>& xyzw) : x(xyzw.x), y(xyzw.y), z(xyzw.z) { }
+
+    /**
+     * @brief Constructs a vector3 from one of another type, for example a float vector3 from a
+     * double one.
+     * @param vec The vector3 to convert.
+     */
+    template <typename Other>
+    explicit constexpr vector3(const vector3<Other>& vec)
+        : x(static_cast<Type>(vec.x)), y(static_cast<Type>(vec.y)), z(static_cast<Type>(vec.z)) { }
 
     /**
      * @brief Constructs a vector3 with the same value for each component.
      * @param value The value of each component.
      */
-    explicit vector3(Type value) : x(value), y(value), z(value) { }
+    explicit constexpr vector3(Type value) : x(value), y(value), z(value) { }
 
     /**
      * @brief Access an element of the vector3 by its index.
      * @param index The index of the element. 0 <= index < 3.
      * @return A reference to the element.
      */
-    float& operator[](uint8_t index) { return (&x)[index]; }
+    Type& operator[](uint8_t index) { return (&x)[index]; }
 
     /**
      * @brief Access an element of the vector3 by its index.
      * @param index The index of the element. 0 <= index < 3.
      * @return A const reference to the element.
      */
-    const float& operator[](uint8_t index) const { return (&x)[index]; }
+    const Type& operator[](uint8_t index) const { return (&x)[index]; }
 
     /**
      * @brief Adds another vector3's components to the current instance's components.
      * @param vec The vector3 to add.
      * @return A reference to this instance.
      */
-    vector3& operator +=(const vector3& vec) {
+    constexpr vector3& operator +=(const vector3& vec) {
         x += vec.x;
         y += vec.y;
         z += vec.z;
@@ -81,7 +90,7 @@ struct vector3 {
      * @param vec The vector3 to subtract by.
      * @return A reference to this instance.
      */
-    vector3& operator -=(const vector3& vec) {
+    constexpr vector3& operator -=(const vector3& vec) {
         x -= vec.x;
         y -= vec.y;
         z -= vec.z;
@@ -94,7 +103,7 @@ struct vector3 {
      * @param vec The vector3 to multiply by.
      * @return A reference to this instance.
      */
-    vector3& operator *=(const vector3& vec) {
+    constexpr vector3& operator *=(const vector3& vec) {
         x *= vec.x;
         y *= vec.y;
         z *= vec.z;
@@ -107,7 +116,7 @@ struct vector3 {
      * @param vec The vector3 to divide by.
      * @return A reference to this instance.
      */
-    vector3& operator /=(const vector3& vec) {
+    constexpr vector3& operator /=(const vector3& vec) {
         x /= vec.x;
         y /= vec.y;
         z /= vec.z;
@@ -120,7 +129,7 @@ struct vector3 {
      * @param value The value to add.
      * @return A reference to this instance.
      */
-    vector3& operator +=(Type value) {
+    constexpr vector3& operator +=(Type value) {
         x += value;
         y += value;
         z += value;
@@ -133,7 +142,7 @@ struct vector3 {
      * @param value The value to subtract by.
      * @return A reference to this instance.
      */
-    vector3& operator -=(Type value) {
+    constexpr vector3& operator -=(Type value) {
         x -= value;
         y -= value;
         z -= value;
@@ -146,7 +155,7 @@ struct vector3 {
      * @param value The value to multiply by.
      * @return A reference to this instance.
      */
-    vector3& operator *=(Type value) {
+    constexpr vector3& operator *=(Type value) {
         x *= value;
         y *= value;
         z *= value;
@@ -159,7 +168,7 @@ struct vector3 {
      * @param value The value to divide by.
      * @return A reference to this instance.
      */
-    vector3& operator /=(Type value) {
+    constexpr vector3& operator /=(Type value) {
         x /= value;
         y /= value;
         z /= value;
@@ -172,7 +181,7 @@ struct vector3 {
      * @param other The vector3 to compare with.
      * @return Whether the two vector3 are equal.
      */
-    bool operator ==(const vector3& other) const {
+    constexpr bool operator ==(const vector3& other) const {
         return x == other.x && y == other.y && z == other.z;
     }
 
@@ -181,7 +190,7 @@ struct vector3 {
      * @param other The vector3 to compare with.
      * @return Whether the two vector3 are different.
      */
-    bool operator !=(const vector3& other) const {
+    constexpr bool operator !=(const vector3& other) const {
         return x != other.x || y != other.y || z != other.z;
     }
 
@@ -222,7 +231,7 @@ std::istream& operator >>(std::istream& stream, vector3<Type>& vec) {
  *  @return The component-wise sum of the two vector3.
  */
 template <typename Type>
-vector3<Type> operator +(const vector3<Type>& left, const vector3<Type>& right) {
+constexpr vector3<Type> operator +(const vector3<Type>& left, const vector3<Type>& right) {
     return vector3<Type>(
         left.x + right.x,
         left.y + right.y,
@@ -236,7 +245,7 @@ vector3<Type> operator +(const vector3<Type>& left, const vector3<Type>& right)
  *  @return The component-wise subtraction of the first vector3 by the second.
  */
 template <typename Type>
-vector3<Type> operator -(const vector3<Type>& left, const vector3<Type>& right) {
+constexpr vector3<Type> operator -(const vector3<Type>& left, const vector3<Type>& right) {
     return vector3<Type>(
         left.x - right.x,
         left.y - right.y,
@@ -250,7 +259,7 @@ vector3<Type> operator -(const vector3<Type>& left, const vector3<Type>& right)
  *  @return The component-wise product of the two vector3.
  */
 template <typename Type>
-vector3<Type> operator *(const vector3<Type>& left, const vector3<Type>& right) {
+constexpr vector3<Type> operator *(const vector3<Type>& left, const vector3<Type>& right) {
     return vector3<Type>(
         left.x * right.x,
         left.y * right.y,
@@ -264,7 +273,7 @@ vector3<Type> operator *(const vector3<Type>& left, const vector3<Type>& right)
  *  @return The component-wise division of the first vector3 by the second.
  */
 template <typename Type>
-vector3<Type> operator /(const vector3<Type>& left, const vector3<Type>& right) {
+constexpr vector3<Type> operator /(const vector3<Type>& left, const vector3<Type>& right) {
     return vector3<Type>(
         left.x / right.x,
         left.y / right.y,
@@ -278,7 +287,7 @@ vector3<Type> operator /(const vector3<Type>& left, const vector3<Type>& right)
  *  @return The component-wise sum of a vector3 by a value.
  */
 template <typename Type>
-vector3<Type> operator +(const vector3<Type>& vec, Type value) {
+constexpr vector3<Type> operator +(const vector3<Type>& vec, Type value) {
     return vector3<Type>(
         vec.x + value,
         vec.y + value,
@@ -292,7 +301,7 @@ vector3<Type> operator +(const vector3<Type>& vec, Type value) {
  *  @return The component-wise subtraction of a vector3 by a value.
  */
 template <typename Type>
-vector3<Type> operator -(const vector3<Type>& vec, Type value) {
+constexpr vector3<Type> operator -(const vector3<Type>& vec, Type value) {
     return vector3<Type>(
         vec.x - value,
         vec.y - value,
@@ -306,7 +315,7 @@ vector3<Type> operator -(const vector3<Type>& vec, Type value) {
  *  @return The component-wise product of a vector3 by a value.
  */
 template <typename Type>
-vector3<Type> operator *(const vector3<Type>& vec, Type value) {
+constexpr vector3<Type> operator *(const vector3<Type>& vec, Type value) {
     return vector3<Type>(
         vec.x * value,
         vec.y * value,
@@ -320,7 +329,7 @@ vector3<Type> operator *(const vector3<Type>& vec, Type value) {
  *  @return The component-wise product of a vector3 by a value.
  */
 template <typename Type>
-vector3<Type> operator *(Type value, const vector3<Type>& vec) {
+constexpr vector3<Type> operator *(Type value, const vector3<Type>& vec) {
     return vector3<Type>(
         value * vec.x,
         value * vec.y,
@@ -334,7 +343,7 @@ vector3<Type> operator *(Type value, const vector3<Type>& vec) {
  *  @return The component-wise division of a vector3 by a value.
  */
 template <typename Type>
-vector3<Type> operator /(const vector3<Type>& vec, Type value) {
+constexpr vector3<Type> operator /(const vector3<Type>& vec, Type value) {
     return vector3<Type>(
         vec.x / value,
         vec.y / value,
@@ -348,6 +357,6 @@ vector3<Type> operator /(const vector3<Type>& vec, Type value) {
  *  @return The component-wise product of a vector3 by -1.
  */
 template <typename Type>
-vector3<Type> operator -(const vector3<Type>& vec) {
+constexpr vector3<Type> operator -(const vector3<Type>& vec) {
     return vector3(-vec.x, -vec.y, -vec.z);
 }
@@ -18,7 +18,7 @@ struct vector4 {
     /**
      * @brief Constructs a vector4 with all components set to 0 (or default initialized in the case of a class).
      */
-    vector4() : x(), y(), z(), w() { }
+    constexpr vector4() : x(), y(), z(), w() { }
 
     /**
      * @brief Constructs a vector4 with a specific value for each component.
@@ -27,7 +27,7 @@ struct vector4 {
      * @param z The value of the z component.
      * @param w The value of the w component.
      */
-    vector4(Type x, Type y, Type z, Type w) : x(x), y(y), z(z), w(w) { }
+    constexpr vector4(Type x, Type y, Type z, Type w) : x(x), y(y), z(z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with its first 2 components specified by a vector2 and its last 2
@@ -36,7 +36,7 @@ struct vector4 {
      * @param z The value of the z component.
      * @param w The value of the w component.
      */
-    vector4(const vector2<Type>& xy, float z, float w) : x(xy.x), y(xy.y), z(z), w(w) { }
+    constexpr vector4(const vector2<Type>& xy, Type z, Type w) : x(xy.x), y(xy.y), z(z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with its first 2 components specified by a vector2 and its last 2
@@ -44,7 +44,7 @@ struct vector4 {
      * @param xy The value of the x and y components.
      * @param zw The value of the z and w components.
      */
-    vector4(const vector2<Type>& xy, const vector2<Type> zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) { }
+    constexpr vector4(const vector2<Type>& xy, const vector2<Type> zw) : x(xy.x), y(xy.y), z(zw.x), w(zw.y) { }
 
     /**
      * @brief Constructs a vector4 with its first 3 components specified by a vector3 and its last
@@ -52,34 +52,34 @@ struct vector4 {
      * @param xyz The value of the x, y and z components
      * @param w The value of the w component.
      */
-    vector4(const vector3<Type>& xyz, float w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) { }
+    constexpr vector4(const vector3<Type>& xyz, Type w) : x(xyz.x), y(xyz.y), z(xyz.z), w(w) { }
 
     /**
      * @brief Constructs a vector4 with the same value for each component.
      * @param value The value of each component.
      */
-    explicit vector4(Type value) : x(value), y(value), z(value), w(value) { }
+    explicit constexpr vector4(Type value) : x(value), y(value), z(value), w(value) { }
 
     /**
      * @brief Access an element of the vector4 by its index.
      * @param index The index of the element. 0 <= index < 4.
      * @return A reference to the element.
      */
-    float& operator[](uint8_t index) { return (&x)[index]; }
+    Type& operator[](uint8_t index) { return (&x)[index]; }
 
     /**
      * @brief Access an element of the vector4 by its index.
      * @param index The index of the element. 0 <= index < 4.
      * @return A const reference to the element.
      */
-    const float& operator[](uint8_t index) const { return (&x)[index]; }
+    const Type& operator[](uint8_t index) const { return (&x)[index]; }
 
     /**
      * @brief Adds another vector4's components to the current instance's components.
      * @param vec The vector4 to add.
      * @return A reference to this instance.
      */
-    vector4& operator +=(const vector4& vec) {
+    constexpr vector4& operator +=(const vector4& vec) {
         x += vec.x;
         y += vec.y;
         z += vec.z;
@@ -93,7 +93,7 @@ struct vector4 {
      * @param vec The vector4 to subtract by.
      * @return A reference to this instance.
      */
-    vector4& operator -=(const vector4& vec) {
+    constexpr vector4& operator -=(const vector4& vec) {
         x -= vec.x;
         y -= vec.y;
         z -= vec.z;
@@ -107,7 +107,7 @@ struct vector4 {
      * @param vec The vector4 to multiply by.
      * @return A reference to this instance.
      */
-    vector4& operator *=(const vector4& vec) {
+    constexpr vector4& operator *=(const vector4& vec) {
         x *= vec.x;
         y *= vec.y;
         z *= vec.z;
@@ -121,7 +121,7 @@ struct vector4 {
      * @param vec The vector4 to divide by.
      * @return A reference to this instance.
      */
-    vector4& operator /=(const vector4& vec) {
+    constexpr vector4& operator /=(const vector4& vec) {
         x /= vec.x;
         y /= vec.y;
         z /= vec.z;
@@ -135,7 +135,7 @@ struct vector4 {
      * @param value The value to add.
      * @return A reference to this instance.
      */
-    vector4& operator +=(Type value) {
+    constexpr vector4& operator +=(Type value) {
         x += value;
         y += value;
         z += value;
@@ -149,7 +149,7 @@ struct vector4 {
      * @param value The value to subtract by.
      * @return A reference to this instance.
      */
-    vector4& operator -=(Type value) {
+    constexpr vector4& operator -=(Type value) {
         x -= value;
         y -= value;
         z -= value;
@@ -163,7 +163,7 @@ struct vector4 {
      * @param value The value to multiply by.
      * @return A reference to this instance.
      */
-    vector4& operator *=(Type value) {
+    constexpr vector4& operator *=(Type value) {
         x *= value;
         y *= value;
         z *= value;
@@ -177,7 +177,7 @@ struct vector4 {
      * @param value The value to divide by.
      * @return A reference to this instance.
      */
-    vector4& operator /=(Type value) {
+    constexpr vector4& operator /=(Type value) {
         x /= value;
         y /= value;
         z /= value;
@@ -191,7 +191,7 @@ struct vector4 {
      * @param other The vector4 to compare with.
      * @return Whether the two vector4 are equal.
      */
-    bool operator ==(const vector4& other) const {
+    constexpr bool operator ==(const vector4& other) const {
         return x == other.x && y == other.y && z == other.z && w == other.w;
     }
 
@@ -200,7 +200,7 @@ struct vector4 {
      * @param other The vector4 to compare with.
      * @return Whether the two vector4 are different.
      */
-    bool operator !=(const vector4& other) const {
+    constexpr bool operator !=(const vector4& other) const {
         return x != other.x || y != other.y || z != other.z || w != other.w;
     }
 
@@ -242,7 +242,7 @@ std::istream& operator >>(std::istream& stream, vector4<Type>& vec) {
  *  @return The component-wise sum of the two vector4.
  */
 template <typename Type>
-vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x + right.x,
         left.y + right.y,
@@ -257,7 +257,7 @@ vector4<Type> operator +(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise subtraction of the first vector4 by the second.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x - right.x,
         left.y - right.y,
@@ -272,7 +272,7 @@ vector4<Type> operator -(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise product of the two vector4.
  */
 template <typename Type>
-vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x * right.x,
         left.y * right.y,
@@ -287,7 +287,7 @@ vector4<Type> operator *(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise division of the first vector4 by the second.
  */
 template <typename Type>
-vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right) {
+constexpr vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right) {
     return vector4<Type>(
         left.x / right.x,
         left.y / right.y,
@@ -302,7 +302,7 @@ vector4<Type> operator /(const vector4<Type>& left, const vector4<Type>& right)
  *  @return The component-wise sum of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator +(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator +(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x + value,
         vec.y + value,
@@ -317,7 +317,7 @@ vector4<Type> operator +(const vector4<Type>& vec, Type value) {
  *  @return The component-wise subtraction of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator -(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x - value,
         vec.y - value,
@@ -332,7 +332,7 @@ vector4<Type> operator -(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator *(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator *(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x * value,
         vec.y * value,
@@ -347,7 +347,7 @@ vector4<Type> operator *(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator *(Type value, const vector4<Type>& vec) {
+constexpr vector4<Type> operator *(Type value, const vector4<Type>& vec) {
     return vector4<Type>(
         value * vec.x,
         value * vec.y,
@@ -362,7 +362,7 @@ vector4<Type> operator *(Type value, const vector4<Type>& vec) {
  *  @return The component-wise division of a vector4 by a value.
  */
 template <typename Type>
-vector4<Type> operator /(const vector4<Type>& vec, Type value) {
+constexpr vector4<Type> operator /(const vector4<Type>& vec, Type value) {
     return vector4<Type>(
         vec.x / value,
         vec.y / value,
@@ -377,6 +377,6 @@ vector4<Type> operator /(const vector4<Type>& vec, Type value) {
  *  @return The component-wise product of a vector4 by -1.
  */
 template <typename Type>
-vector4<Type> operator -(const vector4<Type>& vec) {
+constexpr vector4<Type> operator -(const vector4<Type>& vec) {
     return vector4(-vec.x, -vec.y, -vec.z, -vec.w);
 }
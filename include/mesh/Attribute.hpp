@@ -16,6 +16,8 @@ enum Attribute : unsigned char {
     ATTRIBUTE_COLOR,
     ATTRIBUTE_TANGENT,
     ATTRIBUTE_POINT_SIZE,
+    ATTRIBUTE_JOINTS,  ///< The indices of the 4 joints that influence a vertex, in its skin.
+    ATTRIBUTE_WEIGHTS, ///< The weights of the 4 joints that influence a vertex.
 
     ATTRIBUTE_AMOUNT
 };
@@ -28,6 +30,20 @@ enum class AttributeType : unsigned char {
     VEC4,
 };
 
+/**
+ * @enum ComponentType
+ * @brief The type of the components of an attribute or of the indices. Integer attributes are
+ * converted to floats when they are read by the shaders, normalized or not.
+ */
+enum class ComponentType : unsigned char {
+    FLOAT,
+    BYTE,
+    UNSIGNED_BYTE,
+    SHORT,
+    UNSIGNED_SHORT,
+    UNSIGNED_INT,
+};
+
 inline unsigned int get_attribute_type_count(AttributeType type) {
     switch(type) {
         case AttributeType::FLOAT: return 1;
@@ -38,6 +54,43 @@ inline unsigned int get_attribute_type_count(AttributeType type) {
     }
 }
 
+inline unsigned int get_component_type_size(ComponentType type) {
+    switch(type) {
+        case ComponentType::FLOAT: return 4;
+        case ComponentType::BYTE: return 1;
+        case ComponentType::UNSIGNED_BYTE: return 1;
+        case ComponentType::SHORT: return 2;
+        case ComponentType::UNSIGNED_SHORT: return 2;
+        case ComponentType::UNSIGNED_INT: return 4;
+        default: return 0;
+    }
+}
+
+/**
+ * @return The size in bytes of an attribute in an interleaved vertex. It is padded to 4 bytes like
+ * OpenGL and glTF require.
+ */
+inline unsigned int get_attribute_size(AttributeType type, ComponentType component_type) {
+    return (get_attribute_type_count(type) * get_component_type_size(component_type) + 3) & ~3u;
+}
+
+/**
+ * @brief Reads a component and converts it to a float like OpenGL does for vertex attributes.
+ * @param data The component's bytes.
+ * @param type The type of the component.
+ * @param is_normalized Whether integers are mapped to [0, 1] or [-1, 1].
+ * @return The component's value.
+ */
+float read_component(const unsigned char* data, ComponentType type, bool is_normalized);
+
+/**
+ * @brief Reads an integer component without converting it to a float, for indices.
+ * @param data The component's bytes.
+ * @param type The type of the component, which needs to be an unsigned integer type.
+ * @return The component's value.
+ */
+unsigned int read_unsigned_component(const unsigned char* data, ComponentType type);
+
 inline AttributeType get_attribute_type_from_value(float) { return AttributeType::FLOAT; }
 
 inline AttributeType get_attribute_type_from_value(const vec2&) { return AttributeType::VEC2; }
@@ -54,6 +107,8 @@ inline AttributeType get_default_attribute_type(Attribute attribute) {
         case ATTRIBUTE_COLOR: return AttributeType::VEC3;
         case ATTRIBUTE_TANGENT: return AttributeType::VEC4;
         case ATTRIBUTE_POINT_SIZE: return AttributeType::FLOAT;
+        case ATTRIBUTE_JOINTS: return AttributeType::VEC4;
+        case ATTRIBUTE_WEIGHTS: return AttributeType::VEC4;
         default: return AttributeType::NONE;
     }
 }
@@ -66,6 +121,8 @@ inline std::string attribute_to_string(Attribute attribute) {
         case ATTRIBUTE_COLOR: return "COLOR";
         case ATTRIBUTE_TANGENT: return "TANGENT";
         case ATTRIBUTE_POINT_SIZE: return "POINT_SIZE";
+        case ATTRIBUTE_JOINTS: return "JOINTS";
+        case ATTRIBUTE_WEIGHTS: return "WEIGHTS";
         default: return "INVALID";
     }
 }
@@ -79,3 +136,15 @@ inline std::string attribute_type_to_string(AttributeType type) {
         default: return "NONE";
     }
 }
+
+inline std::string component_type_to_string(ComponentType type) {
+    switch(type) {
+        case ComponentType::FLOAT: return "FLOAT";
+        case ComponentType::BYTE: return "BYTE";
+        case ComponentType::UNSIGNED_BYTE: return "UNSIGNED_BYTE";
+        case ComponentType::SHORT: return "SHORT";
+        case ComponentType::UNSIGNED_SHORT: return "UNSIGNED_SHORT";
+        case ComponentType::UNSIGNED_INT: return "UNSIGNED_INT";
+        default: return "NONE";
+    }
+}
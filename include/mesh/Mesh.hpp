@@ -5,24 +5,50 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 #include "Attribute.hpp"
 #include "culling/AABB.hpp"
-#include "glad/glad.h"
+#include "maths/affine3x4.hpp"
 #include "maths/mat4.hpp"
 #include "maths/vec2.hpp"
 #include "maths/vec3.hpp"
 #include "maths/vec4.hpp"
 
+struct MeshBuffers;
 struct Ray;
 
 enum class MeshPrimitive : unsigned char {
     NONE,
     POINTS,
     LINES,
+    LINE_STRIP,
+    LINE_LOOP,
     TRIANGLES,
+    TRIANGLE_STRIP,
+    TRIANGLE_FAN,
 };
 
+/**
+ * @return Whether a primitive is made of triangles.
+ */
+inline bool is_triangle_primitive(MeshPrimitive primitive) {
+    return primitive == MeshPrimitive::TRIANGLES
+           || primitive == MeshPrimitive::TRIANGLE_STRIP
+           || primitive == MeshPrimitive::TRIANGLE_FAN;
+}
+
+/**
+ * @return Whether a primitive is made of lines.
+ */
+inline bool is_line_primitive(MeshPrimitive primitive) {
+    return primitive == MeshPrimitive::LINES
+           || primitive == MeshPrimitive::LINE_STRIP
+           || primitive == MeshPrimitive::LINE_LOOP;
+}
+
 /**
  * @class Mesh
  * @brief
@@ -32,6 +58,9 @@ public:
     explicit Mesh(MeshPrimitive primitive = MeshPrimitive::NONE);
     ~Mesh();
 
+    Mesh(Mesh&& mesh) noexcept = default;            ///< Default move constructor.
+    Mesh& operator=(Mesh&& mesh) noexcept = default; ///< Default move operator.
+
     void draw() const;
 
     void draw_normals() const;
@@ -47,8 +76,26 @@ public:
 
     AttributeType get_attribute_type(Attribute attribute) const;
 
+    /**
+     * @return The type of the components of an attribute.
+     */
+    ComponentType get_attribute_component_type(Attribute attribute) const;
+
+    /**
+     * @return Whether an integer attribute is normalized.
+     */
+    bool is_attribute_normalized(Attribute attribute) const;
+
     bool has_attribute(Attribute attribute) const;
 
+    /**
+     * @brief Reads an attribute of a vertex and converts it to floats.
+     * @param attribute The attribute, which needs to be enabled.
+     * @param vertex The index of the vertex.
+     * @return The attribute's value. The components the attribute doesn't have are 0, or 1 for w.
+     */
+    vec4 get_attribute_value(Attribute attribute, size_t vertex) const;
+
     /**
      * @return The amount of vertices in the mesh.
      */
@@ -59,10 +106,89 @@ public:
      */
     size_t get_indices_amount() const;
 
+    /**
+     * @param index The index's position in the indices.
+     * @return The index.
+     */
+    unsigned int get_index(size_t index) const;
+
+    /**
+     * @return The type of the indices, UNSIGNED_SHORT or UNSIGNED_INT.
+     */
+    ComponentType get_index_type() const;
+
+    /**
+     * @brief Sets the type of the indices and converts the existing ones.
+     * @param type The type of the indices, UNSIGNED_SHORT or UNSIGNED_INT.
+     */
+    void set_index_type(ComponentType type);
+
+    /**
+     * @return The index that restarts a strip, fan or loop, which is the maximum value of the index
+     * type as GL_PRIMITIVE_RESTART_FIXED_INDEX is enabled.
+     */
+    unsigned int get_restart_index() const;
+
+    /**
+     * @return The interleaved vertex data, either the mesh's own or its external data.
+     */
+    std::span<const unsigned char> get_data() const;
+
+    /**
+     * @return The indices' bytes, either the mesh's own or its external indices.
+     */
+    std::span<const unsigned char> get_indices() const;
+
+    /**
+     * @brief Makes the mesh use vertex data it doesn't own instead of copying it, for example data
+     * in a memory mapped file. Its own vertex data is cleared.
+     * @warning The data needs to be interleaved in the order of the attributes with the mesh's
+     * stride, and to stay alive as long as the mesh uses it.
+     * @param data The vertex data.
+     */
+    void set_external_data(std::span<const unsigned char> data);
+
+    /**
+     * @brief Makes the mesh use indices it doesn't own instead of copying them. Its own indices are
+     * cleared.
+     * @warning The indices need to stay alive as long as the mesh uses them.
+     * @param indices The indices' bytes.
+     * @param type The type of the indices, UNSIGNED_SHORT or UNSIGNED_INT.
+     */
+    void set_external_indices(std::span<const unsigned char> indices, ComponentType type);
+
     AttributeType get_attribute_type(Attribute attribute);
 
     AABB get_AABB() const;
 
+    /**
+     * @brief Recomputes the mesh's AABB from its positions. Does not use OpenGL.
+     */
+    void update_AABB();
+
+    /**
+     * @return Whether the mesh's OpenGL buffers were created.
+     */
+    bool are_buffers_bound() const;
+
+    /**
+     * @return The size in bytes of the vertex data and indices, i.e. what bind_buffers uploads.
+     */
+    size_t get_buffers_size() const;
+
+    /**
+     * @return A hash of the mesh's primitive, attributes, vertex data and indices. Meshes with the
+     * same hash can share their OpenGL buffers.
+     */
+    uint64_t get_content_hash() const;
+
+    /**
+     * @param other The other mesh.
+     * @return Whether the meshes have the same primitive, attributes, vertex data and indices, all
+     * that get_content_hash hashes. Used to make sure meshes with the same hash are duplicates.
+     */
+    bool has_same_content(const Mesh& other) const;
+
     /**
      * @brief Calculates the minimum and maximum value for each coordinate for every position in the
      * mesh. If the mesh doesn't have positions, does nothing.
@@ -71,7 +197,73 @@ public:
      */
     void get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) const;
 
-    float intersect(const Ray& ray, const mat4& model_matrix) const;
+    float intersect(const Ray& ray, const affine3x4& model_matrix) const;
+
+    /**
+     * @brief Intersects a ray with the mesh's triangles using other positions than the mesh's, for
+     * example skinned positions.
+     * @param ray The ray.
+     * @param model_matrix The model matrix applied to the positions.
+     * @param positions The position of every vertex of the mesh, with a w of 1.
+     * @return The distance to the closest intersection, or -infinity if there is none.
+     */
+    float intersect(const Ray& ray, const affine3x4& model_matrix, std::span<const vec4> positions) const;
+
+    /**
+     * @brief Calls a function on every triangle of the mesh, whether it is a list, strips or fans,
+     * with or without indices. Restart indices end the current strip or fan. Strip triangles keep
+     * the winding of the first one. Does nothing if the mesh isn't made of triangles.
+     * @param function The function, called with the three vertex indices of each triangle.
+     */
+    template <typename Function>
+    void for_each_triangle(Function&& function) const {
+        if(!is_triangle_primitive(primitive)) { return; }
+
+        const bool is_indexed = get_indices_amount() > 0;
+        const size_t count = is_indexed ? get_indices_amount() : get_vertices_amount();
+        auto get_vertex = [&](size_t i) { return is_indexed ? get_index(i) : static_cast<unsigned int>(i); };
+
+        if(primitive == MeshPrimitive::TRIANGLES) {
+            for(size_t i = 0 ; i + 2 < count ; i += 3) { function(get_vertex(i), get_vertex(i + 1), get_vertex(i + 2)); }
+            return;
+        }
+
+        const unsigned int restart_index = get_restart_index();
+        unsigned int first = 0, previous = 0, last = 0; // The first and the last two vertices.
+        size_t strip_length = 0;
+
+        for(size_t i = 0 ; i < count ; ++i) {
+            unsigned int vertex = get_vertex(i);
+            if(is_indexed && vertex == restart_index) {
+                strip_length = 0;
+                continue;
+            }
+
+            if(strip_length == 0) { first = vertex; }
+
+            if(strip_length >= 2) {
+                if(primitive == MeshPrimitive::TRIANGLE_FAN) {
+                    function(first, last, vertex);
+                } else if(strip_length % 2 == 0) {
+                    function(previous, last, vertex);
+                } else {
+                    function(last, previous, vertex);
+                }
+            }
+
+            previous = last;
+            last = vertex;
+            ++strip_length;
+        }
+    }
+
+    /**
+     * @brief Converts an indexed triangle list to triangle strips separated by restart indices if
+     * that results in fewer indices. Strips are grown greedily across shared edges and keep the
+     * triangles' winding. External indices are replaced by owned ones.
+     * @return Whether the mesh was converted.
+     */
+    bool stripify();
 
     /**
      * @brief Delete OpenGL buffers and clears the vertices array and the indices array.
@@ -84,10 +276,12 @@ public:
     void delete_buffers();
 
     /**
-     * @brief Applies a model matrix to each vertex in the mesh. If they are enabled, does this to
+     * @brief Applies a model matrix to each vertex in the mesh, which first copies external vertex
+     * data. Positions and normals need to be floats. If they are enabled, does this to
      * the following attributes:
      * - Position: P = model * P
      * - Normal: N = normalize(transpose(inverse(mat3(model))) * N)
+     * The OpenGL buffers aren't updated, bind_buffers needs to be called again.
      * @param model The model matrix to apply.
      */
     void apply_model_matrix(const mat4& model);
@@ -97,8 +291,14 @@ public:
      * @param attribute The attribute to enable.
      * @param type The data type of the attribute. If 'AttributeType::NONE' is passed, a default
      * value is set, see @link get_default_attribute_type.
+     * @param component_type The type of the attribute's components. Only float attributes can be
+     * added with add_vertex, the others need push_bytes.
+     * @param is_normalized Whether an integer attribute is normalized.
      */
-    void enable_attribute(Attribute attribute, AttributeType type = AttributeType::NONE);
+    void enable_attribute(Attribute attribute,
+                          AttributeType type = AttributeType::NONE,
+                          ComponentType component_type = ComponentType::FLOAT,
+                          bool is_normalized = false);
     void disable_attribute(Attribute attribute);
 
     template <typename... Args>
@@ -115,6 +315,11 @@ public:
     }
 
     void add_index(unsigned int index);
+
+    /**
+     * @brief Adds a restart index, which ends the current strip, fan or loop.
+     */
+    void add_primitive_restart();
     void add_line(unsigned int start, unsigned int end);
     void add_line_triangle(unsigned int A, unsigned int B, unsigned int C);
     void add_line_quad(unsigned int A, unsigned int B, unsigned int C, unsigned int D);
@@ -122,6 +327,10 @@ public:
     void add_triangle(unsigned int top, unsigned int left, unsigned int right);
     void add_face(unsigned int topL, unsigned int bottomL, unsigned int bottomR, unsigned int topR);
 
+    /**
+     * @brief Creates the OpenGL buffers and uploads the vertex data and the indices. Like the draw
+     * methods, it is implemented in MeshBuffers.cpp, which is part of engine_gl.
+     */
     void bind_buffers();
 
     void push_value(float value);
@@ -130,9 +339,19 @@ public:
     void push_value(const vec4& value);
     void push_values(const float* values, unsigned int n);
 
+    /**
+     * @brief Appends raw bytes to the vertex data, for attributes that aren't floats.
+     * @param bytes The bytes.
+     * @param size The amount of bytes.
+     */
+    void push_bytes(const void* bytes, size_t size);
+
     void push_indices_buffer(const std::vector<unsigned int>& indices);
 
 private:
+    /**
+     * @return The offset of an attribute in a vertex, in bytes.
+     */
     unsigned int get_attribute_offset(Attribute attribute) const;
 
     template <typename Type, typename... Args>
@@ -142,6 +361,12 @@ private:
         AttributeType type = attributes[attribute_id];
         AttributeType value_type = get_attribute_type_from_value(value);
 
+        if(component_types[attribute_id] != ComponentType::FLOAT) {
+            throw std::runtime_error("Trying to add a float value for an attribute whose components are '"
+                                     + component_type_to_string(component_types[attribute_id])
+                                     + "'.");
+        }
+
         if(type != value_type) {
             throw std::runtime_error("Trying to add an attribute value of type '"
                                      + attribute_type_to_string(value_type)
@@ -160,24 +385,20 @@ private:
     MeshPrimitive primitive;
 
     AttributeType attributes[ATTRIBUTE_AMOUNT];
-    unsigned int stride;                  ///< Stride in amount of floats (not bytes).
-    unsigned int active_attributes_count; ///< Amount of active attributes.
+    ComponentType component_types[ATTRIBUTE_AMOUNT];  ///< The type of the components of each attribute.
+    bool are_attributes_normalized[ATTRIBUTE_AMOUNT]; ///< Whether each integer attribute is normalized.
+    unsigned int stride;                              ///< Stride in bytes.
+    unsigned int active_attributes_count;             ///< Amount of active attributes.
+    ComponentType index_type;                         ///< The type of the indices.
 
-    std::vector<float> data;
-    std::vector<unsigned int> indices;
+    std::vector<unsigned char> data;
+    std::vector<unsigned char> indices;
+    std::span<const unsigned char> external_data;    ///< Vertex data that isn't owned, used instead of data.
+    std::span<const unsigned char> external_indices; ///< Indices that aren't owned, used instead of indices.
 
-    unsigned int VAO;
-    unsigned int VBO;
-    unsigned int EBO;
+    /// The OpenGL objects, null until bind_buffers is called. Their deleter is set by bind_buffers,
+    /// which is part of engine_gl, so Mesh itself doesn't depend on OpenGL.
+    std::unique_ptr<MeshBuffers, void (*)(MeshBuffers*)> buffers;
 
     AABB aabb;
 };
-
-inline unsigned int get_opengl_enum_for_primitive(MeshPrimitive primitive) {
-    switch(primitive) {
-        case MeshPrimitive::POINTS: return GL_POINTS;
-        case MeshPrimitive::LINES: return GL_LINES;
-        case MeshPrimitive::TRIANGLES: return GL_TRIANGLES;
-        default: return GL_NONE;
-    }
-}
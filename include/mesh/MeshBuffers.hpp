@@ -0,0 +1,50 @@
+/***************************************************************************************************
+ * @file  MeshBuffers.hpp
+ * @brief Declaration of the MeshBuffers struct
+ **************************************************************************************************/
+
+#pragma once
+
+#include "glad/glad.h"
+#include "mesh/Mesh.hpp"
+
+/**
+ * @struct MeshBuffers
+ * @brief The OpenGL objects of a mesh, created by Mesh::bind_buffers. They are part of the engine_gl
+ * library, Mesh only holds them through a pointer so that its CPU data doesn't depend on OpenGL.
+ */
+struct MeshBuffers {
+    /**
+     * @brief Deletes the OpenGL objects.
+     */
+    ~MeshBuffers();
+
+    unsigned int VAO; ///< The vertex array object.
+    unsigned int VBO; ///< The vertex buffer object.
+    unsigned int EBO; ///< The element buffer object, 0 if the mesh has no indices.
+};
+
+inline unsigned int get_opengl_enum_for_primitive(MeshPrimitive primitive) {
+    switch(primitive) {
+        case MeshPrimitive::POINTS: return GL_POINTS;
+        case MeshPrimitive::LINES: return GL_LINES;
+        case MeshPrimitive::LINE_STRIP: return GL_LINE_STRIP;
+        case MeshPrimitive::LINE_LOOP: return GL_LINE_LOOP;
+        case MeshPrimitive::TRIANGLES: return GL_TRIANGLES;
+        case MeshPrimitive::TRIANGLE_STRIP: return GL_TRIANGLE_STRIP;
+        case MeshPrimitive::TRIANGLE_FAN: return GL_TRIANGLE_FAN;
+        default: return GL_NONE;
+    }
+}
+
+inline unsigned int get_opengl_enum_for_component_type(ComponentType type) {
+    switch(type) {
+        case ComponentType::FLOAT: return GL_FLOAT;
+        case ComponentType::BYTE: return GL_BYTE;
+        case ComponentType::UNSIGNED_BYTE: return GL_UNSIGNED_BYTE;
+        case ComponentType::SHORT: return GL_SHORT;
+        case ComponentType::UNSIGNED_SHORT: return GL_UNSIGNED_SHORT;
+        case ComponentType::UNSIGNED_INT: return GL_UNSIGNED_INT;
+        default: return GL_NONE;
+    }
+}
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <initializer_list>
+#include <utility>
 
 /**
  * @class HeapArray
@@ -60,6 +61,15 @@ public:
         for(unsigned int i = 0 ; i < size ; ++i) { data[i] = other[i]; }
     }
 
+    /**
+     * @brief Move constructor. Takes the other array's data, leaving it empty.
+     */
+    HeapArray(HeapArray&& other) noexcept
+        : size(other.size), data(other.data) {
+        other.size = 0;
+        other.data = nullptr;
+    }
+
     /**
      * @brief Destructor. Releases allocated memory.
      */
@@ -82,6 +92,22 @@ public:
         return *this;
     }
 
+    /**
+     * @brief Move assignment operator. Takes the other array's data, leaving it empty.
+     */
+    HeapArray& operator=(HeapArray&& other) noexcept {
+        if(this == &other) { return *this; }
+
+        delete[] data;
+
+        size = other.size;
+        data = other.data;
+        other.size = 0;
+        other.data = nullptr;
+
+        return *this;
+    }
+
     /**
      * @brief Access element at `index`.
      * @note No bounds checking.
@@ -105,16 +131,16 @@ public:
     Type* get_data() const { return data; }
 
     /**
-     * @brief Resizes the array. If expanded, new elements are default-constructed. If shrunk,
-     * extra elements are discarded.
+     * @brief Resizes the array. Kept elements are moved, so types that can't be copied can be
+     * stored. If expanded, new elements are default-constructed. If shrunk, extra elements are
+     * discarded.
      * @param new_size New size of the array.
      */
     void resize(size_t new_size) {
         if(new_size > 0) {
             Type* temp = data;
-            data = new Type[new_size];
-            Type default_value = Type();
-            for(unsigned int i = 0 ; i < new_size ; ++i) { data[i] = i < size ? temp[i] : default_value; }
+            data = new Type[new_size]();
+            for(unsigned int i = 0 ; i < new_size && i < size ; ++i) { data[i] = std::move(temp[i]); }
             size = new_size;
             delete[] temp;
         } else {
@@ -0,0 +1,61 @@
+/***************************************************************************************************
+ * @file  MappedFile.hpp
+ * @brief Declaration of the MappedFile class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+/**
+ * @class MappedFile
+ * @brief A read only file mapped into memory. Its pages are loaded by the OS when they are first
+ * accessed and are backed by the file itself, so reading a large file this way doesn't need a copy
+ * in the process' memory and the pages can be reclaimed by the OS under memory pressure.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Creates an empty mapping.
+     */
+    MappedFile();
+
+    /**
+     * @brief Maps a whole file.
+     * @param path The path to the file.
+     * @throw std::runtime_error If the file can't be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @return The file's content. Stays valid as long as the mapping exists.
+     */
+    std::span<const unsigned char> get_data() const;
+
+    /**
+     * @return The size of the file in bytes.
+     */
+    size_t get_size() const;
+
+private:
+    /**
+     * @brief Unmaps the file if one is mapped.
+     */
+    void unmap();
+
+    void* data;  ///< The start of the mapping, nullptr if nothing is mapped.
+    size_t size; ///< The size of the mapping in bytes.
+};
@@ -0,0 +1,184 @@
+/***************************************************************************************************
+ * @file  SlotMap.hpp
+ * @brief Declaration of the Handle struct and the SlotMap class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct Handle
+ * @brief A typed reference to an element of a SlotMap. The generation makes handles to removed
+ * elements invalid, even if their slot was reused.
+ * @tparam Type The type of the referenced element.
+ */
+template <typename Type>
+struct Handle {
+    static constexpr uint32_t INVALID_INDEX = ~0u;
+
+    uint32_t index = INVALID_INDEX; ///< The index of the element's slot.
+    uint32_t generation = 0;        ///< The generation of the slot when the element was added.
+
+    /**
+     * @return Whether the handle was given by a SlotMap. It can still be stale.
+     */
+    bool is_valid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const Handle& other) const = default;
+};
+
+/**
+ * @class SlotMap
+ * @brief Stores elements in slots that are reused once their element is removed. Accessing an
+ * element through its handle is an array access, and elements never move so pointers to them stay
+ * valid until they are removed. Each element has a reference count that its users can increment and
+ * decrement to know when it can be removed.
+ * @tparam Type The type of the elements.
+ * @tparam HandleType The type referenced by the handles. It differs from Type for polymorphic
+ * elements, stored as a std::unique_ptr to their base class but referenced as the base class.
+ */
+template <typename Type, typename HandleType = Type>
+class SlotMap {
+public:
+    /**
+     * @brief Constructs an element in a free slot.
+     * @param args The arguments forwarded to the element's constructor.
+     * @return The element's handle.
+     */
+    template <typename... Args>
+    Handle<HandleType> emplace(Args&&... args) {
+        uint32_t index;
+        if(free_slots.empty()) {
+            index = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        } else {
+            index = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        Slot& slot = slots[index];
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.references_count = 0;
+        ++size;
+
+        return Handle<HandleType>(index, slot.generation);
+    }
+
+    /**
+     * @brief Destroys an element and frees its slot. All handles to the element become stale.
+     * @param handle The element's handle.
+     * @return Whether the element existed.
+     */
+    bool erase(Handle<HandleType> handle) {
+        if(!contains(handle)) { return false; }
+
+        Slot& slot = slots[handle.index];
+        slot.value.reset();
+        ++slot.generation;
+        free_slots.push_back(handle.index);
+        --size;
+
+        return true;
+    }
+
+    /**
+     * @return Whether the handle references an element that wasn't removed.
+     */
+    bool contains(Handle<HandleType> handle) const {
+        return handle.index < slots.size()
+               && slots[handle.index].generation == handle.generation
+               && slots[handle.index].value.has_value();
+    }
+
+    /**
+     * @return A pointer to the element, or nullptr if the handle is stale.
+     */
+    Type* get(Handle<HandleType> handle) {
+        return contains(handle) ? &*slots[handle.index].value : nullptr;
+    }
+
+    /**
+     * @return A pointer to the element, or nullptr if the handle is stale.
+     */
+    const Type* get(Handle<HandleType> handle) const {
+        return contains(handle) ? &*slots[handle.index].value : nullptr;
+    }
+
+    /**
+     * @brief Access the element referenced by a handle.
+     * @throw std::runtime_error If the handle is stale.
+     */
+    Type& operator[](Handle<HandleType> handle) {
+        if(!contains(handle)) { throw std::runtime_error("Stale handle in slot map."); }
+        return *slots[handle.index].value;
+    }
+
+    /**
+     * @brief Access the element referenced by a handle.
+     * @throw std::runtime_error If the handle is stale.
+     */
+    const Type& operator[](Handle<HandleType> handle) const {
+        if(!contains(handle)) { throw std::runtime_error("Stale handle in slot map."); }
+        return *slots[handle.index].value;
+    }
+
+    /**
+     * @brief Increments an element's reference count.
+     */
+    void add_reference(Handle<HandleType> handle) {
+        if(contains(handle)) { ++slots[handle.index].references_count; }
+    }
+
+    /**
+     * @brief Decrements an element's reference count.
+     * @return The remaining amount of references.
+     */
+    uint32_t remove_reference(Handle<HandleType> handle) {
+        if(!contains(handle) || slots[handle.index].references_count == 0) { return 0; }
+        return --slots[handle.index].references_count;
+    }
+
+    /**
+     * @return The element's reference count, 0 if the handle is stale.
+     */
+    uint32_t get_references_count(Handle<HandleType> handle) const {
+        return contains(handle) ? slots[handle.index].references_count : 0;
+    }
+
+    /**
+     * @brief Calls a function on every element.
+     * @param function The function, called with a reference to each element.
+     */
+    template <typename Function>
+    void for_each(Function&& function) {
+        for(Slot& slot : slots) {
+            if(slot.value.has_value()) { function(*slot.value); }
+        }
+    }
+
+    /**
+     * @return The amount of elements.
+     */
+    size_t get_size() const { return size; }
+
+private:
+    /**
+     * @struct Slot
+     * @brief An element and the generation of its slot.
+     */
+    struct Slot {
+        std::optional<Type> value;     ///< The element, empty if the slot is free.
+        uint32_t generation = 0;       ///< Incremented every time the slot's element is removed.
+        uint32_t references_count = 0; ///< The amount of users of the element.
+    };
+
+    std::deque<Slot> slots;           ///< The slots. A deque so that elements never move.
+    std::vector<uint32_t> free_slots; ///< The indices of the free slots.
+    size_t size = 0;                  ///< The amount of elements.
+};
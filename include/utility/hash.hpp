@@ -0,0 +1,25 @@
+/***************************************************************************************************
+ * @file  hash.hpp
+ * @brief Declaration of hashing functions
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Hashes data with the 64 bits xxHash function (XXH64), which processes several gigabytes
+ * per second and is used to identify assets by their content.
+ * @param data The data to hash.
+ * @param size The size of the data in bytes.
+ * @param seed The seed, which can be the hash of previous data to chain hashes.
+ * @return The hash of the data.
+ */
+uint64_t hash_xxh64(const void* data, size_t size, uint64_t seed = 0);
+
+/**
+ * @return The hash as 16 hexadecimal digits.
+ */
+std::string hash_to_string(uint64_t hash);
@@ -13,7 +13,9 @@ in vec3 v_tangent_position;
 layout (binding = 2) uniform sampler2D u_normal_map;
 
 void get_directions(out vec3 normal, out vec3 light_direction, out vec3 view_direction) {
-    normal = normalize(texture(u_normal_map, v_tex_coords).rgb * 2.0f - 1.0f);
+    // Normal maps can be compressed to two channels (BC5) so z is always reconstructed.
+    vec2 normal_xy = texture(u_normal_map, v_tex_coords).rg * 2.0f - 1.0f;
+    normal = normalize(vec3(normal_xy, sqrt(max(1.0f - dot(normal_xy, normal_xy), 0.0f))));
     light_direction = normalize(v_tangent_light_position - v_tangent_position);
     view_direction = normalize(v_tangent_view_position - v_tangent_position);
 }
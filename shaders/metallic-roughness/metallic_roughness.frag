@@ -26,10 +26,14 @@ uniform vec4 u_base_color;
 uniform float u_metallic;
 uniform float u_roughness;
 uniform float u_reflectance;
+uniform bool u_is_base_color_virtual;
 
 // Needs to be defined in another .frag file.
 void get_directions(out vec3 normal, out vec3 light_direction, out vec3 view_direction);
 
+// Defined in virtual_texture.frag.
+vec4 sample_virtual_texture(vec2 uv);
+
 float pow2(float x) { return x * x; }
 float pow5(const float x) {
     float x2 = x * x;
@@ -85,7 +89,12 @@ vec3 brdf(vec3 base_color, float metallic, float roughness) {
 }
 
 void main() {
-    vec4 base_color = u_base_color * texture(u_base_color_map, v_tex_coords);
+    vec4 base_color = u_base_color;
+    if (u_is_base_color_virtual) {
+        base_color *= sample_virtual_texture(v_tex_coords);
+    } else {
+        base_color *= texture(u_base_color_map, v_tex_coords);
+    }
 
     frag_color.a = base_color.a;
     if (frag_color.a < 0.2f) { discard; }
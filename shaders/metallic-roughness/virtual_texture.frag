@@ -0,0 +1,56 @@
+/***************************************************************************************************
+ * @file  virtual_texture.frag
+ * @brief Implementation of the functions used to sample virtual textures
+ **************************************************************************************************/
+
+#version 460 core
+
+// Need to match the constants of the VirtualTextureSystem class.
+const float PAGE_SIZE = 128.0f;
+const float PAGE_BORDER = 4.0f;
+const float SLOT_SIZE = PAGE_SIZE + 2.0f * PAGE_BORDER;
+const float ATLAS_SIZE = 32.0f * SLOT_SIZE;
+
+struct VirtualTexture {
+    vec2 size;
+    int max_level;
+    int index;
+};
+
+uniform VirtualTexture u_virtual_texture;
+
+layout (binding = 3) uniform usampler2D u_page_table;
+layout (binding = 4) uniform sampler2D u_physical_atlas;
+
+vec2 get_level_size(int level) {
+    return max(floor(u_virtual_texture.size / exp2(float(level))), vec2(1.0f));
+}
+
+// Returns the page that needs to be sampled at uv, as x, y and level.
+ivec3 get_virtual_page(vec2 uv, float lod_bias) {
+    vec2 texels = uv * u_virtual_texture.size;
+    float max_derivative = max(dot(dFdx(texels), dFdx(texels)), dot(dFdy(texels), dFdy(texels)));
+    float lod = 0.5f * log2(max(max_derivative, 1e-8f)) + lod_bias;
+    int level = clamp(int(floor(lod + 0.5f)), 0, u_virtual_texture.max_level);
+
+    vec2 page = floor(fract(uv) * get_level_size(level) / PAGE_SIZE);
+    return ivec3(page, level);
+}
+
+vec4 sample_virtual_texture(vec2 uv) {
+    ivec3 page = get_virtual_page(uv, 0.0f);
+
+    // The entry gives the slot of the page, or of its closest resident ancestor, and its level.
+    uvec4 entry = texelFetch(u_page_table, page.xy, page.z);
+    vec2 in_page = fract(fract(uv) * get_level_size(int(entry.z)) / PAGE_SIZE);
+    vec2 atlas_texel = vec2(entry.xy) * SLOT_SIZE + PAGE_BORDER + in_page * PAGE_SIZE;
+
+    return textureLod(u_physical_atlas, atlas_texel / ATLAS_SIZE, 0.0f);
+}
+
+// Returns the page needed at uv as x, y, level and texture index + 1, 0 meaning no page. Written to
+// an RGBA16UI target, so the index needs to be below VirtualTextureSystem::MAX_TEXTURES_COUNT.
+uvec4 get_virtual_texture_feedback(vec2 uv, float lod_bias) {
+    ivec3 page = get_virtual_page(uv, lod_bias);
+    return uvec4(page, u_virtual_texture.index + 1);
+}
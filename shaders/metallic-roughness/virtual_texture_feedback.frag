@@ -0,0 +1,21 @@
+/***************************************************************************************************
+ * @file  virtual_texture_feedback.frag
+ * @brief Fragment shader that writes the virtual texture pages needed by each fragment
+ **************************************************************************************************/
+
+#version 460 core
+
+in vec2 v_tex_coords;
+
+out uvec4 frag_page;
+
+// Compensates for the feedback pass' lower resolution.
+uniform float u_feedback_lod_bias;
+uniform bool u_is_base_color_virtual;
+
+// Defined in virtual_texture.frag.
+uvec4 get_virtual_texture_feedback(vec2 uv, float lod_bias);
+
+void main() {
+    frag_page = u_is_base_color_virtual ? get_virtual_texture_feedback(v_tex_coords, u_feedback_lod_bias) : uvec4(0);
+}
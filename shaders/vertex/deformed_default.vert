@@ -0,0 +1,39 @@
+/***************************************************************************************************
+ * @file  deformed_default.vert
+ * @brief Default vertex shader for morphed and skinned meshes. The morph targets are applied first,
+ * then the skinning. The normals are transformed by the skinning matrix directly, which assumes the
+ * joints are uniformly scaled.
+ **************************************************************************************************/
+
+#version 460 core
+
+layout (location = 0) in vec3 a_position;
+layout (location = 1) in vec3 a_normal;
+layout (location = 2) in vec2 a_tex_coords;
+
+out vec3 v_position;
+out vec3 v_normal;
+out vec2 v_tex_coords;
+
+uniform mat4 u_mvp;
+uniform mat4 u_model;
+uniform mat3 u_normals_model_matrix;
+
+mat4 get_skinning_matrix();
+void apply_morph_targets(inout vec3 position, inout vec3 normal, inout vec3 tangent);
+
+void main() {
+    vec3 morphed_position = a_position;
+    vec3 morphed_normal = a_normal;
+    vec3 morphed_tangent = vec3(0.0f);
+    apply_morph_targets(morphed_position, morphed_normal, morphed_tangent);
+
+    mat4 skinning = get_skinning_matrix();
+    vec4 pos = skinning * vec4(morphed_position, 1.0f);
+
+    gl_Position = u_mvp * pos;
+
+    v_position = (u_model * pos).xyz;
+    v_normal = normalize(u_normals_model_matrix * (mat3(skinning) * morphed_normal));
+    v_tex_coords = a_tex_coords;
+}
@@ -0,0 +1,59 @@
+/***************************************************************************************************
+ * @file  deformed_tangent.vert
+ * @brief Vertex shader for morphed and skinned meshes that handles 4 vertex attributes: positions,
+ * normals, texture coordinates and tangents. The morph targets are applied first, then the skinning.
+ * The normals and tangents are transformed by the skinning matrix directly, which assumes the joints
+ * are uniformly scaled.
+ **************************************************************************************************/
+
+#version 460 core
+
+layout (location = 0) in vec3 a_position;
+layout (location = 1) in vec3 a_normal;
+layout (location = 2) in vec2 a_tex_coords;
+layout (location = 4) in vec4 a_tangent;
+
+out vec2 v_tex_coords;
+out vec3 v_tangent_light_position;
+out vec3 v_tangent_view_position;
+out vec3 v_tangent_position;
+
+uniform mat4 u_mvp;
+uniform mat4 u_model;
+uniform mat3 u_normals_model_matrix;
+
+struct Light {
+    float intensity;
+    vec3 color;
+    vec3 position;
+};
+
+uniform Light u_light;
+uniform vec3 u_camera_position;
+
+mat4 get_skinning_matrix();
+void apply_morph_targets(inout vec3 position, inout vec3 normal, inout vec3 tangent);
+
+void main() {
+    vec3 morphed_position = a_position;
+    vec3 morphed_normal = a_normal;
+    vec3 morphed_tangent = a_tangent.xyz;
+    apply_morph_targets(morphed_position, morphed_normal, morphed_tangent);
+
+    mat4 skinning = get_skinning_matrix();
+    vec4 pos = skinning * vec4(morphed_position, 1.0f);
+
+    gl_Position = u_mvp * pos;
+
+    vec3 position = (u_model * pos).xyz;
+    v_tex_coords = a_tex_coords;
+
+    vec3 normal = normalize(u_normals_model_matrix * (mat3(skinning) * morphed_normal));
+    vec3 tangent = normalize(u_normals_model_matrix * (mat3(skinning) * morphed_tangent));
+    tangent = normalize(tangent - dot(tangent, normal) * normal);
+    vec3 bitangent = a_tangent.w * cross(normal, tangent);
+    mat3 TBN = transpose(mat3(tangent, bitangent, normal));
+    v_tangent_light_position = TBN * u_light.position;
+    v_tangent_view_position = TBN * u_camera_position;
+    v_tangent_position = TBN * position;
+}
@@ -0,0 +1,57 @@
+/***************************************************************************************************
+ * @file  morphing.vert
+ * @brief Implementation of the apply_morph_targets function for the deformed shaders. The deltas are
+ * grouped by vertex, so each vertex only goes through the targets that move it. Morphs with few active
+ * targets are blended on the CPU instead, and each vertex reads a single delta.
+ **************************************************************************************************/
+
+#version 460 core
+
+struct MorphDelta {
+    vec4 position; // The index of the target is in w.
+    vec4 normal;
+    vec4 tangent;
+};
+
+layout (std430, binding = 3) readonly buffer morph_ranges_buffer {
+    uvec2 morph_ranges[]; // The first delta and the amount of deltas of each vertex.
+};
+
+layout (std430, binding = 4) readonly buffer morph_deltas_buffer {
+    MorphDelta morph_deltas[];
+};
+
+layout (std430, binding = 5) readonly buffer morph_weights_buffer {
+    float morph_weights[];
+};
+
+layout (std430, binding = 6) readonly buffer morph_blended_buffer {
+    MorphDelta morph_blended_deltas[]; // One delta per vertex, indexed like the ranges.
+};
+
+uniform uint u_morph_ranges_offset;
+uniform uint u_morph_weights_offset; // 0xFFFFFFFF if the mesh has no morph targets.
+uniform bool u_is_morph_blended;
+
+void apply_morph_targets(inout vec3 position, inout vec3 normal, inout vec3 tangent) {
+    if(u_morph_weights_offset == 0xFFFFFFFFu) { return; }
+
+    if(u_is_morph_blended) {
+        MorphDelta delta = morph_blended_deltas[u_morph_ranges_offset + gl_VertexID];
+        position += delta.position.xyz;
+        normal += delta.normal.xyz;
+        tangent += delta.tangent.xyz;
+        return;
+    }
+
+    uvec2 range = morph_ranges[u_morph_ranges_offset + gl_VertexID];
+
+    for(uint i = range.x ; i < range.x + range.y ; ++i) {
+        MorphDelta delta = morph_deltas[i];
+        float weight = morph_weights[u_morph_weights_offset + uint(delta.position.w)];
+
+        position += weight * delta.position.xyz;
+        normal += weight * delta.normal.xyz;
+        tangent += weight * delta.tangent.xyz;
+    }
+}
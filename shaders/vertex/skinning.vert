@@ -0,0 +1,29 @@
+/***************************************************************************************************
+ * @file  skinning.vert
+ * @brief Implementation of the get_skinning_matrix function for the deformed shaders
+ **************************************************************************************************/
+
+#version 460 core
+
+layout (location = 6) in vec4 a_joints;
+layout (location = 7) in vec4 a_weights;
+
+// The first 3 rows of each joint matrix, whose last row is always (0, 0, 0, 1).
+layout (std430, binding = 2) readonly buffer joint_matrices_buffer {
+    mat3x4 joint_matrices[];
+};
+
+uniform uint u_joint_offset; // 0xFFFFFFFF if the mesh isn't skinned.
+
+mat4 get_skinning_matrix() {
+    if(u_joint_offset == 0xFFFFFFFFu) { return mat4(1.0f); }
+
+    uvec4 joints = uvec4(a_joints) + u_joint_offset;
+
+    mat3x4 rows = a_weights.x * joint_matrices[joints.x]
+                  + a_weights.y * joint_matrices[joints.y]
+                  + a_weights.z * joint_matrices[joints.z]
+                  + a_weights.w * joint_matrices[joints.w];
+
+    return transpose(mat4(rows));
+}
@@ -0,0 +1,15 @@
+/***************************************************************************************************
+ * @file  Animation.cpp
+ * @brief Implementation of the Animation struct
+ **************************************************************************************************/
+
+#include "animation/Animation.hpp"
+
+#include <cmath>
+
+void Animation::advance(float delta) {
+    if(duration <= 0.0f) { return; }
+
+    time = std::fmod(time + speed * delta, duration);
+    if(time < 0.0f) { time += duration; }
+}
@@ -0,0 +1,102 @@
+/***************************************************************************************************
+ * @file  AnimationChannel.cpp
+ * @brief Implementation of the AnimationChannel struct
+ **************************************************************************************************/
+
+#include "animation/AnimationChannel.hpp"
+
+#include <algorithm>
+
+#include "maths/geometry.hpp"
+#include "maths/quaternion.hpp"
+
+void AnimationChannel::sample(float time, float* value) const {
+    const unsigned int components_count = get_components_count();
+
+    if(times.empty()) {
+        std::fill_n(value, components_count, 0.0f);
+        return;
+    }
+
+    const bool is_cubic = interpolation == AnimationInterpolation::CUBIC_SPLINE;
+    const unsigned int keyframe_size = is_cubic ? 3 * components_count : components_count;
+    const unsigned int value_offset = is_cubic ? components_count : 0;
+
+    /* The offset selects the in-tangent, the value or the out-tangent of cubic spline keyframes. */
+    auto get_value = [&](size_t keyframe, unsigned int offset) {
+        return &values[keyframe * keyframe_size + offset];
+    };
+
+    if(time <= times.front()) {
+        std::copy_n(get_value(0, value_offset), components_count, value);
+        return;
+    }
+    if(time >= times.back()) {
+        std::copy_n(get_value(times.size() - 1, value_offset), components_count, value);
+        return;
+    }
+
+    const size_t next = std::ranges::upper_bound(times, time) - times.begin();
+    const size_t previous = next - 1;
+    const float delta = times[next] - times[previous];
+    const float t = (time - times[previous]) / delta;
+
+    switch(interpolation) {
+        case AnimationInterpolation::STEP:
+            std::copy_n(get_value(previous, 0), components_count, value);
+            break;
+        case AnimationInterpolation::LINEAR: {
+            const float* start = get_value(previous, 0);
+            const float* end = get_value(next, 0);
+
+            if(path == AnimationPath::ROTATION) {
+                quaternion rotation = slerp(quaternion(start[0], start[1], start[2], start[3]),
+                                            quaternion(end[0], end[1], end[2], end[3]),
+                                            t);
+                value[0] = rotation.x;
+                value[1] = rotation.y;
+                value[2] = rotation.z;
+                value[3] = rotation.w;
+            } else {
+                for(unsigned int i = 0 ; i < components_count ; ++i) { value[i] = start[i] + t * (end[i] - start[i]); }
+            }
+            break;
+        }
+        case AnimationInterpolation::CUBIC_SPLINE: {
+            /* Hermite spline, the tangents are scaled by the duration between the keyframes. */
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            const float* start = get_value(previous, components_count);
+            const float* start_tangent = get_value(previous, 2 * components_count);
+            const float* end = get_value(next, components_count);
+            const float* end_tangent = get_value(next, 0);
+
+            for(unsigned int i = 0 ; i < components_count ; ++i) {
+                value[i] = (2.0f * t3 - 3.0f * t2 + 1.0f) * start[i]
+                           + (t3 - 2.0f * t2 + t) * delta * start_tangent[i]
+                           + (-2.0f * t3 + 3.0f * t2) * end[i]
+                           + (t3 - t2) * delta * end_tangent[i];
+            }
+
+            if(path == AnimationPath::ROTATION) {
+                vec4 rotation = normalize(vec4(value[0], value[1], value[2], value[3]));
+                for(unsigned int i = 0 ; i < 4 ; ++i) { value[i] = rotation[i]; }
+            }
+            break;
+        }
+    }
+}
+
+vec4 AnimationChannel::sample(float time) const {
+    vec4 value(0.0f);
+    sample(time, &value.x);
+    return value;
+}
+
+unsigned int AnimationChannel::get_components_count() const {
+    switch(path) {
+        case AnimationPath::ROTATION: return 4;
+        case AnimationPath::WEIGHTS: return weights_count;
+        default: return 3;
+    }
+}
@@ -0,0 +1,78 @@
+/***************************************************************************************************
+ * @file  AnimationSampler.cpp
+ * @brief Implementation of the AnimationSampler class
+ **************************************************************************************************/
+
+#include "animation/AnimationSampler.hpp"
+
+#include <algorithm>
+
+size_t AnimationSampler::sample(std::span<Animation> animations,
+                                std::vector<Transform>& transforms,
+                                std::span<float> morph_weights) {
+    size_t tracks_count = sample(animations);
+    const float* sampled_weights = weights.data();
+
+    for(const Sample& sample : samples) {
+        switch(sample.path) {
+            case AnimationPath::TRANSLATION:
+                transforms[sample.node].set_local_position(sample.value.x, sample.value.y, sample.value.z);
+                break;
+            case AnimationPath::ROTATION:
+                transforms[sample.node].set_local_orientation(sample.value.x, sample.value.y, sample.value.z, sample.value.w);
+                break;
+            case AnimationPath::SCALE:
+                transforms[sample.node].set_local_scale(sample.value.x, sample.value.y, sample.value.z);
+                break;
+            case AnimationPath::WEIGHTS: {
+                unsigned int count = static_cast<unsigned int>(sample.value.x);
+                std::copy_n(sampled_weights, count, morph_weights.begin() + sample.node);
+                sampled_weights += count;
+                break;
+            }
+        }
+    }
+
+    return tracks_count;
+}
+
+size_t AnimationSampler::sample(std::span<Animation> animations) {
+    samples.clear();
+    weights.clear();
+    rotation_starts.clear();
+    rotation_ends.clear();
+    rotation_factors.clear();
+    rotation_samples.clear();
+
+    for(Animation& animation : animations) {
+        if(!animation.is_playing) { continue; }
+
+        for(AnimationTrack& track : animation.tracks) {
+            if(track.path == AnimationPath::WEIGHTS) {
+                /* The weights are stored apart since there can be more than 4, the sample only
+                 * keeps their amount. */
+                size_t first_weight = weights.size();
+                weights.resize(first_weight + track.components_count);
+                track.sample(animation.time, &weights[first_weight]);
+                samples.emplace_back(vec4(static_cast<float>(track.components_count)), track.node, track.path);
+            } else if(track.path == AnimationPath::ROTATION && !track.times.empty()) {
+                /* Only the keys are read here, the rotations are interpolated once every track is read. */
+                quaternion& start = rotation_starts.emplace_back();
+                quaternion& end = rotation_ends.emplace_back();
+                rotation_factors.push_back(track.get_rotation_keys(animation.time, start, end));
+                rotation_samples.push_back(samples.size());
+                samples.emplace_back(vec4(0.0f), track.node, track.path);
+            } else {
+                samples.emplace_back(track.sample(animation.time), track.node, track.path);
+            }
+        }
+    }
+
+    slerp(rotation_starts, rotation_ends, rotation_factors, rotation_starts);
+    for(size_t i = 0 ; i < rotation_samples.size() ; ++i) {
+        const quaternion& rotation = rotation_starts[i];
+        samples[rotation_samples[i]].value = vec4(rotation.x, rotation.y, rotation.z, rotation.w);
+    }
+
+    return samples.size();
+}
@@ -0,0 +1,257 @@
+/***************************************************************************************************
+ * @file  AnimationTrack.cpp
+ * @brief Implementation of the QuantizedQuaternion and AnimationTrack structs
+ **************************************************************************************************/
+
+#include "animation/AnimationTrack.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr float QUANTIZATION_RANGE = 0.70710678f; ///< The bound of the three smallest components.
+static constexpr float QUANTIZATION_STEPS = 32767.0f;    ///< The largest 15 bits value.
+
+QuantizedQuaternion QuantizedQuaternion::quantize(const vec4& q) {
+    unsigned int largest = 0;
+    for(unsigned int i = 1 ; i < 4 ; ++i) {
+        if(std::abs(q[i]) > std::abs(q[largest])) { largest = i; }
+    }
+
+    /* q and -q are the same rotation, so the dropped component can be made positive. */
+    const float sign = q[largest] < 0.0f ? -1.0f : 1.0f;
+
+    QuantizedQuaternion quantized;
+    for(unsigned int i = 0, j = 0 ; i < 4 ; ++i) {
+        if(i == largest) { continue; }
+
+        float normalized = std::clamp(sign * q[i] / QUANTIZATION_RANGE * 0.5f + 0.5f, 0.0f, 1.0f);
+        quantized.data[j++] = static_cast<uint16_t>(std::lround(normalized * QUANTIZATION_STEPS));
+    }
+
+    quantized.data[0] |= (largest & 1) << 15;
+    quantized.data[1] |= (largest >> 1) << 15;
+
+    return quantized;
+}
+
+vec4 QuantizedQuaternion::dequantize() const {
+    const unsigned int largest = (data[0] >> 15) | ((data[1] >> 15) << 1);
+
+    vec4 q;
+    float squared_sum = 0.0f;
+    for(unsigned int i = 0, j = 0 ; i < 4 ; ++i) {
+        if(i == largest) { continue; }
+
+        float normalized = static_cast<float>(data[j++] & 0x7FFF) / QUANTIZATION_STEPS;
+        q[i] = (normalized * 2.0f - 1.0f) * QUANTIZATION_RANGE;
+        squared_sum += q[i] * q[i];
+    }
+    q[largest] = std::sqrt(std::max(0.0f, 1.0f - squared_sum));
+
+    return q;
+}
+
+/**
+ * @brief Interpolates between two values of a track.
+ */
+static void interpolate(AnimationPath path,
+                        unsigned int components_count,
+                        const float* start,
+                        const float* end,
+                        float t,
+                        float* value) {
+    if(path == AnimationPath::ROTATION) {
+        quaternion rotation = slerp(quaternion(start[0], start[1], start[2], start[3]),
+                                    quaternion(end[0], end[1], end[2], end[3]),
+                                    t);
+        value[0] = rotation.x;
+        value[1] = rotation.y;
+        value[2] = rotation.z;
+        value[3] = rotation.w;
+        return;
+    }
+
+    for(unsigned int i = 0 ; i < components_count ; ++i) { value[i] = start[i] + t * (end[i] - start[i]); }
+}
+
+/**
+ * @return The largest difference between the components of two values of a track. Rotations are
+ * compared with the sign that makes them the closest, since q and -q are the same rotation.
+ */
+static float get_error(AnimationPath path, unsigned int components_count, const float* value, const float* expected) {
+    float error = 0.0f;
+    float opposite_error = 0.0f;
+    for(unsigned int i = 0 ; i < components_count ; ++i) {
+        error = std::max(error, std::abs(value[i] - expected[i]));
+        opposite_error = std::max(opposite_error, std::abs(value[i] + expected[i]));
+    }
+
+    return path == AnimationPath::ROTATION ? std::min(error, opposite_error) : error;
+}
+
+AnimationTrack AnimationTrack::compress(const AnimationChannel& channel, float tolerance) {
+    AnimationTrack track;
+    track.node = channel.node;
+    track.path = channel.path;
+    track.is_step = channel.interpolation == AnimationInterpolation::STEP;
+    track.components_count = channel.get_components_count();
+
+    const unsigned int components_count = track.components_count;
+    if(channel.times.empty() || components_count == 0) { return track; }
+
+    /* ---- Keys ---- */
+    std::vector<float> times;
+    std::vector<float> values;
+
+    if(channel.interpolation == AnimationInterpolation::CUBIC_SPLINE) {
+        const float start = channel.times.front();
+        const float duration = channel.times.back() - start;
+        const size_t keys_count = static_cast<size_t>(std::ceil(duration * RESAMPLING_RATE)) + 1;
+
+        times.resize(keys_count);
+        values.resize(keys_count * components_count);
+        for(size_t i = 0 ; i < keys_count ; ++i) {
+            times[i] = std::min(start + static_cast<float>(i) / RESAMPLING_RATE, channel.times.back());
+            channel.sample(times[i], &values[i * components_count]);
+        }
+    } else {
+        times = channel.times;
+        values.assign(channel.values.begin(), channel.values.begin() + times.size() * components_count);
+    }
+
+    /* Rotations are quantized first so that the error of the quantization is taken into account. */
+    std::vector<float> keys = values;
+    if(track.path == AnimationPath::ROTATION) {
+        for(size_t i = 0 ; i < keys.size() ; i += 4) {
+            vec4 key = QuantizedQuaternion::quantize(vec4(keys[i], keys[i + 1], keys[i + 2], keys[i + 3])).dequantize();
+            for(unsigned int j = 0 ; j < 4 ; ++j) { keys[i + j] = key[j]; }
+        }
+    }
+
+    /* ---- Key Reduction ---- */
+    /* A segment is extended for as long as all the skipped keys can be interpolated from its ends. */
+    std::vector<float> value(components_count);
+    auto is_reducible = [&](size_t first, size_t last) {
+        const float* first_key = &keys[first * components_count];
+        const float* last_key = &keys[last * components_count];
+
+        for(size_t i = first + 1 ; i < last ; ++i) {
+            if(track.is_step) {
+                std::copy_n(first_key, components_count, value.data());
+            } else {
+                float t = (times[i] - times[first]) / (times[last] - times[first]);
+                interpolate(track.path, components_count, first_key, last_key, t, value.data());
+            }
+
+            if(get_error(track.path, components_count, value.data(), &values[i * components_count]) > tolerance) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<size_t> kept { 0 };
+    for(size_t i = 2 ; i < times.size() ; ++i) {
+        if(!is_reducible(kept.back(), i)) { kept.push_back(i - 1); }
+    }
+    if(times.size() > 1) { kept.push_back(times.size() - 1); }
+
+    /* ---- Storage ---- */
+    track.times.reserve(kept.size());
+    for(size_t key : kept) {
+        track.times.push_back(times[key]);
+
+        const float* key_values = &values[key * components_count];
+        if(track.path == AnimationPath::ROTATION) {
+            track.rotations.push_back(QuantizedQuaternion::quantize(vec4(key_values[0], key_values[1], key_values[2], key_values[3])));
+        } else {
+            track.values.insert(track.values.end(), key_values, key_values + components_count);
+        }
+    }
+
+    return track;
+}
+
+void AnimationTrack::sample(float time, float* value) {
+    if(times.empty()) {
+        std::fill_n(value, components_count, 0.0f);
+        return;
+    }
+
+    size_t key;
+    const float t = seek(time, key);
+    if(t < 0.0f) {
+        get_key(key, value);
+        return;
+    }
+
+    if(path == AnimationPath::ROTATION) {
+        vec4 start = rotations[key].dequantize();
+        vec4 end = rotations[key + 1].dequantize();
+        interpolate(path, components_count, &start.x, &end.x, t, value);
+    } else {
+        interpolate(path, components_count, &values[key * components_count], &values[(key + 1) * components_count], t, value);
+    }
+}
+
+vec4 AnimationTrack::sample(float time) {
+    vec4 value(0.0f);
+    sample(time, &value.x);
+    return value;
+}
+
+float AnimationTrack::get_rotation_keys(float time, quaternion& start, quaternion& end) {
+    size_t key;
+    const float t = seek(time, key);
+
+    vec4 start_key = rotations[key].dequantize();
+    start = quaternion(start_key.x, start_key.y, start_key.z, start_key.w);
+    if(t < 0.0f) {
+        end = start;
+        return 0.0f;
+    }
+
+    vec4 end_key = rotations[key + 1].dequantize();
+    end = quaternion(end_key.x, end_key.y, end_key.z, end_key.w);
+    return t;
+}
+
+float AnimationTrack::seek(float time, size_t& key) {
+    if(time <= times.front()) {
+        key = 0;
+        return -1.0f;
+    }
+    if(time >= times.back()) {
+        key = times.size() - 1;
+        return -1.0f;
+    }
+
+    /* Tracks are mostly played forward, so the key is usually the same as or right after the last one. */
+    if(times[cursor] > time) { cursor = 0; }
+    if(times[cursor + 1] <= time) {
+        ++cursor;
+        if(times[cursor + 1] <= time) {
+            cursor = std::upper_bound(times.begin() + cursor, times.end(), time) - times.begin() - 1;
+        }
+    }
+
+    key = cursor;
+    if(is_step) { return -1.0f; }
+
+    return (time - times[cursor]) / (times[cursor + 1] - times[cursor]);
+}
+
+void AnimationTrack::get_key(size_t key, float* value) const {
+    if(path == AnimationPath::ROTATION) {
+        vec4 rotation = rotations[key].dequantize();
+        std::copy_n(&rotation.x, 4, value);
+    } else {
+        std::copy_n(&values[key * components_count], components_count, value);
+    }
+}
+
+size_t AnimationTrack::get_size() const {
+    return times.size() * sizeof(float)
+           + values.size() * sizeof(float)
+           + rotations.size() * sizeof(QuantizedQuaternion);
+}
@@ -0,0 +1,182 @@
+/***************************************************************************************************
+ * @file  MorphTargets.cpp
+ * @brief Implementation of the MorphTargets class
+ **************************************************************************************************/
+
+#include "animation/MorphTargets.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+void MorphTargets::add_target(size_t vertices_count,
+                              std::span<const float> positions,
+                              std::span<const float> normals,
+                              std::span<const float> tangents) {
+    for(std::span<const float> deltas : { positions, normals, tangents }) {
+        if(!deltas.empty() && deltas.size() != 3 * vertices_count) {
+            throw std::runtime_error("Morph target without a delta for every vertex.");
+        }
+    }
+
+    auto get_delta = [](std::span<const float> deltas, size_t vertex) {
+        return deltas.empty() ? vec4(0.0f) : vec4(deltas[3 * vertex], deltas[3 * vertex + 1], deltas[3 * vertex + 2], 0.0f);
+    };
+
+    MorphTarget& target = targets.emplace_back();
+    target.min_position_delta = vec3(0.0f);
+    target.max_position_delta = vec3(0.0f);
+
+    for(size_t i = 0 ; i < vertices_count ; ++i) {
+        vec4 position = get_delta(positions, i);
+        vec4 normal = get_delta(normals, i);
+        vec4 tangent = get_delta(tangents, i);
+
+        bool is_moved = false;
+        for(unsigned int j = 0 ; j < 3 ; ++j) { is_moved = is_moved || position[j] != 0.0f || normal[j] != 0.0f || tangent[j] != 0.0f; }
+        if(!is_moved) { continue; }
+
+        target.vertices.push_back(i);
+        target.position_deltas.push_back(position);
+        if(!normals.empty()) { target.normal_deltas.push_back(normal); }
+        if(!tangents.empty()) { target.tangent_deltas.push_back(tangent); }
+
+        AABB::axis_aligned_min(target.min_position_delta, position);
+        AABB::axis_aligned_max(target.max_position_delta, position);
+    }
+
+    default_weights.resize(targets.size(), 0.0f);
+}
+
+size_t MorphTargets::get_targets_count() const {
+    return targets.size();
+}
+
+size_t MorphTargets::get_deltas_count() const {
+    size_t deltas_count = 0;
+    for(const MorphTarget& target : targets) { deltas_count += target.vertices.size(); }
+    return deltas_count;
+}
+
+void MorphTargets::morph_positions(std::span<const float> weights, std::vector<vec4>& positions) const {
+    const size_t targets_count = std::min(targets.size(), weights.size());
+
+    for(size_t i = 0 ; i < targets_count ; ++i) {
+        if(weights[i] == 0.0f) { continue; }
+
+        const MorphTarget& target = targets[i];
+        const size_t deltas_count = target.vertices.size();
+
+#ifdef __SSE__
+        /* The deltas' w is 0, so the positions' w is unchanged. */
+        __m128 weight = _mm_set1_ps(weights[i]);
+        for(size_t j = 0 ; j < deltas_count ; ++j) {
+            float* position = &positions[target.vertices[j]].x;
+            __m128 delta = _mm_loadu_ps(&target.position_deltas[j].x);
+            _mm_storeu_ps(position, _mm_add_ps(_mm_loadu_ps(position), _mm_mul_ps(delta, weight)));
+        }
+#else
+        for(size_t j = 0 ; j < deltas_count ; ++j) {
+            positions[target.vertices[j]] += weights[i] * target.position_deltas[j];
+        }
+#endif
+    }
+}
+
+uvec2 MorphTargets::blend_deltas(std::span<const float> weights, std::span<MorphDelta> deltas) const {
+    /* ---- Clearing ---- */
+    uvec2 range(std::numeric_limits<unsigned int>::max(), 0u);
+    for(const MorphTarget& target : targets) {
+        if(target.vertices.empty()) { continue; }
+
+        for(unsigned int vertex : target.vertices) { deltas[vertex] = MorphDelta(vec4(0.0f), vec4(0.0f), vec4(0.0f)); }
+        range.x = std::min(range.x, target.vertices.front());
+        range.y = std::max(range.y, target.vertices.back() + 1);
+    }
+
+    /* ---- Blending ---- */
+    const size_t targets_count = std::min(targets.size(), weights.size());
+    for(size_t i = 0 ; i < targets_count ; ++i) {
+        if(weights[i] == 0.0f) { continue; }
+
+        const MorphTarget& target = targets[i];
+        const size_t deltas_count = target.vertices.size();
+        const bool has_normals = !target.normal_deltas.empty();
+        const bool has_tangents = !target.tangent_deltas.empty();
+
+#ifdef __SSE__
+        __m128 weight = _mm_set1_ps(weights[i]);
+        auto add = [weight](vec4& delta, const vec4& target_delta) {
+            _mm_storeu_ps(&delta.x, _mm_add_ps(_mm_loadu_ps(&delta.x), _mm_mul_ps(_mm_loadu_ps(&target_delta.x), weight)));
+        };
+#else
+        auto add = [weight = weights[i]](vec4& delta, const vec4& target_delta) { delta += weight * target_delta; };
+#endif
+
+        for(size_t j = 0 ; j < deltas_count ; ++j) {
+            MorphDelta& delta = deltas[target.vertices[j]];
+            add(delta.position, target.position_deltas[j]);
+            if(has_normals) { add(delta.normal, target.normal_deltas[j]); }
+            if(has_tangents) { add(delta.tangent, target.tangent_deltas[j]); }
+        }
+    }
+
+    return range.x < range.y ? range : uvec2(0u);
+}
+
+AABB MorphTargets::get_AABB(const AABB& aabb, std::span<const float> weights) const {
+    vec3 min(aabb.min_point);
+    vec3 max(aabb.max_point);
+
+    const size_t targets_count = std::min(targets.size(), weights.size());
+    for(size_t i = 0 ; i < targets_count ; ++i) {
+        vec3 first = weights[i] * targets[i].min_position_delta;
+        vec3 second = weights[i] * targets[i].max_position_delta;
+
+        for(unsigned int j = 0 ; j < 3 ; ++j) {
+            min[j] += std::min(first[j], second[j]);
+            max[j] += std::max(first[j], second[j]);
+        }
+    }
+
+    return AABB(min, max);
+}
+
+void MorphTargets::append_deltas_by_vertex(size_t vertices_count,
+                                           std::vector<uvec2>& ranges,
+                                           std::vector<MorphDelta>& deltas) const {
+    /* ---- Counting ---- */
+    const size_t first_range = ranges.size();
+    ranges.resize(first_range + vertices_count, uvec2(0u));
+
+    for(const MorphTarget& target : targets) {
+        for(unsigned int vertex : target.vertices) { ++ranges[first_range + vertex].y; }
+    }
+
+    unsigned int offset = deltas.size();
+    for(size_t i = 0 ; i < vertices_count ; ++i) {
+        ranges[first_range + i].x = offset;
+        offset += ranges[first_range + i].y;
+    }
+
+    /* ---- Filling ---- */
+    std::vector<unsigned int> filled(vertices_count, 0);
+    deltas.resize(offset);
+
+    for(size_t i = 0 ; i < targets.size() ; ++i) {
+        const MorphTarget& target = targets[i];
+
+        for(size_t j = 0 ; j < target.vertices.size() ; ++j) {
+            unsigned int vertex = target.vertices[j];
+            MorphDelta& delta = deltas[ranges[first_range + vertex].x + filled[vertex]++];
+
+            delta.position = vec4(vec3(target.position_deltas[j]), static_cast<float>(i));
+            delta.normal = target.normal_deltas.empty() ? vec4(0.0f) : target.normal_deltas[j];
+            delta.tangent = target.tangent_deltas.empty() ? vec4(0.0f) : target.tangent_deltas[j];
+        }
+    }
+}
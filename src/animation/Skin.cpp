@@ -0,0 +1,76 @@
+/***************************************************************************************************
+ * @file  Skin.cpp
+ * @brief Implementation of the JointPalette class
+ **************************************************************************************************/
+
+#include "animation/Skin.hpp"
+
+#include <algorithm>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "mesh/Mesh.hpp"
+
+void JointPalette::set(std::span<const affine3x4> matrices) {
+    for(unsigned int column = 0 ; column < 4 ; ++column) {
+        // The implicit last row (0, 0, 0, 1), so that skinned positions keep a w of 1.
+        const float w = column == 3 ? 1.0f : 0.0f;
+
+        columns[column].resize(matrices.size());
+        for(size_t joint = 0 ; joint < matrices.size() ; ++joint) {
+            const affine3x4& matrix = matrices[joint];
+            columns[column][joint] = vec4(matrix(0, column), matrix(1, column), matrix(2, column), w);
+        }
+    }
+}
+
+size_t JointPalette::get_size() const {
+    return columns[0].size();
+}
+
+void JointPalette::skin_positions(const Mesh& mesh, std::vector<vec4>& positions) const {
+    if(!mesh.has_attribute(ATTRIBUTE_JOINTS) || !mesh.has_attribute(ATTRIBUTE_WEIGHTS) || get_size() == 0) { return; }
+
+    const size_t vertices_count = std::min(mesh.get_vertices_amount(), positions.size());
+    const unsigned int last_joint = get_size() - 1;
+
+    for(size_t i = 0 ; i < vertices_count ; ++i) {
+        vec4 position = positions[i];
+        vec4 joints = mesh.get_attribute_value(ATTRIBUTE_JOINTS, i);
+        vec4 weights = mesh.get_attribute_value(ATTRIBUTE_WEIGHTS, i);
+
+#ifdef __SSE__
+        /* Blends the columns of the 4 joint matrices, then transforms the position. */
+        __m128 blended[4] { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+        for(unsigned int k = 0 ; k < 4 ; ++k) {
+            if(weights[k] == 0.0f) { continue; }
+
+            unsigned int joint = std::min(static_cast<unsigned int>(joints[k]), last_joint);
+            __m128 weight = _mm_set1_ps(weights[k]);
+            for(unsigned int column = 0 ; column < 4 ; ++column) {
+                __m128 joint_column = _mm_loadu_ps(&columns[column][joint].x);
+                blended[column] = _mm_add_ps(blended[column], _mm_mul_ps(joint_column, weight));
+            }
+        }
+
+        __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(blended[0], _mm_set1_ps(position.x)),
+                                              _mm_mul_ps(blended[1], _mm_set1_ps(position.y))),
+                                   _mm_add_ps(_mm_mul_ps(blended[2], _mm_set1_ps(position.z)),
+                                              _mm_mul_ps(blended[3], _mm_set1_ps(position.w))));
+
+        _mm_storeu_ps(&positions[i].x, result);
+#else
+        vec4 blended[4] { vec4(0.0f), vec4(0.0f), vec4(0.0f), vec4(0.0f) };
+        for(unsigned int k = 0 ; k < 4 ; ++k) {
+            if(weights[k] == 0.0f) { continue; }
+
+            unsigned int joint = std::min(static_cast<unsigned int>(joints[k]), last_joint);
+            for(unsigned int column = 0 ; column < 4 ; ++column) { blended[column] += weights[k] * columns[column][joint]; }
+        }
+
+        positions[i] = blended[0] * position.x + blended[1] * position.y + blended[2] * position.z + blended[3] * position.w;
+#endif
+    }
+}
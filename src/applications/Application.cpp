@@ -5,11 +5,24 @@
 
 #include "applications/Application.hpp"
 
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
 #include "assets/AssetManager.hpp"
+#include "assets/GLTF.hpp"
+#include "assets/TextureResidencyManager.hpp"
+#include "assets/TextureStreamer.hpp"
+#include "assets/VirtualTextureSystem.hpp"
+#include "engine/BenchmarkReport.hpp"
 #include "engine/EventHandler.hpp"
+#include "engine/FrameTimer.hpp"
+#include "engine/Profiler.hpp"
 #include "engine/Window.hpp"
 #include "glad/glad.h"
 #include "maths/constants.hpp"
@@ -22,13 +35,29 @@
 Application::Application()
     : camera(vec3(0.0f, 10.0f, 0.0f), PI_HALF_F, 0.1f, 1024.0f),
       framebuffer(Window::get_width(), Window::get_height()),
+      screen_mesh(AssetManager::get_mesh_handle("screen")),
+      recording_start_time(0.0),
       are_axes_drawn(false),
+      is_profiler_window_open(false),
       sky_color_low(0.0f, 0.105f, 0.191f),
       sky_color_high(0.123f, 0.285f, 0.583f) {
     /* ---- Event Handler ---- */
     EventHandler::set_active_camera(&camera);
     EventHandler::associate_action_to_key(GLFW_KEY_Q, false, [this] { are_axes_drawn = !are_axes_drawn; });
 
+    /* Records the camera paths replayed by the benchmark mode, the first key is at time 0. */
+    EventHandler::associate_action_to_key(GLFW_KEY_K, false, [this] {
+        if(recorded_path.get_keys_count() == 0) { recording_start_time = glfwGetTime(); }
+        recorded_path.add_key(glfwGetTime() - recording_start_time,
+                              camera.get_position(),
+                              camera.get_position() + camera.get_direction());
+    });
+    EventHandler::associate_action_to_key(GLFW_KEY_L, false, [this] {
+        recorded_path.save("data/camera_path.txt");
+        std::cout << "Saved " << recorded_path.get_keys_count() << " camera keys to 'data/camera_path.txt'.\n";
+        recorded_path.clear();
+    });
+
     /* ---- ImGui ---- */
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -37,6 +66,14 @@ Application::Application()
     ImGui_ImplGlfw_InitForOpenGL(Window::get_glfw(), true);
     ImGui_ImplOpenGL3_Init();
 
+    /* ---- Profiler ---- */
+    Profiler::set_thread_name("Main");
+
+    /* ---- Headless ---- */
+    if(Window::is_headless()) {
+        output_framebuffer = std::make_unique<Framebuffer>(Window::get_width(), Window::get_height());
+    }
+
     /* ---- Other ---- */
     // glfwSwapInterval(0); // disable vsync
 }
@@ -50,31 +87,161 @@ Application::~Application() {
 void Application::run() {
     // scene_graph.add_gltf_scene_node("Duck", 0, "data/models/duck.glb");
     // scene_graph.add_gltf_scene_node("Buggy", 0, "data/models/buggy.glb");
-    unsigned int sponza = scene_graph.add_gltf_scene_node("Sponza", 0, "data/models/sponza/Sponza.gltf");
+    // VirtualTextureSystem::set_enabled(true);
+    // GLTF::Model::set_stripifying_enabled(true);
+    unsigned int sponza = scene_graph.add_gltf_scene_node_async("Sponza", 0, "data/models/sponza/Sponza.gltf");
     scene_graph.transforms[sponza].set_local_scale(10.0f);
 
     /* Main Loop */
     while(!Window::should_close()) {
-        EventHandler::poll_and_handle_events();
+        FrameTimer::begin_frame();
+        poll_events();
+        update_and_draw_frame(EventHandler::get_delta());
+        FrameTimer::end_frame();
+        Profiler::end_frame();
+    }
+}
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+bool Application::run_benchmark(const BenchmarkSettings& settings) {
+    CameraPath path(settings.camera_path);
+
+    scene_graph.add_gltf_scene_node("Scene", 0, settings.scene_path);
+    wait_for_loading();
+
+    /* The frames would be capped to the refresh rate with vsync. */
+    glfwSwapInterval(0);
+
+    /* Each frame is at a fixed time of the path and of the animations, whatever its duration. */
+    const unsigned int frames_count = static_cast<unsigned int>(path.get_duration() / settings.frame_delta) + 1;
+    for(unsigned int i = 0 ; i < settings.warmup_frames_count + frames_count ; ++i) {
+        if(i == settings.warmup_frames_count) { FrameTimer::set_enabled(true); }
+        if(Window::should_close()) { break; }
+
+        FrameTimer::begin_frame();
+        poll_events();
+
+        vec3 position, target;
+        float time = static_cast<float>(i < settings.warmup_frames_count ? 0 : i - settings.warmup_frames_count);
+        path.sample(time * settings.frame_delta, position, target);
+        camera.set_position(position);
+        camera.look_at_point(target);
+
+        update_and_draw_frame(settings.frame_delta);
+        FrameTimer::end_frame();
+        Profiler::end_frame();
+    }
 
+    FrameTimer::resolve();
+    FrameTimer::set_enabled(false);
+
+    /* ---- Report ---- */
+    BenchmarkReport report(settings.scene_path.filename().string(), FrameTimer::get_records());
+    report.print(std::cout);
+
+    if(!settings.report_prefix.empty()) {
+        report.write_csv(settings.report_prefix.string() + ".csv");
+        report.write_json(settings.report_prefix.string() + ".json");
+    }
+
+    if(settings.baseline_path.empty()) { return true; }
+
+    std::cout << "\nComparison with '" << settings.baseline_path.string() << "':\n";
+    return report.compare(settings.baseline_path, settings.threshold, std::cout);
+}
+
+void Application::render_offscreen(const OffscreenSettings& settings) {
+    if(output_framebuffer == nullptr) {
+        throw std::runtime_error("Offscreen rendering needs a headless window.");
+    }
+
+    scene_graph.add_gltf_scene_node("Scene", 0, settings.scene_path);
+    camera.set_position(settings.camera_position);
+    camera.look_at_point(settings.camera_target);
+
+    wait_for_loading();
+
+    for(unsigned int i = 0 ; i < settings.frames_count ; ++i) {
+        scene_graph.update_loading_scenes();
+        scene_graph.update_animations(settings.frame_delta);
         frustum.update(camera);
 
         draw();
 
+        std::ostringstream frame_path;
+        frame_path << settings.output_prefix.string() << '_' << std::setw(4) << std::setfill('0') << i << ".png";
+        output_framebuffer->save_png(frame_path.str());
+        Profiler::end_frame();
+    }
+
+    std::cout << "Rendered " << settings.frames_count << " frames to '" << settings.output_prefix.string() << "_*.png'.\n";
+}
+
+void Application::poll_events() {
+    FrameTimer::Scope scope(FRAME_STAGE_EVENTS);
+    EventHandler::poll_and_handle_events();
+}
+
+void Application::update_and_draw_frame(float delta) {
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui_ImplGlfw_NewFrame();
+    ImGui::NewFrame();
+
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_LOADING);
+        scene_graph.update_loading_scenes();
+    }
+
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_ANIMATIONS);
+        scene_graph.update_animations(delta);
+    }
+
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_CULLING);
+        frustum.update(camera);
+    }
+
+    draw();
+
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_IMGUI);
         draw_imgui_debug_window();
         draw_imgui_object_editor_window();
+        if(is_profiler_window_open) { Profiler::add_imgui_window(&is_profiler_window_open); }
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        Window::swap_buffers();
+    }
+
+    FrameTimer::Scope scope(FRAME_STAGE_SWAP);
+    Window::swap_buffers();
+}
+
+void Application::wait_for_loading() {
+    /* Waits for every texture to be uploaded so the frames don't depend on the loading speed. */
+    auto is_loading = [this] {
+        for(const std::unique_ptr<GLTF::Scene>& scene : scene_graph.gltf_scenes) {
+            if(scene->is_loading()) { return true; }
+        }
+        return TextureStreamer::get_pending_count() > 0;
+    };
+
+    while(is_loading()) {
+        scene_graph.update_loading_scenes();
+        Profiler::end_frame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    /* The frames of a scene that failed to load would be meaningless. */
+    for(const std::unique_ptr<GLTF::Scene>& scene : scene_graph.gltf_scenes) {
+        if(scene->has_failed()) { throw std::runtime_error("A scene failed to load."); }
     }
 }
 
 void Application::draw() {
+    Profiler::Zone zone("Application::draw");
+    Profiler::GPUZone gpu_zone("Application::draw");
+
     framebuffer.bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -89,12 +256,18 @@ void Application::draw() {
     background_shader.set_uniform("u_sky_color_high", sky_color_high);
 
     if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
-    AssetManager::get_mesh("screen").draw();
+    AssetManager::get_mesh(screen_mesh).draw();
     if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
 
     /* ---- Scene ---- */
     scene_graph.draw(frustum);
 
+    /* ---- Virtual Texture Feedback ---- */
+    if(VirtualTextureSystem::begin_feedback_pass()) {
+        scene_graph.draw_virtual_texture_feedback(frustum);
+        VirtualTextureSystem::end_feedback_pass();
+    }
+
     /* ---- Post Processing ---- */
     const Shader& post_processing_shader = AssetManager::get_shader(SHADER_POST_PROCESSING);
     post_processing_shader.use();
@@ -103,11 +276,15 @@ void Application::draw() {
     post_processing_shader.set_uniform_if_exists("u_resolution", Window::get_resolution());
     framebuffer.bind_texture(0);
 
-    Framebuffer::bind_default();
+    if(output_framebuffer != nullptr) {
+        output_framebuffer->bind();
+    } else {
+        Framebuffer::bind_default();
+    }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); }
-    AssetManager::get_mesh("screen").draw();
+    AssetManager::get_mesh(screen_mesh).draw();
     if(EventHandler::is_wireframe_enabled()) { glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); }
 }
 
@@ -123,11 +300,35 @@ void Application::draw_imgui_debug_window() {
 
     ImGui::Text("fps: %f f/s", 1.0f / EventHandler::get_delta());
     ImGui::Text("delta: %fs", EventHandler::get_delta());
+    if(ImGui::Checkbox("Show Profiler", &is_profiler_window_open) && is_profiler_window_open) { Profiler::set_enabled(true); }
 
     ImGui::NewLine();
     ImGui::Checkbox("Draw AABBs", &scene_graph.are_AABBs_drawn);
+    ImGui::Checkbox("Camera Relative Rendering", &scene_graph.is_camera_relative);
     ImGui::Text("Total Nodes Count: %lu", scene_graph.nodes.size());
     ImGui::Text("Total Drawn Objects: %d", scene_graph.total_drawn_objects);
+    for(const std::unique_ptr<GLTF::Scene>& scene : scene_graph.gltf_scenes) {
+        if(scene->is_loading()) { ImGui::ProgressBar(scene->get_loading_progress(), ImVec2(-1.0f, 0.0f), "Loading"); }
+        if(scene->has_failed()) { ImGui::Text("A scene failed to load."); }
+    }
+    if(TextureStreamer::get_pending_count() > 0) {
+        ImGui::Text("Streaming Textures: %lu", TextureStreamer::get_pending_count());
+    }
+    if(VirtualTextureSystem::get_resident_pages_count() > 0) {
+        ImGui::Text("Virtual Texture Pages: %lu / %u",
+                    VirtualTextureSystem::get_resident_pages_count(),
+                    VirtualTextureSystem::get_slots_count());
+    }
+    ImGui::Text("Texture Memory: %.1f / %.1f MiB",
+                static_cast<float>(TextureResidencyManager::get_usage()) / (1024.0f * 1024.0f),
+                static_cast<float>(TextureResidencyManager::get_budget()) / (1024.0f * 1024.0f));
+    ImGui::Text("Texture Evictions: %lu", TextureResidencyManager::get_evictions_count());
+    ImGui::Text("Deduplicated Textures: %lu (%.1f MiB)",
+                TextureStreamer::get_deduplicated_count(),
+                static_cast<float>(TextureStreamer::get_deduplicated_size()) / (1024.0f * 1024.0f));
+    ImGui::Text("Deduplicated Meshes: %lu (%.1f MiB)",
+                scene_graph.deduplicated_meshes_count,
+                static_cast<float>(scene_graph.deduplicated_meshes_size) / (1024.0f * 1024.0f));
 
     ImGui::NewLine();
     ImGui::ColorEdit3("Low Sky Color", &sky_color_low.x);
@@ -5,34 +5,89 @@
 
 #include "assets/AssetManager.hpp"
 
-#include <ranges>
+#include "assets/TextureResidencyManager.hpp"
 #include "mesh/primitives.hpp"
+#include "utility/hash.hpp"
 
 Texture& AssetManager::add_texture(const std::filesystem::path& path, bool flip_vertically, bool srgb) {
     AssetManager& asset_manager = get();
-    auto iterator = asset_manager.textures.find(path.string());
+    auto iterator = asset_manager.texture_names.find(path.string());
 
-    if(iterator == asset_manager.textures.end()) {
+    if(iterator == asset_manager.texture_names.end()) {
         Texture texture;
         texture.create(path, flip_vertically, srgb);
-        return asset_manager.textures.emplace(path.string(), texture).first->second;
+        return add_texture(path.string(), texture);
     }
 
-    return iterator->second;
+    return asset_manager.textures[iterator->second];
 }
 
 Texture& AssetManager::add_texture(const std::string& name, const Texture& texture) {
-    return get().textures.emplace(name, texture).first->second;
+    AssetManager& asset_manager = get();
+    auto [iterator, is_inserted] = asset_manager.texture_names.emplace(name, Handle<Texture>());
+    if(is_inserted) { iterator->second = asset_manager.textures.emplace(texture); }
+
+    return asset_manager.textures[iterator->second];
 }
 
 Texture& AssetManager::add_texture(const std::string& name, const vec3& color) {
     Texture texture;
     texture.create(color);
-    return get().textures.emplace(name, texture).first->second;
+    return add_texture(name, texture);
+}
+
+Handle<Texture> AssetManager::add_texture(const tinygltf::Image& image, const tinygltf::Sampler& sampler, bool srgb) {
+    AssetManager& asset_manager = get();
+
+    /* The color space is part of the uri's key, so that the same image used as SRGB and linear
+     * isn't shared. */
+    std::string uri_key = image.uri.empty() ? std::string() : "pixels " + std::to_string(srgb) + ' ' + image.uri;
+    if(!uri_key.empty()) {
+        auto iterator = asset_manager.texture_names.find(uri_key);
+        if(iterator != asset_manager.texture_names.end()) { return iterator->second; }
+    }
+
+    /* Images are also identified by their pixels so that embedded images and the same image loaded
+     * from different files are shared. */
+    const int settings[5] { image.width, image.height, image.component, image.pixel_type, srgb };
+    uint64_t hash = hash_xxh64(settings, sizeof(settings), hash_xxh64(image.image.data(), image.image.size()));
+    std::string content_key = "pixels " + hash_to_string(hash);
+
+    if(!asset_manager.texture_names.contains(content_key)) {
+        Texture texture;
+        texture.create(image, sampler, srgb);
+        add_texture(content_key, texture);
+    }
+
+    if(!uri_key.empty()) { add_texture_alias(uri_key, content_key); }
+    return get_texture_handle(content_key);
+}
+
+Handle<Texture> AssetManager::get_color_texture(const vec3& color) {
+    std::string name = "color " + std::to_string(color.x) + ' ' + std::to_string(color.y) + ' ' + std::to_string(color.z);
+    if(!has_texture(name)) { add_texture(name, color); }
+
+    return get_texture_handle(name);
+}
+
+void AssetManager::add_texture_alias(const std::string& alias, const std::string& texture_name_or_path) {
+    get().texture_names.emplace(alias, get_texture_handle(texture_name_or_path));
 }
 
 Mesh& AssetManager::add_mesh(const std::string& name) {
-    return get().meshes.emplace(name, Mesh()).first->second;
+    AssetManager& asset_manager = get();
+    auto [iterator, is_inserted] = asset_manager.mesh_names.emplace(name, Handle<Mesh>());
+    if(is_inserted) { iterator->second = asset_manager.meshes.emplace(); }
+
+    return asset_manager.meshes[iterator->second];
+}
+
+Handle<Mesh> AssetManager::add_mesh(Mesh&& mesh) {
+    return get().meshes.emplace(std::move(mesh));
+}
+
+Handle<Material> AssetManager::add_material(std::unique_ptr<Material> material) {
+    return get().materials.emplace(std::move(material));
 }
 
 Shader& AssetManager::get_shader(ShaderName shader_name) {
@@ -40,47 +95,120 @@ Shader& AssetManager::get_shader(ShaderName shader_name) {
 }
 
 Texture& AssetManager::get_texture(const std::string& texture_name_or_path) {
+    return get().textures[get_texture_handle(texture_name_or_path)];
+}
+
+Mesh& AssetManager::get_mesh(const std::string& mesh_name) {
+    return get().meshes[get_mesh_handle(mesh_name)];
+}
+
+Handle<Texture> AssetManager::get_texture_handle(const std::string& texture_name_or_path) {
     AssetManager& asset_manager = get();
 
-    auto iterator = asset_manager.textures.find(texture_name_or_path);
-    if(iterator == asset_manager.textures.end()) {
+    auto iterator = asset_manager.texture_names.find(texture_name_or_path);
+    if(iterator == asset_manager.texture_names.end()) {
         throw std::runtime_error("Couldn't find texture '" + texture_name_or_path + "' in asset manager");
     }
 
     return iterator->second;
 }
 
-Mesh& AssetManager::get_mesh(const std::string& mesh_name) {
+Handle<Mesh> AssetManager::get_mesh_handle(const std::string& mesh_name) {
     AssetManager& asset_manager = get();
 
-    auto iterator = asset_manager.meshes.find(mesh_name);
-    if(iterator == asset_manager.meshes.end()) {
+    auto iterator = asset_manager.mesh_names.find(mesh_name);
+    if(iterator == asset_manager.mesh_names.end()) {
         throw std::runtime_error("Couldn't find triangle mesh '" + mesh_name + "' in asset manager");
     }
 
     return iterator->second;
 }
 
+Texture& AssetManager::get_texture(Handle<Texture> handle) {
+    return get().textures[handle];
+}
+
+Mesh& AssetManager::get_mesh(Handle<Mesh> handle) {
+    return get().meshes[handle];
+}
+
+Material& AssetManager::get_material(Handle<Material> handle) {
+    return *get().materials[handle];
+}
+
+void AssetManager::acquire(Handle<Texture> handle) {
+    get().textures.add_reference(handle);
+}
+
+void AssetManager::acquire(Handle<Mesh> handle) {
+    get().meshes.add_reference(handle);
+}
+
+void AssetManager::acquire(Handle<Material> handle) {
+    get().materials.add_reference(handle);
+}
+
+void AssetManager::release(Handle<Texture> handle) {
+    AssetManager& asset_manager = get();
+    if(asset_manager.textures.get_references_count(handle) == 0) {
+        throw std::runtime_error("Trying to release a texture that wasn't acquired.");
+    }
+    if(asset_manager.textures.remove_reference(handle) > 0) { return; }
+
+    asset_manager.textures[handle].free();
+    asset_manager.textures.erase(handle);
+    std::erase_if(asset_manager.texture_names, [handle](const auto& name) { return name.second == handle; });
+}
+
+void AssetManager::release(Handle<Mesh> handle) {
+    AssetManager& asset_manager = get();
+    if(asset_manager.meshes.get_references_count(handle) == 0) {
+        throw std::runtime_error("Trying to release a mesh that wasn't acquired.");
+    }
+    if(asset_manager.meshes.remove_reference(handle) > 0) { return; }
+
+    asset_manager.meshes.erase(handle);
+    std::erase_if(asset_manager.mesh_names, [handle](const auto& name) { return name.second == handle; });
+}
+
+void AssetManager::release(Handle<Material> handle) {
+    AssetManager& asset_manager = get();
+    if(asset_manager.materials.get_references_count(handle) == 0) {
+        throw std::runtime_error("Trying to release a material that wasn't acquired.");
+    }
+    if(asset_manager.materials.remove_reference(handle) > 0) { return; }
+
+    asset_manager.materials.erase(handle);
+}
+
 Texture* AssetManager::get_texture_ptr(const std::string& texture_name_or_path) {
     AssetManager& asset_manager = get();
 
-    auto iterator = asset_manager.textures.find(texture_name_or_path);
-    return iterator == asset_manager.textures.end() ? nullptr : &iterator->second;
+    auto iterator = asset_manager.texture_names.find(texture_name_or_path);
+    return iterator == asset_manager.texture_names.end() ? nullptr : asset_manager.textures.get(iterator->second);
+}
+
+Texture* AssetManager::get_texture_ptr(Handle<Texture> handle) {
+    return get().textures.get(handle);
 }
 
 Mesh* AssetManager::get_mesh_ptr(const std::string& mesh_name) {
     AssetManager& asset_manager = get();
 
-    auto iterator = asset_manager.meshes.find(mesh_name);
-    return iterator == asset_manager.meshes.end() ? nullptr : &iterator->second;
+    auto iterator = asset_manager.mesh_names.find(mesh_name);
+    return iterator == asset_manager.mesh_names.end() ? nullptr : asset_manager.meshes.get(iterator->second);
+}
+
+Mesh* AssetManager::get_mesh_ptr(Handle<Mesh> handle) {
+    return get().meshes.get(handle);
 }
 
 bool AssetManager::has_texture(const std::string& texture_name_or_path) {
-    return get().textures.contains(texture_name_or_path);
+    return get().texture_names.contains(texture_name_or_path);
 }
 
 bool AssetManager::has_mesh(const std::string& mesh_name) {
-    return get().meshes.contains(mesh_name);
+    return get().mesh_names.contains(mesh_name);
 }
 
 Shader& AssetManager::get_relevant_shader_from_mesh(const Mesh& mesh) {
@@ -90,13 +218,20 @@ Shader& AssetManager::get_relevant_shader_from_mesh(const Mesh& mesh) {
 ShaderName AssetManager::get_relevant_shader_name_from_mesh(const Mesh& mesh) {
     switch(mesh.get_primitive()) {
         case MeshPrimitive::POINTS: return SHADER_POINT_MESH;
-        case MeshPrimitive::LINES: return mesh.has_attribute(ATTRIBUTE_COLOR) ? SHADER_LINE_MESH : SHADER_FLAT;
-        case MeshPrimitive::TRIANGLES: return mesh.has_attribute(ATTRIBUTE_NORMAL) ? SHADER_BLINN_PHONG : SHADER_FLAT;
+        case MeshPrimitive::LINES:
+        case MeshPrimitive::LINE_STRIP:
+        case MeshPrimitive::LINE_LOOP: return mesh.has_attribute(ATTRIBUTE_COLOR) ? SHADER_LINE_MESH : SHADER_FLAT;
+        case MeshPrimitive::TRIANGLES:
+        case MeshPrimitive::TRIANGLE_STRIP:
+        case MeshPrimitive::TRIANGLE_FAN: return mesh.has_attribute(ATTRIBUTE_NORMAL) ? SHADER_BLINN_PHONG : SHADER_FLAT;
         default: return SHADER_FLAT;
     }
 }
 
 AssetManager::AssetManager() {
+    /* Constructed first so that it outlives the asset manager, whose textures stop being tracked when freed. */
+    TextureResidencyManager::get();
+
     /* Shaders */
     shaders[SHADER_POINT_MESH].create({
                                           "shaders/point_mesh/point_mesh.vert",
@@ -132,14 +267,40 @@ AssetManager::AssetManager() {
                                                   "shaders/vertex/tangent.vert",
                                                   "shaders/metallic-roughness/get_directions_tangent.frag",
                                                   "shaders/metallic-roughness/metallic_roughness.frag",
+                                                  "shaders/metallic-roughness/virtual_texture.frag",
                                               }, "metallic-roughness");
 
     shaders[SHADER_METALLIC_ROUGHNESS_NO_TANGENT].create({
                                                              "shaders/vertex/default.vert",
                                                              "shaders/metallic-roughness/get_directions_no_tangent.frag",
                                                              "shaders/metallic-roughness/metallic_roughness.frag",
+                                                             "shaders/metallic-roughness/virtual_texture.frag",
                                                          }, "metallic-roughness no tangent");
 
+    shaders[SHADER_METALLIC_ROUGHNESS_DEFORMED].create({
+                                                           "shaders/vertex/deformed_tangent.vert",
+                                                           "shaders/vertex/morphing.vert",
+                                                           "shaders/vertex/skinning.vert",
+                                                           "shaders/metallic-roughness/get_directions_tangent.frag",
+                                                           "shaders/metallic-roughness/metallic_roughness.frag",
+                                                           "shaders/metallic-roughness/virtual_texture.frag",
+                                                       }, "metallic-roughness deformed");
+
+    shaders[SHADER_METALLIC_ROUGHNESS_NO_TANGENT_DEFORMED].create({
+                                                                      "shaders/vertex/deformed_default.vert",
+                                                                      "shaders/vertex/morphing.vert",
+                                                                      "shaders/vertex/skinning.vert",
+                                                                      "shaders/metallic-roughness/get_directions_no_tangent.frag",
+                                                                      "shaders/metallic-roughness/metallic_roughness.frag",
+                                                                      "shaders/metallic-roughness/virtual_texture.frag",
+                                                                  }, "metallic-roughness no tangent deformed");
+
+    shaders[SHADER_VIRTUAL_TEXTURE_FEEDBACK].create({
+                                                        "shaders/vertex/position_and_texcoords.vert",
+                                                        "shaders/metallic-roughness/virtual_texture_feedback.frag",
+                                                        "shaders/metallic-roughness/virtual_texture.frag",
+                                                    }, "virtual texture feedback");
+
     shaders[SHADER_TERRAIN].create({
                                        "shaders/terrain/terrain.vert",
                                        "shaders/terrain/terrain.tesc",
@@ -166,6 +327,9 @@ AssetManager::AssetManager() {
 }
 
 AssetManager::~AssetManager() {
+    /* The materials release their textures when destroyed, which needs the other containers. */
+    materials.for_each([](std::unique_ptr<Material>& material) { material.reset(); });
+
     for(unsigned int i = 0 ; i < SHADER_COUNT ; ++i) { shaders[i].free(); }
-    for(Texture& texture : textures | std::views::values) { texture.free(); }
+    textures.for_each([](Texture& texture) { texture.free(); });
 }
@@ -34,6 +34,10 @@ Camera::Camera(const vec3& position, const vec3& target, float fov, float near_d
 }
 
 vec3 Camera::get_position() const {
+    return vec3(position);
+}
+
+dvec3 Camera::get_precise_position() const {
     return position;
 }
 
@@ -93,6 +97,30 @@ mat4 Camera::get_view_projection_matrix() const {
     );
 }
 
+mat4 Camera::get_relative_view_projection_matrix() const {
+    return mat4(
+        projection_matrix(0, 0) * view_matrix(0, 0),
+        projection_matrix(0, 0) * view_matrix(0, 1),
+        projection_matrix(0, 0) * view_matrix(0, 2),
+        0.0f,
+
+        projection_matrix(1, 1) * view_matrix(1, 0),
+        projection_matrix(1, 1) * view_matrix(1, 1),
+        projection_matrix(1, 1) * view_matrix(1, 2),
+        0.0f,
+
+        projection_matrix(2, 2) * view_matrix(2, 0),
+        projection_matrix(2, 2) * view_matrix(2, 1),
+        projection_matrix(2, 2) * view_matrix(2, 2),
+        projection_matrix(2, 3),
+
+        -view_matrix(2, 0),
+        -view_matrix(2, 1),
+        -view_matrix(2, 2),
+        0.0f
+    );
+}
+
 mat4 Camera::get_rotation_matrix() const {
     return mat4(
         right.x, up.x, -direction.x,
@@ -103,9 +131,9 @@ mat4 Camera::get_rotation_matrix() const {
 
 mat4 Camera::get_model_matrix() const {
     return mat4(
-        right.x, up.x, -direction.x, position.x,
-        right.y, up.y, -direction.y, position.y,
-        right.z, up.z, -direction.z, position.z,
+        right.x, up.x, -direction.x, static_cast<float>(position.x),
+        right.y, up.y, -direction.y, static_cast<float>(position.y),
+        right.z, up.z, -direction.z, static_cast<float>(position.z),
         0.0f, 0.0f, 0.0f, 1.0f
     );
 }
@@ -119,16 +147,18 @@ mat4 Camera::get_inverse_projection_matrix() const {
     );
 }
 
-mat4 Camera::get_inverse_view_projection_matrix() const {
-    return get_model_matrix() * get_inverse_projection_matrix();
+const mat4& Camera::get_inverse_view_projection_matrix() const {
+    return inverse_view_projection_matrix;
 }
 
 void Camera::set_position(const vec3& position) {
-    this->position = position;
+    set_position(dvec3(position));
+}
 
-    view_matrix(0, 3) = -dot(position, right);
-    view_matrix(1, 3) = -dot(position, up);
-    view_matrix(2, 3) = dot(position, direction);
+void Camera::set_position(const dvec3& position) {
+    this->position = position;
+    update_view_matrix_translation();
+    update_inverse_view_projection_matrix();
 }
 
 void Camera::look_around(float pitch_offset, float yaw_offset) {
@@ -145,38 +175,38 @@ void Camera::move_around(MovementDirection movement_direction) {
 
     switch(movement_direction) {
         case MovementDirection::FORWARD:
-            position += movement_speed * delta * direction;
+            position += dvec3(movement_speed * delta * direction);
             break;
         case MovementDirection::BACKWARD:
-            position -= movement_speed * delta * direction;
+            position -= dvec3(movement_speed * delta * direction);
             break;
         case MovementDirection::LEFT:
-            position -= movement_speed * delta * right;
+            position -= dvec3(movement_speed * delta * right);
             break;
         case MovementDirection::RIGHT:
-            position += movement_speed * delta * right;
+            position += dvec3(movement_speed * delta * right);
             break;
         case MovementDirection::UPWARD:
-            position += movement_speed * delta * WORLD_UP;
+            position += dvec3(movement_speed * delta * WORLD_UP);
             break;
         case MovementDirection::DOWNWARD:
-            position -= movement_speed * delta * WORLD_UP;
+            position -= dvec3(movement_speed * delta * WORLD_UP);
             break;
         default:
             break;
     }
 
-    view_matrix(0, 3) = -dot(position, right);
-    view_matrix(1, 3) = -dot(position, up);
-    view_matrix(2, 3) = dot(position, direction);
+    update_view_matrix_translation();
+    update_inverse_view_projection_matrix();
 }
 
 void Camera::update_projection_matrix() {
     projection_matrix(0, 0) = 1.0f / (Window::get_aspect_ratio() * std::tan(0.5f * fov));
+    update_inverse_view_projection_matrix();
 }
 
 void Camera::look_at_point(const vec3& target) {
-    vec3 dir = normalize(target - position);
+    vec3 dir = normalize(vec3(dvec3(target) - position));
     pitch = std::asin(dir.y);
     yaw = std::atan2(dir.z, dir.x);
     update_vectors_and_view_matrix();
@@ -193,15 +223,25 @@ void Camera::update_vectors_and_view_matrix() {
     view_matrix(0, 0) = right.x;
     view_matrix(0, 1) = right.y;
     view_matrix(0, 2) = right.z;
-    view_matrix(0, 3) = -dot(position, right);
 
     view_matrix(1, 0) = up.x;
     view_matrix(1, 1) = up.y;
     view_matrix(1, 2) = up.z;
-    view_matrix(1, 3) = -dot(position, up);
 
     view_matrix(2, 0) = -direction.x;
     view_matrix(2, 1) = -direction.y;
     view_matrix(2, 2) = -direction.z;
-    view_matrix(2, 3) = dot(position, direction);
+
+    update_view_matrix_translation();
+    update_inverse_view_projection_matrix();
+}
+
+void Camera::update_view_matrix_translation() {
+    view_matrix(0, 3) = static_cast<float>(-(position.x * right.x + position.y * right.y + position.z * right.z));
+    view_matrix(1, 3) = static_cast<float>(-(position.x * up.x + position.y * up.y + position.z * up.z));
+    view_matrix(2, 3) = static_cast<float>(position.x * direction.x + position.y * direction.y + position.z * direction.z);
+}
+
+void Camera::update_inverse_view_projection_matrix() {
+    inverse_view_projection_matrix = get_model_matrix() * get_inverse_projection_matrix();
 }
@@ -0,0 +1,120 @@
+/***************************************************************************************************
+ * @file  CameraPath.cpp
+ * @brief Implementation of the CameraPath class
+ **************************************************************************************************/
+
+#include "assets/CameraPath.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Evaluates a uniform Catmull-Rom spline between p1 and p2.
+ * @param p0 The point before p1.
+ * @param p1 The start of the segment.
+ * @param p2 The end of the segment.
+ * @param p3 The point after p2.
+ * @param t The interpolation factor in [0, 1].
+ * @return The point on the segment.
+ */
+static vec3 catmull_rom(const vec3& p0, const vec3& p1, const vec3& p2, const vec3& p3, float t) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+
+    return 0.5f * (2.0f * p1
+                   + (p2 - p0) * t
+                   + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2
+                   + (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+CameraPath::CameraPath(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to open camera path '" + path.string() + "'.");
+    }
+
+    std::string line;
+    for(unsigned int line_number = 1 ; std::getline(file, line) ; ++line_number) {
+        if(line.empty() || line.front() == '#') { continue; }
+
+        std::istringstream stream(line);
+        CameraKey key;
+        stream >> key.time >> key.position.x >> key.position.y >> key.position.z
+               >> key.target.x >> key.target.y >> key.target.z;
+
+        if(stream.fail() || (!keys.empty() && key.time <= keys.back().time)) {
+            throw std::runtime_error("Invalid key at line " + std::to_string(line_number)
+                                     + " of camera path '" + path.string() + "'.");
+        }
+
+        keys.push_back(key);
+    }
+
+    if(keys.empty()) {
+        throw std::runtime_error("Camera path '" + path.string() + "' has no keys.");
+    }
+}
+
+void CameraPath::save(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to create camera path '" + path.string() + "'.");
+    }
+
+    file << "# time px py pz tx ty tz\n";
+    for(const CameraKey& key : keys) {
+        file << key.time << ' ' << key.position.x << ' ' << key.position.y << ' ' << key.position.z << ' '
+             << key.target.x << ' ' << key.target.y << ' ' << key.target.z << '\n';
+    }
+}
+
+void CameraPath::add_key(float time, const vec3& position, const vec3& target) {
+    if(!keys.empty() && time <= keys.back().time) {
+        throw std::runtime_error("Camera path keys need to be added in chronological order.");
+    }
+
+    keys.emplace_back(time, position, target);
+}
+
+void CameraPath::clear() {
+    keys.clear();
+}
+
+size_t CameraPath::get_keys_count() const {
+    return keys.size();
+}
+
+float CameraPath::get_duration() const {
+    return keys.empty() ? 0.0f : keys.back().time;
+}
+
+void CameraPath::sample(float time, vec3& position, vec3& target) const {
+    if(keys.empty()) { return; }
+
+    if(time <= keys.front().time) {
+        position = keys.front().position;
+        target = keys.front().target;
+        return;
+    }
+
+    if(time >= keys.back().time) {
+        position = keys.back().position;
+        target = keys.back().target;
+        return;
+    }
+
+    auto next = std::ranges::upper_bound(keys, time, {}, &CameraKey::time);
+    size_t i = next - keys.begin() - 1;
+
+    /* The first and last keys are repeated to get the tangents at the ends of the path. */
+    const CameraKey& k0 = keys[i == 0 ? 0 : i - 1];
+    const CameraKey& k1 = keys[i];
+    const CameraKey& k2 = keys[i + 1];
+    const CameraKey& k3 = keys[std::min(i + 2, keys.size() - 1)];
+
+    float t = (time - k1.time) / (k2.time - k1.time);
+    position = catmull_rom(k0.position, k1.position, k2.position, k3.position, t);
+    target = catmull_rom(k0.target, k1.target, k2.target, k3.target, t);
+}
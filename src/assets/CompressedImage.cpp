@@ -0,0 +1,409 @@
+/***************************************************************************************************
+ * @file  CompressedImage.cpp
+ * @brief Implementation of the CompressedImage class
+ **************************************************************************************************/
+
+#include "assets/CompressedImage.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+static constexpr uint32_t CACHE_MAGIC = 0x58455443; ///< "CTEX" in little endian.
+static constexpr uint32_t CACHE_VERSION = 2;
+static const std::filesystem::path CACHE_DIRECTORY = "cache/textures";
+static constexpr uint32_t MAX_CACHE_DIMENSION = 1 << 16; ///< The largest width or height of a cached image.
+static constexpr uint32_t MAX_CACHE_LEVELS_COUNT = 17;   ///< The levels of a full mip chain of the largest image.
+
+/**
+ * @brief Returns the size in bytes of a 4x4 block.
+ * @param format The compression format.
+ * @return 8 for BC1 and BC4, 16 for BC3 and BC5.
+ */
+static unsigned int get_block_size(CompressionFormat format) {
+    return format == CompressionFormat::BC1 || format == CompressionFormat::BC4 ? 8 : 16;
+}
+
+/**
+ * @brief Converts an 8 bits per channel color to 5:6:5.
+ */
+static uint16_t to_565(float r, float g, float b) {
+    auto quantize = [](float value, float max) {
+        return static_cast<uint16_t>(std::clamp(value, 0.0f, 255.0f) * max / 255.0f + 0.5f);
+    };
+
+    return quantize(r, 31.0f) << 11 | quantize(g, 63.0f) << 5 | quantize(b, 31.0f);
+}
+
+/**
+ * @brief Converts a 5:6:5 color to 8 bits per channel the same way the GPU does.
+ */
+static void from_565(uint16_t color, int rgb[3]) {
+    int r = color >> 11 & 31;
+    int g = color >> 5 & 63;
+    int b = color & 31;
+    rgb[0] = r << 3 | r >> 2;
+    rgb[1] = g << 2 | g >> 4;
+    rgb[2] = b << 3 | b >> 2;
+}
+
+/**
+ * @brief Compresses a block of 4x4 RGBA pixels to BC1. The endpoints are the extremities of the
+ * colors' principal axis.
+ * @param pixels The 16 RGBA pixels of the block.
+ * @param output Where to write the 8 bytes of the block.
+ */
+static void compress_bc1_block(const unsigned char* pixels, unsigned char* output) {
+    float mean[3] { 0.0f, 0.0f, 0.0f };
+    for(unsigned int i = 0 ; i < 16 ; ++i) {
+        for(unsigned int c = 0 ; c < 3 ; ++c) { mean[c] += pixels[4 * i + c]; }
+    }
+    for(float& value : mean) { value /= 16.0f; }
+
+    /* Covariance matrix, which is symmetric. */
+    float covariance[6] { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for(unsigned int i = 0 ; i < 16 ; ++i) {
+        float r = pixels[4 * i] - mean[0];
+        float g = pixels[4 * i + 1] - mean[1];
+        float b = pixels[4 * i + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    /* The principal axis is found with a few power iterations. */
+    float axis[3] { 1.0f, 1.0f, 1.0f };
+    for(unsigned int iteration = 0 ; iteration < 8 ; ++iteration) {
+        float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+
+        float max = std::max({ std::abs(x), std::abs(y), std::abs(z) });
+        if(max == 0.0f) { break; }
+        axis[0] = x / max;
+        axis[1] = y / max;
+        axis[2] = z / max;
+    }
+
+    float length_squared = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float min_t = 0.0f;
+    float max_t = 0.0f;
+    for(unsigned int i = 0 ; i < 16 ; ++i) {
+        float t = (pixels[4 * i] - mean[0]) * axis[0]
+                  + (pixels[4 * i + 1] - mean[1]) * axis[1]
+                  + (pixels[4 * i + 2] - mean[2]) * axis[2];
+        min_t = std::min(min_t, t);
+        max_t = std::max(max_t, t);
+    }
+    min_t /= length_squared;
+    max_t /= length_squared;
+
+    uint16_t color0 = to_565(mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t, mean[2] + axis[2] * max_t);
+    uint16_t color1 = to_565(mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t, mean[2] + axis[2] * min_t);
+
+    /* color0 > color1 selects the 4 colors mode, which is also the only mode of BC3's color block. */
+    if(color0 < color1) { std::swap(color0, color1); }
+
+    uint32_t indices = 0;
+    if(color0 != color1) {
+        int palette[4][3];
+        from_565(color0, palette[0]);
+        from_565(color1, palette[1]);
+        for(unsigned int c = 0 ; c < 3 ; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for(unsigned int i = 0 ; i < 16 ; ++i) {
+            unsigned int best_index = 0;
+            int best_distance = std::numeric_limits<int>::max();
+
+            for(unsigned int j = 0 ; j < 4 ; ++j) {
+                int r = pixels[4 * i] - palette[j][0];
+                int g = pixels[4 * i + 1] - palette[j][1];
+                int b = pixels[4 * i + 2] - palette[j][2];
+                int distance = r * r + g * g + b * b;
+                if(distance < best_distance) {
+                    best_distance = distance;
+                    best_index = j;
+                }
+            }
+
+            indices |= best_index << 2 * i;
+        }
+    }
+
+    output[0] = color0 & 0xFF;
+    output[1] = color0 >> 8;
+    output[2] = color1 & 0xFF;
+    output[3] = color1 >> 8;
+    for(unsigned int i = 0 ; i < 4 ; ++i) { output[4 + i] = indices >> 8 * i & 0xFF; }
+}
+
+/**
+ * @brief Compresses a block of 4x4 single channel values to BC4. Uses the 8 values mode with the
+ * block's minimum and maximum as endpoints.
+ * @param pixels The 16 RGBA pixels of the block.
+ * @param channel The channel to compress.
+ * @param output Where to write the 8 bytes of the block.
+ */
+static void compress_bc4_block(const unsigned char* pixels, unsigned int channel, unsigned char* output) {
+    int min = 255;
+    int max = 0;
+    for(unsigned int i = 0 ; i < 16 ; ++i) {
+        min = std::min<int>(min, pixels[4 * i + channel]);
+        max = std::max<int>(max, pixels[4 * i + channel]);
+    }
+
+    uint64_t indices = 0;
+    if(min != max) {
+        int palette[8] { max, min };
+        for(int j = 1 ; j < 7 ; ++j) { palette[j + 1] = ((7 - j) * max + j * min) / 7; }
+
+        for(unsigned int i = 0 ; i < 16 ; ++i) {
+            uint64_t best_index = 0;
+            int best_distance = 256;
+
+            for(unsigned int j = 0 ; j < 8 ; ++j) {
+                int distance = std::abs(pixels[4 * i + channel] - palette[j]);
+                if(distance < best_distance) {
+                    best_distance = distance;
+                    best_index = j;
+                }
+            }
+
+            indices |= best_index << 3 * i;
+        }
+    }
+
+    output[0] = static_cast<unsigned char>(max);
+    output[1] = static_cast<unsigned char>(min);
+    for(unsigned int i = 0 ; i < 6 ; ++i) { output[2 + i] = indices >> 8 * i & 0xFF; }
+}
+
+/**
+ * @brief Compresses a RGBA level.
+ * @param pixels The level's pixels.
+ * @param width The level's width.
+ * @param height The level's height.
+ * @param format The compression format.
+ * @param output Where to write the level's blocks.
+ */
+static void compress_level(const unsigned char* pixels,
+                           unsigned int width,
+                           unsigned int height,
+                           CompressionFormat format,
+                           unsigned char* output) {
+    unsigned char block[64];
+
+    for(unsigned int block_y = 0 ; block_y < height ; block_y += 4) {
+        for(unsigned int block_x = 0 ; block_x < width ; block_x += 4) {
+            /* The blocks on the borders repeat the last row and column of the image. */
+            for(unsigned int y = 0 ; y < 4 ; ++y) {
+                unsigned int row = std::min(block_y + y, height - 1);
+                for(unsigned int x = 0 ; x < 4 ; ++x) {
+                    unsigned int column = std::min(block_x + x, width - 1);
+                    std::copy_n(pixels + 4 * (row * width + column), 4, block + 4 * (4 * y + x));
+                }
+            }
+
+            switch(format) {
+                case CompressionFormat::BC1:
+                    compress_bc1_block(block, output);
+                    break;
+                case CompressionFormat::BC3:
+                    compress_bc4_block(block, 3, output);
+                    compress_bc1_block(block, output + 8);
+                    break;
+                case CompressionFormat::BC4:
+                    compress_bc4_block(block, 0, output);
+                    break;
+                case CompressionFormat::BC5:
+                    compress_bc4_block(block, 0, output);
+                    compress_bc4_block(block, 1, output + 8);
+                    break;
+            }
+
+            output += get_block_size(format);
+        }
+    }
+}
+
+CompressedImage::CompressedImage() : format(CompressionFormat::BC1) { }
+
+CompressedImage::CompressedImage(const Image& image,
+                                 CompressionFormat format,
+                                 bool srgb,
+                                 MipmapFilter filter,
+                                 unsigned int threads_count)
+    : format(format) {
+    unsigned int width = image.get_width();
+    unsigned int height = image.get_height();
+    unsigned int channels_amount = image.get_channels_amount();
+    const unsigned char* image_data = image.get_data();
+
+    /* Every channel amount is expanded to RGBA so that the encoders only handle one layout. */
+    std::vector<unsigned char> pixels(4 * static_cast<size_t>(width) * height);
+    for(size_t i = 0 ; i < static_cast<size_t>(width) * height ; ++i) {
+        const unsigned char* pixel = image_data + i * channels_amount;
+        pixels[4 * i] = pixel[0];
+        pixels[4 * i + 1] = channels_amount >= 2 ? pixel[1] : 0;
+        pixels[4 * i + 2] = channels_amount >= 3 ? pixel[2] : 0;
+        pixels[4 * i + 3] = channels_amount == 4 ? pixel[3] : 255;
+    }
+
+    std::vector<MipLevel> mip_levels = generate_mipmaps(pixels.data(), width, height, filter, srgb, threads_count);
+
+    unsigned int block_size = get_block_size(format);
+    size_t size = 0;
+    for(const MipLevel& mip_level : mip_levels) {
+        size_t level_size = static_cast<size_t>((mip_level.width + 3) / 4) * ((mip_level.height + 3) / 4) * block_size;
+        levels.emplace_back(mip_level.width, mip_level.height, size, level_size);
+        size += level_size;
+    }
+
+    data.resize(size);
+    for(unsigned int i = 0 ; i < levels.size() ; ++i) {
+        compress_level(mip_levels[i].pixels.data(), levels[i].width, levels[i].height, format, data.data() + levels[i].offset);
+    }
+}
+
+CompressionFormat CompressedImage::choose_format(const Image& image, bool is_normal_map) {
+    switch(image.get_channels_amount()) {
+        case 1: return CompressionFormat::BC4;
+        case 2: return CompressionFormat::BC5;
+        case 4: {
+            if(is_normal_map) { return CompressionFormat::BC5; }
+
+            const unsigned char* data = image.get_data();
+            for(size_t i = 3 ; i < image.get_size() ; i += 4) {
+                if(data[i] != 255) { return CompressionFormat::BC3; }
+            }
+
+            return CompressionFormat::BC1;
+        }
+        default: return is_normal_map ? CompressionFormat::BC5 : CompressionFormat::BC1;
+    }
+}
+
+std::filesystem::path CompressedImage::get_cache_path(uint64_t hash) {
+    std::ostringstream file_name;
+    file_name << std::hex << std::setfill('0') << std::setw(16) << hash << ".ctex";
+
+    return CACHE_DIRECTORY / file_name.str();
+}
+
+bool CompressedImage::load(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file.is_open()) { return false; }
+
+    auto read = [&file](auto& value) {
+        file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    };
+
+    /* The cache can be corrupted or written by another version, so nothing is allocated or read
+     * before the header is checked against the size of the file. */
+    std::error_code error;
+    const uintmax_t file_size = std::filesystem::file_size(path, error);
+    if(error) { return false; }
+
+    uint32_t magic, version, file_format, levels_count;
+    read(magic);
+    read(version);
+    read(file_format);
+    read(levels_count);
+    if(!file || magic != CACHE_MAGIC || version != CACHE_VERSION) { return false; }
+    if(file_format > static_cast<uint32_t>(CompressionFormat::BC5)) { return false; }
+    if(levels_count == 0 || levels_count > MAX_CACHE_LEVELS_COUNT) { return false; }
+
+    const CompressionFormat file_compression_format = static_cast<CompressionFormat>(file_format);
+    std::vector<Level> file_levels(levels_count);
+
+    /* Each level is half the size of the previous one, like the mip chains that are saved. */
+    size_t size = 0;
+    for(size_t i = 0 ; i < file_levels.size() ; ++i) {
+        uint32_t width, height;
+        read(width);
+        read(height);
+        if(!file || width == 0 || height == 0 || width > MAX_CACHE_DIMENSION || height > MAX_CACHE_DIMENSION) { return false; }
+        if(i > 0 && (width != std::max(file_levels[i - 1].width / 2, 1u) || height != std::max(file_levels[i - 1].height / 2, 1u))) {
+            return false;
+        }
+
+        Level& level = file_levels[i];
+        level.width = width;
+        level.height = height;
+        level.offset = size;
+        level.size = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * get_block_size(file_compression_format);
+        size += level.size;
+    }
+
+    const size_t header_size = 4 * sizeof(uint32_t) + 2 * sizeof(uint32_t) * static_cast<size_t>(levels_count);
+    if(file_size != header_size + size) { return false; }
+
+    std::vector<unsigned char> file_data(size);
+    file.read(reinterpret_cast<char*>(file_data.data()), static_cast<std::streamsize>(size));
+    if(!file) { return false; }
+
+    format = file_compression_format;
+    levels = std::move(file_levels);
+    data = std::move(file_data);
+    return true;
+}
+
+void CompressedImage::save(const std::filesystem::path& path) const {
+    std::filesystem::create_directories(path.parent_path());
+
+    /* Written to a temporary file first so that other threads and crashes never see a partial file. */
+    std::filesystem::path temporary_path = path;
+    temporary_path += '.' + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+    {
+        std::ofstream file(temporary_path, std::ios::binary);
+        if(!file.is_open()) { throw std::runtime_error("Couldn't write to texture cache file " + path.string()); }
+
+        auto write = [&file](uint32_t value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+
+        write(CACHE_MAGIC);
+        write(CACHE_VERSION);
+        write(static_cast<unsigned int>(format));
+        write(levels.size());
+        for(const Level& level : levels) {
+            write(level.width);
+            write(level.height);
+        }
+
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::rename(temporary_path, path);
+}
+
+CompressionFormat CompressedImage::get_format() const {
+    return format;
+}
+
+const std::vector<CompressedImage::Level>& CompressedImage::get_levels() const {
+    return levels;
+}
+
+const unsigned char* CompressedImage::get_data() const {
+    return data.data();
+}
+
+size_t CompressedImage::get_size() const {
+    return data.size();
+}
+
+bool CompressedImage::has_transparency() const {
+    return format == CompressionFormat::BC3;
+}
@@ -6,274 +6,361 @@
 #include "assets/GLTF.hpp"
 
 #include <algorithm>
+#include <iostream>
 
 #include "assets/AssetManager.hpp"
+#include "assets/TextureStreamer.hpp"
+#include "assets/VirtualTextureSystem.hpp"
+#include "engine/Profiler.hpp"
 #include "engine/SceneGraph.hpp"
 
-GLTF::Scene::Scene(const std::filesystem::path& path, SceneGraph* scene_graph, unsigned int scene_node_index) {
+GLTF::Scene::Scene() : scene_node_index(0), state(LoadingState::LOADED), uploads_count(0) { }
+
+GLTF::Scene::Scene(const std::filesystem::path& path, SceneGraph* scene_graph, unsigned int scene_node_index)
+    : Scene() {
     load(path, scene_graph, scene_node_index);
 }
 
 GLTF::Scene::~Scene() {
-    for(unsigned int i = 0 ; i < meshes.get_size() ; ++i) {
-        for(unsigned int j = 0 ; j < meshes[i].primitives.get_size() ; ++j) {
-            delete meshes[i].primitives[j].material;
+    if(decoding.valid()) { decoding.wait(); }
+
+    for(const std::vector<PrimitiveAssets>& mesh_assets : assets) {
+        for(const PrimitiveAssets& primitive_assets : mesh_assets) {
+            if(primitive_assets.mesh.is_valid()) { AssetManager::release(primitive_assets.mesh); }
+            if(primitive_assets.material.is_valid()) { AssetManager::release(primitive_assets.material); }
         }
     }
 }
 
 void GLTF::Scene::load(const std::filesystem::path& path, SceneGraph* scene_graph, unsigned int scene_node_index) {
-    /* ---- TinyGLTF Load Model ---- */
-    tinygltf::TinyGLTF loader;
-    loader.SetPreserveImageChannels(true);
+    Profiler::Zone zone("GLTF::Scene::load");
+    this->scene_node_index = scene_node_index;
 
-    tinygltf::Model model;
-    std::string error;
-    std::string warning;
+    decode(path, false);
+    create_materials();
 
-    bool success;
+    for(const TextureUpload& upload : pending_textures) { upload_texture(upload); }
+    pending_textures.clear();
 
-    if(path.extension() == ".glb") {
-        success = loader.LoadBinaryFromFile(&model, &error, &warning, path.string());
-    } else {
-        success = loader.LoadASCIIFromFile(&model, &error, &warning, path.string());
-    }
+    create_nodes(scene_graph);
 
-    if(!warning.empty()) { std::cerr << "Warning loading GLTF scene: " << warning << '\n'; }
-    if(!error.empty()) { std::cerr << "Error loading GLTF scene: " << error << '\n'; }
-    if(!success) { throw std::runtime_error("Failed to load GLTF scene from file '" + path.string() + "'."); }
+    for(Handle<::Mesh> mesh : pending_meshes) { AssetManager::get_mesh(mesh).bind_buffers(); }
+    pending_meshes.clear();
 
-    std::cout << "Loading GLTF scene: " << path << ".\n";
+    model.release_source();
+}
 
-    /* ---- Meshes ---- */
-    size_t meshes_count = model.meshes.size();
-    meshes.resize(meshes_count);
+void GLTF::Scene::load_async(const std::filesystem::path& path, unsigned int scene_node_index) {
+    this->scene_node_index = scene_node_index;
+    state = LoadingState::DECODING;
 
-    for(unsigned int i = 0 ; i < meshes_count ; ++i) {
-        tinygltf::Mesh& t_mesh = model.meshes[i];
-        Mesh& mesh = meshes[i];
+    decoding = std::async(std::launch::async, [this, path] {
+        Profiler::set_thread_name("glTF Decoding");
+        decode(path, true);
+    });
+}
 
-        mesh.name = t_mesh.name.empty() ? "Mesh " + std::to_string(i) : t_mesh.name;
+bool GLTF::Scene::update_loading(SceneGraph* scene_graph, size_t& upload_budget) {
+    Profiler::Zone zone("GLTF::Scene::update_loading");
+    if(state == LoadingState::DECODING) {
+        if(decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready) { return false; }
 
-        size_t primitives_count = t_mesh.primitives.size();
-        mesh.primitives.resize(primitives_count);
+        /* The future can only be read once, so a failed load moves to a state that isn't polled. */
+        try {
+            decoding.get(); // Rethrows the background thread's exception if there was one.
 
-        for(unsigned int j = 0 ; j < primitives_count ; ++j) {
-            const tinygltf::Primitive& t_primitive = t_mesh.primitives[j];
-            Primitive& primitive = mesh.primitives[j];
+            create_materials();
 
-            if(t_primitive.material != -1) {
-                const tinygltf::Material& t_material = model.materials[t_primitive.material];
+            /* The encoded images are copied for every texture that uses them but the last one, which
+             * gets them moved. */
+            std::vector<unsigned int> image_uses(model.t_model.images.size(), 0);
+            for(const TextureUpload& upload : pending_textures) {
+                if(upload.texture_index != -1) { ++image_uses[model.t_model.textures[upload.texture_index].source]; }
+            }
 
-                primitive.material = new MRMaterial(t_material.name);
-                MRMaterial* material = primitive.material;
+            /* The maps without a texture are 1x1 textures of their default color, and so are the
+             * placeholders of the streamed textures until their images are decoded and uploaded. */
+            for(const TextureUpload& upload : pending_textures) {
+                if(upload.texture_index == -1) {
+                    upload_texture(upload);
+                    continue;
+                }
 
-                material->base_color = vec4(
-                    t_material.pbrMetallicRoughness.baseColorFactor[0],
-                    t_material.pbrMetallicRoughness.baseColorFactor[1],
-                    t_material.pbrMetallicRoughness.baseColorFactor[2],
-                    t_material.pbrMetallicRoughness.baseColorFactor[3]
-                );
+                unsigned int& uses = image_uses[model.t_model.textures[upload.texture_index].source];
+                stream_texture(upload, --uses == 0);
+            }
+            pending_textures.clear();
+
+            create_nodes(scene_graph);
+        } catch(const std::exception& exception) {
+            std::cerr << "Error loading GLTF scene: " << exception.what() << '\n';
+            pending_textures.clear();
+            pending_meshes.clear();
+            model.release_source();
+            state = LoadingState::FAILED;
+            return false;
+        }
 
-                material->metallic = t_material.pbrMetallicRoughness.metallicFactor;
-                material->roughness = t_material.pbrMetallicRoughness.roughnessFactor;
+        uploads_count = pending_meshes.size();
+        state = LoadingState::UPLOADING;
+    }
 
-                int base_color_texture_index = t_material.pbrMetallicRoughness.baseColorTexture.index;
-                if(base_color_texture_index == -1) {
-                    material->base_color_map.create(255, 255, 255);
-                } else {
-                    const tinygltf::Texture& t_texture = model.textures[base_color_texture_index];
-                    material->base_color_map.create(model.images[t_texture.source],
-                                                    model.samplers[t_texture.sampler],
-                                                    true);
-                }
+    if(state == LoadingState::UPLOADING) {
+        /* Meshes go first so that the geometry shows up as soon as possible. */
+        while(upload_budget > 0 && !pending_meshes.empty()) {
+            ::Mesh& mesh = AssetManager::get_mesh(pending_meshes.back());
+            pending_meshes.pop_back();
+            mesh.bind_buffers();
+            upload_budget -= std::min(upload_budget, mesh.get_buffers_size());
+        }
 
-                int MR_texture_index = t_material.pbrMetallicRoughness.metallicRoughnessTexture.index;
-                if(MR_texture_index == -1) {
-                    material->metallic_roughness_map.create(vec3(0.0f, 0.5f, 0.0f));
-                } else {
-                    const tinygltf::Texture& t_texture = model.textures[MR_texture_index];
-                    material->metallic_roughness_map.create(model.images[t_texture.source],
-                                                            model.samplers[t_texture.sampler],
-                                                            false);
-                }
+        if(pending_meshes.empty()) {
+            model.release_source();
+            state = LoadingState::LOADED;
+        }
+    }
 
-                int normal_map_index = t_material.normalTexture.index;
-                if(normal_map_index == -1) {
-                    material->normal_map.create(vec3(1.0f, 0.5f, 0.5f));
-                } else {
-                    const tinygltf::Texture& t_texture = model.textures[normal_map_index];
-                    material->normal_map.create(model.images[t_texture.source],
-                                                model.samplers[t_texture.sampler],
-                                                false);
-                }
-            }
+    return state == LoadingState::LOADED;
+}
 
-            switch(t_primitive.mode) {
-                case TINYGLTF_MODE_POINTS:
-                    primitive.primitive.set_primitive(MeshPrimitive::POINTS);
-                    break;
-                case TINYGLTF_MODE_LINE:
-                    primitive.primitive.set_primitive(MeshPrimitive::LINES);
-                    break;
-                case TINYGLTF_MODE_LINE_LOOP:
-                    throw std::runtime_error("Unhandled primitive mode: TINYGLTF_MODE_LINE_LOOP.");
-                case TINYGLTF_MODE_LINE_STRIP:
-                    throw std::runtime_error("Unhandled primitive mode: TINYGLTF_MODE_LINE_STRIP.");
-                case TINYGLTF_MODE_TRIANGLES:
-                    primitive.primitive.set_primitive(MeshPrimitive::TRIANGLES);
-                    break;
-                case TINYGLTF_MODE_TRIANGLE_STRIP:
-                    throw std::runtime_error("Unhandled primitive mode: TINYGLTF_MODE_TRIANGLE_STRIP.");
-                case TINYGLTF_MODE_TRIANGLE_FAN:
-                    throw std::runtime_error("Unhandled primitive mode: TINYGLTF_MODE_TRIANGLE_FAN.");
-                default:
-                    throw std::runtime_error("Unknown primitive mode: " + std::to_string(t_primitive.mode) + '.');
-            }
+bool GLTF::Scene::is_loading() const {
+    return state == LoadingState::DECODING || state == LoadingState::UPLOADING;
+}
 
-            static const std::map<std::string, Attribute> GLTF_STRING_TO_ATTR {
-                { "POSITION", ATTRIBUTE_POSITION },
-                { "NORMAL", ATTRIBUTE_NORMAL },
-                { "TEXCOORD_0", ATTRIBUTE_TEX_COORDS },
-                { "COLOR_0", ATTRIBUTE_COLOR },
-                { "TANGENT", ATTRIBUTE_TANGENT },
-            };
-
-            std::vector<AttributeInfo> attribute_infos;
-            size_t vertex_count = 0;
-
-            for(const auto& [attribute_name, accessor_index] : t_primitive.attributes) {
-                const tinygltf::Accessor& t_accessor = model.accessors[accessor_index];
-                const tinygltf::BufferView& t_buffer_view = model.bufferViews[t_accessor.bufferView];
-                const tinygltf::Buffer& t_buffer = model.buffers[t_buffer_view.buffer];
-
-                auto iterator = GLTF_STRING_TO_ATTR.find(attribute_name);
-                if(iterator == GLTF_STRING_TO_ATTR.end()) {
-                    std::cout << "\tUnhandled attribute: " << attribute_name << '\n';
-                } else {
-                    Attribute attribute = iterator->second;
-                    AttributeType attribute_type;
-                    switch(t_accessor.type) {
-                        case TINYGLTF_TYPE_VEC2:
-                            attribute_type = AttributeType::VEC2;
-                            break;
-                        case TINYGLTF_TYPE_VEC3:
-                            attribute_type = AttributeType::VEC3;
-                            break;
-                        case TINYGLTF_TYPE_VEC4:
-                            attribute_type = AttributeType::VEC4;
-                            break;
-                        case TINYGLTF_TYPE_MAT2:
-                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT2.");
-                        case TINYGLTF_TYPE_MAT3:
-                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT3.");
-                        case TINYGLTF_TYPE_MAT4:
-                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT4.");
-                        case TINYGLTF_TYPE_SCALAR:
-                            attribute_type = AttributeType::FLOAT;
-                            break;
-                        case TINYGLTF_TYPE_VECTOR:
-                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_VECTOR.");
-                        case TINYGLTF_TYPE_MATRIX:
-                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MATRIX.");
-                        default:
-                            throw std::runtime_error(
-                                "Unknown attribute type: " + std::to_string(t_accessor.type) + '.');
-                    }
-
-                    if(t_accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT) {
-                        throw std::runtime_error("Unhandled case: non-float attribute.");
-                    }
-
-                    size_t byte_offset = t_accessor.byteOffset + t_buffer_view.byteOffset;
-                    size_t stride_in_floats = t_buffer_view.byteStride == 0
-                                                  ? get_attribute_type_count(attribute_type)
-                                                  : t_buffer_view.byteStride / sizeof(float);
-
-                    attribute_infos.emplace_back(attribute,
-                                                 reinterpret_cast<const float*>(t_buffer.data.data() + byte_offset),
-                                                 stride_in_floats,
-                                                 get_attribute_type_count(attribute_type)
-                    );
-
-                    if(vertex_count == 0) {
-                        vertex_count = t_accessor.count;
-                    } else if(vertex_count != t_accessor.count) {
-                        throw std::runtime_error("Not the same amount of values between vertex attributes.");
-                    }
-
-                    primitive.primitive.enable_attribute(attribute, attribute_type);
-                }
-            }
+bool GLTF::Scene::has_failed() const {
+    return state == LoadingState::FAILED;
+}
 
-            std::ranges::sort(attribute_infos, [](const AttributeInfo& a1, const AttributeInfo& a2) {
-                return a1.attribute < a2.attribute;
-            });
+float GLTF::Scene::get_loading_progress() const {
+    switch(state) {
+        case LoadingState::DECODING:
+        case LoadingState::FAILED: return 0.0f;
+        case LoadingState::UPLOADING: {
+            if(uploads_count == 0) { return 1.0f; }
+            return static_cast<float>(uploads_count - pending_meshes.size()) / static_cast<float>(uploads_count);
+        }
+        default: return 1.0f;
+    }
+}
 
-            for(size_t k = 0 ; k < vertex_count ; ++k) {
-                for(const AttributeInfo& attribute_info : attribute_infos) {
-                    primitive.primitive.push_values(attribute_info.data + k * attribute_info.stride_in_floats,
-                                                    attribute_info.elements_count);
-                }
-            }
+void GLTF::Scene::decode(const std::filesystem::path& path, bool images_as_is) {
+    {
+        Profiler::Zone zone("GLTF::Model::load");
+        model.load(path, images_as_is);
+    }
+    {
+        Profiler::Zone zone("GLTF::Model::create_meshes");
+        model.create_meshes();
+    }
+    {
+        Profiler::Zone zone("GLTF::Model::create_skins_and_animations");
+        model.create_skins_and_animations();
+    }
+}
 
-            if(t_primitive.indices != -1) {
-                const tinygltf::Accessor& t_accessor = model.accessors[t_primitive.indices];
-                const tinygltf::BufferView& t_buffer_view = model.bufferViews[t_accessor.bufferView];
-                const tinygltf::Buffer& t_buffer = model.buffers[t_buffer_view.buffer];
+void GLTF::Scene::create_materials() {
+    Profiler::Zone zone("GLTF::Scene::create_materials");
+    assets.resize(model.meshes.get_size());
 
-                size_t byte_offset = t_accessor.byteOffset + t_buffer_view.byteOffset;
+    for(unsigned int i = 0 ; i < model.meshes.get_size() ; ++i) {
+        const HeapArray<Primitive>& primitives = model.meshes[i].primitives;
+        assets[i].resize(primitives.get_size());
 
-                switch(t_accessor.componentType) {
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
-                        const unsigned char* data = t_buffer.data.data() + byte_offset;
-                        for(size_t k = 0 ; k < t_accessor.count ; ++k) { primitive.primitive.add_index(data[k]); }
-                        break;
-                    }
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
-                        auto data = reinterpret_cast<const unsigned short*>(t_buffer.data.data() + byte_offset);
-                        for(size_t k = 0 ; k < t_accessor.count ; ++k) { primitive.primitive.add_index(data[k]); }
-                        break;
-                    }
-                    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
-                        auto data = reinterpret_cast<const unsigned int*>(t_buffer.data.data() + byte_offset);
-                        for(size_t k = 0 ; k < t_accessor.count ; ++k) { primitive.primitive.add_index(data[k]); }
-                        break;
-                    }
-                    default: throw std::runtime_error("Wrong or unknown component type in indices accessor.");
-                }
-            }
+        for(unsigned int j = 0 ; j < primitives.get_size() ; ++j) {
+            if(primitives[j].material == -1) { continue; }
+
+            const MaterialData& data = model.materials.at(primitives[j].material);
+            std::unique_ptr<MRMaterial> material = std::make_unique<MRMaterial>(data.name);
+            material->base_color = data.base_color;
+            material->metallic = data.metallic;
+            material->roughness = data.roughness;
+
+            Handle<Material> handle = AssetManager::add_material(std::move(material));
+            AssetManager::acquire(handle);
+            assets[i][j].material = handle;
+
+            pending_textures.emplace_back(handle, &MRMaterial::base_color_map, data.base_color_texture, true, false, vec3(1.0f));
+            pending_textures.emplace_back(handle,
+                                          &MRMaterial::metallic_roughness_map,
+                                          data.metallic_roughness_texture,
+                                          false,
+                                          false,
+                                          vec3(0.0f, 0.5f, 0.0f));
+            pending_textures.emplace_back(handle,
+                                          &MRMaterial::normal_map,
+                                          data.normal_texture,
+                                          false,
+                                          true,
+                                          vec3(0.5f, 0.5f, 1.0f));
+        }
+    }
+}
 
-            primitive.primitive.bind_buffers();
+void GLTF::Scene::create_nodes(SceneGraph* scene_graph) {
+    Profiler::Zone zone("GLTF::Scene::create_nodes");
+    /* ---- Assets and deduplication ---- */
+    for(unsigned int i = 0 ; i < model.meshes.get_size() ; ++i) {
+        for(unsigned int j = 0 ; j < model.meshes[i].primitives.get_size() ; ++j) {
+            Primitive& primitive = model.meshes[i].primitives[j];
+            Handle<::Mesh>& mesh = assets[i][j].mesh;
+            mesh = scene_graph->find_duplicate_mesh(primitive.primitive, primitive.content_hash);
+
+            if(mesh.is_valid()) {
+                /* The duplicate was never bound, assigning an empty mesh only frees its vertex data. */
+                primitive.primitive = ::Mesh();
+            } else {
+                mesh = AssetManager::add_mesh(std::move(primitive.primitive));
+                scene_graph->register_mesh_content(mesh, primitive.content_hash);
+                pending_meshes.push_back(mesh);
+            }
+            AssetManager::acquire(mesh);
         }
     }
 
     /* ---- Scenes ---- */
-    if(model.scenes.size() == 0) {
+    const tinygltf::Model& t_model = model.t_model;
+    node_indices.assign(t_model.nodes.size(), INVALID_INDEX);
+    morph_weights_offsets.assign(t_model.nodes.size(), INVALID_INDEX);
+
+    if(t_model.scenes.size() == 0) {
         throw std::runtime_error("Unhandled case, no scene in GLTF file.");
-    } else if(model.scenes.size() == 1) {
-        const tinygltf::Scene& t_scene = model.scenes[0];
+    } else if(t_model.scenes.size() == 1) {
+        const tinygltf::Scene& t_scene = t_model.scenes[0];
         if(!t_scene.name.empty()) { scene_graph->nodes[scene_node_index].name = t_scene.name; }
 
         for(int node_index : t_scene.nodes) {
-            add_node(model.nodes, model.nodes[node_index], scene_graph, scene_node_index);
+            add_node(t_model.nodes, t_model.nodes[node_index], scene_graph, scene_node_index);
         }
     } else {
         unsigned int i = 0;
 
-        for(const tinygltf::Scene& t_scene : model.scenes) {
+        for(const tinygltf::Scene& t_scene : t_model.scenes) {
             unsigned int sg_node_index = scene_graph->add_simple_node(t_scene.name.empty()
                                                                           ? "Scene " + std::to_string(i)
                                                                           : t_scene.name,
                                                                       scene_node_index);
 
             for(int node_index : t_scene.nodes) {
-                add_node(model.nodes, model.nodes[node_index], scene_graph, sg_node_index);
+                add_node(t_model.nodes, t_model.nodes[node_index], scene_graph, sg_node_index);
             }
 
             ++i;
         }
     }
+
+    add_skins_and_animations(scene_graph);
+}
+
+void GLTF::Scene::add_skins_and_animations(SceneGraph* scene_graph) {
+    const tinygltf::Model& t_model = model.t_model;
+
+    /* ---- Skins ---- */
+    for(size_t i = 0 ; i < t_model.nodes.size() ; ++i) {
+        const tinygltf::Node& t_node = t_model.nodes[i];
+        if(t_node.skin == -1 || t_node.mesh == -1 || node_indices[i] == INVALID_INDEX) { continue; }
+
+        const tinygltf::Skin& t_skin = t_model.skins[t_node.skin];
+
+        Skin skin;
+        skin.mesh_node = node_indices[i];
+        skin.inverse_bind_matrices = model.inverse_bind_matrices[t_node.skin];
+        skin.joints.reserve(t_skin.joints.size());
+        for(int joint : t_skin.joints) { skin.joints.push_back(node_indices[joint]); }
+
+        if(std::ranges::find(skin.joints, INVALID_INDEX) != skin.joints.end()) {
+            std::cout << "\tSkin whose joints aren't in the scene: " << t_skin.name << '\n';
+            continue;
+        }
+
+        unsigned int skin_index = scene_graph->add_skin(std::move(skin));
+
+        /* The primitives are the mesh nodes right under the node. Only the ones drawn with a shader
+         * that has a skinned variant are skinned. */
+        for(unsigned int child : scene_graph->nodes[node_indices[i]].children) {
+            Node& node = scene_graph->nodes[child];
+            if(node.type != Node::Type::MESH) { continue; }
+
+            const ::Mesh& mesh = AssetManager::get_mesh(scene_graph->meshes[node.drawable_index]);
+            if(!mesh.has_attribute(ATTRIBUTE_JOINTS) || !mesh.has_attribute(ATTRIBUTE_WEIGHTS)) { continue; }
+
+            switch(node.shader_name) {
+                case SHADER_METALLIC_ROUGHNESS:
+                    node.shader_name = SHADER_METALLIC_ROUGHNESS_DEFORMED;
+                    node.skin_index = skin_index;
+                    break;
+                case SHADER_METALLIC_ROUGHNESS_NO_TANGENT:
+                    node.shader_name = SHADER_METALLIC_ROUGHNESS_NO_TANGENT_DEFORMED;
+                    node.skin_index = skin_index;
+                    break;
+                case SHADER_METALLIC_ROUGHNESS_DEFORMED:
+                case SHADER_METALLIC_ROUGHNESS_NO_TANGENT_DEFORMED:
+                    node.skin_index = skin_index;
+                    break;
+                default: break;
+            }
+        }
+    }
+
+    /* ---- Animations ---- */
+    for(Animation& animation : model.animations) {
+        /* Weights tracks drive the morph weights of the node instead of the node itself. */
+        auto get_target = [this](const AnimationTrack& track) {
+            return track.path == AnimationPath::WEIGHTS ? morph_weights_offsets[track.node] : node_indices[track.node];
+        };
+
+        std::erase_if(animation.tracks, [&](const AnimationTrack& track) { return get_target(track) == INVALID_INDEX; });
+        for(AnimationTrack& track : animation.tracks) { track.node = get_target(track); }
+
+        scene_graph->add_animation(std::move(animation));
+    }
+
+    model.animations.clear();
+    model.inverse_bind_matrices.clear();
+}
+
+size_t GLTF::Scene::upload_texture(const TextureUpload& upload) const {
+    MRMaterial& material = static_cast<MRMaterial&>(AssetManager::get_material(upload.material));
+    if(upload.texture_index == -1) {
+        material.set_map(upload.map, AssetManager::get_color_texture(upload.default_color));
+        return 0;
+    }
+
+    const tinygltf::Texture& t_texture = model.t_model.textures[upload.texture_index];
+    const tinygltf::Image& t_image = model.t_model.images[t_texture.source];
+    material.set_map(upload.map, AssetManager::add_texture(t_image, get_sampler(t_texture), upload.srgb));
+
+    return t_image.image.size();
+}
+
+void GLTF::Scene::stream_texture(const TextureUpload& upload, bool is_last_use) {
+    const tinygltf::Texture& t_texture = model.t_model.textures[upload.texture_index];
+    tinygltf::Image& t_image = model.t_model.images[t_texture.source];
+
+    /* A request can't know in advance whether it will be shared, as uris are only shared between
+     * requests with the same settings, so the data is only moved once no other texture needs it. */
+    std::vector<unsigned char> encoded_data;
+    if(is_last_use) {
+        encoded_data = std::move(t_image.image);
+    } else {
+        encoded_data = t_image.image;
+    }
+
+    /* Only base color maps use the SRGB color space and only they can be sampled virtually. */
+    Handle<Texture> texture = TextureStreamer::request(t_image.uri,
+                                                       std::move(encoded_data),
+                                                       get_sampler(t_texture),
+                                                       upload.srgb,
+                                                       upload.is_normal_map,
+                                                       upload.default_color,
+                                                       upload.srgb && VirtualTextureSystem::is_enabled());
+
+    MRMaterial& material = static_cast<MRMaterial&>(AssetManager::get_material(upload.material));
+    material.set_map(upload.map, texture);
+}
+
+const tinygltf::Sampler& GLTF::Scene::get_sampler(const tinygltf::Texture& t_texture) const {
+    static const tinygltf::Sampler DEFAULT_SAMPLER;
+    return t_texture.sampler == -1 ? DEFAULT_SAMPLER : model.t_model.samplers[t_texture.sampler];
 }
 
 void GLTF::Scene::add_node(const std::vector<tinygltf::Node>& t_nodes,
@@ -282,31 +369,54 @@ void GLTF::Scene::add_node(const std::vector<tinygltf::Node>& t_nodes,
                            int sg_parent_index) {
     if(t_node.mesh == -1) {
         sg_parent_index = scene_graph->add_simple_node(t_node.name, sg_parent_index);
+        node_indices[&t_node - t_nodes.data()] = sg_parent_index;
     } else {
-        const auto& [mesh_name, primitives] = meshes[t_node.mesh];
+        const auto& [mesh_name, primitives] = model.meshes[t_node.mesh];
+        const std::vector<PrimitiveAssets>& mesh_assets = assets[t_node.mesh];
         sg_parent_index = scene_graph->add_simple_node(mesh_name, sg_parent_index);
+        node_indices[&t_node - t_nodes.data()] = sg_parent_index;
+
+        /* All the primitives of a mesh have the same morph targets, so they share their weights. */
+        unsigned int weights_offset = INVALID_INDEX;
+        if(primitives.get_size() > 0 && primitives[0].morph_targets.get_targets_count() > 0) {
+            std::vector<float> weights = primitives[0].morph_targets.default_weights;
+            for(size_t k = 0 ; k < weights.size() && k < t_node.weights.size() ; ++k) {
+                weights[k] = static_cast<float>(t_node.weights[k]);
+            }
+
+            weights_offset = scene_graph->add_morph_weights(weights);
+            morph_weights_offsets[&t_node - t_nodes.data()] = weights_offset;
+        }
 
         for(unsigned int j = 0 ; j < primitives.get_size() ; ++j) {
             const Primitive& primitive = primitives[j];
+            const PrimitiveAssets& primitive_assets = mesh_assets[j];
             std::string primitive_name = "Primitive " + std::to_string(j);
 
-            if(primitive.material != nullptr) {
-                ShaderName shader_name = primitive.primitive.has_attribute(ATTRIBUTE_TANGENT)
-                                             ? SHADER_METALLIC_ROUGHNESS
-                                             : SHADER_METALLIC_ROUGHNESS_NO_TANGENT;
+            if(primitive_assets.material.is_valid()) {
+                bool is_morphed = weights_offset != INVALID_INDEX && primitive.morph_targets.get_targets_count() > 0;
+                bool has_tangents = AssetManager::get_mesh(primitive_assets.mesh).has_attribute(ATTRIBUTE_TANGENT);
+
+                ShaderName shader_name;
+                if(is_morphed) {
+                    shader_name = has_tangents ? SHADER_METALLIC_ROUGHNESS_DEFORMED : SHADER_METALLIC_ROUGHNESS_NO_TANGENT_DEFORMED;
+                } else {
+                    shader_name = has_tangents ? SHADER_METALLIC_ROUGHNESS : SHADER_METALLIC_ROUGHNESS_NO_TANGENT;
+                }
 
                 unsigned int node_index = scene_graph->add_mesh_node(primitive_name,
                                                                      sg_parent_index,
-                                                                     &primitive.primitive,
+                                                                     primitive_assets.mesh,
                                                                      shader_name);
 
-                scene_graph->add_material_to_node(node_index, primitive.material);
+                scene_graph->add_material_to_node(node_index, primitive_assets.material);
+                if(is_morphed) { scene_graph->add_morph(node_index, &primitive.morph_targets, weights_offset); }
             } else {
-                ShaderName shader_name = AssetManager::get_relevant_shader_name_from_mesh(primitive.primitive);
+                ShaderName shader_name = AssetManager::get_relevant_shader_name_from_mesh(AssetManager::get_mesh(primitive_assets.mesh));
 
                 unsigned int node_index = scene_graph->add_mesh_node(primitive_name,
                                                                      sg_parent_index,
-                                                                     &primitive.primitive,
+                                                                     primitive_assets.mesh,
                                                                      shader_name);
 
                 switch(shader_name) {
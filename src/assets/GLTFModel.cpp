@@ -0,0 +1,727 @@
+/***************************************************************************************************
+ * @file  GLTFModel.cpp
+ * @brief Implementation of the GLTF::Model class
+ **************************************************************************************************/
+
+#include "assets/GLTFModel.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+
+#include "json.hpp"
+
+/**
+ * @brief Finds the JSON and binary chunks of a GLB file.
+ * @param file The content of the GLB file.
+ * @param json_text Where the JSON chunk is written.
+ * @param binary_chunk Where the binary chunk is written, empty if there is none.
+ */
+static void read_glb_chunks(std::span<const unsigned char> file,
+                            std::string_view& json_text,
+                            std::span<const unsigned char>& binary_chunk) {
+    static constexpr uint32_t GLB_MAGIC = 0x46546C67;   // "glTF"
+    static constexpr uint32_t CHUNK_JSON = 0x4E4F534A;  // "JSON"
+    static constexpr uint32_t CHUNK_BINARY = 0x004E4942; // "BIN\0"
+
+    auto read_uint32 = [&file](size_t offset) {
+        uint32_t value;
+        std::memcpy(&value, file.data() + offset, sizeof(value));
+        return value;
+    };
+
+    if(file.size() < 20 || read_uint32(0) != GLB_MAGIC || read_uint32(4) != 2) {
+        throw std::runtime_error("Invalid GLB header.");
+    }
+
+    size_t length = std::min<size_t>(read_uint32(8), file.size());
+    size_t offset = 12;
+    bool is_first_chunk = true;
+
+    /* Chunks are 4 bytes aligned and start with their length and type. */
+    while(offset + 8 <= length) {
+        size_t chunk_length = read_uint32(offset);
+        uint32_t chunk_type = read_uint32(offset + 4);
+        offset += 8;
+
+        if(offset + chunk_length > length) { throw std::runtime_error("GLB chunk out of the bounds of the file."); }
+
+        if(is_first_chunk) {
+            if(chunk_type != CHUNK_JSON) { throw std::runtime_error("The first GLB chunk isn't JSON."); }
+            json_text = std::string_view(reinterpret_cast<const char*>(file.data() + offset), chunk_length);
+        } else if(chunk_type == CHUNK_BINARY && binary_chunk.empty()) {
+            binary_chunk = file.subspan(offset, chunk_length);
+        }
+
+        is_first_chunk = false;
+        offset += (chunk_length + 3) & ~size_t(3);
+    }
+
+    if(is_first_chunk) { throw std::runtime_error("GLB file without a JSON chunk."); }
+}
+
+/**
+ * @return The component type corresponding to a tinygltf component type.
+ */
+static ComponentType get_component_type(int t_component_type) {
+    switch(t_component_type) {
+        case TINYGLTF_COMPONENT_TYPE_FLOAT: return ComponentType::FLOAT;
+        case TINYGLTF_COMPONENT_TYPE_BYTE: return ComponentType::BYTE;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: return ComponentType::UNSIGNED_BYTE;
+        case TINYGLTF_COMPONENT_TYPE_SHORT: return ComponentType::SHORT;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: return ComponentType::UNSIGNED_SHORT;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: return ComponentType::UNSIGNED_INT;
+        default: throw std::runtime_error("Unhandled component type: " + std::to_string(t_component_type) + '.');
+    }
+}
+
+/**
+ * @brief Decodes the percent encoded characters of a uri.
+ */
+static std::string decode_uri(const std::string& uri) {
+    std::string decoded;
+    decoded.reserve(uri.size());
+
+    for(size_t i = 0 ; i < uri.size() ; ++i) {
+        if(uri[i] == '%' && i + 2 < uri.size()
+           && std::isxdigit(static_cast<unsigned char>(uri[i + 1]))
+           && std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+            decoded += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            decoded += uri[i];
+        }
+    }
+
+    return decoded;
+}
+
+void GLTF::Model::load(const std::filesystem::path& path, bool images_as_is) {
+    mapped_files.clear();
+    buffers.clear();
+
+    /* ---- Container ---- */
+    std::span<const unsigned char> file = mapped_files.emplace_back(path).get_data();
+    std::string_view json_text;
+    std::span<const unsigned char> binary_chunk;
+
+    if(path.extension() == ".glb") {
+        read_glb_chunks(file, json_text, binary_chunk);
+    } else {
+        json_text = std::string_view(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+    nlohmann::json json = nlohmann::json::parse(json_text, nullptr, false);
+    if(json.is_discarded()) { throw std::runtime_error("Failed to parse the JSON of GLTF scene '" + path.string() + "'."); }
+
+    /* ---- Buffers ---- */
+    /* The GLB binary chunk and the external .bin files are mapped, and replaced by a 1 byte embedded
+     * buffer in the JSON given to tinygltf so that it doesn't read or copy them. Embedded buffers are
+     * left to tinygltf. */
+    static const nlohmann::json PLACEHOLDER_BUFFER {
+        { "byteLength", 1 },
+        { "uri", "data:application/octet-stream;base64,AA==" }
+    };
+
+    if(json.contains("buffers")) {
+        for(nlohmann::json& t_buffer : json["buffers"]) {
+            size_t byte_length = t_buffer.value("byteLength", size_t(0));
+            std::string uri = t_buffer.value("uri", "");
+
+            if(uri.starts_with("data:")) {
+                buffers.emplace_back(std::span<const unsigned char>(), false);
+                continue;
+            }
+
+            std::span<const unsigned char> data = uri.empty()
+                                                      ? binary_chunk
+                                                      : mapped_files.emplace_back(path.parent_path() / decode_uri(uri)).get_data();
+            if(data.size() < byte_length) {
+                throw std::runtime_error("Buffer '" + uri + "' of GLTF scene '" + path.string() + "' is too small.");
+            }
+
+            buffers.emplace_back(data.first(byte_length), true);
+            t_buffer = PLACEHOLDER_BUFFER;
+        }
+    }
+
+    /* ---- Images ---- */
+    /* Images in a mapped buffer are given a fake uri, which the file system callbacks below read
+     * from the mapping. */
+    struct MappedImage {
+        std::span<const unsigned char> data;
+        int buffer_view;
+        std::string mime_type;
+    };
+
+    std::unordered_map<std::string, MappedImage> mapped_images;
+
+    if(json.contains("images")) {
+        unsigned int i = 0;
+        for(nlohmann::json& t_image : json["images"]) {
+            if(t_image.contains("bufferView")) {
+                int buffer_view = t_image["bufferView"];
+                const nlohmann::json& t_buffer_view = json["bufferViews"].at(buffer_view);
+                const BufferData& buffer = buffers.at(t_buffer_view["buffer"].get<size_t>());
+
+                if(buffer.is_mapped) {
+                    std::string uri = "__mapped_image_" + std::to_string(i);
+                    mapped_images.emplace(uri, MappedImage(buffer.data.subspan(t_buffer_view.value("byteOffset", size_t(0)),
+                                                                               t_buffer_view["byteLength"].get<size_t>()),
+                                                           buffer_view,
+                                                           t_image.value("mimeType", "")));
+
+                    t_image.erase("bufferView");
+                    t_image["uri"] = uri;
+                }
+            }
+
+            ++i;
+        }
+    }
+
+    auto find_mapped_image = [&mapped_images](const std::string& file_path) {
+        auto iterator = mapped_images.find(std::filesystem::path(file_path).filename().string());
+        return iterator == mapped_images.end() ? nullptr : &iterator->second;
+    };
+
+    tinygltf::FsCallbacks callbacks {
+        .FileExists = [&](const std::string& file_path, void*) {
+            return find_mapped_image(file_path) != nullptr || tinygltf::FileExists(file_path, nullptr);
+        },
+        .ExpandFilePath = &tinygltf::ExpandFilePath,
+        .ReadWholeFile = [&](std::vector<unsigned char>* out, std::string* error, const std::string& file_path, void*) {
+            const MappedImage* mapped_image = find_mapped_image(file_path);
+            if(mapped_image == nullptr) { return tinygltf::ReadWholeFile(out, error, file_path, nullptr); }
+
+            out->assign(mapped_image->data.begin(), mapped_image->data.end());
+            return true;
+        },
+        .WriteWholeFile = &tinygltf::WriteWholeFile,
+        .GetFileSizeInBytes = [&](size_t* size, std::string* error, const std::string& file_path, void*) {
+            const MappedImage* mapped_image = find_mapped_image(file_path);
+            if(mapped_image == nullptr) { return tinygltf::GetFileSizeInBytes(size, error, file_path, nullptr); }
+
+            *size = mapped_image->data.size();
+            return true;
+        },
+        .user_data = nullptr
+    };
+
+    /* ---- TinyGLTF Load Model ---- */
+    tinygltf::TinyGLTF loader;
+    loader.SetPreserveImageChannels(true);
+    loader.SetImagesAsIs(images_as_is);
+    loader.SetFsCallbacks(callbacks);
+
+    std::string error;
+    std::string warning;
+
+    std::string json_string = json.dump();
+    bool success = loader.LoadASCIIFromString(&t_model,
+                                              &error,
+                                              &warning,
+                                              json_string.data(),
+                                              json_string.size(),
+                                              path.parent_path().string());
+
+    if(!warning.empty()) { std::cerr << "Warning loading GLTF scene: " << warning << '\n'; }
+    if(!error.empty()) { std::cerr << "Error loading GLTF scene: " << error << '\n'; }
+    if(!success) { throw std::runtime_error("Failed to load GLTF scene from file '" + path.string() + "'."); }
+
+    /* The embedded buffers are read from the model and the placeholders are emptied. */
+    for(unsigned int i = 0 ; i < buffers.size() ; ++i) {
+        if(buffers[i].is_mapped) {
+            t_model.buffers[i].data.clear();
+        } else {
+            buffers[i].data = t_model.buffers[i].data;
+        }
+    }
+
+    /* The images in mapped buffers are restored so that they are identified by their content. */
+    for(unsigned int i = 0 ; i < t_model.images.size() ; ++i) {
+        auto iterator = mapped_images.find(t_model.images[i].uri);
+        if(iterator != mapped_images.end()) {
+            t_model.images[i].uri.clear();
+            t_model.images[i].bufferView = iterator->second.buffer_view;
+            t_model.images[i].mimeType = iterator->second.mime_type;
+        }
+    }
+
+    std::cout << "Loading GLTF scene: " << path << ".\n";
+}
+
+const unsigned char* GLTF::Model::get_accessor_data(const tinygltf::Accessor& t_accessor, size_t element_size) const {
+    return get_buffer_view_data(t_accessor.bufferView, t_accessor.byteOffset, t_accessor.count, element_size);
+}
+
+const unsigned char* GLTF::Model::get_buffer_view_data(int buffer_view_index,
+                                                       size_t byte_offset,
+                                                       size_t count,
+                                                       size_t element_size) const {
+    if(buffer_view_index < 0 || static_cast<size_t>(buffer_view_index) >= t_model.bufferViews.size()) {
+        throw std::runtime_error("Accessor without a valid buffer view.");
+    }
+
+    const tinygltf::BufferView& t_buffer_view = t_model.bufferViews[buffer_view_index];
+    if(t_buffer_view.buffer < 0 || static_cast<size_t>(t_buffer_view.buffer) >= buffers.size()) {
+        throw std::runtime_error("Buffer view without a valid buffer.");
+    }
+
+    std::span<const unsigned char> data = buffers[t_buffer_view.buffer].data;
+    size_t stride = t_buffer_view.byteStride == 0 ? element_size : t_buffer_view.byteStride;
+    byte_offset += t_buffer_view.byteOffset;
+    size_t byte_end = count == 0 ? byte_offset : byte_offset + (count - 1) * stride + element_size;
+
+    if(byte_end > t_buffer_view.byteOffset + t_buffer_view.byteLength || byte_end > data.size()) {
+        throw std::runtime_error("Accessor out of the bounds of its buffer.");
+    }
+
+    return data.data() + byte_offset;
+}
+
+std::vector<float> GLTF::Model::read_accessor(const tinygltf::Accessor& t_accessor) const {
+    const int components_count = tinygltf::GetNumComponentsInType(t_accessor.type);
+    if(components_count <= 0) {
+        throw std::runtime_error("Unknown accessor type: " + std::to_string(t_accessor.type) + '.');
+    }
+
+    const ComponentType component_type = get_component_type(t_accessor.componentType);
+    const size_t component_size = get_component_type_size(component_type);
+    const size_t element_size = components_count * component_size;
+
+    std::vector<float> values(t_accessor.count * components_count, 0.0f);
+
+    if(t_accessor.bufferView != -1) {
+        const unsigned char* data = get_accessor_data(t_accessor, element_size);
+
+        const tinygltf::BufferView& t_buffer_view = t_model.bufferViews[t_accessor.bufferView];
+        const size_t stride = t_buffer_view.byteStride == 0 ? element_size : t_buffer_view.byteStride;
+
+        for(size_t i = 0 ; i < t_accessor.count ; ++i) {
+            for(int j = 0 ; j < components_count ; ++j) {
+                values[i * components_count + j] = read_component(data + i * stride + j * component_size,
+                                                                  component_type,
+                                                                  t_accessor.normalized);
+            }
+        }
+    }
+
+    /* Sparse accessors replace some of the elements, their indices and values are tightly packed. */
+    if(t_accessor.sparse.isSparse) {
+        const tinygltf::Accessor::Sparse& t_sparse = t_accessor.sparse;
+        const ComponentType index_type = get_component_type(t_sparse.indices.componentType);
+        const size_t index_size = get_component_type_size(index_type);
+
+        const unsigned char* indices = get_buffer_view_data(t_sparse.indices.bufferView,
+                                                            t_sparse.indices.byteOffset,
+                                                            t_sparse.count,
+                                                            index_size);
+        const unsigned char* sparse_values = get_buffer_view_data(t_sparse.values.bufferView,
+                                                                  t_sparse.values.byteOffset,
+                                                                  t_sparse.count,
+                                                                  element_size);
+
+        for(int i = 0 ; i < t_sparse.count ; ++i) {
+            unsigned int index = read_unsigned_component(indices + i * index_size, index_type);
+            if(index >= t_accessor.count) { throw std::runtime_error("Sparse accessor index out of bounds."); }
+
+            for(int j = 0 ; j < components_count ; ++j) {
+                values[index * components_count + j] = read_component(sparse_values + i * element_size + j * component_size,
+                                                                      component_type,
+                                                                      t_accessor.normalized);
+            }
+        }
+    }
+
+    return values;
+}
+
+std::vector<unsigned int> GLTF::Model::read_index_accessor(const tinygltf::Accessor& t_accessor) const {
+    const ComponentType index_type = get_component_type(t_accessor.componentType);
+    if(index_type != ComponentType::UNSIGNED_BYTE
+       && index_type != ComponentType::UNSIGNED_SHORT
+       && index_type != ComponentType::UNSIGNED_INT) {
+        throw std::runtime_error("Wrong or unknown component type in indices accessor.");
+    }
+
+    const size_t index_size = get_component_type_size(index_type);
+    std::vector<unsigned int> indices(t_accessor.count, 0);
+
+    if(t_accessor.bufferView != -1) {
+        const unsigned char* data = get_accessor_data(t_accessor, index_size);
+        for(size_t i = 0 ; i < t_accessor.count ; ++i) { indices[i] = read_unsigned_component(data + i * index_size, index_type); }
+    }
+
+    if(t_accessor.sparse.isSparse) {
+        const tinygltf::Accessor::Sparse& t_sparse = t_accessor.sparse;
+        const ComponentType sparse_index_type = get_component_type(t_sparse.indices.componentType);
+        const size_t sparse_index_size = get_component_type_size(sparse_index_type);
+
+        const unsigned char* sparse_indices = get_buffer_view_data(t_sparse.indices.bufferView,
+                                                                   t_sparse.indices.byteOffset,
+                                                                   t_sparse.count,
+                                                                   sparse_index_size);
+        const unsigned char* sparse_values = get_buffer_view_data(t_sparse.values.bufferView,
+                                                                  t_sparse.values.byteOffset,
+                                                                  t_sparse.count,
+                                                                  index_size);
+
+        for(int i = 0 ; i < t_sparse.count ; ++i) {
+            unsigned int index = read_unsigned_component(sparse_indices + i * sparse_index_size, sparse_index_type);
+            if(index >= t_accessor.count) { throw std::runtime_error("Sparse accessor index out of bounds."); }
+
+            indices[index] = read_unsigned_component(sparse_values + i * index_size, index_type);
+        }
+    }
+
+    return indices;
+}
+
+void GLTF::Model::create_meshes() {
+    /* ---- Materials ---- */
+    materials.clear();
+    materials.reserve(t_model.materials.size());
+
+    for(const tinygltf::Material& t_material : t_model.materials) {
+        const tinygltf::PbrMetallicRoughness& t_pbr = t_material.pbrMetallicRoughness;
+        materials.emplace_back(t_material.name,
+                               vec4(t_pbr.baseColorFactor[0], t_pbr.baseColorFactor[1], t_pbr.baseColorFactor[2], t_pbr.baseColorFactor[3]),
+                               t_pbr.metallicFactor,
+                               t_pbr.roughnessFactor,
+                               t_pbr.baseColorTexture.index,
+                               t_pbr.metallicRoughnessTexture.index,
+                               t_material.normalTexture.index);
+    }
+
+    /* ---- Meshes ---- */
+    size_t meshes_count = t_model.meshes.size();
+    meshes.resize(meshes_count);
+
+    for(unsigned int i = 0 ; i < meshes_count ; ++i) {
+        tinygltf::Mesh& t_mesh = t_model.meshes[i];
+        Mesh& mesh = meshes[i];
+
+        mesh.name = t_mesh.name.empty() ? "Mesh " + std::to_string(i) : t_mesh.name;
+
+        size_t primitives_count = t_mesh.primitives.size();
+        mesh.primitives.resize(primitives_count);
+
+        for(unsigned int j = 0 ; j < primitives_count ; ++j) {
+            const tinygltf::Primitive& t_primitive = t_mesh.primitives[j];
+            Primitive& primitive = mesh.primitives[j];
+
+            primitive.material = t_primitive.material;
+
+            switch(t_primitive.mode) {
+                case TINYGLTF_MODE_POINTS:
+                    primitive.primitive.set_primitive(MeshPrimitive::POINTS);
+                    break;
+                case TINYGLTF_MODE_LINE:
+                    primitive.primitive.set_primitive(MeshPrimitive::LINES);
+                    break;
+                case TINYGLTF_MODE_LINE_LOOP:
+                    primitive.primitive.set_primitive(MeshPrimitive::LINE_LOOP);
+                    break;
+                case TINYGLTF_MODE_LINE_STRIP:
+                    primitive.primitive.set_primitive(MeshPrimitive::LINE_STRIP);
+                    break;
+                case TINYGLTF_MODE_TRIANGLES:
+                    primitive.primitive.set_primitive(MeshPrimitive::TRIANGLES);
+                    break;
+                case TINYGLTF_MODE_TRIANGLE_STRIP:
+                    primitive.primitive.set_primitive(MeshPrimitive::TRIANGLE_STRIP);
+                    break;
+                case TINYGLTF_MODE_TRIANGLE_FAN:
+                    primitive.primitive.set_primitive(MeshPrimitive::TRIANGLE_FAN);
+                    break;
+                default:
+                    throw std::runtime_error("Unknown primitive mode: " + std::to_string(t_primitive.mode) + '.');
+            }
+
+            static const std::map<std::string, Attribute> GLTF_STRING_TO_ATTR {
+                { "POSITION", ATTRIBUTE_POSITION },
+                { "NORMAL", ATTRIBUTE_NORMAL },
+                { "TEXCOORD_0", ATTRIBUTE_TEX_COORDS },
+                { "COLOR_0", ATTRIBUTE_COLOR },
+                { "TANGENT", ATTRIBUTE_TANGENT },
+                { "JOINTS_0", ATTRIBUTE_JOINTS },
+                { "WEIGHTS_0", ATTRIBUTE_WEIGHTS },
+            };
+
+            std::vector<AttributeInfo> attribute_infos;
+            std::vector<std::vector<float>> read_attributes; // The attributes that can't be read in place.
+            size_t vertex_count = 0;
+
+            for(const auto& [attribute_name, accessor_index] : t_primitive.attributes) {
+                const tinygltf::Accessor& t_accessor = t_model.accessors[accessor_index];
+
+                auto iterator = GLTF_STRING_TO_ATTR.find(attribute_name);
+                if(iterator == GLTF_STRING_TO_ATTR.end()) {
+                    std::cout << "\tUnhandled attribute: " << attribute_name << '\n';
+                } else {
+                    Attribute attribute = iterator->second;
+                    AttributeType attribute_type;
+                    switch(t_accessor.type) {
+                        case TINYGLTF_TYPE_VEC2:
+                            attribute_type = AttributeType::VEC2;
+                            break;
+                        case TINYGLTF_TYPE_VEC3:
+                            attribute_type = AttributeType::VEC3;
+                            break;
+                        case TINYGLTF_TYPE_VEC4:
+                            attribute_type = AttributeType::VEC4;
+                            break;
+                        case TINYGLTF_TYPE_MAT2:
+                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT2.");
+                        case TINYGLTF_TYPE_MAT3:
+                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT3.");
+                        case TINYGLTF_TYPE_MAT4:
+                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MAT4.");
+                        case TINYGLTF_TYPE_SCALAR:
+                            attribute_type = AttributeType::FLOAT;
+                            break;
+                        case TINYGLTF_TYPE_VECTOR:
+                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_VECTOR.");
+                        case TINYGLTF_TYPE_MATRIX:
+                            throw std::runtime_error("Unhandled attribute type: TINYGLTF_TYPE_MATRIX.");
+                        default:
+                            throw std::runtime_error(
+                                "Unknown attribute type: " + std::to_string(t_accessor.type) + '.');
+                    }
+
+                    /* Integer attributes, from KHR_mesh_quantization for example, keep their type
+                     * and are converted by OpenGL. Accessors without a buffer view, which are zeros,
+                     * and sparse accessors are read as floats and copied into the vertices. */
+                    ComponentType component_type = get_component_type(t_accessor.componentType);
+                    bool is_normalized = t_accessor.normalized;
+                    if(t_accessor.bufferView == -1 || t_accessor.sparse.isSparse) {
+                        const std::vector<float>& values = read_attributes.emplace_back(read_accessor(t_accessor));
+                        component_type = ComponentType::FLOAT;
+                        is_normalized = false;
+
+                        unsigned int size = get_attribute_type_count(attribute_type) * sizeof(float);
+                        attribute_infos.emplace_back(attribute,
+                                                     reinterpret_cast<const unsigned char*>(values.data()),
+                                                     size,
+                                                     size,
+                                                     get_attribute_size(attribute_type, component_type),
+                                                     false);
+                    } else {
+                        unsigned int size = get_attribute_type_count(attribute_type) * get_component_type_size(component_type);
+                        const unsigned char* data = get_accessor_data(t_accessor, size); // Checks the buffer view.
+                        const tinygltf::BufferView& t_buffer_view = t_model.bufferViews[t_accessor.bufferView];
+
+                        attribute_infos.emplace_back(attribute,
+                                                     data,
+                                                     t_buffer_view.byteStride == 0 ? size : t_buffer_view.byteStride,
+                                                     size,
+                                                     get_attribute_size(attribute_type, component_type),
+                                                     buffers[t_buffer_view.buffer].is_mapped);
+                    }
+
+                    if(vertex_count == 0) {
+                        vertex_count = t_accessor.count;
+                    } else if(vertex_count != t_accessor.count) {
+                        throw std::runtime_error("Not the same amount of values between vertex attributes.");
+                    }
+
+                    primitive.primitive.enable_attribute(attribute, attribute_type, component_type, is_normalized);
+                }
+            }
+
+            std::ranges::sort(attribute_infos, [](const AttributeInfo& a1, const AttributeInfo& a2) {
+                return a1.attribute < a2.attribute;
+            });
+
+            /* If the attributes are mapped and already interleaved like the mesh's vertices, the
+             * mesh uses the mapping directly. Otherwise the vertices are copied. */
+            size_t stride = 0;
+            for(const AttributeInfo& attribute_info : attribute_infos) { stride += attribute_info.padded_size; }
+
+            bool is_layout_matching = !attribute_infos.empty();
+            size_t offset = 0;
+            for(const AttributeInfo& attribute_info : attribute_infos) {
+                is_layout_matching = is_layout_matching
+                                     && attribute_info.is_mapped
+                                     && attribute_info.stride == stride
+                                     && attribute_info.data == attribute_infos.front().data + offset;
+                offset += attribute_info.padded_size;
+            }
+
+            if(is_layout_matching && vertex_count > 0) {
+                primitive.primitive.set_external_data(std::span(attribute_infos.front().data, vertex_count * stride));
+            } else {
+                static constexpr unsigned char PADDING[4] {};
+
+                for(size_t k = 0 ; k < vertex_count ; ++k) {
+                    for(const AttributeInfo& attribute_info : attribute_infos) {
+                        primitive.primitive.push_bytes(attribute_info.data + k * attribute_info.stride, attribute_info.size);
+                        primitive.primitive.push_bytes(PADDING, attribute_info.padded_size - attribute_info.size);
+                    }
+                }
+            }
+
+            if(t_primitive.indices != -1) {
+                const tinygltf::Accessor& t_accessor = t_model.accessors[t_primitive.indices];
+
+                /* Indices without a buffer view, which are zeros, and sparse indices are copied.
+                 * Otherwise 8 bits indices are widened to 16 bits as they are poorly supported by
+                 * GPUs, and the others keep their type. */
+                if(t_accessor.bufferView == -1 || t_accessor.sparse.isSparse) {
+                    bool is_32_bits = t_accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+                    primitive.primitive.set_index_type(is_32_bits ? ComponentType::UNSIGNED_INT : ComponentType::UNSIGNED_SHORT);
+                    for(unsigned int index : read_index_accessor(t_accessor)) { primitive.primitive.add_index(index); }
+                } else {
+                    switch(t_accessor.componentType) {
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
+                            const unsigned char* data = get_accessor_data(t_accessor, sizeof(unsigned char));
+                            primitive.primitive.set_index_type(ComponentType::UNSIGNED_SHORT);
+                            for(size_t k = 0 ; k < t_accessor.count ; ++k) { primitive.primitive.add_index(data[k]); }
+                            break;
+                        }
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT: {
+                            ComponentType index_type = get_component_type(t_accessor.componentType);
+                            size_t index_size = get_component_type_size(index_type);
+                            const unsigned char* data = get_accessor_data(t_accessor, index_size);
+
+                            if(buffers[t_model.bufferViews[t_accessor.bufferView].buffer].is_mapped) {
+                                primitive.primitive.set_external_indices(std::span(data, t_accessor.count * index_size), index_type);
+                            } else {
+                                primitive.primitive.set_index_type(index_type);
+                                for(size_t k = 0 ; k < t_accessor.count ; ++k) {
+                                    primitive.primitive.add_index(read_unsigned_component(data + k * index_size, index_type));
+                                }
+                            }
+                            break;
+                        }
+                        default: throw std::runtime_error("Wrong or unknown component type in indices accessor.");
+                    }
+                }
+
+                if(b_is_stripifying_enabled) { primitive.primitive.stripify(); }
+            }
+
+            /* ---- Morph Targets ---- */
+            for(const std::map<std::string, int>& t_target : t_primitive.targets) {
+                auto read_deltas = [&](const std::string& attribute_name) {
+                    auto iterator = t_target.find(attribute_name);
+                    return iterator == t_target.end() ? std::vector<float>() : read_accessor(t_model.accessors[iterator->second]);
+                };
+
+                primitive.morph_targets.add_target(vertex_count,
+                                                   read_deltas("POSITION"),
+                                                   read_deltas("NORMAL"),
+                                                   read_deltas("TANGENT"));
+            }
+
+            std::vector<float>& default_weights = primitive.morph_targets.default_weights;
+            for(size_t k = 0 ; k < default_weights.size() && k < t_mesh.weights.size() ; ++k) {
+                default_weights[k] = static_cast<float>(t_mesh.weights[k]);
+            }
+
+            primitive.primitive.update_AABB();
+            primitive.content_hash = primitive.primitive.get_content_hash();
+        }
+    }
+}
+
+void GLTF::Model::create_skins_and_animations() {
+    /* ---- Skins ---- */
+    inverse_bind_matrices.resize(t_model.skins.size());
+
+    for(size_t i = 0 ; i < t_model.skins.size() ; ++i) {
+        const tinygltf::Skin& t_skin = t_model.skins[i];
+        std::vector<affine3x4>& matrices = inverse_bind_matrices[i];
+        matrices.assign(t_skin.joints.size(), affine3x4(1.0f));
+
+        if(t_skin.inverseBindMatrices != -1) {
+            std::vector<float> values = read_accessor(t_model.accessors[t_skin.inverseBindMatrices]);
+            if(values.size() < 16 * matrices.size()) {
+                throw std::runtime_error("Skin with fewer inverse bind matrices than joints.");
+            }
+
+            /* glTF matrices are column major, and inverse bind matrices are affine so their last row
+             * is skipped. */
+            for(size_t j = 0 ; j < matrices.size() ; ++j) {
+                for(unsigned int column = 0 ; column < 4 ; ++column) {
+                    for(unsigned int row = 0 ; row < 3 ; ++row) {
+                        matrices[j](row, column) = values[16 * j + 4 * column + row];
+                    }
+                }
+            }
+        }
+    }
+
+    /* ---- Animations ---- */
+    animations.clear();
+    animations.reserve(t_model.animations.size());
+
+    for(const tinygltf::Animation& t_animation : t_model.animations) {
+        Animation& animation = animations.emplace_back();
+        animation.name = t_animation.name.empty() ? "Animation " + std::to_string(animations.size() - 1) : t_animation.name;
+
+        for(const tinygltf::AnimationChannel& t_channel : t_animation.channels) {
+            if(t_channel.target_node == -1) { continue; }
+
+            AnimationChannel channel;
+            channel.node = t_channel.target_node;
+
+            if(t_channel.target_path == "translation") {
+                channel.path = AnimationPath::TRANSLATION;
+            } else if(t_channel.target_path == "rotation") {
+                channel.path = AnimationPath::ROTATION;
+            } else if(t_channel.target_path == "scale") {
+                channel.path = AnimationPath::SCALE;
+            } else if(t_channel.target_path == "weights") {
+                const tinygltf::Node& t_node = t_model.nodes[t_channel.target_node];
+                if(t_node.mesh == -1 || t_model.meshes[t_node.mesh].primitives.empty()) { continue; }
+
+                channel.path = AnimationPath::WEIGHTS;
+                channel.weights_count = t_model.meshes[t_node.mesh].primitives[0].targets.size();
+            } else {
+                std::cout << "\tUnhandled animation path: " << t_channel.target_path << '\n';
+                continue;
+            }
+
+            const tinygltf::AnimationSampler& t_sampler = t_animation.samplers[t_channel.sampler];
+            if(t_sampler.interpolation == "STEP") {
+                channel.interpolation = AnimationInterpolation::STEP;
+            } else if(t_sampler.interpolation == "CUBICSPLINE") {
+                channel.interpolation = AnimationInterpolation::CUBIC_SPLINE;
+            } else {
+                channel.interpolation = AnimationInterpolation::LINEAR;
+            }
+
+            channel.times = read_accessor(t_model.accessors[t_sampler.input]);
+            channel.values = read_accessor(t_model.accessors[t_sampler.output]);
+
+            size_t keyframe_size = channel.get_components_count();
+            if(channel.interpolation == AnimationInterpolation::CUBIC_SPLINE) { keyframe_size *= 3; }
+            if(channel.values.size() < channel.times.size() * keyframe_size) {
+                throw std::runtime_error("Animation sampler with fewer values than keyframes.");
+            }
+
+            if(!channel.times.empty()) { animation.duration = std::max(animation.duration, channel.times.back()); }
+            animation.tracks.push_back(AnimationTrack::compress(channel));
+        }
+    }
+}
+
+void GLTF::Model::release_source() {
+    t_model = tinygltf::Model();
+    buffers.clear();
+}
+
+void GLTF::Model::set_stripifying_enabled(bool is_enabled) {
+    b_is_stripifying_enabled = is_enabled;
+}
+
+bool GLTF::Model::is_stripifying_enabled() {
+    return b_is_stripifying_enabled;
+}
@@ -7,11 +7,10 @@
 
 #include <iostream>
 
-#include "glad/glad.h"
 #include "stb_image.h"
 
 Image::Image(const std::filesystem::path& path, bool flip_vertically) {
-    stbi_set_flip_vertically_on_load(flip_vertically);
+    stbi_set_flip_vertically_on_load_thread(flip_vertically);
 
     int w, h, c;
     data = stbi_load(path.string().c_str(), &w, &h, &c, 0);
@@ -22,6 +21,36 @@ Image::Image(const std::filesystem::path& path, bool flip_vertically) {
     channels_amount = c;
 }
 
+Image::Image(const unsigned char* encoded_data, size_t size, bool flip_vertically) {
+    stbi_set_flip_vertically_on_load_thread(flip_vertically);
+
+    int w, h, c;
+    data = stbi_load_from_memory(encoded_data, static_cast<int>(size), &w, &h, &c, 0);
+    if(data == nullptr) { throw std::runtime_error("Couldn't decode image from memory"); }
+
+    width = w;
+    height = h;
+    channels_amount = c;
+}
+
+Image::Image(Image&& image) noexcept
+    : data(image.data), width(image.width), height(image.height), channels_amount(image.channels_amount) {
+    image.data = nullptr;
+}
+
+Image& Image::operator=(Image&& image) noexcept {
+    if(this != &image) {
+        stbi_image_free(data);
+        data = image.data;
+        width = image.width;
+        height = image.height;
+        channels_amount = image.channels_amount;
+        image.data = nullptr;
+    }
+
+    return *this;
+}
+
 Image::~Image() {
     stbi_image_free(data);
 }
@@ -41,3 +70,7 @@ unsigned int Image::get_height() const {
 unsigned int Image::get_channels_amount() const {
     return channels_amount;
 }
+
+size_t Image::get_size() const {
+    return static_cast<size_t>(width) * height * channels_amount;
+}
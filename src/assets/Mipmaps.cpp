@@ -0,0 +1,271 @@
+/***************************************************************************************************
+ * @file  Mipmaps.cpp
+ * @brief Implementation of functions to generate mip chains on the CPU
+ **************************************************************************************************/
+
+#include "assets/Mipmaps.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#include "maths/constants.hpp"
+
+static constexpr unsigned int LINEAR_TO_SRGB_TABLE_SIZE = 16384;
+
+/**
+ * @brief The filter's weights for every pixel of a destination row or column.
+ */
+struct FilterWeights {
+    std::vector<unsigned int> offsets; ///< Where each destination pixel's weights start, plus the end.
+    std::vector<unsigned int> indices; ///< The index of the source pixel of each weight.
+    std::vector<float> weights;        ///< The normalized weights.
+};
+
+static float srgb_to_linear(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static float sinc(float x) {
+    if(x == 0.0f) { return 1.0f; }
+    return std::sin(PI_F * x) / (PI_F * x);
+}
+
+/**
+ * @brief Zeroth order modified Bessel function of the first kind, used by the Kaiser window.
+ */
+static float bessel_i0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float half_x_squared = 0.25f * x * x;
+
+    for(unsigned int k = 1 ; term > sum * 1e-8f ; ++k) {
+        term *= half_x_squared / static_cast<float>(k * k);
+        sum += term;
+    }
+
+    return sum;
+}
+
+/**
+ * @return The radius of a filter in destination pixels.
+ */
+static float get_filter_support(MipmapFilter filter) {
+    return filter == MipmapFilter::BOX ? 0.5f : 3.0f;
+}
+
+/**
+ * @brief Evaluates a filter.
+ * @param filter The filter.
+ * @param x The distance to the center of the destination pixel, in destination pixels.
+ * @return The filter's unnormalized weight.
+ */
+static float evaluate_filter(MipmapFilter filter, float x) {
+    static constexpr float KAISER_ALPHA = 4.0f;
+    static const float KAISER_NORMALIZATION = 1.0f / bessel_i0(KAISER_ALPHA);
+
+    float support = get_filter_support(filter);
+    if(std::abs(x) > support) { return 0.0f; }
+
+    switch(filter) {
+        case MipmapFilter::BOX:
+            return 1.0f;
+        case MipmapFilter::KAISER: {
+            float t = x / support;
+            return sinc(x) * bessel_i0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) * KAISER_NORMALIZATION;
+        }
+        case MipmapFilter::LANCZOS:
+            return sinc(x) * sinc(x / support);
+        default: return 0.0f;
+    }
+}
+
+/**
+ * @brief Computes the weights to downsample a row or a column. The pixels outside of the image are
+ * clamped to the edge.
+ */
+static FilterWeights compute_filter_weights(MipmapFilter filter, unsigned int source_size, unsigned int destination_size) {
+    FilterWeights filter_weights;
+
+    float scale = static_cast<float>(source_size) / static_cast<float>(destination_size);
+    float support = get_filter_support(filter) * scale;
+
+    for(unsigned int i = 0 ; i < destination_size ; ++i) {
+        filter_weights.offsets.push_back(filter_weights.weights.size());
+
+        float center = (static_cast<float>(i) + 0.5f) * scale;
+        int first = static_cast<int>(std::floor(center - support));
+        int last = static_cast<int>(std::ceil(center + support));
+
+        float sum = 0.0f;
+        for(int j = first ; j <= last ; ++j) {
+            float weight = evaluate_filter(filter, (static_cast<float>(j) + 0.5f - center) / scale);
+            if(weight == 0.0f) { continue; }
+
+            filter_weights.indices.push_back(std::clamp(j, 0, static_cast<int>(source_size) - 1));
+            filter_weights.weights.push_back(weight);
+            sum += weight;
+        }
+
+        for(size_t k = filter_weights.offsets.back() ; k < filter_weights.weights.size() ; ++k) {
+            filter_weights.weights[k] /= sum;
+        }
+    }
+
+    filter_weights.offsets.push_back(filter_weights.weights.size());
+
+    return filter_weights;
+}
+
+/**
+ * @brief Computes the weighted sum of RGBA pixels.
+ * @param source The first source pixel.
+ * @param stride The distance between two source pixels in floats.
+ * @param filter_weights The filter's weights.
+ * @param index The index of the destination pixel in the row or column.
+ * @param destination Where to write the RGBA result.
+ */
+static void filter_pixel(const float* source,
+                         size_t stride,
+                         const FilterWeights& filter_weights,
+                         unsigned int index,
+                         float* destination) {
+    unsigned int begin = filter_weights.offsets[index];
+    unsigned int end = filter_weights.offsets[index + 1];
+
+#ifdef __SSE__
+    __m128 sum = _mm_setzero_ps();
+    for(unsigned int k = begin ; k < end ; ++k) {
+        __m128 pixel = _mm_loadu_ps(source + filter_weights.indices[k] * stride);
+        sum = _mm_add_ps(sum, _mm_mul_ps(pixel, _mm_set1_ps(filter_weights.weights[k])));
+    }
+    _mm_storeu_ps(destination, sum);
+#else
+    float sum[4] { 0.0f, 0.0f, 0.0f, 0.0f };
+    for(unsigned int k = begin ; k < end ; ++k) {
+        const float* pixel = source + filter_weights.indices[k] * stride;
+        for(unsigned int c = 0 ; c < 4 ; ++c) { sum[c] += pixel[c] * filter_weights.weights[k]; }
+    }
+    std::copy_n(sum, 4, destination);
+#endif
+}
+
+/**
+ * @brief Splits rows between threads.
+ * @param rows_count The amount of rows.
+ * @param threads_count The amount of threads.
+ * @param function The function called with the first and past-the-last rows of each thread.
+ */
+static void parallel_for_rows(unsigned int rows_count,
+                              unsigned int threads_count,
+                              const std::function<void(unsigned int, unsigned int)>& function) {
+    threads_count = std::clamp(threads_count, 1u, rows_count);
+    if(threads_count == 1) {
+        function(0, rows_count);
+        return;
+    }
+
+    std::vector<std::jthread> threads;
+    unsigned int rows_per_thread = (rows_count + threads_count - 1) / threads_count;
+
+    for(unsigned int begin = 0 ; begin < rows_count ; begin += rows_per_thread) {
+        threads.emplace_back(function, begin, std::min(begin + rows_per_thread, rows_count));
+    }
+}
+
+std::vector<MipLevel> generate_mipmaps(const unsigned char* pixels,
+                                       unsigned int width,
+                                       unsigned int height,
+                                       MipmapFilter filter,
+                                       bool srgb,
+                                       unsigned int threads_count) {
+    static const std::array<float, 256> SRGB_TO_LINEAR = [] {
+        std::array<float, 256> table;
+        for(unsigned int i = 0 ; i < 256 ; ++i) { table[i] = srgb_to_linear(static_cast<float>(i) / 255.0f); }
+        return table;
+    }();
+
+    static const std::array<unsigned char, LINEAR_TO_SRGB_TABLE_SIZE> LINEAR_TO_SRGB = [] {
+        std::array<unsigned char, LINEAR_TO_SRGB_TABLE_SIZE> table;
+        for(unsigned int i = 0 ; i < LINEAR_TO_SRGB_TABLE_SIZE ; ++i) {
+            float value = linear_to_srgb(static_cast<float>(i) / (LINEAR_TO_SRGB_TABLE_SIZE - 1));
+            table[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+        }
+        return table;
+    }();
+
+    if(threads_count == 0) { threads_count = std::max(1u, std::thread::hardware_concurrency()); }
+
+    std::vector<MipLevel> levels;
+    levels.emplace_back(width, height, std::vector(pixels, pixels + 4 * static_cast<size_t>(width) * height));
+
+    /* ---- Conversion to linear floats ---- */
+    std::vector<float> current(4 * static_cast<size_t>(width) * height);
+    for(size_t i = 0 ; i < current.size() ; ++i) {
+        bool is_color = srgb && i % 4 != 3;
+        current[i] = is_color ? SRGB_TO_LINEAR[pixels[i]] : static_cast<float>(pixels[i]) / 255.0f;
+    }
+
+    while(width > 1 || height > 1) {
+        unsigned int next_width = std::max(1u, width / 2);
+        unsigned int next_height = std::max(1u, height / 2);
+
+        FilterWeights horizontal_weights = compute_filter_weights(filter, width, next_width);
+        FilterWeights vertical_weights = compute_filter_weights(filter, height, next_height);
+
+        /* ---- Separable filtering ---- */
+        std::vector<float> horizontal(4 * static_cast<size_t>(next_width) * height);
+        parallel_for_rows(height, threads_count, [&](unsigned int begin, unsigned int end) {
+            for(unsigned int y = begin ; y < end ; ++y) {
+                for(unsigned int x = 0 ; x < next_width ; ++x) {
+                    filter_pixel(current.data() + 4 * static_cast<size_t>(y) * width,
+                                 4,
+                                 horizontal_weights,
+                                 x,
+                                 horizontal.data() + 4 * (static_cast<size_t>(y) * next_width + x));
+                }
+            }
+        });
+
+        std::vector<float> next(4 * static_cast<size_t>(next_width) * next_height);
+        parallel_for_rows(next_height, threads_count, [&](unsigned int begin, unsigned int end) {
+            for(unsigned int y = begin ; y < end ; ++y) {
+                for(unsigned int x = 0 ; x < next_width ; ++x) {
+                    filter_pixel(horizontal.data() + 4 * x,
+                                 4 * static_cast<size_t>(next_width),
+                                 vertical_weights,
+                                 y,
+                                 next.data() + 4 * (static_cast<size_t>(y) * next_width + x));
+                }
+            }
+        });
+
+        /* ---- Conversion back to unsigned bytes ---- */
+        MipLevel& level = levels.emplace_back(next_width, next_height, std::vector<unsigned char>(next.size()));
+        for(size_t i = 0 ; i < next.size() ; ++i) {
+            float value = std::clamp(next[i], 0.0f, 1.0f);
+
+            if(srgb && i % 4 != 3) {
+                level.pixels[i] = LINEAR_TO_SRGB[static_cast<unsigned int>(value * (LINEAR_TO_SRGB_TABLE_SIZE - 1) + 0.5f)];
+            } else {
+                level.pixels[i] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+        }
+
+        current = std::move(next);
+        width = next_width;
+        height = next_height;
+    }
+
+    return levels;
+}
@@ -5,9 +5,18 @@
 
 #include "assets/Texture.hpp"
 
-#include "assets/AssetManager.hpp"
+#include "assets/TextureResidencyManager.hpp"
+#include "assets/VirtualTextureSystem.hpp"
 #include "glad/glad.h"
 
+/* From the EXT_texture_compression_s3tc and EXT_texture_sRGB extensions, which glad doesn't load. */
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
 /**
  * @brief Returns the internal_format and format corresponding to a specific amount of channels.
  * @param channels_amount The amount of channels.
@@ -40,13 +49,95 @@ static void get_formats_from_channels_amount(unsigned int channels_amount,
     }
 }
 
-Texture::Texture() : id(0), b_has_transparency(false) { }
+/**
+ * @brief Returns the size of a pixel in bytes.
+ * @param format The pixel data's format.
+ * @param type The pixel data's type.
+ */
+static unsigned int get_bytes_per_pixel(unsigned int format, unsigned int type) {
+    unsigned int channels_amount;
+    switch(format) {
+        case GL_RED:
+        case GL_RED_INTEGER:
+            channels_amount = 1;
+            break;
+        case GL_RG:
+        case GL_RG_INTEGER:
+            channels_amount = 2;
+            break;
+        case GL_RGB:
+        case GL_BGR:
+        case GL_RGB_INTEGER:
+            channels_amount = 3;
+            break;
+        default:
+            channels_amount = 4;
+            break;
+    }
+
+    switch(type) {
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+            return 4 * channels_amount;
+        case GL_HALF_FLOAT:
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+            return 2 * channels_amount;
+        default: return channels_amount;
+    }
+}
+
+/**
+ * @brief Returns the internal format corresponding to a compression format.
+ * @param format The compression format.
+ * @param srgb Whether the internal format should be SRGB. Only used by BC1 and BC3.
+ */
+static unsigned int get_compressed_internal_format(CompressionFormat format, bool srgb) {
+    switch(format) {
+        case CompressionFormat::BC1:
+            return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case CompressionFormat::BC3:
+            return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case CompressionFormat::BC4:
+            return GL_COMPRESSED_RED_RGTC1;
+        case CompressionFormat::BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        default: throw std::runtime_error("Unknown compression format.");
+    }
+}
+
+/**
+ * @brief Uploads the levels of a compressed image to the bound texture.
+ * @param image The compressed image.
+ * @param srgb Whether the internal format should be SRGB.
+ * @param data The blocks of all the levels, or an offset in the bound pixel unpack buffer.
+ * @param first_level The level of the image that becomes the texture's first level.
+ */
+static void upload_compressed_levels(const CompressedImage& image,
+                                     bool srgb,
+                                     const unsigned char* data,
+                                     unsigned int first_level) {
+    unsigned int internal_format = get_compressed_internal_format(image.get_format(), srgb);
+
+    const std::vector<CompressedImage::Level>& levels = image.get_levels();
+    for(unsigned int i = first_level ; i < levels.size() ; ++i) {
+        const void* level_data = reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(data) + levels[i].offset);
+        glCompressedTexImage2D(GL_TEXTURE_2D, i - first_level, internal_format, levels[i].width, levels[i].height, 0,
+                               static_cast<int>(levels[i].size), level_data);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(levels.size() - first_level) - 1);
+}
+
+Texture::Texture() : id(0), b_has_transparency(false), virtual_texture_index(~0u) { }
 
-Texture::Texture(const Texture& texture) : id(texture.id), b_has_transparency(texture.has_transparency()) { }
+Texture::Texture(const Texture& texture)
+    : id(texture.id), b_has_transparency(texture.has_transparency()), virtual_texture_index(texture.virtual_texture_index) { }
 
 Texture& Texture::operator=(const Texture& texture) {
     id = texture.id;
     b_has_transparency = texture.b_has_transparency;
+    virtual_texture_index = texture.virtual_texture_index;
     return *this;
 }
 
@@ -56,6 +147,7 @@ void Texture::init() {
 
 void Texture::free() {
     if(id == 0) { return; }
+    TextureResidencyManager::remove(id);
     glDeleteTextures(1, &id);
     id = 0;
 }
@@ -72,18 +164,51 @@ void Texture::create(unsigned int internal_format,
     glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, data);
     glGenerateMipmap(GL_TEXTURE_2D);
 
+    // The mip chain adds a third of the first level's size.
+    size_t first_level_size = static_cast<size_t>(width) * height * get_bytes_per_pixel(format, type);
+    TextureResidencyManager::add(id, first_level_size + first_level_size / 3);
+
     b_has_transparency = format == GL_RGBA
                          || format == GL_BGRA
                          || format == GL_RGBA_INTEGER
                          || format == GL_BGRA_INTEGER;
 }
 
-void Texture::create(const Image& image, bool srgb) {
+void Texture::create(unsigned int width, unsigned int height, unsigned int channels_amount, bool srgb, const void* data) {
     unsigned int internal_format;
     unsigned int format;
-    get_formats_from_channels_amount(image.get_channels_amount(), srgb, internal_format, format);
+    get_formats_from_channels_amount(channels_amount, srgb, internal_format, format);
+
+    create(internal_format, format, GL_UNSIGNED_BYTE, width, height, data);
+}
 
-    create(internal_format, format, GL_UNSIGNED_BYTE, image.get_width(), image.get_height(), image.get_data());
+void Texture::create(const Image& image, bool srgb) {
+    create(image.get_width(), image.get_height(), image.get_channels_amount(), srgb, image.get_data());
+}
+
+void Texture::create(const CompressedImage& image, bool srgb, const unsigned char* data) {
+    init();
+    bind();
+
+    upload_compressed_levels(image, srgb, data, 0);
+    TextureResidencyManager::add(id, image.get_size());
+
+    b_has_transparency = image.has_transparency();
+}
+
+void Texture::replace_levels(unsigned int id, const CompressedImage& image, bool srgb, unsigned int first_level) {
+    glBindTexture(GL_TEXTURE_2D, id);
+
+    /* The levels past the new last level still hold their old data, they are emptied to free it. */
+    int previous_max_level;
+    glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &previous_max_level);
+
+    upload_compressed_levels(image, srgb, image.get_data(), first_level);
+
+    unsigned int internal_format = get_compressed_internal_format(image.get_format(), srgb);
+    for(int level = static_cast<int>(image.get_levels().size() - first_level) ; level <= previous_max_level ; ++level) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, internal_format, 0, 0, 0, 0, nullptr);
+    }
 }
 
 void Texture::create(const std::filesystem::path& path, bool flip_vertically, bool srgb) {
@@ -100,32 +225,33 @@ void Texture::create(unsigned char r, unsigned char g, unsigned char b) {
 }
 
 void Texture::create(const tinygltf::Image& image, const tinygltf::Sampler& sampler, bool srgb) {
-    if(image.uri.empty()) { throw std::runtime_error("Unhandled case: tinygltf::Image without URI."); }
-
-    const Texture* asset_manager_texture = AssetManager::get_texture_ptr(image.uri);
-    if(asset_manager_texture != nullptr) {
-        id = asset_manager_texture->get_id();
-        b_has_transparency = asset_manager_texture->has_transparency();
-        return;
-    }
-
     unsigned int internal_format;
     unsigned int format;
     get_formats_from_channels_amount(image.component, srgb, internal_format, format);
 
     create(internal_format, format, image.pixel_type, image.width, image.height, image.image.data());
+    set_sampler(sampler);
+}
+
+void Texture::create_virtual(CompressedImage&& image) {
+    id = 0;
+    b_has_transparency = image.has_transparency();
+    virtual_texture_index = VirtualTextureSystem::add_texture(std::move(image));
+}
+
+void Texture::set_sampler(const tinygltf::Sampler& sampler) const {
+    bind();
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sampler.wrapS);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, sampler.wrapT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, sampler.minFilter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, sampler.magFilter);
-
-    AssetManager::add_texture(image.uri, *this);
+    if(sampler.minFilter != -1) { glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, sampler.minFilter); }
+    if(sampler.magFilter != -1) { glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, sampler.magFilter); }
 }
 
 void Texture::bind(unsigned int texture_unit) const {
     glActiveTexture(GL_TEXTURE0 + texture_unit);
     glBindTexture(GL_TEXTURE_2D, id);
+    TextureResidencyManager::touch(id);
 }
 
 bool Texture::is_default_texture() const {
@@ -139,3 +265,11 @@ unsigned int Texture::get_id() const {
 bool Texture::has_transparency() const {
     return b_has_transparency;
 }
+
+bool Texture::is_virtual() const {
+    return virtual_texture_index != ~0u;
+}
+
+unsigned int Texture::get_virtual_texture_index() const {
+    return virtual_texture_index;
+}
@@ -0,0 +1,193 @@
+/***************************************************************************************************
+ * @file  TextureResidencyManager.cpp
+ * @brief Implementation of the TextureResidencyManager class
+ **************************************************************************************************/
+
+#include "assets/TextureResidencyManager.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "assets/Texture.hpp"
+#include "assets/TextureStreamer.hpp"
+
+void TextureResidencyManager::add(unsigned int id, size_t size) {
+    TextureResidencyManager& texture_residency_manager = get();
+
+    remove(id);
+    texture_residency_manager.entries.emplace(id, Entry(size, size, texture_residency_manager.frame, {}, false, false, 0, false));
+    texture_residency_manager.usage += size;
+}
+
+void TextureResidencyManager::set_source(unsigned int id, const std::filesystem::path& cache_path, bool srgb) {
+    TextureResidencyManager& texture_residency_manager = get();
+
+    auto iterator = texture_residency_manager.entries.find(id);
+    if(iterator == texture_residency_manager.entries.end()) { return; }
+
+    iterator->second.full_size = iterator->second.size;
+    iterator->second.cache_path = cache_path;
+    iterator->second.srgb = srgb;
+}
+
+void TextureResidencyManager::remove(unsigned int id) {
+    TextureResidencyManager& texture_residency_manager = get();
+
+    auto iterator = texture_residency_manager.entries.find(id);
+    if(iterator == texture_residency_manager.entries.end()) { return; }
+
+    texture_residency_manager.usage -= iterator->second.size;
+    texture_residency_manager.entries.erase(iterator);
+}
+
+void TextureResidencyManager::touch(unsigned int id) {
+    TextureResidencyManager& texture_residency_manager = get();
+
+    auto iterator = texture_residency_manager.entries.find(id);
+    if(iterator != texture_residency_manager.entries.end()) {
+        iterator->second.last_used_frame = texture_residency_manager.frame;
+    }
+}
+
+size_t TextureResidencyManager::get_size(unsigned int id) {
+    TextureResidencyManager& texture_residency_manager = get();
+
+    auto iterator = texture_residency_manager.entries.find(id);
+    return iterator == texture_residency_manager.entries.end() ? 0 : iterator->second.size;
+}
+
+void TextureResidencyManager::update(size_t& upload_budget) {
+    TextureResidencyManager& texture_residency_manager = get();
+    std::unordered_map<unsigned int, Entry>& entries = texture_residency_manager.entries;
+    uint64_t frame = texture_residency_manager.frame++;
+
+    /* ---- Uploads ---- */
+    while(upload_budget > 0) {
+        LoadedImage loaded_image;
+
+        {
+            std::lock_guard lock(texture_residency_manager.mutex);
+            if(texture_residency_manager.loaded_images.empty()) { break; }
+            loaded_image = std::move(texture_residency_manager.loaded_images.front());
+            texture_residency_manager.loaded_images.pop_front();
+        }
+
+        upload_budget -= std::min(upload_budget, texture_residency_manager.upload(loaded_image));
+    }
+
+    /* The usage once the reloads in flight are uploaded, downgraded textures being counted as empty
+     * since their lower levels are only known once they are loaded. */
+    size_t expected_usage = texture_residency_manager.usage;
+    for(const auto& [id, entry] : entries) {
+        if(entry.reload_id == 0) { continue; }
+        expected_usage -= entry.size;
+        if(!entry.is_reload_downgrading) { expected_usage += entry.full_size; }
+    }
+
+    /* ---- Restoring ---- */
+    for(auto& [id, entry] : entries) {
+        if(upload_budget == 0) { break; }
+        if(!entry.is_downgraded || entry.reload_id != 0 || entry.last_used_frame != frame) { continue; }
+
+        size_t usage_after_restoring = expected_usage - entry.size + entry.full_size;
+        if(usage_after_restoring > texture_residency_manager.budget) { continue; }
+
+        texture_residency_manager.queue_reload(id, entry, false);
+        expected_usage = usage_after_restoring;
+    }
+
+    if(expected_usage <= texture_residency_manager.budget) { return; }
+
+    /* ---- Eviction ---- */
+    std::vector<std::pair<uint64_t, unsigned int>> candidates;
+    for(const auto& [id, entry] : entries) {
+        if(!entry.is_downgraded && entry.reload_id == 0 && !entry.cache_path.empty() && entry.last_used_frame < frame) {
+            candidates.emplace_back(entry.last_used_frame, id);
+        }
+    }
+    std::ranges::sort(candidates);
+
+    for(const auto& [last_used_frame, id] : candidates) {
+        if(expected_usage <= texture_residency_manager.budget || upload_budget == 0) { break; }
+
+        Entry& entry = entries[id];
+        texture_residency_manager.queue_reload(id, entry, true);
+        expected_usage -= entry.size;
+    }
+}
+
+void TextureResidencyManager::set_budget(size_t budget) {
+    get().budget = budget;
+}
+
+size_t TextureResidencyManager::get_budget() {
+    return get().budget;
+}
+
+size_t TextureResidencyManager::get_usage() {
+    return get().usage;
+}
+
+size_t TextureResidencyManager::get_evictions_count() {
+    return get().evictions_count;
+}
+
+TextureResidencyManager::TextureResidencyManager()
+    : budget(512 * 1024 * 1024), usage(0), evictions_count(0), frame(0), next_reload_id(1) { }
+
+void TextureResidencyManager::queue_reload(unsigned int id, Entry& entry, bool is_downgraded) {
+    entry.reload_id = next_reload_id++;
+    entry.is_reload_downgrading = is_downgraded;
+
+    TextureStreamer::run_on_worker([id, reload_id = entry.reload_id, cache_path = entry.cache_path, is_downgraded] {
+        std::optional<CompressedImage> image(std::in_place);
+        try {
+            if(!image->load(cache_path)) { image.reset(); }
+        } catch(const std::exception& exception) {
+            std::cerr << "Error reloading texture: " << exception.what() << '\n';
+            image.reset();
+        }
+
+        TextureResidencyManager& texture_residency_manager = get();
+        std::lock_guard lock(texture_residency_manager.mutex);
+        texture_residency_manager.loaded_images.emplace_back(id, reload_id, is_downgraded, std::move(image));
+    });
+}
+
+size_t TextureResidencyManager::upload(LoadedImage& loaded_image) {
+    /* The texture was removed, and its id maybe reused, while its image was being loaded. */
+    auto iterator = entries.find(loaded_image.id);
+    if(iterator == entries.end() || iterator->second.reload_id != loaded_image.reload_id) { return 0; }
+
+    Entry& entry = iterator->second;
+    entry.reload_id = 0;
+
+    if(!loaded_image.image.has_value()) {
+        std::cerr << "Couldn't reload texture from '" << entry.cache_path.string() << "', it won't be downgraded.\n";
+        entry.cache_path.clear();
+        return 0;
+    }
+
+    const CompressedImage& image = *loaded_image.image;
+    const std::vector<CompressedImage::Level>& levels = image.get_levels();
+    unsigned int first_level = 0;
+    if(loaded_image.is_downgraded) {
+        while(first_level + 1 < levels.size()
+              && std::max(levels[first_level].width, levels[first_level].height) > DOWNGRADED_SIZE) {
+            ++first_level;
+        }
+    }
+
+    Texture::replace_levels(loaded_image.id, image, entry.srgb, first_level);
+
+    size_t size = 0;
+    for(unsigned int i = first_level ; i < levels.size() ; ++i) { size += levels[i].size; }
+
+    usage = usage - entry.size + size;
+    entry.size = size;
+    entry.is_downgraded = loaded_image.is_downgraded;
+    if(loaded_image.is_downgraded) { ++evictions_count; }
+
+    return size;
+}
@@ -0,0 +1,320 @@
+/***************************************************************************************************
+ * @file  TextureStreamer.cpp
+ * @brief Implementation of the TextureStreamer class
+ **************************************************************************************************/
+
+#include "assets/TextureStreamer.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#include "assets/AssetManager.hpp"
+#include "assets/TextureResidencyManager.hpp"
+#include "assets/VirtualTextureSystem.hpp"
+#include "engine/Profiler.hpp"
+#include "glad/glad.h"
+#include "utility/hash.hpp"
+
+Handle<Texture> TextureStreamer::request(const std::string& key,
+                                         std::vector<unsigned char>&& encoded_data,
+                                         const tinygltf::Sampler& sampler,
+                                         bool srgb,
+                                         bool is_normal_map,
+                                         const vec3& placeholder_color,
+                                         bool is_virtual) {
+    TextureStreamer& texture_streamer = get();
+
+    /* Everything that changes the compressed image is part of the keys, so that the same image
+     * used with different settings isn't shared. */
+    const unsigned char settings[3] { srgb, is_normal_map, static_cast<unsigned char>(MIPMAP_FILTER) };
+    std::string settings_key = std::to_string(srgb) + std::to_string(is_normal_map)
+                               + std::to_string(static_cast<int>(MIPMAP_FILTER));
+    std::string uri_key = key.empty() ? std::string() : "streamed " + settings_key + ' ' + key;
+
+    if(!uri_key.empty()) {
+        Handle<Texture> texture = texture_streamer.share(uri_key);
+        if(texture.is_valid()) { return texture; }
+    }
+    if(encoded_data.empty()) { throw std::runtime_error("No image data to stream for texture '" + key + "'."); }
+
+    uint64_t hash = hash_xxh64(settings, 3, hash_xxh64(encoded_data.data(), encoded_data.size()));
+    std::string content_key = "content " + hash_to_string(hash);
+
+    Handle<Texture> texture = texture_streamer.share(content_key);
+    if(texture.is_valid()) {
+        if(!uri_key.empty()) {
+            AssetManager::add_texture_alias(uri_key, content_key);
+
+            auto iterator = texture_streamer.keys.find(content_key);
+            if(iterator != texture_streamer.keys.end()) {
+                texture_streamer.keys.insert_or_assign(uri_key, iterator->second);
+                texture_streamer.requests[iterator->second].keys.push_back(uri_key);
+            }
+        }
+        return texture;
+    }
+
+    texture_streamer.start();
+
+    /* The placeholder is in the asset manager right away so that the texture can be referenced
+     * through its handle, its content is replaced once the image is uploaded. */
+    Texture placeholder;
+    placeholder.create(placeholder_color);
+    AssetManager::add_texture(content_key, placeholder);
+    texture = AssetManager::get_texture_handle(content_key);
+
+    unsigned int request_id = texture_streamer.next_request_id++;
+    Request& request = texture_streamer.requests.emplace(request_id,
+                                                         Request({ content_key }, texture, sampler, srgb, is_virtual, 0))
+                                                .first->second;
+    texture_streamer.keys.insert_or_assign(content_key, request_id);
+    if(!uri_key.empty()) {
+        AssetManager::add_texture_alias(uri_key, content_key);
+        request.keys.push_back(uri_key);
+        texture_streamer.keys.insert_or_assign(uri_key, request_id);
+    }
+
+    {
+        std::lock_guard lock(texture_streamer.mutex);
+        texture_streamer.jobs.emplace_back(request_id, std::move(encoded_data), hash, srgb, is_normal_map);
+    }
+
+    texture_streamer.jobs_cv.notify_one();
+
+    return texture;
+}
+
+void TextureStreamer::update(size_t& upload_budget) {
+    Profiler::Zone zone("TextureStreamer::update");
+    TextureStreamer& texture_streamer = get();
+
+    while(upload_budget > 0) {
+        DecodedImage* decoded_image;
+
+        /* Only the main thread pops images and references to the elements of a deque stay valid
+         * when elements are pushed at its back, so the lock isn't needed while uploading. */
+        {
+            std::lock_guard lock(texture_streamer.mutex);
+            if(texture_streamer.decoded_images.empty()) { break; }
+            decoded_image = &texture_streamer.decoded_images.front();
+        }
+
+        auto iterator = texture_streamer.requests.find(decoded_image->request_id);
+        const Request& request = iterator->second;
+
+        /* The image is dropped if all the users of its texture released it while it was decoded. */
+        if(decoded_image->image.has_value() && AssetManager::get_texture_ptr(request.texture) != nullptr) {
+            size_t size = decoded_image->image->get_size();
+            if(!texture_streamer.upload(*decoded_image->image, decoded_image->cache_path, request)) { break; }
+            upload_budget -= std::min(upload_budget, size);
+            texture_streamer.deduplicated_size += size * request.duplicates_count;
+        }
+
+        for(const std::string& key : request.keys) {
+            auto key_iterator = texture_streamer.keys.find(key);
+            if(key_iterator != texture_streamer.keys.end() && key_iterator->second == iterator->first) {
+                texture_streamer.keys.erase(key_iterator);
+            }
+        }
+        texture_streamer.requests.erase(iterator);
+
+        std::lock_guard lock(texture_streamer.mutex);
+        texture_streamer.decoded_images.pop_front();
+    }
+}
+
+void TextureStreamer::run_on_worker(std::function<void()>&& task) {
+    TextureStreamer& texture_streamer = get();
+    texture_streamer.start();
+
+    {
+        std::lock_guard lock(texture_streamer.mutex);
+        texture_streamer.tasks.push_back(std::move(task));
+    }
+
+    texture_streamer.jobs_cv.notify_one();
+}
+
+size_t TextureStreamer::get_pending_count() {
+    return get().requests.size();
+}
+
+size_t TextureStreamer::get_deduplicated_count() {
+    return get().deduplicated_count;
+}
+
+size_t TextureStreamer::get_deduplicated_size() {
+    return get().deduplicated_size;
+}
+
+TextureStreamer::TextureStreamer()
+    : next_request_id(0), pixel_buffers{}, next_pixel_buffer(0), deduplicated_count(0), deduplicated_size(0) { }
+
+TextureStreamer::~TextureStreamer() {
+    workers.clear(); // Stops and joins the threads.
+
+    for(PixelBuffer& pixel_buffer : pixel_buffers) {
+        if(pixel_buffer.fence != nullptr) { glDeleteSync(static_cast<GLsync>(pixel_buffer.fence)); }
+        if(pixel_buffer.id != 0) { glDeleteBuffers(1, &pixel_buffer.id); }
+    }
+}
+
+void TextureStreamer::work(const std::stop_token& stop_token) {
+    Profiler::set_thread_name("Texture Streaming");
+
+    while(true) {
+        Job job;
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock(mutex);
+            if(!jobs_cv.wait(lock, stop_token, [this] { return !jobs.empty() || !tasks.empty(); })) { return; }
+
+            /* Tasks are short and something waits for them, they go before the images. */
+            if(!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            } else {
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+        }
+
+        if(task) {
+            task();
+            continue;
+        }
+
+        Profiler::Zone zone("TextureStreamer::decode");
+        std::filesystem::path cache_path = CompressedImage::get_cache_path(job.hash);
+
+        std::optional<CompressedImage> image(std::in_place);
+        if(!image->load(cache_path)) {
+            image.reset();
+
+            try {
+                /* glTF's texture coordinates have their origin at the top left so the image isn't flipped.
+                 * The workers already decode images in parallel, so the mip levels use one thread each. */
+                Image decoded_image(job.encoded_data.data(), job.encoded_data.size(), false);
+                image.emplace(decoded_image,
+                              CompressedImage::choose_format(decoded_image, job.is_normal_map),
+                              job.srgb,
+                              MIPMAP_FILTER,
+                              1);
+            } catch(const std::exception& exception) {
+                std::cerr << "Error streaming texture: " << exception.what() << '\n';
+            }
+
+            if(image.has_value()) {
+                try {
+                    image->save(cache_path);
+                } catch(const std::exception& exception) {
+                    std::cerr << "Error saving texture to the cache: " << exception.what() << '\n';
+                    cache_path.clear();
+                }
+            }
+        }
+
+        std::lock_guard lock(mutex);
+        decoded_images.emplace_back(job.request_id, std::move(image), std::move(cache_path));
+    }
+}
+
+Handle<Texture> TextureStreamer::share(const std::string& key) {
+    /* The pending requests are checked first as their placeholder is already in the asset manager.
+     * A request whose texture was released can't be shared anymore. */
+    auto iterator = keys.find(key);
+    if(iterator != keys.end()) {
+        Request& request = requests[iterator->second];
+        if(AssetManager::get_texture_ptr(request.texture) == nullptr) { return Handle<Texture>(); }
+
+        ++deduplicated_count;
+        ++request.duplicates_count;
+        return request.texture;
+    }
+
+    const Texture* asset_manager_texture = AssetManager::get_texture_ptr(key);
+    if(asset_manager_texture == nullptr) { return Handle<Texture>(); }
+
+    ++deduplicated_count;
+    deduplicated_size += TextureResidencyManager::get_size(asset_manager_texture->get_id());
+    return AssetManager::get_texture_handle(key);
+}
+
+void TextureStreamer::start() {
+    if(!workers.empty()) { return; }
+
+    unsigned int workers_count = std::max(1u, std::thread::hardware_concurrency() / 2);
+    for(unsigned int i = 0 ; i < workers_count ; ++i) {
+        workers.emplace_back([this](const std::stop_token& stop_token) { work(stop_token); });
+    }
+
+    for(PixelBuffer& pixel_buffer : pixel_buffers) { glGenBuffers(1, &pixel_buffer.id); }
+}
+
+bool TextureStreamer::upload(CompressedImage& image,
+                             const std::filesystem::path& cache_path,
+                             const Request& request) {
+    CompressionFormat format = image.get_format();
+    if(request.is_virtual
+       && (format == CompressionFormat::BC1 || format == CompressionFormat::BC3)
+       && VirtualTextureSystem::can_add_texture()) {
+        /* Only the pages that are needed are uploaded, by the VirtualTextureSystem. */
+        Texture texture;
+        texture.create_virtual(std::move(image));
+        assign_texture(texture, request);
+        return true;
+    }
+
+    PixelBuffer& pixel_buffer = pixel_buffers[next_pixel_buffer];
+
+    /* The buffer is never waited on, if the GPU still reads from it the upload waits for the next frame. */
+    if(pixel_buffer.fence != nullptr) {
+        GLsync fence = static_cast<GLsync>(pixel_buffer.fence);
+        if(glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) { return false; }
+        glDeleteSync(fence);
+        pixel_buffer.fence = nullptr;
+    }
+
+    size_t size = image.get_size();
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer.id);
+    if(pixel_buffer.capacity < size) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_DRAW);
+        pixel_buffer.capacity = size;
+    }
+
+    void* mapped_buffer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                           0,
+                                           static_cast<GLsizeiptr>(size),
+                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if(mapped_buffer == nullptr) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        throw std::runtime_error("Couldn't map pixel buffer to stream texture.");
+    }
+
+    std::memcpy(mapped_buffer, image.get_data(), size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    /* The data pointer is an offset in the pixel buffer. */
+    Texture texture;
+    texture.create(image, request.srgb, nullptr);
+    texture.set_sampler(request.sampler);
+    if(!cache_path.empty()) { TextureResidencyManager::set_source(texture.get_id(), cache_path, request.srgb); }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pixel_buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    next_pixel_buffer = (next_pixel_buffer + 1) % PIXEL_BUFFERS_COUNT;
+
+    assign_texture(texture, request);
+
+    return true;
+}
+
+void TextureStreamer::assign_texture(const Texture& texture, const Request& request) {
+    /* The users of the texture reference it through its handle, so replacing the placeholder in the
+     * asset manager updates all of them. */
+    Texture& target = AssetManager::get_texture(request.texture);
+    target.free();
+    target = texture;
+}
@@ -0,0 +1,431 @@
+/***************************************************************************************************
+ * @file  VirtualTextureSystem.cpp
+ * @brief Implementation of the VirtualTextureSystem class
+ **************************************************************************************************/
+
+#include "assets/VirtualTextureSystem.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#include "engine/Window.hpp"
+#include "glad/glad.h"
+
+/* From the EXT_texture_compression_s3tc and EXT_texture_sRGB extensions, which glad doesn't load. */
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+static constexpr unsigned int SLOT_SIZE = VirtualTextureSystem::PAGE_SIZE + 2 * VirtualTextureSystem::PAGE_BORDER;
+static constexpr unsigned int SLOT_BLOCKS = SLOT_SIZE / 4;
+static constexpr unsigned int SLOT_BYTES = SLOT_BLOCKS * SLOT_BLOCKS * 16;
+static constexpr unsigned int ATLAS_SIZE = VirtualTextureSystem::SLOTS_PER_SIDE * SLOT_SIZE;
+
+static_assert(VirtualTextureSystem::PAGE_BORDER % 4 == 0, "Pages need to be made of whole blocks.");
+
+/**
+ * @brief Creates the key of a page. The level is in the most significant bits so that sorting keys
+ * in descending order puts the coarsest pages first.
+ */
+static uint64_t make_page_key(unsigned int texture_index, unsigned int level, unsigned int x, unsigned int y) {
+    return static_cast<uint64_t>(level) << 56 | static_cast<uint64_t>(texture_index) << 32 | y << 16 | x;
+}
+
+static unsigned int get_page_level(uint64_t page_key) { return page_key >> 56; }
+static unsigned int get_page_texture_index(uint64_t page_key) { return page_key >> 32 & 0xFFFFFF; }
+static unsigned int get_page_y(uint64_t page_key) { return page_key >> 16 & 0xFFFF; }
+static unsigned int get_page_x(uint64_t page_key) { return page_key & 0xFFFF; }
+
+void VirtualTextureSystem::set_enabled(bool is_enabled) {
+    get().b_is_enabled = is_enabled;
+}
+
+bool VirtualTextureSystem::is_enabled() {
+    return get().b_is_enabled;
+}
+
+unsigned int VirtualTextureSystem::add_texture(CompressedImage&& image) {
+    VirtualTextureSystem& virtual_texture_system = get();
+    virtual_texture_system.init();
+
+    if(image.get_format() != CompressionFormat::BC1 && image.get_format() != CompressionFormat::BC3) {
+        throw std::runtime_error("Virtual textures need to be compressed with BC1 or BC3.");
+    }
+    if(!can_add_texture()) { throw std::runtime_error("Too many virtual textures."); }
+
+    const CompressedImage::Level& first_level = image.get_levels().front();
+    unsigned int pages_count = std::max((first_level.width + PAGE_SIZE - 1) / PAGE_SIZE,
+                                        (first_level.height + PAGE_SIZE - 1) / PAGE_SIZE);
+
+    /* The page table is a power of two so that each level has exactly half the pages of the previous one. */
+    unsigned int page_table_size = std::bit_ceil(pages_count);
+    if(page_table_size > 256) { throw std::runtime_error("Virtual texture too large, pages are stored on 8 bits."); }
+
+    unsigned int texture_index = virtual_texture_system.textures.size();
+    VirtualTexture& texture = virtual_texture_system.textures.emplace_back();
+    texture.image = std::move(image);
+    texture.page_table_size = page_table_size;
+    texture.max_level = std::countr_zero(page_table_size);
+    texture.is_page_table_dirty = true;
+
+    for(unsigned int level = 0 ; level <= texture.max_level ; ++level) {
+        unsigned int size = page_table_size >> level;
+        texture.pages.emplace_back(size * size, 0);
+    }
+
+    glGenTextures(1, &texture.page_table);
+    glBindTexture(GL_TEXTURE_2D, texture.page_table);
+    glTexStorage2D(GL_TEXTURE_2D, texture.max_level + 1, GL_RGBA8UI, page_table_size, page_table_size);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, texture.max_level);
+
+    /* ---- Root Page ---- */
+    unsigned int slot_index = virtual_texture_system.acquire_slot();
+    if(slot_index == INVALID_SLOT) { throw std::runtime_error("No slot left in the virtual texture atlas."); }
+
+    virtual_texture_system.load_page(make_page_key(texture_index, texture.max_level, 0, 0), slot_index);
+    virtual_texture_system.slots[slot_index].is_pinned = true;
+    upload_page_table(texture);
+
+    return texture_index;
+}
+
+bool VirtualTextureSystem::can_add_texture() {
+    /* The feedback stores the index + 1 of the textures on 16 bits, and every texture pins a slot. */
+    size_t textures_count = get().textures.size();
+    return textures_count < MAX_TEXTURES_COUNT && textures_count < SLOTS_PER_SIDE * SLOTS_PER_SIDE;
+}
+
+void VirtualTextureSystem::bind(unsigned int texture_index, const Shader* shader) {
+    VirtualTextureSystem& virtual_texture_system = get();
+    const VirtualTexture& texture = virtual_texture_system.textures[texture_index];
+    const CompressedImage::Level& first_level = texture.image.get_levels().front();
+
+    glActiveTexture(GL_TEXTURE0 + 3);
+    glBindTexture(GL_TEXTURE_2D, texture.page_table);
+    glActiveTexture(GL_TEXTURE0 + 4);
+    glBindTexture(GL_TEXTURE_2D, virtual_texture_system.atlas);
+
+    shader->set_uniform_if_exists("u_is_base_color_virtual", true);
+    shader->set_uniform_if_exists("u_virtual_texture.size", vec2(first_level.width, first_level.height));
+    shader->set_uniform_if_exists("u_virtual_texture.max_level", static_cast<int>(texture.max_level));
+    shader->set_uniform_if_exists("u_virtual_texture.index", static_cast<int>(texture_index));
+}
+
+bool VirtualTextureSystem::begin_feedback_pass() {
+    VirtualTextureSystem& virtual_texture_system = get();
+    if(virtual_texture_system.textures.empty() || virtual_texture_system.feedback_fence != nullptr) { return false; }
+
+    unsigned int width = std::max(1u, static_cast<unsigned int>(Window::get_width()) / FEEDBACK_DOWNSCALE);
+    unsigned int height = std::max(1u, static_cast<unsigned int>(Window::get_height()) / FEEDBACK_DOWNSCALE);
+    if(width != virtual_texture_system.feedback_width || height != virtual_texture_system.feedback_height) {
+        virtual_texture_system.create_feedback_framebuffer(width, height);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, virtual_texture_system.feedback_FBO);
+    glViewport(0, 0, static_cast<int>(width), static_cast<int>(height));
+
+    static constexpr unsigned int NO_PAGE[4] { 0, 0, 0, 0 };
+    glClearBufferuiv(GL_COLOR, 0, NO_PAGE);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    return true;
+}
+
+void VirtualTextureSystem::end_feedback_pass() {
+    VirtualTextureSystem& virtual_texture_system = get();
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, virtual_texture_system.feedback_PBO);
+    glReadPixels(0, 0,
+                 static_cast<int>(virtual_texture_system.feedback_width),
+                 static_cast<int>(virtual_texture_system.feedback_height),
+                 GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    virtual_texture_system.feedback_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, Window::get_width(), Window::get_height());
+}
+
+void VirtualTextureSystem::update(size_t& upload_budget) {
+    VirtualTextureSystem& virtual_texture_system = get();
+    ++virtual_texture_system.frame;
+
+    GLsync fence = static_cast<GLsync>(virtual_texture_system.feedback_fence);
+    if(fence != nullptr && glClientWaitSync(fence, 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(fence);
+        virtual_texture_system.feedback_fence = nullptr;
+
+        /* ---- Feedback ---- */
+        size_t pixels_count = virtual_texture_system.feedback_width * virtual_texture_system.feedback_height;
+        std::vector<uint64_t> needed_pages;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, virtual_texture_system.feedback_PBO);
+        auto pixels = static_cast<const uint16_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER,
+                                                                    0,
+                                                                    static_cast<GLsizeiptr>(4 * sizeof(uint16_t) * pixels_count),
+                                                                    GL_MAP_READ_BIT));
+        if(pixels != nullptr) {
+            for(size_t i = 0 ; i < pixels_count ; ++i) {
+                const uint16_t* pixel = pixels + 4 * i;
+                if(pixel[3] == 0 || pixel[3] > virtual_texture_system.textures.size()) { continue; }
+
+                const VirtualTexture& texture = virtual_texture_system.textures[pixel[3] - 1];
+                unsigned int level = std::min<unsigned int>(pixel[2], texture.max_level);
+                unsigned int size = texture.page_table_size >> level;
+                if(pixel[0] >= size || pixel[1] >= size) { continue; }
+
+                needed_pages.push_back(make_page_key(pixel[3] - 1, level, pixel[0], pixel[1]));
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        std::ranges::sort(needed_pages);
+        auto [first, last] = std::ranges::unique(needed_pages);
+        needed_pages.erase(first, last);
+
+        std::vector<uint64_t> missing_pages;
+        for(uint64_t page_key : needed_pages) { virtual_texture_system.touch_page(page_key, missing_pages); }
+
+        /* ---- Streaming ---- */
+        std::ranges::sort(missing_pages, std::ranges::greater());
+        auto [first_missing, last_missing] = std::ranges::unique(missing_pages);
+        missing_pages.erase(first_missing, last_missing);
+
+        for(uint64_t page_key : missing_pages) {
+            if(upload_budget == 0) { break; }
+
+            unsigned int slot_index = virtual_texture_system.acquire_slot();
+            if(slot_index == INVALID_SLOT) { break; }
+
+            virtual_texture_system.load_page(page_key, slot_index);
+            upload_budget -= std::min<size_t>(upload_budget, SLOT_BYTES);
+        }
+    }
+
+    for(VirtualTexture& texture : virtual_texture_system.textures) {
+        if(texture.is_page_table_dirty) { upload_page_table(texture); }
+    }
+}
+
+size_t VirtualTextureSystem::get_resident_pages_count() {
+    return get().resident_pages.size();
+}
+
+unsigned int VirtualTextureSystem::get_slots_count() {
+    return SLOTS_PER_SIDE * SLOTS_PER_SIDE;
+}
+
+VirtualTextureSystem::VirtualTextureSystem()
+    : b_is_enabled(false),
+      frame(0),
+      atlas(0),
+      feedback_FBO(0),
+      feedback_texture(0),
+      feedback_RBO(0),
+      feedback_PBO(0),
+      feedback_width(0),
+      feedback_height(0),
+      feedback_fence(nullptr) { }
+
+VirtualTextureSystem::~VirtualTextureSystem() {
+    if(atlas == 0) { return; }
+
+    for(VirtualTexture& texture : textures) { glDeleteTextures(1, &texture.page_table); }
+    glDeleteTextures(1, &atlas);
+
+    if(feedback_fence != nullptr) { glDeleteSync(static_cast<GLsync>(feedback_fence)); }
+    glDeleteBuffers(1, &feedback_PBO);
+    glDeleteTextures(1, &feedback_texture);
+    glDeleteRenderbuffers(1, &feedback_RBO);
+    glDeleteFramebuffers(1, &feedback_FBO);
+}
+
+void VirtualTextureSystem::init() {
+    if(atlas != 0) { return; }
+
+    slots.resize(SLOTS_PER_SIDE * SLOTS_PER_SIDE, Slot(0, 0, false, false));
+
+    /* The atlas is always BC3 SRGB, BC1 pages are converted by giving them an opaque alpha block. */
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, ATLAS_SIZE, ATLAS_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &feedback_FBO);
+    glGenTextures(1, &feedback_texture);
+    glGenRenderbuffers(1, &feedback_RBO);
+    glGenBuffers(1, &feedback_PBO);
+}
+
+void VirtualTextureSystem::touch_page(uint64_t page_key, std::vector<uint64_t>& missing_pages) {
+    unsigned int texture_index = get_page_texture_index(page_key);
+    unsigned int max_level = textures[texture_index].max_level;
+
+    /* The ancestors are kept resident too since they are what is sampled while a page is missing. */
+    for(unsigned int level = get_page_level(page_key) ; level <= max_level ; ++level) {
+        unsigned int shift = level - get_page_level(page_key);
+        uint64_t key = make_page_key(texture_index, level, get_page_x(page_key) >> shift, get_page_y(page_key) >> shift);
+
+        auto iterator = resident_pages.find(key);
+        if(iterator == resident_pages.end()) {
+            missing_pages.push_back(key);
+        } else {
+            slots[iterator->second].last_used_frame = frame;
+        }
+    }
+}
+
+void VirtualTextureSystem::load_page(uint64_t page_key, unsigned int slot_index) {
+    VirtualTexture& texture = textures[get_page_texture_index(page_key)];
+    unsigned int level_index = get_page_level(page_key);
+    unsigned int page_x = get_page_x(page_key);
+    unsigned int page_y = get_page_y(page_key);
+
+    const CompressedImage::Level& level = texture.image.get_levels()[level_index];
+    const unsigned char* level_data = texture.image.get_data() + level.offset;
+    int blocks_x = static_cast<int>((level.width + 3) / 4);
+    int blocks_y = static_cast<int>((level.height + 3) / 4);
+    bool is_bc1 = texture.image.get_format() == CompressionFormat::BC1;
+    unsigned int block_size = is_bc1 ? 8 : 16;
+
+    /* An opaque BC3 alpha block: both endpoints are 255 and all indices are 0. */
+    static constexpr unsigned char OPAQUE_ALPHA_BLOCK[8] { 255, 255, 0, 0, 0, 0, 0, 0 };
+
+    /* The page's blocks and its border, wrapped around the level as the textures repeat. */
+    std::vector<unsigned char> slot_data(SLOT_BYTES);
+    int first_x = static_cast<int>(page_x * PAGE_SIZE / 4) - static_cast<int>(PAGE_BORDER / 4);
+    int first_y = static_cast<int>(page_y * PAGE_SIZE / 4) - static_cast<int>(PAGE_BORDER / 4);
+
+    for(unsigned int j = 0 ; j < SLOT_BLOCKS ; ++j) {
+        int block_y = ((first_y + static_cast<int>(j)) % blocks_y + blocks_y) % blocks_y;
+
+        for(unsigned int i = 0 ; i < SLOT_BLOCKS ; ++i) {
+            int block_x = ((first_x + static_cast<int>(i)) % blocks_x + blocks_x) % blocks_x;
+
+            const unsigned char* source = level_data + (block_y * blocks_x + block_x) * block_size;
+            unsigned char* destination = slot_data.data() + (j * SLOT_BLOCKS + i) * 16;
+
+            if(is_bc1) {
+                std::memcpy(destination, OPAQUE_ALPHA_BLOCK, 8);
+                std::memcpy(destination + 8, source, 8);
+            } else {
+                std::memcpy(destination, source, 16);
+            }
+        }
+    }
+
+    unsigned int slot_x = slot_index % SLOTS_PER_SIDE;
+    unsigned int slot_y = slot_index / SLOTS_PER_SIDE;
+
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glCompressedTexSubImage2D(GL_TEXTURE_2D, 0,
+                              static_cast<int>(slot_x * SLOT_SIZE), static_cast<int>(slot_y * SLOT_SIZE),
+                              SLOT_SIZE, SLOT_SIZE,
+                              GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+                              SLOT_BYTES, slot_data.data());
+
+    slots[slot_index] = Slot(page_key, frame, true, false);
+    resident_pages[page_key] = slot_index;
+
+    unsigned int size = texture.page_table_size >> level_index;
+    texture.pages[level_index][page_y * size + page_x] = slot_index + 1;
+    texture.is_page_table_dirty = true;
+}
+
+unsigned int VirtualTextureSystem::acquire_slot() {
+    unsigned int best_slot = INVALID_SLOT;
+    uint64_t best_frame = std::numeric_limits<uint64_t>::max();
+
+    for(unsigned int i = 0 ; i < slots.size() ; ++i) {
+        const Slot& slot = slots[i];
+        if(!slot.is_used) { return i; }
+
+        if(!slot.is_pinned && slot.last_used_frame < frame && slot.last_used_frame < best_frame) {
+            best_slot = i;
+            best_frame = slot.last_used_frame;
+        }
+    }
+
+    if(best_slot != INVALID_SLOT) {
+        uint64_t page_key = slots[best_slot].page_key;
+        VirtualTexture& texture = textures[get_page_texture_index(page_key)];
+        unsigned int level = get_page_level(page_key);
+        unsigned int size = texture.page_table_size >> level;
+
+        texture.pages[level][get_page_y(page_key) * size + get_page_x(page_key)] = 0;
+        texture.is_page_table_dirty = true;
+        resident_pages.erase(page_key);
+        slots[best_slot].is_used = false;
+    }
+
+    return best_slot;
+}
+
+void VirtualTextureSystem::upload_page_table(VirtualTexture& texture) {
+    glBindTexture(GL_TEXTURE_2D, texture.page_table);
+
+    /* Each entry is the slot of the page and the level of the page that is in it. Missing pages use
+     * the entry of their parent, which was resolved just before since the levels go from the coarsest. */
+    std::vector<uint32_t> parent_entries;
+    for(int level = static_cast<int>(texture.max_level) ; level >= 0 ; --level) {
+        unsigned int size = texture.page_table_size >> level;
+        std::vector<uint32_t> entries(size * size, 0);
+
+        for(unsigned int y = 0 ; y < size ; ++y) {
+            for(unsigned int x = 0 ; x < size ; ++x) {
+                uint32_t slot = texture.pages[level][y * size + x];
+
+                if(slot != 0) {
+                    --slot;
+                    entries[y * size + x] = slot % SLOTS_PER_SIDE
+                                            | slot / SLOTS_PER_SIDE << 8
+                                            | static_cast<uint32_t>(level) << 16
+                                            | 0xFFu << 24;
+                } else if(!parent_entries.empty()) {
+                    entries[y * size + x] = parent_entries[y / 2 * (size / 2) + x / 2];
+                }
+            }
+        }
+
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, size, size, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, entries.data());
+        parent_entries = std::move(entries);
+    }
+
+    texture.is_page_table_dirty = false;
+}
+
+void VirtualTextureSystem::create_feedback_framebuffer(unsigned int width, unsigned int height) {
+    feedback_width = width;
+    feedback_height = height;
+
+    glBindTexture(GL_TEXTURE_2D, feedback_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, feedback_RBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, feedback_FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, feedback_texture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, feedback_RBO);
+
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("Couldn't create the virtual texture feedback framebuffer");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, feedback_PBO);
+    glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(4 * sizeof(uint16_t) * width * height), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
@@ -5,9 +5,14 @@
 
 #include "culling/AABB.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
 #include "maths/functions.hpp"
 #include "maths/geometry.hpp"
 
@@ -78,8 +83,69 @@ void AABB::set(const vec3& min, const vec3& max) {
 }
 
 void AABB::set(const AABB& aabb, const Transform& transform) {
-    const mat4& model = transform.get_global_model_const_reference();
+    set(aabb, transform.get_global_model_const_reference());
+}
+
+/**
+ * @brief Sets an AABB to the bounds of another AABB transformed by an affine matrix, using Arvo's
+ * method: the center is transformed as a point and the extent by the absolute values of the upper
+ * left 3x3 matrix, which gives the bounds of the 8 transformed corners without computing them.
+ * @param result The AABB that is set.
+ * @param aabb The transformed AABB.
+ * @param model The affine matrix.
+ */
+static inline void set_to_transformed_center_extent(AABB& result, const AABB& aabb, const affine3x4& model) {
+#ifdef __SSE__
+    /* Transposing the rows gives the columns, whose w is 0, and the translation, whose w is 1 so
+     * that the w of the result's points stays 1. */
+    __m128 column0 = _mm_loadu_ps(&model.get_row(0).x);
+    __m128 column1 = _mm_loadu_ps(&model.get_row(1).x);
+    __m128 column2 = _mm_loadu_ps(&model.get_row(2).x);
+    __m128 translation = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    _MM_TRANSPOSE4_PS(column0, column1, column2, translation);
+
+    __m128 min = _mm_loadu_ps(&aabb.min_point.x);
+    __m128 max = _mm_loadu_ps(&aabb.max_point.x);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+    __m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+    __m128 new_center = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(column0, _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0))),
+                   _mm_mul_ps(column1, _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm_add_ps(_mm_mul_ps(column2, _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2))), translation)
+    );
+
+    __m128 sign_mask = _mm_set1_ps(-0.0f);
+    __m128 new_extent = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign_mask, column0), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0))),
+                   _mm_mul_ps(_mm_andnot_ps(sign_mask, column1), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm_mul_ps(_mm_andnot_ps(sign_mask, column2), _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2)))
+    );
+
+    _mm_storeu_ps(&result.min_point.x, _mm_sub_ps(new_center, new_extent));
+    _mm_storeu_ps(&result.max_point.x, _mm_add_ps(new_center, new_extent));
+#else
+    vec3 center(0.5f * (aabb.min_point.x + aabb.max_point.x),
+                0.5f * (aabb.min_point.y + aabb.max_point.y),
+                0.5f * (aabb.min_point.z + aabb.max_point.z));
+    vec3 extent(0.5f * (aabb.max_point.x - aabb.min_point.x),
+                0.5f * (aabb.max_point.y - aabb.min_point.y),
+                0.5f * (aabb.max_point.z - aabb.min_point.z));
+
+    vec3 new_center = transform_point(model, center);
+    vec3 new_extent(
+        std::abs(model(0, 0)) * extent.x + std::abs(model(0, 1)) * extent.y + std::abs(model(0, 2)) * extent.z,
+        std::abs(model(1, 0)) * extent.x + std::abs(model(1, 1)) * extent.y + std::abs(model(1, 2)) * extent.z,
+        std::abs(model(2, 0)) * extent.x + std::abs(model(2, 1)) * extent.y + std::abs(model(2, 2)) * extent.z
+    );
+
+    result.set(new_center - new_extent, new_center + new_extent);
+#endif
+}
 
+void AABB::set(const AABB& aabb, const mat4& model) {
+    /* The matrix may not be affine, so the corners are transformed one by one. */
     vec4 corners[8] {
         model * vec4(aabb.min_point.x, aabb.min_point.y, aabb.min_point.z, 1.0f),
         model * vec4(aabb.min_point.x, aabb.min_point.y, aabb.max_point.z, 1.0f),
@@ -99,3 +165,12 @@ void AABB::set(const AABB& aabb, const Transform& transform) {
         axis_aligned_max(max_point, point);
     }
 }
+
+void AABB::set(const AABB& aabb, const affine3x4& model) {
+    set_to_transformed_center_extent(*this, aabb, model);
+}
+
+void AABB::transform(std::span<const AABB> aabbs, std::span<const affine3x4> models, std::span<AABB> results) {
+    const size_t count = std::min(aabbs.size(), std::min(models.size(), results.size()));
+    for(size_t i = 0 ; i < count ; ++i) { set_to_transformed_center_extent(results[i], aabbs[i], models[i]); }
+}
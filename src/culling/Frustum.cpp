@@ -5,8 +5,8 @@
 
 #include "culling/Frustum.hpp"
 
-void Frustum::update(const Camera& camera) {
-    view_projection = camera.get_view_projection_matrix();
+void Frustum::update(const mat4& view_projection, const mat4& inverse_projection) {
+    this->view_projection = view_projection;
 
     static const vec4 projection_space_points[8] {
         vec4(1.0f, 1.0f, 1.0f, 1.0f),
@@ -19,7 +19,6 @@ void Frustum::update(const Camera& camera) {
         vec4(-1.0f, -1.0f, -1.0f, 1.0f)
     };
 
-    mat4 inverse_projection = camera.get_inverse_projection_matrix();
     for(int i = 0 ; i < 8 ; ++i) {
         points[i] = inverse_projection * projection_space_points[i];
         points[i] /= points[i].w;
@@ -0,0 +1,151 @@
+/***************************************************************************************************
+ * @file  BenchmarkReport.cpp
+ * @brief Implementation of the BenchmarkReport class
+ **************************************************************************************************/
+
+#include "engine/BenchmarkReport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+#include "json.hpp"
+
+static constexpr float NOISE_FLOOR = 0.05f; ///< The differences in milliseconds that are ignored.
+
+/**
+ * @brief Computes the statistics of a timing.
+ * @param name What is timed.
+ * @param values The timing of each frame, which are sorted.
+ * @return The statistics.
+ */
+static TimingStatistics compute_statistics(const std::string& name, std::vector<float>& values) {
+    TimingStatistics statistics { name, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    if(values.empty()) { return statistics; }
+
+    std::ranges::sort(values);
+
+    /* Nearest-rank percentiles, so they are always a measured value. */
+    auto percentile = [&values](float rank) {
+        size_t index = static_cast<size_t>(std::ceil(rank * static_cast<float>(values.size())));
+        return values[std::clamp<size_t>(index, 1, values.size()) - 1];
+    };
+
+    statistics.mean = std::accumulate(values.begin(), values.end(), 0.0f) / static_cast<float>(values.size());
+    statistics.p50 = percentile(0.50f);
+    statistics.p95 = percentile(0.95f);
+    statistics.p99 = percentile(0.99f);
+    statistics.max = values.back();
+
+    return statistics;
+}
+
+BenchmarkReport::BenchmarkReport(const std::string& scene_name, const std::vector<FrameRecord>& records)
+    : scene_name(scene_name), records(records) {
+    std::vector<float> values;
+    values.reserve(records.size());
+
+    for(unsigned int i = 0 ; i < FRAME_STAGE_COUNT ; ++i) {
+        values.clear();
+        for(const FrameRecord& record : records) { values.push_back(record.stages[i]); }
+        statistics.push_back(compute_statistics(get_frame_stage_name(static_cast<FrameStage>(i)), values));
+    }
+
+    values.clear();
+    for(const FrameRecord& record : records) { values.push_back(record.cpu_total); }
+    statistics.push_back(compute_statistics("cpu_total", values));
+
+    /* The GPU times are unknown if timer queries aren't supported. */
+    values.clear();
+    for(const FrameRecord& record : records) {
+        if(record.gpu_total >= 0.0f) { values.push_back(record.gpu_total); }
+    }
+    if(!values.empty()) { statistics.push_back(compute_statistics("gpu_total", values)); }
+}
+
+void BenchmarkReport::write_csv(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to create benchmark report '" + path.string() + "'.");
+    }
+
+    file << "frame";
+    for(unsigned int i = 0 ; i < FRAME_STAGE_COUNT ; ++i) { file << ',' << get_frame_stage_name(static_cast<FrameStage>(i)); }
+    file << ",cpu_total,gpu_total\n";
+
+    for(size_t i = 0 ; i < records.size() ; ++i) {
+        file << i;
+        for(float stage : records[i].stages) { file << ',' << stage; }
+        file << ',' << records[i].cpu_total << ',' << records[i].gpu_total << '\n';
+    }
+}
+
+void BenchmarkReport::write_json(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to create benchmark report '" + path.string() + "'.");
+    }
+
+    nlohmann::json json;
+    json["scene"] = scene_name;
+    json["frames"] = records.size();
+
+    for(const TimingStatistics& timing : statistics) {
+        json["statistics"][timing.name] = {
+            { "mean", timing.mean },
+            { "p50", timing.p50 },
+            { "p95", timing.p95 },
+            { "p99", timing.p99 },
+            { "max", timing.max }
+        };
+    }
+
+    file << json.dump(4) << '\n';
+}
+
+void BenchmarkReport::print(std::ostream& stream) const {
+    stream << std::fixed << std::setprecision(3)
+           << std::left << std::setw(12) << "ms" << std::right
+           << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p95"
+           << std::setw(10) << "p99" << std::setw(10) << "max" << '\n';
+
+    for(const TimingStatistics& timing : statistics) {
+        stream << std::left << std::setw(12) << timing.name << std::right
+               << std::setw(10) << timing.mean << std::setw(10) << timing.p50 << std::setw(10) << timing.p95
+               << std::setw(10) << timing.p99 << std::setw(10) << timing.max << '\n';
+    }
+}
+
+bool BenchmarkReport::compare(const std::filesystem::path& baseline_path, float threshold, std::ostream& stream) const {
+    std::ifstream file(baseline_path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to open benchmark baseline '" + baseline_path.string() + "'.");
+    }
+
+    nlohmann::json baseline = nlohmann::json::parse(file, nullptr, false);
+    if(baseline.is_discarded() || !baseline.contains("statistics")) {
+        throw std::runtime_error("Invalid benchmark baseline '" + baseline_path.string() + "'.");
+    }
+
+    bool has_regressed = false;
+    stream << std::fixed << std::setprecision(3);
+
+    for(const TimingStatistics& timing : statistics) {
+        if(!baseline["statistics"].contains(timing.name)) { continue; }
+        const nlohmann::json& baseline_timing = baseline["statistics"][timing.name];
+
+        for(auto [percentile, value] : { std::pair("p50", timing.p50), std::pair("p95", timing.p95) }) {
+            float baseline_value = baseline_timing.value(percentile, 0.0f);
+            bool is_regression = value > baseline_value * (1.0f + threshold) && value - baseline_value > NOISE_FLOOR;
+            has_regressed = has_regressed || is_regression;
+
+            stream << std::left << std::setw(12) << timing.name << std::setw(5) << percentile << std::right
+                   << std::setw(10) << baseline_value << " -> " << std::setw(10) << value
+                   << (is_regression ? "  REGRESSION" : "") << '\n';
+        }
+    }
+
+    return !has_regressed;
+}
@@ -0,0 +1,126 @@
+/***************************************************************************************************
+ * @file  FrameTimer.cpp
+ * @brief Implementation of the FrameTimer class
+ **************************************************************************************************/
+
+#include "engine/FrameTimer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include "glad/glad.h"
+
+using Milliseconds = std::chrono::duration<float, std::milli>;
+
+const char* get_frame_stage_name(FrameStage stage) {
+    switch(stage) {
+        case FRAME_STAGE_EVENTS: return "events";
+        case FRAME_STAGE_LOADING: return "loading";
+        case FRAME_STAGE_ANIMATIONS: return "animations";
+        case FRAME_STAGE_TRANSFORMS: return "transforms";
+        case FRAME_STAGE_AABBS: return "aabbs";
+        case FRAME_STAGE_CULLING: return "culling";
+        case FRAME_STAGE_SUBMISSION: return "submission";
+        case FRAME_STAGE_IMGUI: return "imgui";
+        case FRAME_STAGE_SWAP: return "swap";
+        default: return "unknown";
+    }
+}
+
+FrameTimer::Scope::Scope(FrameStage stage)
+    : stage(stage), start_time(std::chrono::steady_clock::now()) { }
+
+FrameTimer::Scope::~Scope() {
+    FrameTimer& frame_timer = get();
+    if(!frame_timer.b_is_enabled || frame_timer.records.empty()) { return; }
+
+    frame_timer.records.back().stages[stage] += Milliseconds(std::chrono::steady_clock::now() - start_time).count();
+}
+
+FrameTimer::FrameTimer()
+    : b_is_enabled(false), queries{}, first_pending_frame(0) {
+    glGenQueries(QUERIES_COUNT, queries.data());
+}
+
+FrameTimer::~FrameTimer() {
+    glDeleteQueries(QUERIES_COUNT, queries.data());
+}
+
+void FrameTimer::set_enabled(bool is_enabled) {
+    FrameTimer& frame_timer = get();
+    if(is_enabled && !frame_timer.b_is_enabled) {
+        frame_timer.records.clear();
+        frame_timer.first_pending_frame = 0;
+    }
+
+    frame_timer.b_is_enabled = is_enabled;
+}
+
+bool FrameTimer::is_enabled() {
+    return get().b_is_enabled;
+}
+
+void FrameTimer::begin_frame() {
+    FrameTimer& frame_timer = get();
+    if(!frame_timer.b_is_enabled) { return; }
+
+    /* The query is reused, so the frame that used it last needs to be read first. */
+    size_t frame = frame_timer.records.size();
+    if(frame >= QUERIES_COUNT) {
+        for(size_t i = frame_timer.first_pending_frame ; i <= frame - QUERIES_COUNT ; ++i) {
+            frame_timer.read_query(i, true);
+        }
+        frame_timer.first_pending_frame = std::max(frame_timer.first_pending_frame, frame - QUERIES_COUNT + 1);
+    }
+
+    FrameRecord& record = frame_timer.records.emplace_back();
+    record.stages.fill(0.0f);
+    record.cpu_total = 0.0f;
+    record.gpu_total = -1.0f;
+
+    frame_timer.frame_start = std::chrono::steady_clock::now();
+    glBeginQuery(GL_TIME_ELAPSED, frame_timer.queries[frame % QUERIES_COUNT]);
+}
+
+void FrameTimer::end_frame() {
+    FrameTimer& frame_timer = get();
+    if(!frame_timer.b_is_enabled || frame_timer.records.empty()) { return; }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    frame_timer.records.back().cpu_total = Milliseconds(std::chrono::steady_clock::now() - frame_timer.frame_start).count();
+
+    /* Reads the results that are ready without waiting, in order. */
+    while(frame_timer.first_pending_frame < frame_timer.records.size()
+          && frame_timer.read_query(frame_timer.first_pending_frame, false)) {
+        ++frame_timer.first_pending_frame;
+    }
+}
+
+void FrameTimer::resolve() {
+    FrameTimer& frame_timer = get();
+
+    for(; frame_timer.first_pending_frame < frame_timer.records.size() ; ++frame_timer.first_pending_frame) {
+        frame_timer.read_query(frame_timer.first_pending_frame, true);
+    }
+}
+
+const std::vector<FrameRecord>& FrameTimer::get_records() {
+    return get().records;
+}
+
+bool FrameTimer::read_query(size_t frame, bool wait) {
+    if(records[frame].gpu_total >= 0.0f) { return true; }
+
+    unsigned int query = queries[frame % QUERIES_COUNT];
+
+    if(!wait) {
+        int is_available = GL_FALSE;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &is_available);
+        if(is_available == GL_FALSE) { return false; }
+    }
+
+    uint64_t nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    records[frame].gpu_total = static_cast<float>(nanoseconds) * 1e-6f;
+
+    return true;
+}
@@ -5,7 +5,10 @@
 
 #include "engine/Framebuffer.hpp"
 
+#include <algorithm>
+#include <vector>
 #include "glad/glad.h"
+#include "stb_image_write.h"
 
 Framebuffer::Framebuffer(unsigned int width, unsigned int height)
     : FBO(0), RBO(0), width(width), height(height) {
@@ -53,3 +56,24 @@ vec2 Framebuffer::get_resolution() const {
 void Framebuffer::bind_default() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
+
+void Framebuffer::save_png(const std::filesystem::path& path) const {
+    const size_t row_size = 3 * width;
+    std::vector<unsigned char> pixels(row_size * height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    /* OpenGL's first row is the bottom one while PNG's is the top one. */
+    for(size_t i = 0 ; i < height / 2 ; ++i) {
+        std::swap_ranges(pixels.begin() + i * row_size,
+                         pixels.begin() + (i + 1) * row_size,
+                         pixels.begin() + (height - 1 - i) * row_size);
+    }
+
+    if(!stbi_write_png(path.c_str(), width, height, 3, pixels.data(), row_size)) {
+        throw std::runtime_error("Failed to write image '" + path.string() + "'.");
+    }
+}
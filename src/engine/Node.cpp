@@ -14,5 +14,7 @@ Node::Node(const std::string& name, int parent, Type type)
       color_index(INVALID_INDEX),
       scene_index(INVALID_INDEX),
       material_index(INVALID_INDEX),
+      skin_index(INVALID_INDEX),
+      morph_index(INVALID_INDEX),
       is_visible(true),
       is_selected(false) { }
@@ -0,0 +1,335 @@
+/***************************************************************************************************
+ * @file  Profiler.cpp
+ * @brief Implementation of the Profiler class
+ **************************************************************************************************/
+
+#include "engine/Profiler.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include "imgui.h"
+#include "glad/glad.h"
+#include "json.hpp"
+
+static constexpr size_t NO_ZONE = static_cast<size_t>(-1); ///< The index of GPU zones that aren't recorded.
+
+Profiler::Zone::Zone(const char* name)
+    : name(name), start(-1) {
+    Profiler& profiler = get();
+    if(!profiler.b_is_enabled.load(std::memory_order_relaxed)) { return; }
+
+    ++profiler.get_thread_buffer().depth;
+    start = get_time();
+}
+
+Profiler::Zone::~Zone() {
+    if(start < 0) { return; }
+
+    int64_t end = get_time();
+    ThreadBuffer& buffer = get().get_thread_buffer();
+    --buffer.depth;
+
+    /* The zone is dropped if the main thread didn't drain the buffer in time. */
+    size_t head = buffer.head.load(std::memory_order_relaxed);
+    if(head - buffer.tail.load(std::memory_order_acquire) < ThreadBuffer::CAPACITY) {
+        buffer.events[head % ThreadBuffer::CAPACITY] = Event(name, start, end, buffer.depth, 0);
+        buffer.head.store(head + 1, std::memory_order_release);
+    }
+}
+
+Profiler::GPUZone::GPUZone(const char* name)
+    : zone_index(NO_ZONE) {
+    Profiler& profiler = get();
+    if(!profiler.b_is_enabled.load(std::memory_order_relaxed)) { return; }
+
+    std::array<unsigned int, 2> queries;
+    for(unsigned int& query : queries) {
+        if(profiler.free_queries.empty()) {
+            glGenQueries(1, &query);
+        } else {
+            query = profiler.free_queries.back();
+            profiler.free_queries.pop_back();
+        }
+    }
+
+    glQueryCounter(queries[0], GL_TIMESTAMP);
+
+    zone_index = profiler.gpu_zones.size();
+    profiler.gpu_zones.emplace_back(name, queries, profiler.gpu_depth++, profiler.frames_count, false);
+}
+
+Profiler::GPUZone::~GPUZone() {
+    if(zone_index == NO_ZONE) { return; }
+
+    Profiler& profiler = get();
+    PendingGPUZone& zone = profiler.gpu_zones[zone_index];
+    glQueryCounter(zone.queries[1], GL_TIMESTAMP);
+    zone.is_closed = true;
+    --profiler.gpu_depth;
+}
+
+Profiler::Profiler()
+    : b_is_enabled(false), frames_count(0), gpu_depth(0), gpu_time_offset(0), is_paused(false), selected_frame(0) {
+    frames.emplace_back(0, get_time(), get_time(), std::vector<Event>());
+}
+
+Profiler::~Profiler() {
+    for(const PendingGPUZone& zone : gpu_zones) { glDeleteQueries(zone.queries.size(), zone.queries.data()); }
+    if(!free_queries.empty()) { glDeleteQueries(free_queries.size(), free_queries.data()); }
+}
+
+void Profiler::set_enabled(bool is_enabled) {
+    get().b_is_enabled = is_enabled;
+}
+
+bool Profiler::is_enabled() {
+    return get().b_is_enabled;
+}
+
+void Profiler::set_thread_name(const std::string& name) {
+    Profiler& profiler = get();
+    ThreadBuffer& buffer = profiler.get_thread_buffer();
+
+    std::lock_guard lock(profiler.threads_mutex);
+    buffer.name = name;
+}
+
+void Profiler::end_frame() {
+    Profiler& profiler = get();
+    Frame& frame = profiler.frames.back();
+    frame.end = get_time();
+
+    /* ---- CPU Zones ---- */
+    {
+        std::lock_guard lock(profiler.threads_mutex);
+
+        for(unsigned int i = 0 ; i < profiler.threads.size() ; ++i) {
+            ThreadBuffer& buffer = *profiler.threads[i];
+            size_t head = buffer.head.load(std::memory_order_acquire);
+            size_t tail = buffer.tail.load(std::memory_order_relaxed);
+
+            for(; tail < head ; ++tail) {
+                Event& event = frame.events.emplace_back(buffer.events[tail % ThreadBuffer::CAPACITY]);
+                event.track = i;
+            }
+
+            buffer.tail.store(tail, std::memory_order_release);
+        }
+    }
+
+    /* ---- GPU Zones ---- */
+    if(!profiler.gpu_zones.empty()) {
+        /* The GPU and the CPU clocks are synchronized every frame to place the GPU zones. */
+        int64_t gpu_time = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+        profiler.gpu_time_offset = get_time() - gpu_time;
+
+        profiler.read_gpu_zones();
+    }
+
+    /* ---- Next Frame ---- */
+    if(!profiler.is_paused) { profiler.selected_frame = frame.index; }
+
+    profiler.frames.emplace_back(++profiler.frames_count, frame.end, frame.end, std::vector<Event>());
+    if(profiler.frames.size() > FRAMES_COUNT) { profiler.frames.pop_front(); }
+}
+
+void Profiler::add_imgui_window(bool* is_open) {
+    Profiler& profiler = get();
+
+    if(!ImGui::Begin("Profiler", is_open)) {
+        ImGui::End();
+        return;
+    }
+
+    bool is_enabled = profiler.b_is_enabled;
+    if(ImGui::Checkbox("Enabled", &is_enabled)) { set_enabled(is_enabled); }
+    ImGui::SameLine();
+    ImGui::Checkbox("Paused", &profiler.is_paused);
+    ImGui::SameLine();
+    if(ImGui::Button("Export Chrome Trace")) {
+        try {
+            export_chrome_trace("data/profile.json");
+            std::cout << "Exported the profiler's frames to 'data/profile.json'.\n";
+        } catch(const std::exception& exception) {
+            std::cerr << "Error exporting the profiler's frames: " << exception.what() << '\n';
+        }
+    }
+
+    /* ---- Frames ---- */
+    const size_t complete_frames_count = profiler.frames.size() - 1;
+    std::vector<float> durations(complete_frames_count);
+    for(size_t i = 0 ; i < complete_frames_count ; ++i) {
+        durations[i] = static_cast<float>(profiler.frames[i].end - profiler.frames[i].start) * 1e-6f;
+    }
+
+    ImGui::PlotHistogram("##Frames", durations.data(), durations.size(), 0, "Frame Durations (click to select)",
+                         0.0f, FLT_MAX, ImVec2(-1.0f, 60.0f));
+
+    if(ImGui::IsItemClicked() && complete_frames_count > 0) {
+        float ratio = (ImGui::GetMousePos().x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+        size_t frame = std::min(static_cast<size_t>(ratio * complete_frames_count), complete_frames_count - 1);
+        profiler.selected_frame = profiler.frames[frame].index;
+        profiler.is_paused = true;
+    }
+
+    /* ---- Flame Graph ---- */
+    const uint64_t first_frame = profiler.frames.front().index;
+    if(profiler.selected_frame >= first_frame && profiler.selected_frame - first_frame < complete_frames_count) {
+        profiler.draw_flame_graph(profiler.frames[profiler.selected_frame - first_frame]);
+    }
+
+    ImGui::End();
+}
+
+void Profiler::export_chrome_trace(const std::filesystem::path& path) {
+    Profiler& profiler = get();
+
+    std::ofstream file(path);
+    if(!file.is_open()) {
+        throw std::runtime_error("Failed to create trace '" + path.string() + "'.");
+    }
+
+    nlohmann::json events = nlohmann::json::array();
+
+    /* ---- Tracks ---- */
+    unsigned int gpu_track;
+    {
+        std::lock_guard lock(profiler.threads_mutex);
+
+        for(unsigned int i = 0 ; i < profiler.threads.size() ; ++i) {
+            events.push_back({
+                { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", i },
+                { "args", { { "name", profiler.threads[i]->name } } }
+            });
+        }
+
+        gpu_track = profiler.threads.size();
+        events.push_back({
+            { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", gpu_track }, { "args", { { "name", "GPU" } } }
+        });
+    }
+
+    /* ---- Zones ---- */
+    const int64_t origin = profiler.frames.front().start;
+    for(const Frame& frame : profiler.frames) {
+        for(const Event& event : frame.events) {
+            events.push_back({
+                { "name", event.name },
+                { "ph", "X" },
+                { "pid", 0 },
+                { "tid", event.track == GPU_TRACK ? gpu_track : event.track },
+                { "ts", static_cast<double>(event.start - origin) * 1e-3 },
+                { "dur", static_cast<double>(event.end - event.start) * 1e-3 }
+            });
+        }
+    }
+
+    file << nlohmann::json { { "traceEvents", events }, { "displayTimeUnit", "ms" } }.dump() << '\n';
+}
+
+int64_t Profiler::get_time() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadBuffer& Profiler::get_thread_buffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+
+    /* The buffers are owned by the profiler so that the zones of finished threads can still be read. */
+    if(buffer == nullptr) {
+        std::lock_guard lock(threads_mutex);
+        buffer = threads.emplace_back(std::make_unique<ThreadBuffer>()).get();
+        buffer->name = "Thread " + std::to_string(threads.size() - 1);
+    }
+
+    return *buffer;
+}
+
+void Profiler::read_gpu_zones() {
+    const uint64_t first_frame = frames.front().index;
+    size_t pending_count = 0;
+
+    for(PendingGPUZone& zone : gpu_zones) {
+        int is_available = GL_FALSE;
+        if(zone.is_closed) { glGetQueryObjectiv(zone.queries[1], GL_QUERY_RESULT_AVAILABLE, &is_available); }
+
+        if(is_available == GL_FALSE) {
+            gpu_zones[pending_count++] = zone;
+            continue;
+        }
+
+        uint64_t start, end;
+        glGetQueryObjectui64v(zone.queries[0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(zone.queries[1], GL_QUERY_RESULT, &end);
+        free_queries.insert(free_queries.end(), zone.queries.begin(), zone.queries.end());
+
+        /* The zone is dropped if its frame isn't kept anymore. */
+        if(zone.frame >= first_frame) {
+            frames[zone.frame - first_frame].events.emplace_back(zone.name,
+                                                                 static_cast<int64_t>(start) + gpu_time_offset,
+                                                                 static_cast<int64_t>(end) + gpu_time_offset,
+                                                                 zone.depth,
+                                                                 GPU_TRACK);
+        }
+    }
+
+    gpu_zones.resize(pending_count);
+}
+
+void Profiler::draw_flame_graph(const Frame& frame) const {
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    const float width = ImGui::GetContentRegionAvail().x;
+    const float row_height = ImGui::GetTextLineHeightWithSpacing();
+    const double duration = static_cast<double>(std::max<int64_t>(frame.end - frame.start, 1));
+
+    ImGui::Text("Frame %lu: %.3f ms", frame.index, duration * 1e-6);
+
+    /* Zones are drawn in the order of the tracks, the GPU being last. */
+    std::vector<unsigned int> tracks;
+    for(const Event& event : frame.events) {
+        if(std::ranges::find(tracks, event.track) == tracks.end()) { tracks.push_back(event.track); }
+    }
+    std::ranges::sort(tracks);
+
+    for(unsigned int track : tracks) {
+        if(track == GPU_TRACK) {
+            ImGui::TextUnformatted("GPU");
+        } else {
+            std::lock_guard lock(threads_mutex);
+            ImGui::TextUnformatted(threads[track]->name.c_str());
+        }
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        unsigned int depths_count = 0;
+
+        for(const Event& event : frame.events) {
+            if(event.track != track) { continue; }
+            depths_count = std::max(depths_count, event.depth + 1);
+
+            /* Zones of background threads can start before the frame. */
+            float start = static_cast<float>(std::clamp(static_cast<double>(event.start - frame.start) / duration, 0.0, 1.0));
+            float end = static_cast<float>(std::clamp(static_cast<double>(event.end - frame.start) / duration, 0.0, 1.0));
+
+            ImVec2 min(origin.x + start * width, origin.y + event.depth * row_height);
+            ImVec2 max(origin.x + std::max(end * width, start * width + 1.0f), min.y + row_height - 1.0f);
+
+            float hue = static_cast<float>(std::hash<std::string_view>()(event.name) % 360) / 360.0f;
+            draw_list->AddRectFilled(min, max, ImColor::HSV(hue, 0.5f, 0.7f));
+
+            draw_list->PushClipRect(min, max, true);
+            draw_list->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32_WHITE, event.name);
+            draw_list->PopClipRect();
+
+            if(ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s: %.3f ms", event.name, static_cast<double>(event.end - event.start) * 1e-6);
+            }
+        }
+
+        ImGui::Dummy(ImVec2(width, depths_count * row_height));
+    }
+}
@@ -9,13 +9,21 @@
 #include "imgui_internal.h"
 #include "imgui_stdlib.h"
 #include "assets/AssetManager.hpp"
+#include "assets/TextureResidencyManager.hpp"
+#include "assets/TextureStreamer.hpp"
+#include "assets/VirtualTextureSystem.hpp"
 #include "culling/Ray.hpp"
 #include "engine/EventHandler.hpp"
+#include "engine/FrameTimer.hpp"
 #include "engine/Node.hpp"
+#include "engine/Profiler.hpp"
 #include "engine/Window.hpp"
+#include "glad/glad.h"
 #include "maths/geometry.hpp"
 #include "mesh/primitives.hpp"
 
+#include <algorithm>
+
 bool is_mouse_hovering_imgui() {
     ImGuiContext* imgui_context = ImGui::GetCurrentContext();
     return imgui_context->HoveredWindow != nullptr
@@ -26,8 +34,18 @@ SceneGraph::SceneGraph()
     : are_AABBs_drawn(false),
       are_normals_drawn(false),
       is_wireframe_drawn(true),
+      is_camera_relative(false),
+      upload_budget_per_frame(32 * 1024 * 1024),
+      deduplicated_meshes_count(0),
+      deduplicated_meshes_size(0),
       light_node_index(INVALID_INDEX),
-      selected_node(INVALID_INDEX) {
+      selected_node(INVALID_INDEX),
+      joint_matrices_SSBO(0),
+      morph_ranges_SSBO(0),
+      morph_deltas_SSBO(0),
+      morph_weights_SSBO(0),
+      morph_blended_SSBO(0),
+      are_morph_deltas_uploaded(true) {
     /* ---- Asset Manager ---- */
     /* Meshes */
     AssetManager::add_mesh("sphere 8 16", create_sphere_mesh, 8, 16);
@@ -41,6 +59,7 @@ SceneGraph::SceneGraph()
     AssetManager::add_mesh("axes", create_axes_mesh, 0.5f);
     AssetManager::add_mesh("camera pyramid", create_pyramid_mesh,
                            vec3(1.0f, 1.0f, -1.0f), vec3(1.0f, -1.0f, -1.0f), vec3(-1.0f, -1.0f, -1.0f), 1.0f);
+    wireframe_cube_mesh = AssetManager::get_mesh_handle("wireframe cube");
 
     /* Textures */
     AssetManager::add_texture("default", vec3(1.0f));
@@ -54,7 +73,7 @@ SceneGraph::SceneGraph()
     /* ---- Light ---- */
     light_node_index = add_mesh_node("Light",
                                      0,
-                                     AssetManager::get_mesh_ptr("icosphere 1"),
+                                     AssetManager::get_mesh_handle("icosphere 1"),
                                      SHADER_FLAT);
     add_color_to_node(light_node_index, vec4(1.0f));
     transforms[light_node_index].set_local_position(0.0f, 10.0f, 0.0f);
@@ -93,9 +112,19 @@ SceneGraph::SceneGraph()
 
             /* Intersect Meshes */
             float distance = infinity;
+            std::vector<vec4> deformed_positions;
             for(std::size_t index : intersected_indices) {
-                float dist = meshes[nodes[index].drawable_index]
-                  ->intersect(ray, transforms[index].get_global_model_const_reference());
+                const Mesh& mesh = AssetManager::get_mesh(meshes[nodes[index].drawable_index]);
+                const affine3x4& model = transforms[index].get_global_model_const_reference();
+
+                float dist;
+                if(nodes[index].skin_index == INVALID_INDEX && nodes[index].morph_index == INVALID_INDEX) {
+                    dist = mesh.intersect(ray, model);
+                } else {
+                    get_deformed_positions(index, deformed_positions);
+                    dist = mesh.intersect(ray, model, deformed_positions);
+                }
+
                 if(dist > 0.0f && dist < distance) {
                     distance = dist;
                     selected_node = index;
@@ -107,25 +136,63 @@ SceneGraph::SceneGraph()
     });
 }
 
+SceneGraph::~SceneGraph() {
+    for(Handle<Mesh> mesh : meshes) { AssetManager::release(mesh); }
+    for(Handle<Material> material : materials) { AssetManager::release(material); }
+
+    if(joint_matrices_SSBO != 0) { glDeleteBuffers(1, &joint_matrices_SSBO); }
+    if(morph_ranges_SSBO != 0) { glDeleteBuffers(1, &morph_ranges_SSBO); }
+    if(morph_deltas_SSBO != 0) { glDeleteBuffers(1, &morph_deltas_SSBO); }
+    if(morph_weights_SSBO != 0) { glDeleteBuffers(1, &morph_weights_SSBO); }
+    if(morph_blended_SSBO != 0) { glDeleteBuffers(1, &morph_blended_SSBO); }
+}
+
 Node& SceneGraph::operator[](unsigned int node_index) { return nodes[node_index]; }
 
 void SceneGraph::draw(const Frustum& frustum) {
+    Profiler::Zone zone("SceneGraph::draw");
+    Profiler::GPUZone gpu_zone("SceneGraph::draw");
+
     total_drawn_objects = 0;
+    update_rendering_origin();
 
     const vec4& color = colors[nodes[light_node_index].color_index];
     light_color.x = color.x;
     light_color.y = color.y;
     light_color.z = color.z;
-    light_position = transforms[light_node_index].get_global_position();
+    light_position = is_camera_relative
+                     ? vec3(transforms[light_node_index].get_precise_global_position_const_reference() - rendering_origin)
+                     : transforms[light_node_index].get_global_position();
+
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_TRANSFORMS);
+        update_transform_and_children();
+        update_skins();
+        update_morphs();
+    }
 
-    update_transform_and_children();
-    update_AABBs();
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_AABBS);
+        update_AABBs();
+    }
 
-    draw(frustum, 0);
+    {
+        FrameTimer::Scope scope(FRAME_STAGE_CULLING);
+        visible_nodes.clear();
+        cull(frustum, 0);
+    }
+
+    FrameTimer::Scope scope(FRAME_STAGE_SUBMISSION);
+    for(unsigned int node_index : visible_nodes) { submit(frustum, node_index); }
 
-    if(selected_node != INVALID_INDEX && nodes[selected_node].type == Node::Type::MESH) {
-        mat4 mvp = frustum.view_projection * transforms[selected_node].get_global_model_const_reference();
-        const Mesh* mesh = meshes[nodes[selected_node].drawable_index];
+    if(selected_node != INVALID_INDEX
+       && nodes[selected_node].type == Node::Type::MESH
+       && AssetManager::get_mesh(meshes[nodes[selected_node].drawable_index]).are_buffers_bound()) {
+        const Transform& transform = transforms[selected_node];
+        mat4 mvp = is_camera_relative
+                   ? relative_view_projection * transform.compute_relative_global_model(rendering_origin)
+                   : frustum.view_projection * transform.get_global_model_const_reference();
+        const Mesh& mesh = AssetManager::get_mesh(meshes[nodes[selected_node].drawable_index]);
 
         if(are_normals_drawn) {
             static const Shader& normals_shader = AssetManager::get_shader(SHADER_NORMALS);
@@ -135,18 +202,30 @@ void SceneGraph::draw(const Frustum& frustum) {
             const AABB& aabb = AABBs[selected_node];
             float dist = 0.05f * std::log(10.0f * aabb.get_size()) * length(aabb.get_center() - camera.get_position());
             normals_shader.set_uniform("u_normal_length", dist * std::tan(camera.get_fov() * 0.5f));
-            mesh->draw_normals();
+            mesh.draw_normals();
         }
 
         if(is_wireframe_drawn && !EventHandler::is_wireframe_enabled()) {
             static const Shader& wireframe_shader = AssetManager::get_shader(SHADER_WIREFRAME);
             wireframe_shader.use();
             wireframe_shader.set_uniform("u_mvp", mvp);
-            mesh->draw_wireframe();
+            mesh.draw_wireframe();
         }
     }
 }
 
+void SceneGraph::draw_virtual_texture_feedback(const Frustum& frustum) {
+    static const Shader& feedback_shader = AssetManager::get_shader(SHADER_VIRTUAL_TEXTURE_FEEDBACK);
+    feedback_shader.use();
+    update_rendering_origin();
+
+    /* The derivatives are FEEDBACK_DOWNSCALE times larger at the feedback pass' resolution. */
+    feedback_shader.set_uniform("u_feedback_lod_bias",
+                                -std::log2(static_cast<float>(VirtualTextureSystem::FEEDBACK_DOWNSCALE)));
+
+    draw_virtual_texture_feedback(frustum, feedback_shader, 0);
+}
+
 unsigned int SceneGraph::add_simple_node(const std::string& name, unsigned int parent) {
     return add_node(name, parent, Node::Type::SIMPLE);
 }
@@ -165,11 +244,9 @@ unsigned int SceneGraph::add_mesh_node(const std::string& name,
 
 unsigned int SceneGraph::add_mesh_node(const std::string& name,
                                        unsigned int parent,
-                                       const Mesh* mesh,
+                                       Handle<Mesh> mesh,
                                        ShaderName shader_name) {
-    meshes.push_back(mesh);
-
-    return add_mesh_node(name, parent, meshes.size() - 1, shader_name);
+    return add_mesh_node(name, parent, add_mesh(mesh), shader_name);
 }
 
 unsigned int SceneGraph::add_gltf_scene_node(const std::string& name,
@@ -177,17 +254,129 @@ unsigned int SceneGraph::add_gltf_scene_node(const std::string& name,
                                              const std::filesystem::path& scene_path) {
     unsigned int index = add_node(name, parent, Node::Type::GLTF_SCENE);
 
-    gltf_scenes.emplace_back(scene_path, this, index);
+    gltf_scenes.push_back(std::make_unique<GLTF::Scene>(scene_path, this, index));
+    nodes[index].scene_index = gltf_scenes.size() - 1;
+
+    return index;
+}
+
+unsigned int SceneGraph::add_gltf_scene_node_async(const std::string& name,
+                                                   unsigned int parent,
+                                                   const std::filesystem::path& scene_path) {
+    unsigned int index = add_node(name, parent, Node::Type::GLTF_SCENE);
+
+    gltf_scenes.push_back(std::make_unique<GLTF::Scene>());
+    gltf_scenes.back()->load_async(scene_path, index);
     nodes[index].scene_index = gltf_scenes.size() - 1;
 
     return index;
 }
 
-unsigned int SceneGraph::add_mesh(const Mesh* mesh) {
+void SceneGraph::update_loading_scenes() {
+    Profiler::Zone zone("SceneGraph::update_loading_scenes");
+    size_t upload_budget = upload_budget_per_frame;
+
+    for(std::unique_ptr<GLTF::Scene>& scene : gltf_scenes) {
+        if(scene->is_loading()) { scene->update_loading(this, upload_budget); }
+    }
+
+    TextureStreamer::update(upload_budget);
+    VirtualTextureSystem::update(upload_budget);
+    TextureResidencyManager::update(upload_budget);
+}
+
+unsigned int SceneGraph::add_mesh(Handle<Mesh> mesh) {
+    AssetManager::acquire(mesh);
     meshes.push_back(mesh);
     return meshes.size() - 1;
 }
 
+Handle<Mesh> SceneGraph::find_duplicate_mesh(const Mesh& mesh, uint64_t content_hash) {
+    auto iterator = meshes_by_content.find(content_hash);
+    if(iterator == meshes_by_content.end()) { return Handle<Mesh>(); }
+
+    /* The meshes of the scene's glTF files keep their CPU data, so a hash collision is ruled out by
+     * comparing the bytes. A mesh that was released can't be reused. */
+    const Mesh* existing_mesh = AssetManager::get_mesh_ptr(iterator->second);
+    if(existing_mesh == nullptr) {
+        meshes_by_content.erase(iterator);
+        return Handle<Mesh>();
+    }
+    if(!existing_mesh->has_same_content(mesh)) { return Handle<Mesh>(); }
+
+    ++deduplicated_meshes_count;
+    deduplicated_meshes_size += mesh.get_buffers_size();
+
+    return iterator->second;
+}
+
+void SceneGraph::register_mesh_content(Handle<Mesh> mesh, uint64_t content_hash) {
+    meshes_by_content.emplace(content_hash, mesh);
+}
+
+unsigned int SceneGraph::add_skin(Skin&& skin) {
+    skin.palette_offset = joint_matrices.size();
+    joint_matrices.resize(joint_matrices.size() + skin.joints.size(), affine3x4(1.0f));
+    skins.push_back(std::move(skin));
+    return skins.size() - 1;
+}
+
+unsigned int SceneGraph::add_animation(Animation&& animation) {
+    animations.push_back(std::move(animation));
+    return animations.size() - 1;
+}
+
+void SceneGraph::update_animations(float delta) {
+    for(Animation& animation : animations) {
+        if(animation.is_playing) { animation.advance(delta); }
+    }
+
+    animation_sampler.sample(animations, transforms, morph_weights);
+}
+
+unsigned int SceneGraph::add_morph_weights(std::span<const float> weights) {
+    unsigned int weights_offset = morph_weights.size();
+    morph_weights.insert(morph_weights.end(), weights.begin(), weights.end());
+    return weights_offset;
+}
+
+unsigned int SceneGraph::add_morph(unsigned int node_index, const MorphTargets* targets, unsigned int weights_offset) {
+    const Mesh& mesh = AssetManager::get_mesh(meshes[nodes[node_index].drawable_index]);
+
+    morphs.emplace_back(targets, weights_offset, morph_ranges.size(), mesh.get_vertices_amount(), false, std::vector<float>());
+    targets->append_deltas_by_vertex(mesh.get_vertices_amount(), morph_ranges, morph_deltas);
+    morph_blended_deltas.resize(morph_ranges.size(), MorphDelta(vec4(0.0f), vec4(0.0f), vec4(0.0f)));
+    are_morph_deltas_uploaded = false;
+
+    nodes[node_index].morph_index = morphs.size() - 1;
+    return morphs.size() - 1;
+}
+
+void SceneGraph::get_deformed_positions(unsigned int node_index, std::vector<vec4>& positions) const {
+    const Node& node = nodes[node_index];
+    const Mesh& mesh = AssetManager::get_mesh(meshes[node.drawable_index]);
+
+    positions.resize(mesh.get_vertices_amount());
+    for(size_t i = 0 ; i < positions.size() ; ++i) {
+        positions[i] = vec4(vec3(mesh.get_attribute_value(ATTRIBUTE_POSITION, i)), 1.0f);
+    }
+
+    /* Like in the deformed shaders, the targets are applied before the skinning. */
+    if(node.morph_index != INVALID_INDEX) {
+        const Morph& morph = morphs[node.morph_index];
+        morph.targets->morph_positions(std::span(morph_weights).subspan(morph.weights_offset,
+                                                                        morph.targets->get_targets_count()),
+                                       positions);
+    }
+
+    if(node.skin_index != INVALID_INDEX) {
+        const Skin& skin = skins[node.skin_index];
+
+        picking_palette.set(std::span(joint_matrices).subspan(skin.palette_offset, skin.joints.size()));
+        picking_palette.skin_positions(mesh, positions);
+    }
+}
+
 unsigned int SceneGraph::add_color_to_node(unsigned int node_index, const vec4& color) {
     colors.push_back(color);
     unsigned int color_index = colors.size() - 1;
@@ -195,7 +384,8 @@ unsigned int SceneGraph::add_color_to_node(unsigned int node_index, const vec4&
     return color_index;
 }
 
-unsigned int SceneGraph::add_material_to_node(unsigned int node_index, Material* material) {
+unsigned int SceneGraph::add_material_to_node(unsigned int node_index, Handle<Material> material) {
+    AssetManager::acquire(material);
     materials.push_back(material);
     unsigned int material_index = materials.size() - 1;
     nodes[node_index].material_index = material_index;
@@ -225,7 +415,7 @@ void SceneGraph::add_object_editor_to_imgui_window() {
 
         if(ImGui::Checkbox("Is Object Visible", &node.is_visible)) { set_visibility(selected_node, node.is_visible); }
 
-        bool is_dirty = ImGui::DragFloat3("Local Position", &transform.get_local_position_reference().x);
+        bool is_dirty = ImGui::DragScalarN("Local Position", ImGuiDataType_Double, &transform.get_local_position_reference().x, 3);
 
         quaternion& orientation = transform.get_local_orientation_reference();
         if(ImGui::DragFloat4("Local Orientation", &orientation.x, 0.1f)) {
@@ -240,16 +430,16 @@ void SceneGraph::add_object_editor_to_imgui_window() {
         ImGui::NewLine();
         switch(node.type) {
             case Node::Type::MESH: {
-                const Mesh* mesh = meshes[node.drawable_index];
+                const Mesh& mesh = AssetManager::get_mesh(meshes[node.drawable_index]);
                 ImGui::Text("Mesh: %zu vertices, %zu indices, attributes:",
-                            mesh->get_vertices_amount(),
-                            mesh->get_indices_amount());
+                            mesh.get_vertices_amount(),
+                            mesh.get_indices_amount());
                 for(unsigned int i = 0 ; i < ATTRIBUTE_AMOUNT ; ++i) {
                     Attribute attribute = static_cast<Attribute>(i);
-                    if(mesh->has_attribute(attribute)) {
+                    if(mesh.has_attribute(attribute)) {
                         ImGui::Text(" - %s (%s)",
                                     attribute_to_string(attribute).c_str(),
-                                    attribute_type_to_string(mesh->get_attribute_type(attribute)).c_str());
+                                    attribute_type_to_string(mesh.get_attribute_type(attribute)).c_str());
                     }
                 }
                 break;
@@ -262,7 +452,7 @@ void SceneGraph::add_object_editor_to_imgui_window() {
             ImGui::Text("Shader: '%s'", AssetManager::get_shader(node.shader_name).get_name().c_str());
         }
         if(node.color_index != INVALID_INDEX) { ImGui::ColorEdit4("Color", &colors[node.color_index].x); }
-        if(node.material_index != INVALID_INDEX) { materials[node.material_index]->add_to_object_editor(); }
+        if(node.material_index != INVALID_INDEX) { AssetManager::get_material(materials[node.material_index]).add_to_object_editor(); }
     } else {
         ImGui::Text("No Node is Selected");
     }
@@ -282,77 +472,130 @@ void SceneGraph::set_is_selected(unsigned int node_index, bool is_selected) {
     }
 }
 
-void SceneGraph::draw(const Frustum& frustum, unsigned int node_index) {
+void SceneGraph::cull(const Frustum& frustum, unsigned int node_index) {
     const Node& node = nodes[node_index];
 
-    if(!node.is_visible) { return; }
+    if(!node.is_visible || !AABBs[node_index].is_in_frustum(frustum)) { return; }
 
-    if(AABBs[node_index].is_in_frustum(frustum)) {
-        if(node.drawable_index != INVALID_INDEX) {
-            ++total_drawn_objects;
-            draw(frustum.view_projection, AssetManager::get_shader(node.shader_name), node_index);
-        }
+    visible_nodes.push_back(node_index);
+    for(unsigned int index : node.children) { cull(frustum, index); }
+}
 
-        if(are_AABBs_drawn || node.is_selected) {
-            const Shader& shader = AssetManager::get_shader(SHADER_FLAT);
-            shader.use();
-            shader.set_uniform("u_mvp", frustum.view_projection * AABBs[node_index].get_global_model_matrix());
+void SceneGraph::submit(const Frustum& frustum, unsigned int node_index) {
+    const Node& node = nodes[node_index];
 
-            if(node.is_selected) {
-                if(node.parent == INVALID_INDEX || !nodes[node.parent].is_selected) {
-                    shader.set_uniform("u_color", vec4(0.0f, 1.0f, 1.0f, 1.0f));
-                } else {
-                    shader.set_uniform("u_color", vec4(0.0f, 0.0f, 1.0f, 1.0f));
-                }
-            } else if(node.drawable_index == INVALID_INDEX) { // Not a drawable node.
-                shader.set_uniform("u_color", vec4(0.0f, 1.0f, 0.0f, 1.0f));
+    // Meshes of scenes that are still loading don't have buffers yet.
+    if(node.drawable_index != INVALID_INDEX && AssetManager::get_mesh(meshes[node.drawable_index]).are_buffers_bound()) {
+        ++total_drawn_objects;
+        draw(frustum.view_projection, AssetManager::get_shader(node.shader_name), node_index);
+    }
+
+    if(are_AABBs_drawn || node.is_selected) {
+        const Shader& shader = AssetManager::get_shader(SHADER_FLAT);
+        shader.use();
+        mat4 model = AABBs[node_index].get_global_model_matrix();
+        if(is_camera_relative) {
+            model(0, 3) = static_cast<float>(model(0, 3) - rendering_origin.x);
+            model(1, 3) = static_cast<float>(model(1, 3) - rendering_origin.y);
+            model(2, 3) = static_cast<float>(model(2, 3) - rendering_origin.z);
+        }
+        shader.set_uniform("u_mvp", (is_camera_relative ? relative_view_projection : frustum.view_projection) * model);
+
+        if(node.is_selected) {
+            if(node.parent == INVALID_INDEX || !nodes[node.parent].is_selected) {
+                shader.set_uniform("u_color", vec4(0.0f, 1.0f, 1.0f, 1.0f));
             } else {
-                shader.set_uniform("u_color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
+                shader.set_uniform("u_color", vec4(0.0f, 0.0f, 1.0f, 1.0f));
             }
-
-            glLineWidth(3.0f);
-            AssetManager::get_mesh("wireframe cube").draw();
-            glLineWidth(1.0f);
+        } else if(node.drawable_index == INVALID_INDEX) { // Not a drawable node.
+            shader.set_uniform("u_color", vec4(0.0f, 1.0f, 0.0f, 1.0f));
+        } else {
+            shader.set_uniform("u_color", vec4(1.0f, 0.0f, 0.0f, 1.0f));
         }
 
-        for(unsigned int index : node.children) { draw(frustum, index); }
+        glLineWidth(3.0f);
+        AssetManager::get_mesh(wireframe_cube_mesh).draw();
+        glLineWidth(1.0f);
+    }
+}
+
+void SceneGraph::draw_virtual_texture_feedback(const Frustum& frustum,
+                                               const Shader& shader,
+                                               unsigned int node_index) const {
+    const Node& node = nodes[node_index];
+
+    if(!node.is_visible || !AABBs[node_index].is_in_frustum(frustum)) { return; }
+
+    /* Every mesh is drawn so that the depth test hides the pages of occluded surfaces, but only the
+     * materials with virtual textures are bound and write the pages they need. */
+    if(node.drawable_index != INVALID_INDEX && AssetManager::get_mesh(meshes[node.drawable_index]).are_buffers_bound()) {
+        const bool has_virtual_textures = node.material_index != INVALID_INDEX
+                                          && AssetManager::get_material(materials[node.material_index]).has_virtual_textures();
+        if(!has_virtual_textures) { shader.set_uniform("u_is_base_color_virtual", false); }
+        draw(frustum.view_projection, shader, node_index, has_virtual_textures);
     }
+
+    for(unsigned int index : node.children) { draw_virtual_texture_feedback(frustum, shader, index); }
 }
 
-void SceneGraph::draw(const mat4& view_projection, const Shader& shader, unsigned int node_index) const {
+void SceneGraph::draw(const mat4& view_projection, const Shader& shader, unsigned int node_index, bool is_material_bound) const {
     const Node& node = nodes[node_index];
 
     shader.use();
 
-    const mat4& global_model = transforms[node_index].get_global_model_const_reference();
-    shader.set_uniform_if_exists("u_model", global_model);
+    /* In the camera relative mode, the camera is at the origin so only small translations reach the
+     * shaders, computed in double precision. */
+    const Transform& transform = transforms[node_index];
+    affine3x4 global_model = is_camera_relative
+                             ? transform.compute_relative_global_model(rendering_origin)
+                             : transform.get_global_model_const_reference();
+    shader.set_uniform_if_exists("u_model", global_model.to_mat4());
 
     int u_mvp_location = shader.get_uniform_location("u_mvp");
     if(u_mvp_location != -1) {
-        Shader::set_uniform(u_mvp_location, view_projection * global_model);
+        Shader::set_uniform(u_mvp_location,
+                            (is_camera_relative ? relative_view_projection : view_projection) * global_model);
     }
 
     int u_normals_model_matrix_location = shader.get_uniform_location("u_normals_model_matrix");
     if(u_normals_model_matrix_location != -1) {
-        Shader::set_uniform(u_normals_model_matrix_location, transpose_inverse(global_model));
+        Shader::set_uniform(u_normals_model_matrix_location, transform.get_normals_model_const_reference());
     }
 
     shader.set_uniform_if_exists("u_light.intensity", 3.0f);
     shader.set_uniform_if_exists("u_light.color", light_color);
     shader.set_uniform_if_exists("u_light.position", light_position);
-    shader.set_uniform_if_exists("u_camera_position", EventHandler::get_active_camera()->get_position());
+    shader.set_uniform_if_exists("u_camera_position",
+                                 is_camera_relative ? vec3(0.0f) : EventHandler::get_active_camera()->get_position());
 
     if(node.color_index != INVALID_INDEX) { shader.set_uniform_if_exists("u_color", colors[node.color_index]); }
-    if(node.material_index != INVALID_INDEX) { materials[node.material_index]->update_shader_uniforms(&shader); }
+    if(is_material_bound && node.material_index != INVALID_INDEX) {
+        AssetManager::get_material(materials[node.material_index]).update_shader_uniforms(&shader);
+    }
+
+    /* The deformed shaders are shared by skinned and morphed nodes, so both offsets are always set. */
+    shader.set_uniform_if_exists("u_joint_offset",
+                                 node.skin_index == INVALID_INDEX ? INVALID_INDEX : skins[node.skin_index].palette_offset);
+    shader.set_uniform_if_exists("u_morph_ranges_offset",
+                                 node.morph_index == INVALID_INDEX ? INVALID_INDEX : morphs[node.morph_index].ranges_offset);
+    shader.set_uniform_if_exists("u_morph_weights_offset",
+                                 node.morph_index == INVALID_INDEX ? INVALID_INDEX : morphs[node.morph_index].weights_offset);
+    shader.set_uniform_if_exists("u_is_morph_blended", node.morph_index != INVALID_INDEX && morphs[node.morph_index].is_blended);
 
     switch(node.type) {
         case Node::Type::MESH:
-            meshes[node.drawable_index]->draw();
+            AssetManager::get_mesh(meshes[node.drawable_index]).draw();
             break;
         default: break;
     }
 }
 
+void SceneGraph::update_rendering_origin() {
+    const Camera& camera = *EventHandler::get_active_camera();
+    rendering_origin = camera.get_precise_position();
+    relative_view_projection = camera.get_relative_view_projection_matrix();
+}
+
 void SceneGraph::update_transform_and_children(unsigned int node_index) {
     if(transforms[node_index].is_local_model_dirty()) {
         force_update_transform_and_children(node_index);
@@ -366,7 +609,7 @@ void SceneGraph::update_transform_and_children(unsigned int node_index) {
 void SceneGraph::force_update_transform_and_children(unsigned int node_index) {
     Node& node = nodes[node_index];
     if(nodes[node_index].parent != INVALID_INDEX) {
-        transforms[node_index].update_global_model(transforms[node.parent].get_global_model_const_reference());
+        transforms[node_index].update_global_model(transforms[node.parent]);
     } else {
         transforms[node_index].update_global_model();
     }
@@ -383,9 +626,35 @@ void SceneGraph::update_AABBs(unsigned int node_index) {
     vec3 max(std::numeric_limits<float>::lowest());
 
     switch(nodes[node_index].type) {
-        case Node::Type::MESH:
-            AABBs[node_index].set(meshes[nodes[node_index].drawable_index]->get_AABB(), transforms[node_index]);
+        case Node::Type::MESH: {
+            const Node& node = nodes[node_index];
+            AABB mesh_AABB = AssetManager::get_mesh(meshes[node.drawable_index]).get_AABB();
+
+            if(node.morph_index != INVALID_INDEX) {
+                const Morph& morph = morphs[node.morph_index];
+                mesh_AABB = morph.targets->get_AABB(mesh_AABB,
+                                                    std::span(morph_weights).subspan(morph.weights_offset,
+                                                                                     morph.targets->get_targets_count()));
+            }
+
+            if(node.skin_index == INVALID_INDEX) {
+                AABBs[node_index].set(mesh_AABB, transforms[node_index]);
+                break;
+            }
+
+            /* Skinned vertices are weighted averages of the vertex transformed by each of its joints,
+             * so they stay in the union of the mesh's AABB transformed by every joint matrix. */
+            const Skin& skin = skins[node.skin_index];
+            const affine3x4& model = transforms[node_index].get_global_model_const_reference();
+            AABB joint_AABB;
+            for(size_t j = 0 ; j < skin.joints.size() ; ++j) {
+                joint_AABB.set(mesh_AABB, model * joint_matrices[skin.palette_offset + j]);
+                AABB::axis_aligned_min(min, joint_AABB.min_point);
+                AABB::axis_aligned_max(max, joint_AABB.max_point);
+            }
+            AABBs[node_index].set(min, max);
             break;
+        }
         case Node::Type::SIMPLE:
         case Node::Type::GLTF_SCENE:
             for(unsigned int index : nodes[node_index].children) {
@@ -397,6 +666,85 @@ void SceneGraph::update_AABBs(unsigned int node_index) {
     }
 }
 
+void SceneGraph::update_skins() {
+    if(skins.empty()) { return; }
+
+    for(const Skin& skin : skins) {
+        const affine3x4& inverse_mesh_model = transforms[skin.mesh_node].get_inverse_global_model_const_reference();
+
+        for(size_t j = 0 ; j < skin.joints.size() ; ++j) {
+            joint_matrices[skin.palette_offset + j] = inverse_mesh_model
+                                                      * transforms[skin.joints[j]].get_global_model_const_reference()
+                                                      * skin.inverse_bind_matrices[j];
+        }
+    }
+
+    /* The palettes of every skin are uploaded at once, the skinned shaders index them with an
+     * offset. Respecifying the storage orphans the previous frame's, which may still be in use.
+     * Only the 3 rows of each matrix are uploaded, which the shaders read as a mat3x4. */
+    if(joint_matrices_SSBO == 0) { glGenBuffers(1, &joint_matrices_SSBO); }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, joint_matrices_SSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, joint_matrices.size() * sizeof(affine3x4), joint_matrices.data(), GL_STREAM_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, JOINT_MATRICES_BINDING, joint_matrices_SSBO);
+}
+
+void SceneGraph::update_morphs() {
+    if(morphs.empty()) { return; }
+
+    /* The deltas only change when morphs are added, the weights are animated. */
+    if(!are_morph_deltas_uploaded) {
+        if(morph_ranges_SSBO == 0) { glGenBuffers(1, &morph_ranges_SSBO); }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, morph_ranges_SSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, morph_ranges.size() * sizeof(uvec2), morph_ranges.data(), GL_STATIC_DRAW);
+
+        if(morph_deltas_SSBO == 0) { glGenBuffers(1, &morph_deltas_SSBO); }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, morph_deltas_SSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, morph_deltas.size() * sizeof(MorphDelta), morph_deltas.data(), GL_STATIC_DRAW);
+
+        if(morph_blended_SSBO == 0) { glGenBuffers(1, &morph_blended_SSBO); }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, morph_blended_SSBO);
+        glBufferData(GL_SHADER_STORAGE_BUFFER,
+                     morph_blended_deltas.size() * sizeof(MorphDelta),
+                     morph_blended_deltas.data(),
+                     GL_DYNAMIC_DRAW);
+
+        are_morph_deltas_uploaded = true;
+    }
+
+    /* ---- CPU blending ---- */
+    /* With few active targets, blending once per vertex on the CPU is cheaper than having the vertex
+     * shaders go through every target of every vertex each frame, and it only needs an upload when
+     * the weights change. */
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, morph_blended_SSBO);
+    for(Morph& morph : morphs) {
+        std::span<const float> weights = std::span(morph_weights).subspan(morph.weights_offset,
+                                                                           morph.targets->get_targets_count());
+        morph.is_blended = std::ranges::count_if(weights, [](float weight) { return weight != 0.0f; })
+                           <= static_cast<std::ptrdiff_t>(CPU_MORPH_MAX_ACTIVE_TARGETS);
+        if(!morph.is_blended || std::ranges::equal(weights, morph.blended_weights)) { continue; }
+
+        std::span<MorphDelta> deltas = std::span(morph_blended_deltas).subspan(morph.ranges_offset, morph.vertices_count);
+        uvec2 range = morph.targets->blend_deltas(weights, deltas);
+        morph.blended_weights.assign(weights.begin(), weights.end());
+
+        if(range.y > range.x) {
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                            (morph.ranges_offset + range.x) * sizeof(MorphDelta),
+                            (range.y - range.x) * sizeof(MorphDelta),
+                            deltas.data() + range.x);
+        }
+    }
+
+    if(morph_weights_SSBO == 0) { glGenBuffers(1, &morph_weights_SSBO); }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, morph_weights_SSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, morph_weights.size() * sizeof(float), morph_weights.data(), GL_STREAM_DRAW);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MORPH_RANGES_BINDING, morph_ranges_SSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MORPH_DELTAS_BINDING, morph_deltas_SSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MORPH_WEIGHTS_BINDING, morph_weights_SSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MORPH_BLENDED_BINDING, morph_blended_SSBO);
+}
+
 unsigned int SceneGraph::add_node(const std::string& name, unsigned int parent, Node::Type type) {
     nodes.emplace_back(name, parent, type);
     transforms.emplace_back();
@@ -109,6 +109,14 @@ Window::Window()
     /* ---- GLFW ---- */
     glfwSetErrorCallback(glfw_error_callback);
 
+    if(b_is_headless) {
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        throw std::runtime_error("Headless rendering needs GLFW 3.4 or newer.");
+#endif
+    }
+
     if(!glfwInit()) {
         throw std::runtime_error("Failed to initialize GLFW.");
     }
@@ -117,7 +125,20 @@ Window::Window()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    window = glfwCreateWindow(1920, 1080, "Projet Stage L3", nullptr, nullptr);
+    if(b_is_headless) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        window = glfwCreateWindow(headless_width, headless_height, "Projet Stage L3", nullptr, nullptr);
+
+        /* Falls back to Mesa's software rasterizer when there is no EGL driver. */
+        if(window == nullptr) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+            window = glfwCreateWindow(headless_width, headless_height, "Projet Stage L3", nullptr, nullptr);
+        }
+    } else {
+        window = glfwCreateWindow(1920, 1080, "Projet Stage L3", nullptr, nullptr);
+    }
+
     if(window == nullptr) {
         throw std::runtime_error("Failed to create window.");
     }
@@ -125,7 +146,7 @@ Window::Window()
     glfwMakeContextCurrent(window);
     // glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-    glfwMaximizeWindow(window);
+    if(!b_is_headless) { glfwMaximizeWindow(window); }
     glfwGetWindowSize(window, &width, &height);
 
     /* ---- GLAD ---- */
@@ -138,6 +159,7 @@ Window::Window()
 
     glEnable(GL_CULL_FACE);
     glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LEQUAL);
@@ -164,6 +186,16 @@ Window::~Window() {
     glfwTerminate();
 }
 
+void Window::set_headless(int width, int height) {
+    b_is_headless = true;
+    headless_width = width;
+    headless_height = height;
+}
+
+bool Window::is_headless() {
+    return b_is_headless;
+}
+
 GLFWwindow* Window::get_glfw() {
     return get().window;
 }
@@ -197,5 +229,6 @@ bool Window::should_close() {
 }
 
 void Window::swap_buffers() {
+    if(b_is_headless) { return; }
     glfwSwapBuffers(get_glfw());
 }
@@ -3,22 +3,173 @@
  * @brief Contains the main program of the project
  **************************************************************************************************/
 
+#include <cstdio>
 #include <iostream>
+#include <string>
 #include "applications/Application.hpp"
 #include "assets/AssetManager.hpp"
 #include "engine/EventHandler.hpp"
+#include "engine/Profiler.hpp"
 #include "engine/Window.hpp"
 
-int main() {
+static constexpr const char* USAGE =
+    "Usage: OpenGL-Engine [--trace <trace.json>]\n"
+    "       OpenGL-Engine --headless <scene> [--size <width>x<height>] [--camera <x>,<y>,<z>]\n"
+    "                     [--target <x>,<y>,<z>] [--frames <count>] [--delta <seconds>] [--output <prefix>]\n"
+    "       OpenGL-Engine --benchmark <scene> --path <camera path> [--size <width>x<height>]\n"
+    "                     [--delta <seconds>] [--warmup <count>] [--report <prefix>]\n"
+    "                     [--baseline <report.json>] [--threshold <ratio>]\n"
+    "Passing --size to the benchmark runs it headless. Passing --trace to any mode records the\n"
+    "profiler's zones and writes them to a Chrome trace when it exits.";
+
+/**
+ * @enum Mode
+ * @brief What the program does.
+ */
+enum class Mode : unsigned char {
+    INTERACTIVE, ///< Opens a window and runs the application.
+    HEADLESS,    ///< Renders frames offscreen to PNG files.
+    BENCHMARK    ///< Benchmarks a scene along a camera path.
+};
+
+/**
+ * @struct Arguments
+ * @brief The parsed command line arguments.
+ */
+struct Arguments {
+    Mode mode;                            ///< What the program does.
+    bool is_headless;                     ///< Whether the window is headless.
+    int width;                            ///< The width of the headless window.
+    int height;                           ///< The height of the headless window.
+    OffscreenSettings offscreen_settings; ///< The settings of the headless mode.
+    BenchmarkSettings benchmark_settings; ///< The settings of the benchmark mode.
+    std::string trace_path;               ///< Where the profiler's trace is written, empty if it isn't enabled.
+};
+
+/**
+ * @brief Parses the command line arguments.
+ * @param argc The amount of arguments.
+ * @param argv The arguments.
+ * @return The parsed arguments.
+ */
+static Arguments parse_arguments(int argc, char** argv) {
+    Arguments arguments {
+        .mode = Mode::INTERACTIVE,
+        .is_headless = false,
+        .width = 1280,
+        .height = 720,
+        .offscreen_settings = {
+            .scene_path = "",
+            .camera_position = vec3(10.0f, 10.0f, 10.0f),
+            .camera_target = vec3(0.0f),
+            .frames_count = 1,
+            .frame_delta = 1.0f / 60.0f,
+            .output_prefix = "frame"
+        },
+        .benchmark_settings = {
+            .scene_path = "",
+            .camera_path = "",
+            .frame_delta = 1.0f / 60.0f,
+            .warmup_frames_count = 60,
+            .report_prefix = "",
+            .baseline_path = "",
+            .threshold = 0.1f
+        },
+        .trace_path = ""
+    };
+
+    OffscreenSettings& offscreen = arguments.offscreen_settings;
+    BenchmarkSettings& benchmark = arguments.benchmark_settings;
+
+    for(int i = 1 ; i < argc ; ++i) {
+        std::string argument = argv[i];
+        if(i + 1 == argc) { throw std::runtime_error("Missing value for '" + argument + "'.\n" + USAGE); }
+        const char* value = argv[++i];
+
+        bool is_valid = true;
+        if(argument == "--headless") {
+            arguments.mode = Mode::HEADLESS;
+            arguments.is_headless = true;
+            offscreen.scene_path = value;
+        } else if(argument == "--benchmark") {
+            arguments.mode = Mode::BENCHMARK;
+            benchmark.scene_path = value;
+        } else if(argument == "--size") {
+            arguments.is_headless = true;
+            is_valid = std::sscanf(value, "%dx%d", &arguments.width, &arguments.height) == 2
+                       && arguments.width > 0 && arguments.height > 0;
+        } else if(argument == "--camera") {
+            vec3& position = offscreen.camera_position;
+            is_valid = std::sscanf(value, "%f,%f,%f", &position.x, &position.y, &position.z) == 3;
+        } else if(argument == "--target") {
+            vec3& target = offscreen.camera_target;
+            is_valid = std::sscanf(value, "%f,%f,%f", &target.x, &target.y, &target.z) == 3;
+        } else if(argument == "--frames") {
+            is_valid = std::sscanf(value, "%u", &offscreen.frames_count) == 1;
+        } else if(argument == "--delta") {
+            is_valid = std::sscanf(value, "%f", &offscreen.frame_delta) == 1 && offscreen.frame_delta > 0.0f;
+            benchmark.frame_delta = offscreen.frame_delta;
+        } else if(argument == "--output") {
+            offscreen.output_prefix = value;
+        } else if(argument == "--path") {
+            benchmark.camera_path = value;
+        } else if(argument == "--warmup") {
+            is_valid = std::sscanf(value, "%u", &benchmark.warmup_frames_count) == 1;
+        } else if(argument == "--report") {
+            benchmark.report_prefix = value;
+        } else if(argument == "--baseline") {
+            benchmark.baseline_path = value;
+        } else if(argument == "--threshold") {
+            is_valid = std::sscanf(value, "%f", &benchmark.threshold) == 1;
+        } else if(argument == "--trace") {
+            arguments.trace_path = value;
+        } else {
+            throw std::runtime_error("Unknown argument '" + argument + "'.\n" + USAGE);
+        }
+
+        if(!is_valid) { throw std::runtime_error("Invalid value for '" + argument + "'.\n" + USAGE); }
+    }
+
+    if(arguments.mode == Mode::INTERACTIVE && argc > (arguments.trace_path.empty() ? 1 : 3)) {
+        throw std::runtime_error(std::string("Missing mode.\n") + USAGE);
+    }
+    if(arguments.mode == Mode::BENCHMARK && benchmark.camera_path.empty()) {
+        throw std::runtime_error(std::string("Missing camera path.\n") + USAGE);
+    }
+
+    return arguments;
+}
+
+int main(int argc, char** argv) {
     try {
+        Arguments arguments = parse_arguments(argc, argv);
+        if(arguments.is_headless) { Window::set_headless(arguments.width, arguments.height); }
+
         /* Making Sure Singletons are Initialized First */
         Window::get();
         EventHandler::get();
         AssetManager::get();
 
+        /* The profiler is only enabled on demand, it would skew the benchmarks otherwise. */
+        if(!arguments.trace_path.empty()) { Profiler::set_enabled(true); }
+
         /* Running Application */
         Application app;
-        app.run();
+        bool is_passing = true;
+        switch(arguments.mode) {
+            case Mode::INTERACTIVE:
+                app.run();
+                break;
+            case Mode::HEADLESS:
+                app.render_offscreen(arguments.offscreen_settings);
+                break;
+            case Mode::BENCHMARK:
+                is_passing = app.run_benchmark(arguments.benchmark_settings);
+                break;
+        }
+
+        if(!arguments.trace_path.empty()) { Profiler::export_chrome_trace(arguments.trace_path); }
+        if(!is_passing) { return 1; }
     } catch(const std::exception& exception) {
         std::cerr << "ERROR : " << exception.what() << '\n';
         return -1;
@@ -5,6 +5,8 @@
 
 #include "materials/MRMaterial.hpp"
 
+#include "assets/AssetManager.hpp"
+#include "assets/VirtualTextureSystem.hpp"
 #include "imgui.h"
 
 MRMaterial::MRMaterial(const std::string& name)
@@ -14,10 +16,29 @@ MRMaterial::MRMaterial(const std::string& name)
       reflectance(0.5f) // Index of Refraction = 1.5f, 4% reflectance
 { }
 
+MRMaterial::~MRMaterial() {
+    for(Handle<Texture> map : { base_color_map, metallic_roughness_map, normal_map }) {
+        if(map.is_valid()) { AssetManager::release(map); }
+    }
+}
+
+void MRMaterial::set_map(Handle<Texture> MRMaterial::* map, Handle<Texture> texture) {
+    /* Acquired first, in case it is the same texture. */
+    AssetManager::acquire(texture);
+    if((this->*map).is_valid()) { AssetManager::release(this->*map); }
+    this->*map = texture;
+}
+
 void MRMaterial::update_shader_uniforms(const Shader* shader) const {
-    base_color_map.bind(0);
-    metallic_roughness_map.bind(1);
-    normal_map.bind(2);
+    const Texture& base_color_texture = AssetManager::get_texture(base_color_map);
+    if(base_color_texture.is_virtual()) {
+        VirtualTextureSystem::bind(base_color_texture.get_virtual_texture_index(), shader);
+    } else {
+        base_color_texture.bind(0);
+        shader->set_uniform_if_exists("u_is_base_color_virtual", false);
+    }
+    AssetManager::get_texture(metallic_roughness_map).bind(1);
+    AssetManager::get_texture(normal_map).bind(2);
 
     shader->set_uniform_if_exists("u_base_color", base_color);
     shader->set_uniform_if_exists("u_metallic", metallic);
@@ -26,15 +47,19 @@ void MRMaterial::update_shader_uniforms(const Shader* shader) const {
 }
 
 bool MRMaterial::has_transparency() const {
-    return base_color.w < 1.0f || base_color_map.has_transparency();
+    return base_color.w < 1.0f || AssetManager::get_texture(base_color_map).has_transparency();
+}
+
+bool MRMaterial::has_virtual_textures() const {
+    return AssetManager::get_texture(base_color_map).is_virtual();
 }
 
 void MRMaterial::add_to_object_editor() {
-    ImGui::Image(base_color_map.get_id(), ImVec2(128.0f, 128.0f));
+    ImGui::Image(AssetManager::get_texture(base_color_map).get_id(), ImVec2(128.0f, 128.0f));
     ImGui::SameLine();
-    ImGui::Image(metallic_roughness_map.get_id(), ImVec2(128.0f, 128.0f));
+    ImGui::Image(AssetManager::get_texture(metallic_roughness_map).get_id(), ImVec2(128.0f, 128.0f));
     ImGui::SameLine();
-    ImGui::Image(normal_map.get_id(), ImVec2(128.0f, 128.0f));
+    ImGui::Image(AssetManager::get_texture(normal_map).get_id(), ImVec2(128.0f, 128.0f));
     ImGui::ColorEdit4("base_color", &base_color.x);
     ImGui::SliderFloat("Metallic", &metallic, 0.0f, 1.0f);
     ImGui::SliderFloat("Roughness", &roughness, 0.0f, 1.0f);
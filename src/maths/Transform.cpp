@@ -10,18 +10,26 @@
 #include "maths/geometry.hpp"
 
 Transform::Transform()
-    : local_position(0.0f),
+    : local_position(0.0),
       local_orientation(0.0f, 0.0f, 0.0f, 1.0f),
       local_scale(1.0f),
       is_dirty(true),
-      global_model(1.0f) { }
+      global_model(1.0f),
+      inverse_global_model(1.0f),
+      normals_model(1.0f),
+      global_position(0.0) { }
 
 void Transform::set_local_position(const vec3& position) {
+    local_position = dvec3(position);
+    is_dirty = true;
+}
+
+void Transform::set_local_position(const dvec3& position) {
     local_position = position;
     is_dirty = true;
 }
 
-void Transform::set_local_position(float x, float y, float z) {
+void Transform::set_local_position(double x, double y, double z) {
     local_position.x = x;
     local_position.y = y;
     local_position.z = z;
@@ -116,11 +124,11 @@ void Transform::set_local_model_to_dirty() {
     is_dirty = true;
 }
 
-vec3 Transform::get_local_position() const {
+dvec3 Transform::get_local_position() const {
     return local_position;
 }
 
-vec3& Transform::get_local_position_reference() {
+dvec3& Transform::get_local_position_reference() {
     return local_position;
 }
 
@@ -140,22 +148,42 @@ vec3& Transform::get_local_scale_reference() {
     return local_scale;
 }
 
-mat4 Transform::compute_local_model() const {
-    return TRS_matrix(local_position, local_orientation, local_scale);
+affine3x4 Transform::compute_local_model() const {
+    return affine_TRS_matrix(vec3(local_position), local_orientation, local_scale);
 }
 
-mat4 Transform::get_global_model() const {
+affine3x4 Transform::get_global_model() const {
     return global_model;
 }
 
-const mat4& Transform::get_global_model_const_reference() const {
+const affine3x4& Transform::get_global_model_const_reference() const {
     return global_model;
 }
 
+const affine3x4& Transform::get_inverse_global_model_const_reference() const {
+    return inverse_global_model;
+}
+
+const mat3& Transform::get_normals_model_const_reference() const {
+    return normals_model;
+}
+
 vec3 Transform::get_global_position() const {
     return vec3(global_model(0, 3), global_model(1, 3), global_model(2, 3));
 }
 
+const dvec3& Transform::get_precise_global_position_const_reference() const {
+    return global_position;
+}
+
+affine3x4 Transform::compute_relative_global_model(const dvec3& origin) const {
+    affine3x4 model = global_model;
+    model(0, 3) = static_cast<float>(global_position.x - origin.x);
+    model(1, 3) = static_cast<float>(global_position.y - origin.y);
+    model(2, 3) = static_cast<float>(global_position.z - origin.z);
+    return model;
+}
+
 vec3 Transform::get_global_scale() const {
     return vec3(length(get_right_vector()), length(get_up_vector()), length(get_front_vector()));
 }
@@ -178,10 +206,32 @@ bool Transform::is_local_model_dirty() const {
 
 void Transform::update_global_model() {
     global_model = compute_local_model();
+    global_position = local_position;
+    update_inverse_global_model();
     is_dirty = false;
 }
 
-void Transform::update_global_model(const mat4& parent_global_model) {
-    global_model = parent_global_model * compute_local_model();
+void Transform::update_global_model(const Transform& parent) {
+    const affine3x4& parent_model = parent.global_model;
+    global_model = parent_model * compute_local_model();
+
+    /* The translation is also computed in double precision, from the parent's, so that it doesn't
+     * lose precision far from the origin. */
+    global_position = parent.global_position + dvec3(
+        parent_model(0, 0) * local_position.x + parent_model(0, 1) * local_position.y + parent_model(0, 2) * local_position.z,
+        parent_model(1, 0) * local_position.x + parent_model(1, 1) * local_position.y + parent_model(1, 2) * local_position.z,
+        parent_model(2, 0) * local_position.x + parent_model(2, 1) * local_position.y + parent_model(2, 2) * local_position.z
+    );
+
+    update_inverse_global_model();
     is_dirty = false;
 }
+
+void Transform::update_inverse_global_model() {
+    inverse_global_model = affine_inverse(global_model);
+
+    /* The inverse of the upper left 3x3 matrix is the one of the affine inverse. */
+    for(int row = 0 ; row < 3 ; ++row) {
+        for(int column = 0 ; column < 3 ; ++column) { normals_model(row, column) = inverse_global_model(column, row); }
+    }
+}
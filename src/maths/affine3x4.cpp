@@ -0,0 +1,211 @@
+/***************************************************************************************************
+ * @file  affine3x4.cpp
+ * @brief Implementation of the affine3x4 struct
+ **************************************************************************************************/
+
+#include "maths/affine3x4.hpp"
+
+#include "maths/simd.hpp"
+
+affine3x4::affine3x4(float v00, float v01, float v02, float v03,
+                     float v10, float v11, float v12, float v13,
+                     float v20, float v21, float v22, float v23)
+    : rows{
+        vec4(v00, v01, v02, v03),
+        vec4(v10, v11, v12, v13),
+        vec4(v20, v21, v22, v23)
+    } { }
+
+affine3x4::affine3x4(float scalar)
+    : rows{
+        vec4(scalar, 0.0f, 0.0f, 0.0f),
+        vec4(0.0f, scalar, 0.0f, 0.0f),
+        vec4(0.0f, 0.0f, scalar, 0.0f)
+    } { }
+
+affine3x4::affine3x4(const mat4& mat)
+    : rows{
+        vec4(mat(0, 0), mat(0, 1), mat(0, 2), mat(0, 3)),
+        vec4(mat(1, 0), mat(1, 1), mat(1, 2), mat(1, 3)),
+        vec4(mat(2, 0), mat(2, 1), mat(2, 2), mat(2, 3))
+    } { }
+
+mat4 affine3x4::to_mat4() const {
+    return mat4(
+        rows[0].x, rows[0].y, rows[0].z, rows[0].w,
+        rows[1].x, rows[1].y, rows[1].z, rows[1].w,
+        rows[2].x, rows[2].y, rows[2].z, rows[2].w,
+        0.0f, 0.0f, 0.0f, 1.0f
+    );
+}
+
+std::ostream& operator <<(std::ostream& stream, const affine3x4& mat) {
+    for(int i = 0 ; i < 3 ; ++i) {
+        stream << "( ";
+
+        for(int j = 0 ; j < 3 ; ++j) {
+            stream << ' ' << mat(i, j) << " ; ";
+        }
+
+        stream << mat(i, 3) << " )\n";
+    }
+    return stream;
+}
+
+affine3x4 operator *(const affine3x4& left, const affine3x4& right) {
+    affine3x4 result;
+
+#ifdef __SSE__
+    /* Each row of the result is a combination of the rows of right, plus the row's translation
+     * which is multiplied by the implicit (0, 0, 0, 1) last row. */
+    __m128 right_row0 = _mm_loadu_ps(&right.get_row(0).x);
+    __m128 right_row1 = _mm_loadu_ps(&right.get_row(1).x);
+    __m128 right_row2 = _mm_loadu_ps(&right.get_row(2).x);
+    __m128 translation_mask = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    for(uint8_t row = 0 ; row < 3 ; ++row) {
+        __m128 left_row = _mm_loadu_ps(&left.get_row(row).x);
+        __m128 result_row = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(broadcast<0>(left_row), right_row0), _mm_mul_ps(broadcast<1>(left_row), right_row1)),
+            _mm_add_ps(_mm_mul_ps(broadcast<2>(left_row), right_row2), _mm_mul_ps(left_row, translation_mask))
+        );
+        _mm_storeu_ps(&result(row, 0), result_row);
+    }
+#else
+    for(uint8_t row = 0 ; row < 3 ; ++row) {
+        for(uint8_t column = 0 ; column < 4 ; ++column) {
+            result(row, column) = left(row, 0) * right(0, column)
+                                  + left(row, 1) * right(1, column)
+                                  + left(row, 2) * right(2, column);
+        }
+        result(row, 3) += left(row, 3);
+    }
+#endif
+
+    return result;
+}
+
+mat4 operator *(const mat4& left, const affine3x4& right) {
+    mat4 result;
+
+#ifdef __SSE__
+    /* Each column of the result is a combination of the columns of left, the last one also adds
+     * left's last column since right's last row is (0, 0, 0, 1). */
+    __m128 left_column0 = _mm_loadu_ps(&left[0].x);
+    __m128 left_column1 = _mm_loadu_ps(&left[1].x);
+    __m128 left_column2 = _mm_loadu_ps(&left[2].x);
+
+    for(uint8_t column = 0 ; column < 4 ; ++column) {
+        __m128 result_column = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(left_column0, _mm_set1_ps(right(0, column))),
+                       _mm_mul_ps(left_column1, _mm_set1_ps(right(1, column)))),
+            _mm_mul_ps(left_column2, _mm_set1_ps(right(2, column)))
+        );
+        _mm_storeu_ps(&result[column].x, result_column);
+    }
+
+    _mm_storeu_ps(&result[3].x, _mm_add_ps(_mm_loadu_ps(&result[3].x), _mm_loadu_ps(&left[3].x)));
+#else
+    for(uint8_t column = 0 ; column < 4 ; ++column) {
+        result[column] = left[0] * right(0, column) + left[1] * right(1, column) + left[2] * right(2, column);
+    }
+    result[3] += left[3];
+#endif
+
+    return result;
+}
+
+vec4 operator *(const affine3x4& mat, const vec4& vec) {
+    return vec4(
+        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z + mat(0, 3) * vec.w,
+        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z + mat(1, 3) * vec.w,
+        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z + mat(2, 3) * vec.w,
+        vec.w
+    );
+}
+
+vec3 transform_point(const affine3x4& mat, const vec3& point) {
+    return vec3(
+        mat(0, 0) * point.x + mat(0, 1) * point.y + mat(0, 2) * point.z + mat(0, 3),
+        mat(1, 0) * point.x + mat(1, 1) * point.y + mat(1, 2) * point.z + mat(1, 3),
+        mat(2, 0) * point.x + mat(2, 1) * point.y + mat(2, 2) * point.z + mat(2, 3)
+    );
+}
+
+vec3 transform_vector(const affine3x4& mat, const vec3& vector) {
+    return vec3(
+        mat(0, 0) * vector.x + mat(0, 1) * vector.y + mat(0, 2) * vector.z,
+        mat(1, 0) * vector.x + mat(1, 1) * vector.y + mat(1, 2) * vector.z,
+        mat(2, 0) * vector.x + mat(2, 1) * vector.y + mat(2, 2) * vector.z
+    );
+}
+
+affine3x4 affine_inverse(const affine3x4& mat) {
+#ifdef __SSE__
+    /* The columns of the inverse of the upper left 3x3 matrix are the cross products of its rows
+     * divided by its determinant. The translation lanes don't change the cross products' xyz. */
+    __m128 row0 = _mm_loadu_ps(&mat.get_row(0).x);
+    __m128 row1 = _mm_loadu_ps(&mat.get_row(1).x);
+    __m128 row2 = _mm_loadu_ps(&mat.get_row(2).x);
+
+    __m128 column0 = cross_product(row1, row2);
+    __m128 column1 = cross_product(row2, row0);
+    __m128 column2 = cross_product(row0, row1);
+
+    __m128 det = _mm_mul_ps(row0, column0);
+    det = _mm_add_ps(det, _mm_movehl_ps(det, det));
+    det = _mm_add_ss(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 1, 1, 1)));
+    if(_mm_cvtss_f32(det) == 0.0f) { return mat; }
+
+    __m128 inverse_det = _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(det, det, 0));
+    column0 = _mm_mul_ps(column0, inverse_det);
+    column1 = _mm_mul_ps(column1, inverse_det);
+    column2 = _mm_mul_ps(column2, inverse_det);
+
+    /* The translation is -inverse * translation, then transposing the 4 columns gives the rows. */
+    __m128 translation = _mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(column0, broadcast<3>(row0)), _mm_mul_ps(column1, broadcast<3>(row1))),
+        _mm_mul_ps(column2, broadcast<3>(row2))
+    ));
+    _MM_TRANSPOSE4_PS(column0, column1, column2, translation);
+
+    affine3x4 result;
+    _mm_storeu_ps(&result(0, 0), column0);
+    _mm_storeu_ps(&result(1, 0), column1);
+    _mm_storeu_ps(&result(2, 0), column2);
+
+    return result;
+#else
+    float det = mat(0, 0) * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1))
+                - mat(0, 1) * (mat(1, 0) * mat(2, 2) - mat(1, 2) * mat(2, 0))
+                + mat(0, 2) * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0));
+
+    if(det == 0.0f) { return mat; }
+
+    float inv = 1.0f / det;
+
+    /* The inverse of the upper left 3x3 matrix, then the translation is -inverse * translation. */
+    affine3x4 result(
+        inv * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1)),
+        inv * (mat(0, 2) * mat(2, 1) - mat(0, 1) * mat(2, 2)),
+        inv * (mat(0, 1) * mat(1, 2) - mat(0, 2) * mat(1, 1)),
+        0.0f,
+
+        inv * (mat(1, 2) * mat(2, 0) - mat(1, 0) * mat(2, 2)),
+        inv * (mat(0, 0) * mat(2, 2) - mat(0, 2) * mat(2, 0)),
+        inv * (mat(0, 2) * mat(1, 0) - mat(0, 0) * mat(1, 2)),
+        0.0f,
+
+        inv * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0)),
+        inv * (mat(0, 1) * mat(2, 0) - mat(0, 0) * mat(2, 1)),
+        inv * (mat(0, 0) * mat(1, 1) - mat(0, 1) * mat(1, 0)),
+        0.0f
+    );
+
+    for(uint8_t row = 0 ; row < 3 ; ++row) {
+        result(row, 3) = -(result(row, 0) * mat(0, 3) + result(row, 1) * mat(1, 3) + result(row, 2) * mat(2, 3));
+    }
+
+    return result;
+#endif
+}
@@ -6,6 +6,7 @@
 #include "maths/mat4.hpp"
 
 #include "maths/geometry.hpp"
+#include "maths/simd.hpp"
 
 mat4::mat4(float v00, float v01, float v02, float v03,
            float v10, float v11, float v12, float v13,
@@ -121,27 +122,6 @@ mat4 operator -(const mat4& left, const mat4& right) {
     return result;
 }
 
-mat4 operator *(const mat4& left, const mat4& right) {
-    return mat4(
-        left(0, 0) * right(0, 0) + left(0, 1) * right(1, 0) + left(0, 2) * right(2, 0) + left(0, 3) * right(3, 0),
-        left(0, 0) * right(0, 1) + left(0, 1) * right(1, 1) + left(0, 2) * right(2, 1) + left(0, 3) * right(3, 1),
-        left(0, 0) * right(0, 2) + left(0, 1) * right(1, 2) + left(0, 2) * right(2, 2) + left(0, 3) * right(3, 2),
-        left(0, 0) * right(0, 3) + left(0, 1) * right(1, 3) + left(0, 2) * right(2, 3) + left(0, 3) * right(3, 3),
-        left(1, 0) * right(0, 0) + left(1, 1) * right(1, 0) + left(1, 2) * right(2, 0) + left(1, 3) * right(3, 0),
-        left(1, 0) * right(0, 1) + left(1, 1) * right(1, 1) + left(1, 2) * right(2, 1) + left(1, 3) * right(3, 1),
-        left(1, 0) * right(0, 2) + left(1, 1) * right(1, 2) + left(1, 2) * right(2, 2) + left(1, 3) * right(3, 2),
-        left(1, 0) * right(0, 3) + left(1, 1) * right(1, 3) + left(1, 2) * right(2, 3) + left(1, 3) * right(3, 3),
-        left(2, 0) * right(0, 0) + left(2, 1) * right(1, 0) + left(2, 2) * right(2, 0) + left(2, 3) * right(3, 0),
-        left(2, 0) * right(0, 1) + left(2, 1) * right(1, 1) + left(2, 2) * right(2, 1) + left(2, 3) * right(3, 1),
-        left(2, 0) * right(0, 2) + left(2, 1) * right(1, 2) + left(2, 2) * right(2, 2) + left(2, 3) * right(3, 2),
-        left(2, 0) * right(0, 3) + left(2, 1) * right(1, 3) + left(2, 2) * right(2, 3) + left(2, 3) * right(3, 3),
-        left(3, 0) * right(0, 0) + left(3, 1) * right(1, 0) + left(3, 2) * right(2, 0) + left(3, 3) * right(3, 0),
-        left(3, 0) * right(0, 1) + left(3, 1) * right(1, 1) + left(3, 2) * right(2, 1) + left(3, 3) * right(3, 1),
-        left(3, 0) * right(0, 2) + left(3, 1) * right(1, 2) + left(3, 2) * right(2, 2) + left(3, 3) * right(3, 2),
-        left(3, 0) * right(0, 3) + left(3, 1) * right(1, 3) + left(3, 2) * right(2, 3) + left(3, 3) * right(3, 3)
-    );
-}
-
 mat4 operator +(const mat4& mat, float scalar) {
     mat4 result;
 
@@ -202,19 +182,208 @@ mat4 operator /(const mat4& mat, float scalar) {
     return result;
 }
 
-vec3 operator*(const mat4& mat, const vec3& vec) {
-    return vec3(
-        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z,
-        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z,
-        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z
+#ifdef __SSE__
+/**
+ * @brief Multiplies two 2x2 matrices stored as (m00, m01, m10, m11): left * right.
+ */
+static inline __m128 mat2_multiply(__m128 left, __m128 right) {
+    return _mm_add_ps(_mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(3, 0, 3, 0))),
+                      _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)),
+                                 _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+
+/**
+ * @brief Multiplies the adjugate of a 2x2 matrix by another: adjugate(left) * right.
+ */
+static inline __m128 mat2_adjugate_multiply(__m128 left, __m128 right) {
+    return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(0, 0, 3, 3)), right),
+                      _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 2, 1, 1)),
+                                 _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+/**
+ * @brief Multiplies a 2x2 matrix by the adjugate of another: left * adjugate(right).
+ */
+static inline __m128 mat2_multiply_adjugate(__m128 left, __m128 right) {
+    return _mm_sub_ps(_mm_mul_ps(left, _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 3, 0, 3))),
+                      _mm_mul_ps(_mm_shuffle_ps(left, left, _MM_SHUFFLE(2, 3, 0, 1)),
+                                 _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 2, 1, 2))));
+}
+#endif
+
+mat4 affine_inverse(const mat4& mat) {
+#ifdef __SSE__
+    /* The rows of the inverse of the upper left 3x3 matrix are the cross products of its columns
+     * divided by its determinant, they only need to be transposed to become columns. */
+    __m128 column0 = _mm_loadu_ps(&mat[0].x);
+    __m128 column1 = _mm_loadu_ps(&mat[1].x);
+    __m128 column2 = _mm_loadu_ps(&mat[2].x);
+
+    __m128 row0 = cross_product(column1, column2);
+    __m128 row1 = cross_product(column2, column0);
+    __m128 row2 = cross_product(column0, column1);
+    __m128 row3 = _mm_setzero_ps();
+
+    __m128 det = _mm_mul_ps(column0, row0);
+    det = _mm_add_ps(det, _mm_movehl_ps(det, det));
+    det = _mm_add_ss(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 1, 1, 1)));
+    if(_mm_cvtss_f32(det) == 0.0f) { return mat; }
+
+    __m128 inverse_det = _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(det, det, 0));
+    row0 = _mm_mul_ps(row0, inverse_det);
+    row1 = _mm_mul_ps(row1, inverse_det);
+    row2 = _mm_mul_ps(row2, inverse_det);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    /* The translation is -inverse * translation. */
+    __m128 translation = _mm_loadu_ps(&mat[3].x);
+    __m128 inverse_translation = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(row0, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(0, 0, 0, 0))),
+                   _mm_mul_ps(row1, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(1, 1, 1, 1)))),
+        _mm_mul_ps(row2, _mm_shuffle_ps(translation, translation, _MM_SHUFFLE(2, 2, 2, 2)))
     );
+
+    mat4 result;
+    _mm_storeu_ps(&result[0].x, row0);
+    _mm_storeu_ps(&result[1].x, row1);
+    _mm_storeu_ps(&result[2].x, row2);
+    _mm_storeu_ps(&result[3].x, _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), inverse_translation));
+
+    return result;
+#else
+    float det = mat(0, 0) * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1))
+                - mat(0, 1) * (mat(1, 0) * mat(2, 2) - mat(1, 2) * mat(2, 0))
+                + mat(0, 2) * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0));
+
+    if(det == 0.0f) { return mat; }
+
+    float inv = 1.0f / det;
+
+    /* The inverse of the upper left 3x3 matrix, then the translation is -inverse * translation. */
+    mat4 result(
+        inv * (mat(1, 1) * mat(2, 2) - mat(1, 2) * mat(2, 1)),
+        inv * (mat(0, 2) * mat(2, 1) - mat(0, 1) * mat(2, 2)),
+        inv * (mat(0, 1) * mat(1, 2) - mat(0, 2) * mat(1, 1)),
+
+        inv * (mat(1, 2) * mat(2, 0) - mat(1, 0) * mat(2, 2)),
+        inv * (mat(0, 0) * mat(2, 2) - mat(0, 2) * mat(2, 0)),
+        inv * (mat(0, 2) * mat(1, 0) - mat(0, 0) * mat(1, 2)),
+
+        inv * (mat(1, 0) * mat(2, 1) - mat(1, 1) * mat(2, 0)),
+        inv * (mat(0, 1) * mat(2, 0) - mat(0, 0) * mat(2, 1)),
+        inv * (mat(0, 0) * mat(1, 1) - mat(0, 1) * mat(1, 0))
+    );
+
+    vec3 translation = result * vec3(mat(0, 3), mat(1, 3), mat(2, 3));
+    result(0, 3) = -translation.x;
+    result(1, 3) = -translation.y;
+    result(2, 3) = -translation.z;
+
+    return result;
+#endif
 }
 
-vec4 operator*(const mat4& mat, const vec4& vec) {
-    return vec4(
-        mat(0, 0) * vec.x + mat(0, 1) * vec.y + mat(0, 2) * vec.z + mat(0, 3) * vec.w,
-        mat(1, 0) * vec.x + mat(1, 1) * vec.y + mat(1, 2) * vec.z + mat(1, 3) * vec.w,
-        mat(2, 0) * vec.x + mat(2, 1) * vec.y + mat(2, 2) * vec.z + mat(2, 3) * vec.w,
-        mat(3, 0) * vec.x + mat(3, 1) * vec.y + mat(3, 2) * vec.z + mat(3, 3) * vec.w
+mat4 inverse(const mat4& mat) {
+#ifdef __SSE__
+    /* Block inversion with 2x2 sub-matrices: M = | A B |, inverse(M) = 1/det(M) * | X Y |.
+     *                                              | C D |                          | Z W |
+     * The inverse of the transpose is the transpose of the inverse, so it works on the columns. */
+    __m128 column0 = _mm_loadu_ps(&mat[0].x);
+    __m128 column1 = _mm_loadu_ps(&mat[1].x);
+    __m128 column2 = _mm_loadu_ps(&mat[2].x);
+    __m128 column3 = _mm_loadu_ps(&mat[3].x);
+
+    __m128 A = _mm_movelh_ps(column0, column1);
+    __m128 B = _mm_movehl_ps(column1, column0);
+    __m128 C = _mm_movelh_ps(column2, column3);
+    __m128 D = _mm_movehl_ps(column3, column2);
+
+    /* The determinants of the sub-matrices: (det(A), det(B), det(C), det(D)). */
+    __m128 sub_dets = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(column0, column2, _MM_SHUFFLE(2, 0, 2, 0)),
+                   _mm_shuffle_ps(column1, column3, _MM_SHUFFLE(3, 1, 3, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(column0, column2, _MM_SHUFFLE(3, 1, 3, 1)),
+                   _mm_shuffle_ps(column1, column3, _MM_SHUFFLE(2, 0, 2, 0)))
     );
+    __m128 det_A = _mm_shuffle_ps(sub_dets, sub_dets, _MM_SHUFFLE(0, 0, 0, 0));
+    __m128 det_B = _mm_shuffle_ps(sub_dets, sub_dets, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 det_C = _mm_shuffle_ps(sub_dets, sub_dets, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 det_D = _mm_shuffle_ps(sub_dets, sub_dets, _MM_SHUFFLE(3, 3, 3, 3));
+
+    __m128 D_C = mat2_adjugate_multiply(D, C);
+    __m128 A_B = mat2_adjugate_multiply(A, B);
+    __m128 X = _mm_sub_ps(_mm_mul_ps(det_D, A), mat2_multiply(B, D_C));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(det_A, D), mat2_multiply(C, A_B));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(det_B, C), mat2_multiply_adjugate(D, A_B));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(det_C, B), mat2_multiply_adjugate(A, D_C));
+
+    /* det(M) = det(A) * det(D) + det(B) * det(C) - trace(adjugate(A) * B * adjugate(D) * C) */
+    __m128 trace = _mm_mul_ps(A_B, _mm_shuffle_ps(D_C, D_C, _MM_SHUFFLE(3, 1, 2, 0)));
+    trace = _mm_add_ps(trace, _mm_movehl_ps(trace, trace));
+    trace = _mm_add_ss(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 1, 1, 1)));
+    __m128 det = _mm_sub_ss(_mm_add_ss(_mm_mul_ss(det_A, det_D), _mm_mul_ss(det_B, det_C)), trace);
+    if(_mm_cvtss_f32(det) == 0.0f) { return mat; }
+
+    __m128 inverse_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), _mm_shuffle_ps(det, det, 0));
+    X = _mm_mul_ps(X, inverse_det);
+    Y = _mm_mul_ps(Y, inverse_det);
+    Z = _mm_mul_ps(Z, inverse_det);
+    W = _mm_mul_ps(W, inverse_det);
+
+    /* Applies the adjugate and recombines the sub-matrices into columns. */
+    mat4 result;
+    _mm_storeu_ps(&result[0].x, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(&result[1].x, _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0, 2, 0, 2)));
+    _mm_storeu_ps(&result[2].x, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1, 3, 1, 3)));
+    _mm_storeu_ps(&result[3].x, _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0, 2, 0, 2)));
+
+    return result;
+#else
+    /* Adjugate by cofactor expansion, on the columns for the same reason. */
+    const float* m = &mat[0].x;
+    float adjugate[16];
+
+    adjugate[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+                   + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    adjugate[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+                   - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    adjugate[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+                   + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    adjugate[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+                    - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    adjugate[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+                   - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    adjugate[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+                   + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    adjugate[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+                   - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    adjugate[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+                    + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    adjugate[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+                   + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    adjugate[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+                   - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    adjugate[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+                    + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    adjugate[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+                    - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    adjugate[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+                   - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    adjugate[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+                   + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    adjugate[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+                    - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    adjugate[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+                    + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float det = m[0] * adjugate[0] + m[1] * adjugate[4] + m[2] * adjugate[8] + m[3] * adjugate[12];
+    if(det == 0.0f) { return mat; }
+
+    float inverse_det = 1.0f / det;
+    mat4 result;
+    float* r = &result[0].x;
+    for(int i = 0 ; i < 16 ; ++i) { r[i] = adjugate[i] * inverse_det; }
+
+    return result;
+#endif
 }
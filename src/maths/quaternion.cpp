@@ -5,9 +5,12 @@
 
 #include "maths/quaternion.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 #include "maths/constants.hpp"
+#include "maths/geometry.hpp"
+#include "maths/simd.hpp"
 #include "maths/trigonometry.hpp"
 
 quaternion::quaternion() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) { }
@@ -33,21 +36,14 @@ quaternion& quaternion::operator -=(const quaternion& q) {
 }
 
 quaternion& quaternion::operator *=(const quaternion& q) {
-    x = y * q.z - z * q.y + x * q.w + w * q.x;
-    y = z * q.x - x * q.z + y * q.w + w * q.y;
-    z = x * q.y - y * q.x + z * q.w + w * q.z;
-    w = w * q.w - x * q.x - y * q.y - z * q.z;
+    /* Every coefficient of the product depends on all of the previous ones. */
+    *this = *this * q;
 
     return *this;
 }
 
 quaternion& quaternion::operator /=(const quaternion& q) {
-    quaternion inv = q.get_inverse();
-
-    x = y * inv.z - z * inv.y + x * inv.w + w * inv.x;
-    y = z * inv.x - x * inv.z + y * inv.w + w * inv.y;
-    z = x * inv.y - y * inv.x + z * inv.w + w * inv.z;
-    w = w * inv.w - x * inv.x - y * inv.y - z * inv.z;
+    *this = *this * q.get_inverse();
 
     return *this;
 }
@@ -175,12 +171,30 @@ quaternion operator -(const quaternion& q, const quaternion& r) {
 }
 
 quaternion operator *(const quaternion& q, const quaternion& r) {
+#ifdef __SSE__
+    /* Each coefficient of q multiplies a permutation of r's with its own signs. */
+    __m128 left = _mm_loadu_ps(&q.x);
+    __m128 right = _mm_loadu_ps(&r.x);
+
+    __m128 result = _mm_mul_ps(broadcast<3>(left), right);
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(broadcast<0>(left), _mm_shuffle_ps(right, right, _MM_SHUFFLE(0, 1, 2, 3))),
+                                           _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(broadcast<1>(left), _mm_shuffle_ps(right, right, _MM_SHUFFLE(1, 0, 3, 2))),
+                                           _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+    result = _mm_add_ps(result, _mm_xor_ps(_mm_mul_ps(broadcast<2>(left), _mm_shuffle_ps(right, right, _MM_SHUFFLE(2, 3, 0, 1))),
+                                           _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+
+    quaternion product;
+    _mm_storeu_ps(&product.x, result);
+    return product;
+#else
     return quaternion(
         q.y * r.z - q.z * r.y + q.x * r.w + q.w * r.x,
         q.z * r.x - q.x * r.z + q.y * r.w + q.w * r.y,
         q.x * r.y - q.y * r.x + q.z * r.w + q.w * r.z,
         q.w * r.w - q.x * r.x - q.y * r.y - q.z * r.z
     );
+#endif
 }
 
 quaternion operator /(const quaternion& q, const quaternion& r) {
@@ -202,3 +216,167 @@ quaternion operator /(const quaternion& q, float scalar) {
 quaternion operator /(float scalar, const quaternion& q) {
     return scalar * q.get_inverse();
 }
+
+/**
+ * @brief Calculates the factors of the two quaternions of a slerp.
+ * @param cos_theta The cosine of the angle between the quaternions, positive.
+ * @param t The interpolation factor.
+ * @param q_factor The factor of the quaternion at t = 0.
+ * @param r_factor The factor of the quaternion at t = 1.
+ */
+static inline void get_slerp_factors(float cos_theta, float t, float& q_factor, float& r_factor) {
+    /* Close quaternions are linearly interpolated to avoid dividing by sin(theta) ~ 0. */
+    q_factor = 1.0f - t;
+    r_factor = t;
+    if(cos_theta < 0.9995f) {
+        float theta = std::acos(cos_theta);
+        float sin_theta = std::sin(theta);
+        q_factor = std::sin((1.0f - t) * theta) / sin_theta;
+        r_factor = std::sin(t * theta) / sin_theta;
+    }
+}
+
+quaternion slerp(const quaternion& q, quaternion r, float t) {
+    float cos_theta = q.x * r.x + q.y * r.y + q.z * r.z + q.w * r.w;
+    if(cos_theta < 0.0f) {
+        r = -1.0f * r;
+        cos_theta = -cos_theta;
+    }
+
+    float q_factor, r_factor;
+    get_slerp_factors(cos_theta, t, q_factor, r_factor);
+
+    quaternion result = q_factor * q + r_factor * r;
+    result.normalize();
+    return result;
+}
+
+quaternion nlerp(const quaternion& q, quaternion r, float t) {
+    if(q.x * r.x + q.y * r.y + q.z * r.z + q.w * r.w < 0.0f) { r = -1.0f * r; }
+
+    quaternion result = (1.0f - t) * q + t * r;
+    result.normalize();
+    return result;
+}
+
+#ifdef __SSE__
+/**
+ * @brief Loads 4 quaternions transposed: each register holds the same coefficient of the 4.
+ * @param quaternions The first of the 4 quaternions.
+ * @param coefficients The x, y, z and w coefficients.
+ */
+static inline void load_transposed(const quaternion* quaternions, __m128 coefficients[4]) {
+    for(unsigned int i = 0 ; i < 4 ; ++i) { coefficients[i] = _mm_loadu_ps(&quaternions[i].x); }
+    _MM_TRANSPOSE4_PS(coefficients[0], coefficients[1], coefficients[2], coefficients[3]);
+}
+
+/**
+ * @brief Calculates the dot product of 4 pairs of transposed quaternions.
+ */
+static inline __m128 dot_transposed(const __m128 left[4], const __m128 right[4]) {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(left[0], right[0]), _mm_mul_ps(left[1], right[1])),
+                      _mm_add_ps(_mm_mul_ps(left[2], right[2]), _mm_mul_ps(left[3], right[3])));
+}
+
+/**
+ * @brief Blends 4 pairs of transposed quaternions, normalizes them and stores them.
+ * @param starts The quaternions at t = 0.
+ * @param ends The quaternions at t = 1.
+ * @param start_factors The factor of each start.
+ * @param end_factors The factor of each end, negated for the ends on the other hemisphere.
+ * @param results The first of the 4 results.
+ */
+static inline void blend_and_store(const __m128 starts[4],
+                                   const __m128 ends[4],
+                                   __m128 start_factors,
+                                   __m128 end_factors,
+                                   quaternion* results) {
+    __m128 blended[4];
+    for(unsigned int i = 0 ; i < 4 ; ++i) {
+        blended[i] = _mm_add_ps(_mm_mul_ps(starts[i], start_factors), _mm_mul_ps(ends[i], end_factors));
+    }
+
+    __m128 inverse_length = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(dot_transposed(blended, blended)));
+    for(unsigned int i = 0 ; i < 4 ; ++i) { blended[i] = _mm_mul_ps(blended[i], inverse_length); }
+
+    _MM_TRANSPOSE4_PS(blended[0], blended[1], blended[2], blended[3]);
+    for(unsigned int i = 0 ; i < 4 ; ++i) { _mm_storeu_ps(&results[i].x, blended[i]); }
+}
+#endif
+
+void slerp(std::span<const quaternion> starts,
+           std::span<const quaternion> ends,
+           std::span<const float> factors,
+           std::span<quaternion> results) {
+    const size_t count = std::min({ starts.size(), ends.size(), factors.size(), results.size() });
+    size_t i = 0;
+
+#ifdef __SSE__
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    for( ; i + 4 <= count ; i += 4) {
+        __m128 start[4], end[4];
+        load_transposed(&starts[i], start);
+        load_transposed(&ends[i], end);
+
+        /* The ends on the other hemisphere are negated through their factor. Only the angles need
+         * scalar code, for the trigonometric functions. */
+        __m128 cos_theta = dot_transposed(start, end);
+        __m128 signs = _mm_and_ps(cos_theta, sign_mask);
+
+        float cosines[4], start_factors[4], end_factors[4];
+        _mm_storeu_ps(cosines, _mm_andnot_ps(sign_mask, cos_theta));
+        for(unsigned int j = 0 ; j < 4 ; ++j) {
+            get_slerp_factors(cosines[j], factors[i + j], start_factors[j], end_factors[j]);
+        }
+
+        blend_and_store(start, end, _mm_loadu_ps(start_factors), _mm_xor_ps(_mm_loadu_ps(end_factors), signs), &results[i]);
+    }
+#endif
+
+    for( ; i < count ; ++i) { results[i] = slerp(starts[i], ends[i], factors[i]); }
+}
+
+void nlerp(std::span<const quaternion> starts,
+           std::span<const quaternion> ends,
+           std::span<const float> factors,
+           std::span<quaternion> results) {
+    const size_t count = std::min({ starts.size(), ends.size(), factors.size(), results.size() });
+    size_t i = 0;
+
+#ifdef __SSE__
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    for( ; i + 4 <= count ; i += 4) {
+        __m128 start[4], end[4];
+        load_transposed(&starts[i], start);
+        load_transposed(&ends[i], end);
+
+        /* The ends on the other hemisphere are negated through their factor. */
+        __m128 signs = _mm_and_ps(dot_transposed(start, end), sign_mask);
+        __m128 t = _mm_loadu_ps(&factors[i]);
+
+        blend_and_store(start, end, _mm_sub_ps(_mm_set1_ps(1.0f), t), _mm_xor_ps(t, signs), &results[i]);
+    }
+#endif
+
+    for( ; i < count ; ++i) { results[i] = nlerp(starts[i], ends[i], factors[i]); }
+}
+
+vec3 rotate(const quaternion& q, const vec3& vector) {
+    /* v + 2w(u x v) + 2u x (u x v), with u the imaginary part of q. */
+#ifdef __SSE__
+    __m128 rotation = _mm_loadu_ps(&q.x);
+    __m128 v = _mm_setr_ps(vector.x, vector.y, vector.z, 0.0f);
+    __m128 t = cross_product(rotation, v);
+    t = _mm_add_ps(t, t);
+
+    __m128 result = _mm_add_ps(_mm_add_ps(v, _mm_mul_ps(broadcast<3>(rotation), t)), cross_product(rotation, t));
+
+    float values[4];
+    _mm_storeu_ps(values, result);
+    return vec3(values[0], values[1], values[2]);
+#else
+    vec3 u(q.x, q.y, q.z);
+    vec3 t = 2.0f * cross(u, vector);
+    return vector + q.w * t + cross(u, t);
+#endif
+}
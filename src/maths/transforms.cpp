@@ -5,8 +5,10 @@
 
 #include "maths/transforms.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include "maths/geometry.hpp"
+#include "maths/simd.hpp"
 #include "maths/trigonometry.hpp"
 
 mat4 scale(float factor) {
@@ -197,26 +199,92 @@ mat4 TRS_matrix(const vec3& translation, const vec3& rotation, const vec3& scale
 }
 
 mat4 TRS_matrix(const vec3& translation, const quaternion& rotation, const vec3& scale) {
-    return mat4(
+    return affine_TRS_matrix(translation, rotation, scale).to_mat4();
+}
+
+affine3x4 affine_TRS_matrix(const vec3& translation, const quaternion& rotation, const vec3& scale) {
+    /* The scale is applied first, so each column of the rotation matrix is scaled by its factor. */
+    return affine3x4(
         scale.x * (1.0f - 2.0f * (rotation.y * rotation.y + rotation.z * rotation.z)),
-        scale.x * (2.0f * (rotation.x * rotation.y - rotation.w * rotation.z)),
-        scale.x * (2.0f * (rotation.x * rotation.z + rotation.w * rotation.y)),
+        scale.y * (2.0f * (rotation.x * rotation.y - rotation.w * rotation.z)),
+        scale.z * (2.0f * (rotation.x * rotation.z + rotation.w * rotation.y)),
         translation.x,
 
-        scale.y * (2.0f * (rotation.x * rotation.y + rotation.w * rotation.z)),
+        scale.x * (2.0f * (rotation.x * rotation.y + rotation.w * rotation.z)),
         scale.y * (1.0f - 2.0f * (rotation.x * rotation.x + rotation.z * rotation.z)),
-        scale.y * (2.0f * (rotation.y * rotation.z - rotation.w * rotation.x)),
+        scale.z * (2.0f * (rotation.y * rotation.z - rotation.w * rotation.x)),
         translation.y,
 
-        scale.z * (2.0f * (rotation.x * rotation.z - rotation.w * rotation.y)),
-        scale.z * (2.0f * (rotation.y * rotation.z + rotation.w * rotation.x)),
+        scale.x * (2.0f * (rotation.x * rotation.z - rotation.w * rotation.y)),
+        scale.y * (2.0f * (rotation.y * rotation.z + rotation.w * rotation.x)),
         scale.z * (1.0f - 2.0f * (rotation.x * rotation.x + rotation.y * rotation.y)),
-        translation.z,
-
-        0.0f, 0.0f, 0.0f, 1.0f
+        translation.z
     );
 }
 
+#ifdef __SSE__
+/**
+ * @brief Stores the same row of 4 affine matrices from the registers holding each of its columns
+ * for the 4 matrices.
+ */
+static inline void store_row(affine3x4* results, uint8_t row, __m128 column0, __m128 column1, __m128 column2, __m128 column3) {
+    _MM_TRANSPOSE4_PS(column0, column1, column2, column3);
+    _mm_storeu_ps(&results[0](row, 0), column0);
+    _mm_storeu_ps(&results[1](row, 0), column1);
+    _mm_storeu_ps(&results[2](row, 0), column2);
+    _mm_storeu_ps(&results[3](row, 0), column3);
+}
+#endif
+
+void affine_TRS_matrices(std::span<const vec3> translations,
+                         std::span<const quaternion> rotations,
+                         std::span<const vec3> scales,
+                         std::span<affine3x4> results) {
+    const size_t count = std::min({ translations.size(), rotations.size(), scales.size(), results.size() });
+    size_t i = 0;
+
+#ifdef __SSE__
+    /* Each register holds the same value for 4 matrices, which are transposed back row by row. */
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    for( ; i + 4 <= count ; i += 4) {
+        __m128 x = _mm_loadu_ps(&rotations[i].x);
+        __m128 y = _mm_loadu_ps(&rotations[i + 1].x);
+        __m128 z = _mm_loadu_ps(&rotations[i + 2].x);
+        __m128 w = _mm_loadu_ps(&rotations[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+        __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+        __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+        const vec3* t = &translations[i];
+        const vec3* s = &scales[i];
+        __m128 scale_x = _mm_setr_ps(s[0].x, s[1].x, s[2].x, s[3].x);
+        __m128 scale_y = _mm_setr_ps(s[0].y, s[1].y, s[2].y, s[3].y);
+        __m128 scale_z = _mm_setr_ps(s[0].z, s[1].z, s[2].z, s[3].z);
+
+        store_row(&results[i], 0,
+                  _mm_mul_ps(scale_x, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)))),
+                  _mm_mul_ps(scale_y, _mm_mul_ps(two, _mm_sub_ps(xy, wz))),
+                  _mm_mul_ps(scale_z, _mm_mul_ps(two, _mm_add_ps(xz, wy))),
+                  _mm_setr_ps(t[0].x, t[1].x, t[2].x, t[3].x));
+        store_row(&results[i], 1,
+                  _mm_mul_ps(scale_x, _mm_mul_ps(two, _mm_add_ps(xy, wz))),
+                  _mm_mul_ps(scale_y, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)))),
+                  _mm_mul_ps(scale_z, _mm_mul_ps(two, _mm_sub_ps(yz, wx))),
+                  _mm_setr_ps(t[0].y, t[1].y, t[2].y, t[3].y));
+        store_row(&results[i], 2,
+                  _mm_mul_ps(scale_x, _mm_mul_ps(two, _mm_sub_ps(xz, wy))),
+                  _mm_mul_ps(scale_y, _mm_mul_ps(two, _mm_add_ps(yz, wx))),
+                  _mm_mul_ps(scale_z, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))),
+                  _mm_setr_ps(t[0].z, t[1].z, t[2].z, t[3].z));
+    }
+#endif
+
+    for( ; i < count ; ++i) { results[i] = affine_TRS_matrix(translations[i], rotations[i], scales[i]); }
+}
+
 mat4 look_at(const vec3& eye, const vec3& target, const vec3& up) {
     const vec3 FRONT = normalize(eye - target); // vec3 from the target to the camera
     const vec3 RIGHT = normalize(cross(up, FRONT));
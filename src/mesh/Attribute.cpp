@@ -4,3 +4,53 @@
  **************************************************************************************************/
 
 #include "mesh/Attribute.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Reads a value of a specific type from possibly unaligned bytes.
+ */
+template <typename Type>
+static Type read_value(const unsigned char* data) {
+    Type value;
+    std::memcpy(&value, data, sizeof(Type));
+    return value;
+}
+
+float read_component(const unsigned char* data, ComponentType type, bool is_normalized) {
+    switch(type) {
+        case ComponentType::FLOAT: return read_value<float>(data);
+        case ComponentType::BYTE: {
+            float value = read_value<int8_t>(data);
+            return is_normalized ? std::max(value / 127.0f, -1.0f) : value;
+        }
+        case ComponentType::UNSIGNED_BYTE: {
+            float value = read_value<uint8_t>(data);
+            return is_normalized ? value / 255.0f : value;
+        }
+        case ComponentType::SHORT: {
+            float value = read_value<int16_t>(data);
+            return is_normalized ? std::max(value / 32767.0f, -1.0f) : value;
+        }
+        case ComponentType::UNSIGNED_SHORT: {
+            float value = read_value<uint16_t>(data);
+            return is_normalized ? value / 65535.0f : value;
+        }
+        case ComponentType::UNSIGNED_INT: {
+            float value = static_cast<float>(read_value<uint32_t>(data));
+            return is_normalized ? value / 4294967295.0f : value;
+        }
+        default: return 0.0f;
+    }
+}
+
+unsigned int read_unsigned_component(const unsigned char* data, ComponentType type) {
+    switch(type) {
+        case ComponentType::UNSIGNED_BYTE: return read_value<uint8_t>(data);
+        case ComponentType::UNSIGNED_SHORT: return read_value<uint16_t>(data);
+        case ComponentType::UNSIGNED_INT: return read_value<uint32_t>(data);
+        default: return 0;
+    }
+}
@@ -5,19 +5,22 @@
 
 #include "mesh/Mesh.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include "culling/Ray.hpp"
 #include "maths/geometry.hpp"
 #include "maths/mat3.hpp"
+#include "utility/hash.hpp"
 
 Mesh::Mesh(MeshPrimitive primitive)
     : primitive(primitive),
       stride(0),
       active_attributes_count(0),
-      VAO(0),
-      VBO(0),
-      EBO(0) {
+      index_type(ComponentType::UNSIGNED_INT),
+      buffers(nullptr, nullptr) {
     for(AttributeType& attribute : attributes) { attribute = AttributeType::NONE; }
+    for(ComponentType& component_type : component_types) { component_type = ComponentType::FLOAT; }
+    for(bool& is_normalized : are_attributes_normalized) { is_normalized = false; }
     enable_attribute(ATTRIBUTE_POSITION);
 }
 
@@ -25,115 +28,101 @@ Mesh::~Mesh() {
     delete_buffers();
 }
 
-void Mesh::draw() const {
-    if(primitive == MeshPrimitive::NONE) {
-        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have a primitive.\n";
-        return;
-    }
+void Mesh::set_primitive(MeshPrimitive primitive) {
+    this->primitive = primitive;
+}
 
-    if(stride == 0) {
-        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have any active attributes.\n";
-        return;
-    }
+MeshPrimitive Mesh::get_primitive() const {
+    return primitive;
+}
 
-    if(VAO == 0 || VBO == 0) {
-        std::cout << "[WARNING] Mesh wasn't drawn as its buffers aren't bound.\n";
-        return;
-    }
+AttributeType Mesh::get_attribute_type(Attribute attribute) const {
+    return attributes[attribute];
+}
 
-    glBindVertexArray(VAO);
+ComponentType Mesh::get_attribute_component_type(Attribute attribute) const {
+    return component_types[attribute];
+}
 
-    if(indices.empty()) {
-        glDrawArrays(get_opengl_enum_for_primitive(primitive), 0, get_vertices_amount());
-    } else {
-        glDrawElements(get_opengl_enum_for_primitive(primitive), indices.size(), GL_UNSIGNED_INT, nullptr);
-    }
+bool Mesh::is_attribute_normalized(Attribute attribute) const {
+    return are_attributes_normalized[attribute];
 }
 
-void Mesh::draw_normals() const {
-    if(primitive == MeshPrimitive::NONE) {
-        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have a primitive.\n";
-        return;
-    }
+bool Mesh::has_attribute(Attribute attribute) const {
+    return get_attribute_type(attribute) != AttributeType::NONE;
+}
 
-    if(stride == 0) {
-        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have any active attributes.\n";
-        return;
-    }
+vec4 Mesh::get_attribute_value(Attribute attribute, size_t vertex) const {
+    const unsigned char* element = get_data().data() + vertex * stride + get_attribute_offset(attribute);
+    const ComponentType component_type = component_types[attribute];
+    const unsigned int component_size = get_component_type_size(component_type);
 
-    if(VAO == 0 || VBO == 0) {
-        std::cout << "[WARNING] Normals weren't drawn as the mesh's buffers aren't bound.\n";
-        return;
+    vec4 value(0.0f, 0.0f, 0.0f, 1.0f);
+    for(unsigned int i = 0 ; i < get_attribute_type_count(attributes[attribute]) ; ++i) {
+        value[i] = read_component(element + i * component_size, component_type, are_attributes_normalized[attribute]);
     }
 
-    if(primitive != MeshPrimitive::TRIANGLES) {
-        std::cout << "[WARNING] Normals weren't drawn as the mesh wasn't a triangle mesh.\n";
-        return;
-    }
+    return value;
+}
 
-    if(!has_attribute(ATTRIBUTE_NORMAL)) {
-        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have any normals.\n";
-        return;
-    }
+size_t Mesh::get_vertices_amount() const {
+    return stride == 0 ? 0 : get_data().size() / stride;
+}
 
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_POINTS, 0, get_vertices_amount());
+size_t Mesh::get_indices_amount() const {
+    return get_indices().size() / get_component_type_size(index_type);
 }
 
-void Mesh::draw_wireframe() const {
-    if(primitive == MeshPrimitive::NONE) {
-        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh didn't have a primitive.\n";
-        return;
-    }
+unsigned int Mesh::get_index(size_t index) const {
+    const unsigned char* bytes = get_indices().data() + index * get_component_type_size(index_type);
+    return read_unsigned_component(bytes, index_type);
+}
 
-    if(stride == 0) {
-        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh didn't have any active attributes.\n";
-        return;
-    }
+ComponentType Mesh::get_index_type() const {
+    return index_type;
+}
 
-    if(VAO == 0 || VBO == 0) {
-        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh's buffers aren't bound.\n";
-        return;
+void Mesh::set_index_type(ComponentType type) {
+    if(type != ComponentType::UNSIGNED_SHORT && type != ComponentType::UNSIGNED_INT) {
+        throw std::runtime_error("Indices can't be of type '" + component_type_to_string(type) + "'.");
     }
 
-    if(primitive != MeshPrimitive::TRIANGLES) {
-        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh wasn't a triangle mesh.\n";
-        return;
-    }
+    if(type == index_type) { return; }
 
-    glBindVertexArray(VAO);
+    std::vector<unsigned int> previous_indices(get_indices_amount());
+    for(size_t i = 0 ; i < previous_indices.size() ; ++i) { previous_indices[i] = get_index(i); }
 
-    glLineWidth(2);
-    if(indices.empty()) {
-        glDrawArrays(GL_TRIANGLES, 0, get_vertices_amount());
-    } else {
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
-    }
-    glLineWidth(1);
+    indices.clear();
+    external_indices = {};
+    index_type = type;
+    push_indices_buffer(previous_indices);
 }
 
-void Mesh::set_primitive(MeshPrimitive primitive) {
-    this->primitive = primitive;
+unsigned int Mesh::get_restart_index() const {
+    return index_type == ComponentType::UNSIGNED_SHORT ? 0xFFFF : 0xFFFFFFFF;
 }
 
-MeshPrimitive Mesh::get_primitive() const {
-    return primitive;
+std::span<const unsigned char> Mesh::get_data() const {
+    return external_data.data() == nullptr ? std::span<const unsigned char>(data) : external_data;
 }
 
-AttributeType Mesh::get_attribute_type(Attribute attribute) const {
-    return attributes[attribute];
+std::span<const unsigned char> Mesh::get_indices() const {
+    return external_indices.data() == nullptr ? std::span<const unsigned char>(indices) : external_indices;
 }
 
-bool Mesh::has_attribute(Attribute attribute) const {
-    return get_attribute_type(attribute) != AttributeType::NONE;
+void Mesh::set_external_data(std::span<const unsigned char> data) {
+    this->data.clear();
+    external_data = data;
 }
 
-size_t Mesh::get_vertices_amount() const {
-    return data.size() / stride;
-}
+void Mesh::set_external_indices(std::span<const unsigned char> indices, ComponentType type) {
+    if(type != ComponentType::UNSIGNED_SHORT && type != ComponentType::UNSIGNED_INT) {
+        throw std::runtime_error("Indices can't be of type '" + component_type_to_string(type) + "'.");
+    }
 
-size_t Mesh::get_indices_amount() const {
-    return indices.size();
+    this->indices.clear();
+    external_indices = indices;
+    index_type = type;
 }
 
 AttributeType Mesh::get_attribute_type(Attribute attribute) {
@@ -144,79 +133,213 @@ AABB Mesh::get_AABB() const {
     return aabb;
 }
 
+void Mesh::update_AABB() {
+    vec3 min(std::numeric_limits<float>::max());
+    vec3 max(std::numeric_limits<float>::lowest());
+    get_min_max_axis_aligned_coordinates(min, max);
+    aabb.set(min, max);
+}
+
+bool Mesh::are_buffers_bound() const {
+    return buffers != nullptr;
+}
+
+size_t Mesh::get_buffers_size() const {
+    return get_data().size_bytes() + get_indices().size_bytes();
+}
+
+uint64_t Mesh::get_content_hash() const {
+    uint64_t hash = hash_xxh64(&primitive, sizeof(primitive));
+    hash = hash_xxh64(attributes, sizeof(attributes), hash);
+    hash = hash_xxh64(component_types, sizeof(component_types), hash);
+    hash = hash_xxh64(are_attributes_normalized, sizeof(are_attributes_normalized), hash);
+    hash = hash_xxh64(&index_type, sizeof(index_type), hash);
+    hash = hash_xxh64(get_data().data(), get_data().size_bytes(), hash);
+    return hash_xxh64(get_indices().data(), get_indices().size_bytes(), hash);
+}
+
+bool Mesh::has_same_content(const Mesh& other) const {
+    return primitive == other.primitive
+           && std::ranges::equal(attributes, other.attributes)
+           && std::ranges::equal(component_types, other.component_types)
+           && std::ranges::equal(are_attributes_normalized, other.are_attributes_normalized)
+           && index_type == other.index_type
+           && std::ranges::equal(get_data(), other.get_data())
+           && std::ranges::equal(get_indices(), other.get_indices());
+}
+
 void Mesh::get_min_max_axis_aligned_coordinates(vec3& minimum, vec3& maximum) const {
     if(has_attribute(ATTRIBUTE_POSITION)) {
-        const unsigned int offset = get_attribute_offset(ATTRIBUTE_POSITION);
-        for(unsigned int i = offset ; i < data.size() ; i += stride) {
-            minimum.x = std::min(minimum.x, data[i]);
-            minimum.y = std::min(minimum.y, data[i + 1]);
-            minimum.z = std::min(minimum.z, data[i + 2]);
-
-            maximum.x = std::max(maximum.x, data[i]);
-            maximum.y = std::max(maximum.y, data[i + 1]);
-            maximum.z = std::max(maximum.z, data[i + 2]);
+        const size_t vertices_count = get_vertices_amount();
+        for(size_t i = 0 ; i < vertices_count ; ++i) {
+            vec4 position = get_attribute_value(ATTRIBUTE_POSITION, i);
+
+            minimum.x = std::min(minimum.x, position.x);
+            minimum.y = std::min(minimum.y, position.y);
+            minimum.z = std::min(minimum.z, position.z);
+
+            maximum.x = std::max(maximum.x, position.x);
+            maximum.y = std::max(maximum.y, position.y);
+            maximum.z = std::max(maximum.z, position.z);
         }
     }
 }
 
-float Mesh::intersect(const Ray& ray, const mat4& model_matrix) const {
+float Mesh::intersect(const Ray& ray, const affine3x4& model_matrix) const {
     // TODO Implement for other primitives.
-    if(primitive != MeshPrimitive::TRIANGLES) { return -infinity; }
+    if(!is_triangle_primitive(primitive)) { return -infinity; }
 
-    auto intersect_triangle = [&](size_t index0, size_t index1, size_t index2) -> float {
-        std::size_t baseA = index0 * stride;
-        std::size_t baseB = index1 * stride;
-        std::size_t baseC = index2 * stride;
-
-        return ray.intersect_triangle(
-            model_matrix * vec4(data[baseA], data[baseA + 1], data[baseA + 2], 1.0f),
-            model_matrix * vec4(data[baseB], data[baseB + 1], data[baseB + 2], 1.0f),
-            model_matrix * vec4(data[baseC], data[baseC + 1], data[baseC + 2], 1.0f)
+    float distance = infinity;
+    for_each_triangle([&](unsigned int index0, unsigned int index1, unsigned int index2) {
+        float dist = ray.intersect_triangle(
+            model_matrix * vec4(vec3(get_attribute_value(ATTRIBUTE_POSITION, index0)), 1.0f),
+            model_matrix * vec4(vec3(get_attribute_value(ATTRIBUTE_POSITION, index1)), 1.0f),
+            model_matrix * vec4(vec3(get_attribute_value(ATTRIBUTE_POSITION, index2)), 1.0f)
         );
-    };
+        if(dist > 0.0f) { distance = std::min(distance, dist); }
+    });
+
+    return distance == infinity ? -infinity : distance;
+}
+
+float Mesh::intersect(const Ray& ray, const affine3x4& model_matrix, std::span<const vec4> positions) const {
+    if(!is_triangle_primitive(primitive) || positions.size() < get_vertices_amount()) { return -infinity; }
 
     float distance = infinity;
-    if(indices.empty()) {
-        const std::size_t vertices_count = get_vertices_amount();
-        for(std::size_t i = 0 ; i + 2 < vertices_count ; i += 3) {
-            float dist = intersect_triangle(i, i + 1, i + 2);
-            if(dist > 0.0f) { distance = std::min(distance, dist); }
+    for_each_triangle([&](unsigned int index0, unsigned int index1, unsigned int index2) {
+        float dist = ray.intersect_triangle(model_matrix * positions[index0],
+                                            model_matrix * positions[index1],
+                                            model_matrix * positions[index2]);
+        if(dist > 0.0f) { distance = std::min(distance, dist); }
+    });
+
+    return distance == infinity ? -infinity : distance;
+}
+
+bool Mesh::stripify() {
+    const size_t indices_count = get_indices_amount();
+    if(primitive != MeshPrimitive::TRIANGLES || indices_count < 6) { return false; }
+
+    const size_t triangles_count = indices_count / 3;
+    const unsigned int restart_index = get_restart_index();
+
+    std::vector<unsigned int> triangles(triangles_count * 3);
+    for(size_t i = 0 ; i < triangles.size() ; ++i) {
+        triangles[i] = get_index(i);
+        if(triangles[i] == restart_index) { return false; }
+    }
+
+    /* Directed edges of every triangle, sorted to find the triangle on the other side of an edge. */
+    struct Edge {
+        uint64_t key;          ///< The edge's start in the high bits and its end in the low bits.
+        uint32_t triangle;     ///< The triangle the edge is in.
+        unsigned int opposite; ///< The triangle's vertex that isn't on the edge.
+    };
+
+    auto get_edge_key = [](unsigned int start, unsigned int end) {
+        return static_cast<uint64_t>(start) << 32 | end;
+    };
+
+    std::vector<Edge> edges;
+    edges.reserve(triangles.size());
+    for(uint32_t triangle = 0 ; triangle < triangles_count ; ++triangle) {
+        const unsigned int* vertices = &triangles[3 * triangle];
+        for(unsigned int i = 0 ; i < 3 ; ++i) {
+            edges.emplace_back(get_edge_key(vertices[i], vertices[(i + 1) % 3]), triangle, vertices[(i + 2) % 3]);
         }
-    } else {
-        const std::size_t indices_count = get_indices_amount();
-        for(std::size_t i = 0 ; i + 2 < indices_count ; i += 3) {
-            float dist = intersect_triangle(indices[i], indices[i + 1], indices[i + 2]);
-            if(dist > 0.0f) { distance = std::min(distance, dist); }
+    }
+    std::ranges::sort(edges, {}, &Edge::key);
+
+    std::vector<bool> is_used(triangles_count, false);
+
+    /* Finds an unused triangle with a directed edge, returns the edge's index or edges.size() if none. */
+    auto find_neighbor = [&](unsigned int start, unsigned int end) -> size_t {
+        const uint64_t key = get_edge_key(start, end);
+        auto iterator = std::ranges::lower_bound(edges, key, {}, &Edge::key);
+        for(; iterator != edges.end() && iterator->key == key ; ++iterator) {
+            if(!is_used[iterator->triangle]) { return iterator - edges.begin(); }
+        }
+        return edges.size();
+    };
+
+    std::vector<unsigned int> strips;
+    strips.reserve(indices_count);
+
+    for(uint32_t triangle = 0 ; triangle < triangles_count ; ++triangle) {
+        if(is_used[triangle]) { continue; }
+        is_used[triangle] = true;
+
+        /* Starts with the rotation of the triangle that can be continued, if any. */
+        const unsigned int* vertices = &triangles[3 * triangle];
+        unsigned int rotation = 0;
+        while(rotation < 3 && find_neighbor(vertices[(rotation + 2) % 3], vertices[(rotation + 1) % 3]) == edges.size()) {
+            ++rotation;
+        }
+        rotation %= 3;
+
+        if(!strips.empty()) { strips.push_back(restart_index); }
+        for(unsigned int i = 0 ; i < 3 ; ++i) { strips.push_back(vertices[(rotation + i) % 3]); }
+
+        /* Odd triangles of a strip are wound the other way, so the edge to share alternates. */
+        for(size_t k = 1 ; ; ++k) {
+            unsigned int a = strips[strips.size() - 2];
+            unsigned int b = strips.back();
+            size_t edge = k % 2 == 1 ? find_neighbor(b, a) : find_neighbor(a, b);
+            if(edge == edges.size()) { break; }
+
+            is_used[edges[edge].triangle] = true;
+            strips.push_back(edges[edge].opposite);
         }
     }
 
-    return distance == infinity ? -infinity : distance;
+    if(strips.size() >= indices_count) { return false; }
+
+    indices.clear();
+    external_indices = {};
+    primitive = MeshPrimitive::TRIANGLE_STRIP;
+    push_indices_buffer(strips);
+
+    return true;
 }
 
 void Mesh::clear() {
     delete_buffers();
     data.clear();
     indices.clear();
+    external_data = {};
+    external_indices = {};
     stride = 0;
     active_attributes_count = 0;
+    index_type = ComponentType::UNSIGNED_INT;
     for(AttributeType& attribute : attributes) { attribute = AttributeType::NONE; }
+    for(ComponentType& component_type : component_types) { component_type = ComponentType::FLOAT; }
+    for(bool& is_normalized : are_attributes_normalized) { is_normalized = false; }
     enable_attribute(ATTRIBUTE_POSITION);
 }
 
 void Mesh::delete_buffers() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    VAO = VBO = EBO = 0;
+    // Meshes without buffers have no deleter, so meshes created and destroyed on a loading thread
+    // or by tools that don't link engine_gl never call OpenGL.
+    buffers.reset();
 }
 
 void Mesh::apply_model_matrix(const mat4& model) {
+    if(external_data.data() != nullptr) {
+        data.assign(external_data.begin(), external_data.end());
+        external_data = {};
+    }
+
+    if(component_types[ATTRIBUTE_POSITION] != ComponentType::FLOAT
+       || component_types[ATTRIBUTE_NORMAL] != ComponentType::FLOAT) {
+        throw std::runtime_error("Can't apply a model matrix to a mesh whose positions or normals aren't floats.");
+    }
+
     mat3 normals_model = transpose_inverse(model);
 
     const unsigned int pos_offset = get_attribute_offset(ATTRIBUTE_POSITION);
     const unsigned int normal_offset = get_attribute_offset(ATTRIBUTE_NORMAL);
 
-    for(unsigned int i = 0 ; i < data.size() ; i += stride) {
+    for(size_t i = 0 ; i < data.size() ; i += stride) {
         if(has_attribute(ATTRIBUTE_POSITION)) {
             vec3* pos = reinterpret_cast<vec3*>(&data[pos_offset + i]);
             *pos = vec3(model * vec4(pos->x, pos->y, pos->z, 1.0f));
@@ -228,31 +351,52 @@ void Mesh::apply_model_matrix(const mat4& model) {
         }
     }
 
-    bind_buffers();
+    update_AABB();
 }
 
-void Mesh::enable_attribute(Attribute attribute, AttributeType type) {
+void Mesh::enable_attribute(Attribute attribute, AttributeType type, ComponentType component_type, bool is_normalized) {
     if(type == AttributeType::NONE) { type = get_default_attribute_type(attribute); }
 
-    unsigned int stride_difference = get_attribute_type_count(type) - get_attribute_type_count(attributes[attribute]);
-    stride += stride_difference;
-    active_attributes_count += stride_difference > 0 ? 1 : -1;
+    if(has_attribute(attribute)) {
+        stride -= get_attribute_size(attributes[attribute], component_types[attribute]);
+    } else {
+        ++active_attributes_count;
+    }
+
     attributes[attribute] = type;
+    component_types[attribute] = component_type;
+    are_attributes_normalized[attribute] = is_normalized;
+    stride += get_attribute_size(type, component_type);
 }
 
 void Mesh::disable_attribute(Attribute attribute) {
-    stride -= get_attribute_type_count(attributes[attribute]);
+    if(!has_attribute(attribute)) { return; }
+
+    stride -= get_attribute_size(attributes[attribute], component_types[attribute]);
     active_attributes_count--;
     attributes[attribute] = AttributeType::NONE;
 }
 
 void Mesh::add_index(unsigned int index) {
-    indices.push_back(index);
+    if(index_type == ComponentType::UNSIGNED_SHORT) {
+        if(index > 0xFFFF) { throw std::runtime_error("Index " + std::to_string(index) + " doesn't fit in 16 bits."); }
+
+        uint16_t short_index = static_cast<uint16_t>(index);
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&short_index);
+        indices.insert(indices.end(), bytes, bytes + sizeof(short_index));
+    } else {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&index);
+        indices.insert(indices.end(), bytes, bytes + sizeof(index));
+    }
+}
+
+void Mesh::add_primitive_restart() {
+    add_index(get_restart_index());
 }
 
 void Mesh::add_line(unsigned int start, unsigned int end) {
-    indices.push_back(start);
-    indices.push_back(end);
+    add_index(start);
+    add_index(end);
 }
 
 void Mesh::add_line_triangle(unsigned int A, unsigned int B, unsigned int C) {
@@ -269,9 +413,9 @@ void Mesh::add_line_quad(unsigned int A, unsigned int B, unsigned int C, unsigne
 }
 
 void Mesh::add_triangle(unsigned int top, unsigned int left, unsigned int right) {
-    indices.push_back(top);
-    indices.push_back(left);
-    indices.push_back(right);
+    add_index(top);
+    add_index(left);
+    add_index(right);
 }
 
 void Mesh::add_face(unsigned int topL, unsigned int bottomL, unsigned int bottomR, unsigned int topR) {
@@ -279,79 +423,40 @@ void Mesh::add_face(unsigned int topL, unsigned int bottomL, unsigned int bottom
     add_triangle(topL, bottomR, topR);
 }
 
-void Mesh::bind_buffers() {
-    /* AABB */
-    vec3 min(std::numeric_limits<float>::max());
-    vec3 max(std::numeric_limits<float>::lowest());
-    get_min_max_axis_aligned_coordinates(min, max);
-    aabb.set(min, max);
-
-    /* VAO */
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    /* VBO */
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), data.data(), GL_STATIC_DRAW);
-
-    /* Vertex Attributes */
-    float stride_in_bytes = stride * sizeof(float);
-    unsigned int offset = 0;
-
-    for(unsigned int attr = 0 ; attr < ATTRIBUTE_AMOUNT ; ++attr) {
-        AttributeType type = attributes[attr];
-        if(type != AttributeType::NONE) {
-            unsigned int size = get_attribute_type_count(type);
-            glVertexAttribPointer(attr, size, GL_FLOAT, false, stride_in_bytes, reinterpret_cast<void*>(offset));
-            glEnableVertexAttribArray(attr);
-            offset += size * sizeof(float);
-        }
-    }
-
-    /* Indices & EBO */
-    if(!indices.empty()) {
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-    }
-}
-
 void Mesh::push_value(float value) {
-    data.push_back(value);
+    push_bytes(&value, sizeof(float));
 }
 
 void Mesh::push_value(const vec2& value) {
-    data.push_back(value.x);
-    data.push_back(value.y);
+    push_values(&value.x, 2);
 }
 
 void Mesh::push_value(const vec3& value) {
-    data.push_back(value.x);
-    data.push_back(value.y);
-    data.push_back(value.z);
+    push_values(&value.x, 3);
 }
 
 void Mesh::push_value(const vec4& value) {
-    data.push_back(value.x);
-    data.push_back(value.y);
-    data.push_back(value.z);
-    data.push_back(value.w);
+    push_values(&value.x, 4);
 }
 
 void Mesh::push_values(const float* values, unsigned int n) {
-    for(unsigned int i = 0 ; i < n ; ++i) { data.push_back(values[i]); }
+    push_bytes(values, n * sizeof(float));
+}
+
+void Mesh::push_bytes(const void* bytes, size_t size) {
+    const unsigned char* begin = static_cast<const unsigned char*>(bytes);
+    data.insert(data.end(), begin, begin + size);
 }
 
 void Mesh::push_indices_buffer(const std::vector<unsigned int>& indices) {
-    this->indices.insert(this->indices.end(), indices.begin(), indices.end());
+    for(unsigned int index : indices) { add_index(index); }
 }
 
 unsigned int Mesh::get_attribute_offset(Attribute attribute) const {
     unsigned int offset = 0;
 
     for(unsigned char attr = 0 ; attr < attribute ; ++attr) {
-        offset += get_attribute_type_count(attributes[attr]);
+        offset += get_attribute_size(attributes[attr], component_types[attr]);
     }
 
     return offset;
@@ -0,0 +1,146 @@
+/***************************************************************************************************
+ * @file  MeshBuffers.cpp
+ * @brief Implementation of the MeshBuffers struct and of the OpenGL part of the Mesh class
+ **************************************************************************************************/
+
+#include "mesh/MeshBuffers.hpp"
+
+#include <iostream>
+
+MeshBuffers::~MeshBuffers() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+void Mesh::draw() const {
+    if(primitive == MeshPrimitive::NONE) {
+        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have a primitive.\n";
+        return;
+    }
+
+    if(stride == 0) {
+        std::cout << "[WARNING] Mesh wasn't drawn as it didn't have any active attributes.\n";
+        return;
+    }
+
+    if(!buffers) {
+        std::cout << "[WARNING] Mesh wasn't drawn as its buffers aren't bound.\n";
+        return;
+    }
+
+    glBindVertexArray(buffers->VAO);
+
+    if(get_indices_amount() == 0) {
+        glDrawArrays(get_opengl_enum_for_primitive(primitive), 0, get_vertices_amount());
+    } else {
+        glDrawElements(get_opengl_enum_for_primitive(primitive), get_indices_amount(), get_opengl_enum_for_component_type(index_type), nullptr);
+    }
+}
+
+void Mesh::draw_normals() const {
+    if(primitive == MeshPrimitive::NONE) {
+        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have a primitive.\n";
+        return;
+    }
+
+    if(stride == 0) {
+        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have any active attributes.\n";
+        return;
+    }
+
+    if(!buffers) {
+        std::cout << "[WARNING] Normals weren't drawn as the mesh's buffers aren't bound.\n";
+        return;
+    }
+
+    if(!is_triangle_primitive(primitive)) {
+        std::cout << "[WARNING] Normals weren't drawn as the mesh wasn't a triangle mesh.\n";
+        return;
+    }
+
+    if(!has_attribute(ATTRIBUTE_NORMAL)) {
+        std::cout << "[WARNING] Normals weren't drawn as the mesh didn't have any normals.\n";
+        return;
+    }
+
+    glBindVertexArray(buffers->VAO);
+    glDrawArrays(GL_POINTS, 0, get_vertices_amount());
+}
+
+void Mesh::draw_wireframe() const {
+    if(primitive == MeshPrimitive::NONE) {
+        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh didn't have a primitive.\n";
+        return;
+    }
+
+    if(stride == 0) {
+        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh didn't have any active attributes.\n";
+        return;
+    }
+
+    if(!buffers) {
+        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh's buffers aren't bound.\n";
+        return;
+    }
+
+    if(!is_triangle_primitive(primitive)) {
+        std::cout << "[WARNING] Wireframe wasn't drawn as the mesh wasn't a triangle mesh.\n";
+        return;
+    }
+
+    glBindVertexArray(buffers->VAO);
+
+    // The wireframe geometry shader takes triangles, which strips and fans are assembled into.
+    glLineWidth(2);
+    if(get_indices_amount() == 0) {
+        glDrawArrays(get_opengl_enum_for_primitive(primitive), 0, get_vertices_amount());
+    } else {
+        glDrawElements(get_opengl_enum_for_primitive(primitive), get_indices_amount(), get_opengl_enum_for_component_type(index_type), nullptr);
+    }
+    glLineWidth(1);
+}
+
+void Mesh::bind_buffers() {
+    /* AABB */
+    update_AABB();
+
+    /* VAO */
+    // Replacing the buffers deletes the previous ones.
+    buffers = { new MeshBuffers { 0, 0, 0 }, [](MeshBuffers* mesh_buffers) { delete mesh_buffers; } };
+    glGenVertexArrays(1, &buffers->VAO);
+    glBindVertexArray(buffers->VAO);
+
+    /* VBO */
+    // Immutable storage uploaded straight from the vertex data, which can be in a mapped file.
+    std::span<const unsigned char> data = get_data();
+    glGenBuffers(1, &buffers->VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers->VBO);
+    if(!data.empty()) { glBufferStorage(GL_ARRAY_BUFFER, data.size_bytes(), data.data(), 0); }
+
+    /* Vertex Attributes */
+    // Integer attributes are converted to floats by OpenGL, so they keep their size on the GPU.
+    uintptr_t offset = 0;
+
+    for(unsigned int attr = 0 ; attr < ATTRIBUTE_AMOUNT ; ++attr) {
+        AttributeType type = attributes[attr];
+        if(type != AttributeType::NONE) {
+            glVertexAttribPointer(attr,
+                                  get_attribute_type_count(type),
+                                  get_opengl_enum_for_component_type(component_types[attr]),
+                                  are_attributes_normalized[attr],
+                                  stride,
+                                  reinterpret_cast<void*>(offset));
+            glEnableVertexAttribArray(attr);
+            offset += get_attribute_size(type, component_types[attr]);
+        }
+    }
+
+    /* Indices & EBO */
+    std::span<const unsigned char> indices = get_indices();
+    if(!indices.empty()) {
+        glGenBuffers(1, &buffers->EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers->EBO);
+        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, indices.size_bytes(), indices.data(), 0);
+    }
+}
@@ -0,0 +1,72 @@
+/***************************************************************************************************
+ * @file  MappedFile.cpp
+ * @brief Implementation of the MappedFile class
+ **************************************************************************************************/
+
+#include "utility/MappedFile.hpp"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+MappedFile::MappedFile() : data(nullptr), size(0) { }
+
+MappedFile::MappedFile(const std::filesystem::path& path) : MappedFile() {
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if(file_descriptor == -1) { throw std::runtime_error("Failed to open file '" + path.string() + "'."); }
+
+    struct stat file_status;
+    if(fstat(file_descriptor, &file_status) == -1) {
+        close(file_descriptor);
+        throw std::runtime_error("Failed to get the size of file '" + path.string() + "'.");
+    }
+
+    size = static_cast<size_t>(file_status.st_size);
+
+    /* An empty file can't be mapped, it is kept as an empty mapping. */
+    if(size > 0) {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if(data == MAP_FAILED) {
+            data = nullptr;
+            size = 0;
+            close(file_descriptor);
+            throw std::runtime_error("Failed to map file '" + path.string() + "'.");
+        }
+    }
+
+    close(file_descriptor); // The mapping keeps its own reference to the file.
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) { }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+
+    return *this;
+}
+
+std::span<const unsigned char> MappedFile::get_data() const {
+    return { static_cast<const unsigned char*>(data), size };
+}
+
+size_t MappedFile::get_size() const {
+    return size;
+}
+
+void MappedFile::unmap() {
+    if(data != nullptr) { munmap(data, size); }
+    data = nullptr;
+    size = 0;
+}
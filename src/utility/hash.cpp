@@ -0,0 +1,95 @@
+/***************************************************************************************************
+ * @file  hash.cpp
+ * @brief Implementation of hashing functions
+ **************************************************************************************************/
+
+#include "utility/hash.hpp"
+
+#include <bit>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87;
+static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4F;
+static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9;
+static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63;
+static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5;
+
+static uint64_t read_64(const unsigned char* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint32_t read_32(const unsigned char* data) {
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static uint64_t round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME_2;
+    accumulator = std::rotl(accumulator, 31);
+    return accumulator * PRIME_1;
+}
+
+static uint64_t merge_round(uint64_t accumulator, uint64_t value) {
+    accumulator ^= round(0, value);
+    return accumulator * PRIME_1 + PRIME_4;
+}
+
+uint64_t hash_xxh64(const void* data, size_t size, uint64_t seed) {
+    auto bytes = static_cast<const unsigned char*>(data);
+    const unsigned char* end = bytes + size;
+    uint64_t hash;
+
+    /* ---- Stripes of 32 bytes ---- */
+    if(size >= 32) {
+        uint64_t accumulators[4] { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+
+        for(; bytes + 32 <= end ; bytes += 32) {
+            for(unsigned int i = 0 ; i < 4 ; ++i) { accumulators[i] = round(accumulators[i], read_64(bytes + 8 * i)); }
+        }
+
+        hash = std::rotl(accumulators[0], 1) + std::rotl(accumulators[1], 7)
+               + std::rotl(accumulators[2], 12) + std::rotl(accumulators[3], 18);
+        for(uint64_t accumulator : accumulators) { hash = merge_round(hash, accumulator); }
+    } else {
+        hash = seed + PRIME_5;
+    }
+
+    hash += size;
+
+    /* ---- Remaining bytes ---- */
+    for(; bytes + 8 <= end ; bytes += 8) {
+        hash ^= round(0, read_64(bytes));
+        hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+    }
+
+    if(bytes + 4 <= end) {
+        hash ^= read_32(bytes) * PRIME_1;
+        hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+        bytes += 4;
+    }
+
+    for(; bytes < end ; ++bytes) {
+        hash ^= *bytes * PRIME_5;
+        hash = std::rotl(hash, 11) * PRIME_1;
+    }
+
+    /* ---- Avalanche ---- */
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+std::string hash_to_string(uint64_t hash) {
+    std::ostringstream stream;
+    stream << std::hex << std::setfill('0') << std::setw(16) << hash;
+    return stream.str();
+}